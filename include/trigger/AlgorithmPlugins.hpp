@@ -14,6 +14,7 @@
 #include "triggeralgs/TriggerDecisionMaker.hpp"
 #include "triggeralgs/TriggerActivityFactory.hpp"
 #include "triggeralgs/TriggerCandidateFactory.hpp"
+#include "trigger/AlgorithmRegistry.hpp"
 #include "trigger/Issues.hpp"
 
 #include "cetlib/BasicPluginFactory.h"
@@ -31,6 +32,11 @@ namespace dunedaq::trigger {
 inline std::unique_ptr<triggeralgs::TriggerActivityMaker>
 make_ta_maker(std::string const& plugin_name)
 {
+  // Statically linked algorithms resolve here with no dynamic loading;
+  // the registry is empty in ordinary plugin builds
+  if (auto ta_maker = AlgorithmRegistry<triggeralgs::TriggerActivityMaker>::get_instance().build(plugin_name)) {
+    return ta_maker;
+  }
   auto ta_factory = triggeralgs::TriggerActivityFactory::get_instance();
   auto ta_maker = ta_factory->build_maker(plugin_name);
   if (!ta_maker) {
@@ -51,6 +57,9 @@ namespace dunedaq::trigger {
 inline std::unique_ptr<triggeralgs::TriggerCandidateMaker>
 make_tc_maker(std::string const& plugin_name)
 {
+  if (auto tc_maker = AlgorithmRegistry<triggeralgs::TriggerCandidateMaker>::get_instance().build(plugin_name)) {
+    return tc_maker;
+  }
   auto tc_factory = triggeralgs::TriggerCandidateFactory::get_instance();
   auto tc_maker = tc_factory->build_maker(plugin_name);
   if (!tc_maker) {
@@ -85,6 +94,9 @@ namespace dunedaq::trigger {
 inline std::unique_ptr<triggeralgs::TriggerDecisionMaker>
 make_td_maker(std::string const& plugin_name)
 {
+  if (auto td_maker = AlgorithmRegistry<triggeralgs::TriggerDecisionMaker>::get_instance().build(plugin_name)) {
+    return td_maker;
+  }
   static cet::BasicPluginFactory bpf("duneTDMaker", "make");
 
   // TODO Philip Rodrigues <philiprodrigues@github.com> Apr-04-2021: Rethrow any cetlib exception as an ERS issue
@@ -93,4 +105,34 @@ make_td_maker(std::string const& plugin_name)
 
 } // namespace dunedaq::trigger
 
+/**
+ * @brief Statically register an algorithm under the name the config uses
+ *
+ * For monolithic builds that link the algorithm libraries directly: place
+ * one of these at namespace scope in a translation unit the application
+ * links (one macro per algorithm), and the corresponding make_*_maker
+ * call resolves through the static registry with no dlopen. `name` must
+ * be the same string the configuration passes as the plugin name.
+ */
+// NOLINTNEXTLINE(build/define_used)
+#define TRIGGER_REGISTER_STATIC_TA_MAKER(name, klass)                                                                  \
+  namespace {                                                                                                          \
+  const bool s_static_ta_maker_registered =                                                                            \
+    dunedaq::trigger::register_algorithm<triggeralgs::TriggerActivityMaker, klass>(name);                              \
+  }
+
+// NOLINTNEXTLINE(build/define_used)
+#define TRIGGER_REGISTER_STATIC_TC_MAKER(name, klass)                                                                  \
+  namespace {                                                                                                          \
+  const bool s_static_tc_maker_registered =                                                                            \
+    dunedaq::trigger::register_algorithm<triggeralgs::TriggerCandidateMaker, klass>(name);                             \
+  }
+
+// NOLINTNEXTLINE(build/define_used)
+#define TRIGGER_REGISTER_STATIC_TD_MAKER(name, klass)                                                                  \
+  namespace {                                                                                                          \
+  const bool s_static_td_maker_registered =                                                                            \
+    dunedaq::trigger::register_algorithm<triggeralgs::TriggerDecisionMaker, klass>(name);                              \
+  }
+
 #endif // TRIGGER_INCLUDE_TRIGGER_ALGORITHMPLUGINS_HPP_
@@ -0,0 +1,89 @@
+/**
+ * @file AlgorithmRegistry.hpp
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#ifndef TRIGGER_INCLUDE_TRIGGER_ALGORITHMREGISTRY_HPP_
+#define TRIGGER_INCLUDE_TRIGGER_ALGORITHMREGISTRY_HPP_
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace dunedaq::trigger {
+
+/**
+ * @brief Compile-time registry of trigger algorithm factories
+ *
+ * The maker modules normally resolve their algorithm by name through the
+ * plugin factories' dlopen machinery, which costs seconds of dynamic
+ * loading and symbol resolution when cold-starting a full trigger app.
+ * Monolithic production builds can instead link the algorithms in and
+ * register them here at static-initialization time; make_ta_maker /
+ * make_tc_maker / make_td_maker consult this registry first and only
+ * fall back to the plugin path for names not statically registered.
+ *
+ * Registration happens via TRIGGER_REGISTER_STATIC_*_MAKER (see
+ * AlgorithmPlugins.hpp) from a translation unit the monolithic build
+ * links; the registry stays empty - and the behaviour unchanged - in
+ * ordinary plugin builds.
+ */
+template<class MAKER>
+class AlgorithmRegistry
+{
+public:
+  using factory_fn = std::unique_ptr<MAKER> (*)();
+
+  static AlgorithmRegistry& get_instance()
+  {
+    static AlgorithmRegistry instance;
+    return instance;
+  }
+
+  void register_maker(const std::string& name, factory_fn factory)
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_factories[name] = factory;
+  }
+
+  // Returns nullptr for names not statically registered, in which case
+  // the caller falls back to the plugin factory
+  std::unique_ptr<MAKER> build(const std::string& name)
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_factories.find(name);
+    if (it == m_factories.end()) {
+      return nullptr;
+    }
+    return it->second();
+  }
+
+private:
+  AlgorithmRegistry() = default;
+
+  std::mutex m_mutex;
+  std::map<std::string, factory_fn> m_factories;
+};
+
+// Helper returning true so registrations can run at static-init time as
+// the initializer of a namespace-scope bool
+template<class MAKER, class T>
+bool
+register_algorithm(const std::string& name)
+{
+  AlgorithmRegistry<MAKER>::get_instance().register_maker(
+    name, []() -> std::unique_ptr<MAKER> { return std::make_unique<T>(); });
+  return true;
+}
+
+} // namespace dunedaq::trigger
+
+#endif // TRIGGER_INCLUDE_TRIGGER_ALGORITHMREGISTRY_HPP_
+
+// Local Variables:
+// c-basic-offset: 2
+// End:
@@ -0,0 +1,103 @@
+/**
+ * @file IssueThrottler.hpp
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#ifndef TRIGGER_INCLUDE_TRIGGER_ISSUETHROTTLER_HPP_
+#define TRIGGER_INCLUDE_TRIGGER_ISSUETHROTTLER_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace dunedaq::trigger {
+
+/**
+ * @brief Token bucket limiting ERS issue emission on hot paths
+ *
+ * A pathological input (one misbehaving stream, one badly tardy producer)
+ * can raise the same warning for every object in a multi-MHz loop, and the
+ * ers emission cost then dwarfs the work being warned about. An
+ * IssueThrottler sits in front of one issue type at one call site: bursts
+ * up to `burst` issues pass through unchanged, after which one issue per
+ * `token_interval` is let out and the rest are only counted. When an
+ * emission next goes through, take_suppressed() hands the caller the
+ * number swallowed since the last report, to be attached as a summary
+ * issue; suppressed_count() is the running total for opmon.
+ *
+ * The allow()/take_suppressed() path is meant for a single caller thread
+ * (the hot path being protected); only suppressed_count() may be read
+ * concurrently, from the opmon thread.
+ */
+class IssueThrottler
+{
+public:
+  explicit IssueThrottler(uint64_t burst = 5, // NOLINT(build/unsigned)
+                          std::chrono::milliseconds token_interval = std::chrono::seconds(10))
+    : m_burst(burst)
+    , m_token_interval(token_interval)
+    , m_tokens(burst)
+  {}
+
+  // True if the caller should emit the issue now. A false return means the
+  // occurrence was absorbed into the suppressed counts instead
+  bool allow()
+  {
+    auto now = std::chrono::steady_clock::now();
+    if (m_tokens < m_burst) {
+      uint64_t refill = (now - m_last_refill) / m_token_interval; // NOLINT(build/unsigned)
+      if (refill > 0) {
+        m_tokens = std::min(m_burst, m_tokens + refill);
+        m_last_refill += refill * m_token_interval;
+      }
+    } else {
+      m_last_refill = now;
+    }
+    if (m_tokens > 0) {
+      --m_tokens;
+      return true;
+    }
+    ++m_suppressed_since_report;
+    m_suppressed_total.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+
+  // Number of occurrences suppressed since the last call; resets the
+  // since-report count. Call after an allowed emission to attach a summary
+  uint64_t take_suppressed() // NOLINT(build/unsigned)
+  {
+    uint64_t n = m_suppressed_since_report; // NOLINT(build/unsigned)
+    m_suppressed_since_report = 0;
+    return n;
+  }
+
+  // Running total of suppressed occurrences, for opmon
+  uint64_t suppressed_count() const { return m_suppressed_total.load(std::memory_order_relaxed); } // NOLINT(build/unsigned)
+
+  void reset()
+  {
+    m_tokens = m_burst;
+    m_suppressed_since_report = 0;
+    m_suppressed_total.store(0, std::memory_order_relaxed);
+    m_last_refill = std::chrono::steady_clock::now();
+  }
+
+private:
+  const uint64_t m_burst;                            // NOLINT(build/unsigned)
+  const std::chrono::steady_clock::duration m_token_interval;
+  uint64_t m_tokens;                                 // NOLINT(build/unsigned)
+  std::chrono::steady_clock::time_point m_last_refill{ std::chrono::steady_clock::now() };
+  uint64_t m_suppressed_since_report{ 0 };           // NOLINT(build/unsigned)
+  std::atomic<uint64_t> m_suppressed_total{ 0 };     // NOLINT(build/unsigned)
+};
+
+} // namespace dunedaq::trigger
+
+#endif // TRIGGER_INCLUDE_TRIGGER_ISSUETHROTTLER_HPP_
+
+// Local Variables:
+// c-basic-offset: 2
+// End:
@@ -113,6 +113,14 @@ ERS_DECLARE_ISSUE_BASE(trigger,
                        ((std::string)name),
                        ((triggeralgs::timestamp_t)previous)((triggeralgs::timestamp_t)current))
 
+ERS_DECLARE_ISSUE_BASE(trigger,
+                       IssuesSuppressed,
+                       appfwk::GeneralDAQModuleIssue,
+                       count << " further " << issue_name << " issues were suppressed by rate limiting since the last report",
+                       ((std::string)name),
+                       ((std::string)issue_name)
+                       ((uint64_t)count)) // NOLINT(build/unsigned)
+
 ERS_DECLARE_ISSUE_BASE(trigger,
                        AlgorithmFailedToSend,
                        appfwk::GeneralDAQModuleIssue,
@@ -167,6 +175,13 @@ ERS_DECLARE_ISSUE_BASE(trigger,
                        ((triggeralgs::timestamp_t)td_start)
                        ((triggeralgs::timestamp_t)td_end))
 
+ERS_DECLARE_ISSUE_BASE(trigger,
+                       UnknownReadoutType,
+                       appfwk::GeneralDAQModuleIssue,
+                       "Readout map entry for TC type " << tc_type << " is outside the supported type range and will be ignored",
+                       ((std::string)name),
+                       ((int)tc_type))
+
 ERS_DECLARE_ISSUE_BASE(trigger,
                        TCTimestampsSizeError,
                        appfwk::GeneralDAQModuleIssue,
@@ -193,6 +208,36 @@ ERS_DECLARE_ISSUE_BASE(trigger,
 		       ((std::bitset<32>)bits)
 		       ((size_t)map_size))
 
+ERS_DECLARE_ISSUE_BASE(trigger,
+                       LoadSheddingLevelChanged,
+                       appfwk::GeneralDAQModuleIssue,
+                       "Load shedding level is now " << level << " (ADC-integral floor " << adc_floor
+                       << ", per-channel cap " << channel_cap << " TPs/set; 0 = unlimited)",
+                       ((std::string)name),
+                       ((uint64_t)level) // NOLINT(build/unsigned)
+                       ((uint64_t)adc_floor) // NOLINT(build/unsigned)
+                       ((uint64_t)channel_cap)) // NOLINT(build/unsigned)
+
+ERS_DECLARE_ISSUE(trigger,
+                  WorkerStalled,
+                  "Worker " << worker << " has made no progress for " << stalled_ms << " ms (last stage: " << stage
+                            << ")",
+                  ((std::string)worker)((uint64_t)stalled_ms)((std::string)stage)) // NOLINT(build/unsigned)
+
+ERS_DECLARE_ISSUE(trigger,
+                  HugePagesUnavailable,
+                  "Could not obtain explicit huge pages for " << name << " (" << bytes
+                                                              << " bytes requested); falling back to ordinary pages "
+                                                                 "with transparent-huge-page advice",
+                  ((std::string)name)((uint64_t)bytes)) // NOLINT(build/unsigned)
+
+ERS_DECLARE_ISSUE(trigger,
+                  ThreadPlacementFailed,
+                  "Could not apply " << what << " for " << name << ": " << error,
+                  ((std::string)what)
+                  ((std::string)name)
+                  ((std::string)error))
+
 ERS_DECLARE_ISSUE(trigger,
                   MissingFactoryItemError,
                   "Factory could not find requested item " << item << ".",
@@ -8,6 +8,8 @@
 #ifndef TRIGGER_INCLUDE_LOGGING_HPP_
 #define TRIGGER_INCLUDE_LOGGING_HPP_
 
+#include "logging/Logging.hpp"
+
 namespace dunedaq {
 namespace trigger {
 namespace logging {
@@ -31,4 +33,36 @@ enum
 } // namespace trigger
 } // namespace dunedaq
 
+/**
+ * Compile-time cap on debug-log verbosity for this package.
+ *
+ * Debug statements on per-set and per-window hot paths cost a runtime
+ * level check and keep their stream-building code in the instruction
+ * stream even when the level is disabled. TRIGGER_TLOG_DEBUG behaves
+ * exactly like TLOG_DEBUG for levels at or below the cap, and compiles
+ * to nothing above it (the statement is discarded by `if constexpr`,
+ * stream arguments included).
+ *
+ * The default cap keeps everything in developer (non-NDEBUG) builds and
+ * drops TLVL_DEBUG_MEDIUM and above in production builds; override with
+ * -DTRIGGER_DEBUG_LOG_LEVEL=<level> to choose explicitly. Only hot-loop
+ * statements should use the capped macro - anything on a cold path
+ * should stay on plain TLOG_DEBUG so it can be enabled in the field
+ * without a rebuild.
+ */
+#ifndef TRIGGER_DEBUG_LOG_LEVEL
+#ifdef NDEBUG
+#define TRIGGER_DEBUG_LOG_LEVEL dunedaq::trigger::logging::TLVL_DEBUG_LOW
+#else
+#define TRIGGER_DEBUG_LOG_LEVEL dunedaq::trigger::logging::TLVL_DEBUG_ALL
+#endif
+#endif
+
+// clang-format off
+#define TRIGGER_TLOG_DEBUG(lvl)                                                \
+  if constexpr ((lvl) > TRIGGER_DEBUG_LOG_LEVEL) {                             \
+  } else /* NOLINT(readability/braces) */                                      \
+    TLOG_DEBUG(lvl)
+// clang-format on
+
 #endif // TRIGGER_INCLUDE_LOGGING_HPP_
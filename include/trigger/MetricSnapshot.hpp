@@ -0,0 +1,98 @@
+/**
+ * @file MetricSnapshot.hpp
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#ifndef TRIGGER_INCLUDE_TRIGGER_METRICSNAPSHOT_HPP_
+#define TRIGGER_INCLUDE_TRIGGER_METRICSNAPSHOT_HPP_
+
+#include <atomic>
+#include <cstdint>
+#include <type_traits>
+
+namespace dunedaq::trigger {
+
+/**
+ * @brief Double-buffered seqlock for publishing opmon Info snapshots
+ *
+ * get_info() runs on the opmon thread at its own cadence, and an
+ * implementation that assembles an Info record there reads counters and
+ * histograms the worker thread owns - at best adding cache traffic to the
+ * hot path, at worst needing a lock. A MetricSnapshot inverts this: the
+ * worker publishes a complete Info record on its own cadence, and the
+ * opmon thread copies the latest published snapshot without touching any
+ * worker-owned state.
+ *
+ * Two slots with per-slot sequence counters: the writer alternates slots,
+ * bumping the slot's counter to odd before the copy and even after, then
+ * pointing m_latest at it. A reader copies the slot m_latest names and
+ * retries on the (rare) torn read where the writer lapped it. publish()
+ * is single-writer; read() may be called from any thread and never blocks
+ * the writer.
+ */
+template<class INFO>
+class MetricSnapshot
+{
+  static_assert(std::is_trivially_copyable_v<INFO>,
+                "MetricSnapshot requires a trivially copyable Info record");
+
+public:
+  // Publish a new snapshot. Wait-free; worker thread only
+  void publish(const INFO& info)
+  {
+    uint32_t next = m_latest.load(std::memory_order_relaxed) ^ 1; // NOLINT(build/unsigned)
+    Slot& s = m_slots[next];
+    s.seq.fetch_add(1, std::memory_order_acq_rel); // odd: write in progress
+    s.data = info;
+    s.seq.fetch_add(1, std::memory_order_release); // even: write complete
+    m_latest.store(next, std::memory_order_release);
+  }
+
+  // Copy the latest published snapshot into `out`. Returns false if
+  // nothing has been published yet (out is untouched)
+  bool read(INFO& out) const
+  {
+    for (int attempt = 0; attempt < 8; ++attempt) {
+      uint32_t idx = m_latest.load(std::memory_order_acquire); // NOLINT(build/unsigned)
+      const Slot& s = m_slots[idx];
+      uint64_t seq_before = s.seq.load(std::memory_order_acquire); // NOLINT(build/unsigned)
+      if (seq_before == 0 || (seq_before & 1) != 0) {
+        if (seq_before == 0) {
+          return false;
+        }
+        continue;
+      }
+      INFO copy = s.data;
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (s.seq.load(std::memory_order_relaxed) == seq_before) {
+        out = copy;
+        return true;
+      }
+    }
+    // Writer lapped us on every attempt - only plausible if the publish
+    // cadence collapses to the copy duration. Report nothing rather than
+    // a torn snapshot; the next poll will get one
+    return false;
+  }
+
+private:
+  struct Slot
+  {
+    std::atomic<uint64_t> seq{ 0 }; // NOLINT(build/unsigned)
+    INFO data{};
+  };
+
+  Slot m_slots[2];
+  std::atomic<uint32_t> m_latest{ 0 }; // NOLINT(build/unsigned)
+};
+
+} // namespace dunedaq::trigger
+
+#endif // TRIGGER_INCLUDE_TRIGGER_METRICSNAPSHOT_HPP_
+
+// Local Variables:
+// c-basic-offset: 2
+// End:
@@ -12,6 +12,7 @@
 #include "daqdataformats/SourceID.hpp"
 #include "daqdataformats/Types.hpp"
 #include "trgdataformats/Types.hpp"
+#include "trigger/SmallVector.hpp"
 
 #include <cstdint>
 #include <vector>
@@ -29,6 +30,12 @@ public:
   using origin_t = daqdataformats::SourceID;
   using timestamp_t = daqdataformats::timestamp_t;
 
+  // Objects per Set stored inline before spilling to the heap. Most Sets
+  // in a quiet period carry at most a handful of objects, so this makes
+  // the dominant transport object allocation-free
+  static constexpr size_t s_inline_capacity = 8;
+  using collection_t = SmallVector<T, s_inline_capacity>;
+
   enum Type
   {
     kUnknown = 0,
@@ -58,7 +65,7 @@ public:
   timestamp_t end_time{ 0 };
 
   // The TPs/TAs themselves. Needs a better name!
-  std::vector<T> objects;
+  collection_t objects;
 };
 
 } // namespace dunedaq::trigger
@@ -0,0 +1,335 @@
+/**
+ * @file ShmSetArena.hpp
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#ifndef TRIGGER_INCLUDE_TRIGGER_SHMSETARENA_HPP_
+#define TRIGGER_INCLUDE_TRIGGER_SHMSETARENA_HPP_
+
+#include "serialization/Serialization.hpp"
+#include "trigger/Set.hpp"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+namespace dunedaq::trigger {
+
+/**
+ * @brief Handle to a Set parked in a shared-memory arena
+ *
+ * This is what actually crosses the app boundary: a fixed 16-byte message
+ * instead of a serialized payload. The generation field detects the slot
+ * being recycled under a slow consumer, so a stale handle is refused
+ * rather than yielding another Set's data.
+ */
+struct ShmSetHandle
+{
+  uint32_t slot{ 0 };       // NOLINT(build/unsigned)
+  uint32_t generation{ 0 }; // NOLINT(build/unsigned)
+  uint64_t n_objects{ 0 };  // NOLINT(build/unsigned)
+};
+
+/**
+ * @brief Single-producer shared-memory arena for intra-host Set passing
+ *
+ * Trigger apps co-located on one host were paying a full serialize /
+ * deserialize round trip for every Set crossing an app boundary. The
+ * arena is a POSIX shared-memory segment holding a ring of fixed-size
+ * slots; the producer writes each Set once (header plus the contiguous
+ * payload array) and sends only a ShmSetHandle through the usual
+ * iomanager connection, and consumers attach to the same segment by name
+ * and read the payload in place through a View, with a per-slot reader
+ * count keeping a slot alive until every view is released.
+ *
+ * Only Sets of trivially copyable elements qualify (i.e. TPSets): the
+ * payload is placed into the slot as a flat overlay, the same layout the
+ * network serialization blob uses. A Set whose payload exceeds the slot
+ * capacity does not fit the arena and must take the ordinary serialized
+ * path; write() reports this by returning false.
+ *
+ * Integration status: the arena itself is complete and unit tested, but
+ * it is not yet wired into the maker pipeline. What remains is config
+ * work: an opt-in flag plus segment name and sizing fields in the maker
+ * schemas, producer-side arena setup next to get_iom_sender in
+ * TriggerGenericMaker::init, a ShmSetHandle receive path in
+ * TriggerGenericWorker::process reading in place (with copy_out for
+ * consumers that buffer Sets beyond the slot's lifetime), and a counter
+ * for refused and recycled handles in the maker info schema.
+ */
+template<class SET>
+class ShmSetArena
+{
+  static_assert(std::is_trivially_copyable_v<typename SET::element_t>,
+                "ShmSetArena requires a trivially copyable Set element type");
+
+  // Defined below; forward-declared so View can hold a pointer to the
+  // member type rather than accidentally introducing a namespace-scope Slot
+  struct Slot;
+
+public:
+  // Header fields of a parked Set, stored flat in the slot
+  struct SlotHeader
+  {
+    typename SET::seqno_t seqno;
+    daqdataformats::run_number_t run_number;
+    uint32_t origin_subsystem; // NOLINT(build/unsigned)
+    uint32_t origin_id;        // NOLINT(build/unsigned)
+    int32_t type;
+    typename SET::timestamp_t start_time;
+    typename SET::timestamp_t end_time;
+  };
+
+  // In-place read of a parked Set. Holds the slot's reader count until
+  // destroyed; objects() points straight into the shared segment
+  class View
+  {
+  public:
+    View() = default;
+    View(const View&) = delete;
+    View& operator=(const View&) = delete;
+    View(View&& other) noexcept { *this = std::move(other); }
+    View& operator=(View&& other) noexcept
+    {
+      release();
+      m_slot = other.m_slot;
+      m_n_objects = other.m_n_objects;
+      other.m_slot = nullptr;
+      return *this;
+    }
+    ~View() { release(); }
+
+    bool valid() const { return m_slot != nullptr; }
+    const SlotHeader& header() const { return m_slot->header; }
+    const typename SET::element_t* objects() const
+    {
+      return reinterpret_cast<const typename SET::element_t*>(m_slot->payload);
+    }
+    size_t n_objects() const { return m_n_objects; }
+
+    void release()
+    {
+      if (m_slot != nullptr) {
+        m_slot->readers.fetch_sub(1, std::memory_order_release);
+        m_slot = nullptr;
+      }
+    }
+
+  private:
+    friend class ShmSetArena;
+    Slot* m_slot{ nullptr };
+    size_t m_n_objects{ 0 };
+  };
+
+  // Producer constructor: create (or take over) the named segment
+  ShmSetArena(const std::string& name, size_t n_slots, size_t max_objects_per_set)
+    : m_name(name)
+    , m_owner(true)
+  {
+    int fd = ::shm_open(name.c_str(), O_CREAT | O_RDWR, 0600);
+    if (fd < 0) {
+      throw std::runtime_error("ShmSetArena: shm_open failed for " + name);
+    }
+    m_segment_bytes = sizeof(ArenaHeader) + n_slots * slot_bytes(max_objects_per_set);
+    if (::ftruncate(fd, m_segment_bytes) != 0) {
+      ::close(fd);
+      throw std::runtime_error("ShmSetArena: ftruncate failed for " + name);
+    }
+    map_segment(fd);
+    ::close(fd);
+    m_arena->n_slots = n_slots;
+    m_arena->slot_capacity = max_objects_per_set;
+    for (size_t i = 0; i < n_slots; ++i) {
+      Slot& s = slot(i);
+      s.generation.store(0, std::memory_order_relaxed);
+      s.readers.store(0, std::memory_order_relaxed);
+    }
+    m_arena->magic.store(s_magic, std::memory_order_release);
+  }
+
+  // Consumer constructor: attach to an existing segment
+  explicit ShmSetArena(const std::string& name)
+    : m_name(name)
+    , m_owner(false)
+  {
+    int fd = ::shm_open(name.c_str(), O_RDWR, 0600);
+    if (fd < 0) {
+      throw std::runtime_error("ShmSetArena: shm_open failed for " + name);
+    }
+    struct ::stat st;
+    if (::fstat(fd, &st) != 0) {
+      ::close(fd);
+      throw std::runtime_error("ShmSetArena: fstat failed for " + name);
+    }
+    m_segment_bytes = st.st_size;
+    map_segment(fd);
+    ::close(fd);
+    if (m_arena->magic.load(std::memory_order_acquire) != s_magic) {
+      throw std::runtime_error("ShmSetArena: segment " + name + " not initialized by a producer");
+    }
+  }
+
+  ShmSetArena(const ShmSetArena&) = delete;
+  ShmSetArena& operator=(const ShmSetArena&) = delete;
+
+  ~ShmSetArena()
+  {
+    if (m_arena != nullptr) {
+      ::munmap(m_arena, m_segment_bytes);
+    }
+    if (m_owner) {
+      ::shm_unlink(m_name.c_str());
+    }
+  }
+
+  // Producer: park `in` in the next ring slot and fill `handle`. Returns
+  // false (leaving the Set for the ordinary serialized path) if the
+  // payload exceeds the slot capacity, or if the slot still has readers -
+  // the ring equivalent of a full queue
+  bool write(const SET& in, ShmSetHandle& handle)
+  {
+    if (in.objects.size() > m_arena->slot_capacity) {
+      return false;
+    }
+    Slot& s = slot(m_next_slot % m_arena->n_slots);
+    // Seqlock-style publication: handles only ever carry even generations,
+    // and the slot is marked in-progress (odd generation) BEFORE the
+    // reader check. Both sides use sequentially consistent operations on
+    // the generation/readers pair, so either this check observes a racing
+    // reader's increment (and the write aborts), or that reader's
+    // subsequent generation load observes the odd value (and the read is
+    // refused) - a consumer can never validate a view against a slot that
+    // is being rewritten
+    const uint32_t even = s.generation.load(std::memory_order_relaxed); // NOLINT(build/unsigned)
+    s.generation.store(even + 1);
+    if (s.readers.load() != 0) {
+      // Restore the old generation so existing handles to this slot stay
+      // readable; the refused write is the ring equivalent of a full queue
+      s.generation.store(even, std::memory_order_release);
+      return false;
+    }
+    s.header.seqno = in.seqno;
+    s.header.run_number = in.run_number;
+    s.header.origin_subsystem = static_cast<uint32_t>(in.origin.subsystem); // NOLINT(build/unsigned)
+    s.header.origin_id = in.origin.id;
+    s.header.type = static_cast<int32_t>(in.type);
+    s.header.start_time = in.start_time;
+    s.header.end_time = in.end_time;
+    std::memcpy(s.payload, in.objects.begin(), in.objects.size() * sizeof(typename SET::element_t));
+    s.generation.store(even + 2, std::memory_order_release);
+    handle.slot = m_next_slot % m_arena->n_slots;
+    handle.generation = even + 2;
+    handle.n_objects = in.objects.size();
+    ++m_next_slot;
+    return true;
+  }
+
+  // Consumer: get an in-place view of a parked Set. An invalid View means
+  // the slot was recycled before this handle was consumed (the shm
+  // equivalent of a drop, to be counted by the caller)
+  View read(const ShmSetHandle& handle)
+  {
+    View view;
+    if (handle.slot >= m_arena->n_slots) {
+      return view;
+    }
+    Slot& s = slot(handle.slot);
+    // Register as a reader first, then validate. A slot mid-rewrite (odd
+    // generation) or recycled (different even generation) is refused; see
+    // write() for why this ordering closes the publish race
+    s.readers.fetch_add(1);
+    if (s.generation.load() != handle.generation) {
+      s.readers.fetch_sub(1, std::memory_order_release);
+      return view;
+    }
+    view.m_slot = &s;
+    view.m_n_objects = handle.n_objects;
+    return view;
+  }
+
+  // Materialize an owning Set from a view, for consumers that need to
+  // forward the Set rather than read it in place
+  static void copy_out(const View& view, SET& out)
+  {
+    out.seqno = view.header().seqno;
+    out.run_number = view.header().run_number;
+    out.origin = daqdataformats::SourceID(
+      static_cast<daqdataformats::SourceID::Subsystem>(view.header().origin_subsystem), view.header().origin_id);
+    out.type = static_cast<typename SET::Type>(view.header().type);
+    out.start_time = view.header().start_time;
+    out.end_time = view.header().end_time;
+    out.objects.clear();
+    out.objects.reserve(view.n_objects());
+    for (size_t i = 0; i < view.n_objects(); ++i) {
+      out.objects.push_back(view.objects()[i]);
+    }
+  }
+
+private:
+  struct ArenaHeader
+  {
+    std::atomic<uint64_t> magic{ 0 }; // NOLINT(build/unsigned)
+    uint64_t n_slots{ 0 };            // NOLINT(build/unsigned)
+    uint64_t slot_capacity{ 0 };      // max objects per slot // NOLINT(build/unsigned)
+  };
+
+  struct Slot
+  {
+    std::atomic<uint32_t> generation; // NOLINT(build/unsigned)
+    std::atomic<uint32_t> readers;    // NOLINT(build/unsigned)
+    SlotHeader header;
+    alignas(64) char payload[1]; // actually slot_capacity * sizeof(element_t)
+  };
+
+  static constexpr uint64_t s_magic = 0x5450534554534852; // NOLINT(build/unsigned)
+
+  size_t slot_bytes(size_t max_objects) const
+  {
+    size_t bytes = offsetof(Slot, payload) + max_objects * sizeof(typename SET::element_t);
+    return (bytes + 63) & ~size_t{ 63 }; // keep slots cache-line aligned
+  }
+
+  void map_segment(int fd)
+  {
+    void* addr = ::mmap(nullptr, m_segment_bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (addr == MAP_FAILED) { // NOLINT
+      throw std::runtime_error("ShmSetArena: mmap failed for " + m_name);
+    }
+    m_arena = static_cast<ArenaHeader*>(addr);
+  }
+
+  Slot& slot(size_t i)
+  {
+    char* base = reinterpret_cast<char*>(m_arena) + sizeof(ArenaHeader);
+    return *reinterpret_cast<Slot*>(base + i * slot_bytes(m_arena->slot_capacity));
+  }
+
+  std::string m_name;
+  bool m_owner;
+  ArenaHeader* m_arena{ nullptr };
+  size_t m_segment_bytes{ 0 };
+  uint64_t m_next_slot{ 0 }; // NOLINT(build/unsigned)
+
+  static_assert(std::is_standard_layout_v<SlotHeader>, "slot layout must be stable across processes");
+};
+
+} // namespace dunedaq::trigger
+
+DUNE_DAQ_SERIALIZE_NON_INTRUSIVE(dunedaq::trigger, ShmSetHandle, slot, generation, n_objects)
+
+#endif // TRIGGER_INCLUDE_TRIGGER_SHMSETARENA_HPP_
+
+// Local Variables:
+// c-basic-offset: 2
+// End:
@@ -0,0 +1,155 @@
+/**
+ * @file SmallVector.hpp
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#ifndef TRIGGER_INCLUDE_TRIGGER_SMALLVECTOR_HPP_
+#define TRIGGER_INCLUDE_TRIGGER_SMALLVECTOR_HPP_
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace dunedaq::trigger {
+
+/**
+ * @brief Small-buffer-optimized sequence for Set payloads
+ *
+ * In quiet detector periods most Sets carry a handful of objects, yet a
+ * std::vector payload costs one heap allocation per Set regardless of
+ * occupancy. SmallVector stores up to N objects inline and only spills to
+ * a heap vector beyond that, so the majority-sparse transport workload
+ * allocates nothing. Storage is contiguous in both regimes, and the
+ * interface covers the subset of std::vector the Set consumers use.
+ *
+ * A spilled instance stays spilled until clear(), which keeps the heap
+ * capacity for reuse (matching the slab-reuse behaviour relied on
+ * elsewhere) while returning to the inline regime for subsequent fills.
+ */
+template<class T, size_t N>
+class SmallVector
+{
+public:
+  using value_type = T;
+  using iterator = T*;
+  using const_iterator = const T*;
+
+  SmallVector() = default;
+
+  // Adopt a whole vector: small contents move element-wise into the inline
+  // storage, large contents take over the vector's heap buffer outright
+  SmallVector& operator=(std::vector<T>&& other)
+  {
+    if (other.size() <= N) {
+      std::move(other.begin(), other.end(), m_inline.begin());
+      m_size = other.size();
+      // Drop any previously spilled elements (keeping the heap capacity),
+      // or the next spill() would append the inline prefix after them and
+      // resurface stale payload
+      m_spill.clear();
+      m_spilled = false;
+      other.clear();
+    } else {
+      m_spill = std::move(other);
+      m_spilled = true;
+      m_size = 0;
+    }
+    return *this;
+  }
+
+  size_t size() const { return m_spilled ? m_spill.size() : m_size; }
+  bool empty() const { return size() == 0; }
+
+  iterator begin() { return m_spilled ? m_spill.data() : m_inline.data(); }
+  iterator end() { return begin() + size(); }
+  const_iterator begin() const { return m_spilled ? m_spill.data() : m_inline.data(); }
+  const_iterator end() const { return begin() + size(); }
+
+  T& operator[](size_t i) { return begin()[i]; }
+  const T& operator[](size_t i) const { return begin()[i]; }
+  T& front() { return *begin(); }
+  const T& front() const { return *begin(); }
+  T& back() { return *(end() - 1); }
+  const T& back() const { return *(end() - 1); }
+
+  void clear()
+  {
+    m_size = 0;
+    m_spill.clear(); // keeps any heap capacity for the next spill
+    m_spilled = false;
+  }
+
+  void reserve(size_t n)
+  {
+    if (n > N) {
+      spill(n);
+    }
+  }
+
+  void push_back(const T& x)
+  {
+    if (!m_spilled && m_size < N) {
+      m_inline[m_size] = x;
+      ++m_size;
+    } else {
+      spill(size() + 1);
+      m_spill.push_back(x);
+    }
+  }
+
+  void push_back(T&& x)
+  {
+    if (!m_spilled && m_size < N) {
+      m_inline[m_size] = std::move(x);
+      ++m_size;
+    } else {
+      spill(size() + 1);
+      m_spill.push_back(std::move(x));
+    }
+  }
+
+  // Erase [first, last), shifting the tail down. With (it, end()) this is
+  // the truncation produced by the erase-remove idiom
+  iterator erase(iterator first, iterator last)
+  {
+    std::move(last, end(), first);
+    size_t removed = last - first;
+    if (m_spilled) {
+      m_spill.resize(m_spill.size() - removed);
+    } else {
+      m_size -= removed;
+    }
+    return first;
+  }
+
+private:
+  // Move the inline prefix into the heap vector, reserving for at least n
+  void spill(size_t n)
+  {
+    if (m_spilled) {
+      return;
+    }
+    m_spill.reserve(std::max(n, 2 * N));
+    std::move(m_inline.begin(), m_inline.begin() + m_size, std::back_inserter(m_spill));
+    m_size = 0;
+    m_spilled = true;
+  }
+
+  std::array<T, N> m_inline{};
+  std::vector<T> m_spill;
+  size_t m_size{ 0 };
+  bool m_spilled{ false };
+};
+
+} // namespace dunedaq::trigger
+
+#endif // TRIGGER_INCLUDE_TRIGGER_SMALLVECTOR_HPP_
+
+// Local Variables:
+// c-basic-offset: 2
+// End:
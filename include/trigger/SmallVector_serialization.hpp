@@ -0,0 +1,88 @@
+/**
+ * @file SmallVector_serialization.hpp
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#ifndef TRIGGER_INCLUDE_TRIGGER_SMALLVECTOR_SERIALIZATION_HPP_
+#define TRIGGER_INCLUDE_TRIGGER_SMALLVECTOR_SERIALIZATION_HPP_
+
+#include "serialization/Serialization.hpp"
+#include "trigger/SmallVector.hpp"
+
+// SmallVector serializes exactly like std::vector (a plain array), so the
+// wire format of the Set types is unchanged by the small-buffer payload
+
+namespace msgpack {
+MSGPACK_API_VERSION_NAMESPACE(MSGPACK_DEFAULT_API_NS)
+{
+  namespace adaptor {
+
+  template<class T, size_t N>
+  struct pack<dunedaq::trigger::SmallVector<T, N>>
+  {
+    template<typename Stream>
+    msgpack::packer<Stream>& operator()(msgpack::packer<Stream>& o,
+                                        const dunedaq::trigger::SmallVector<T, N>& v) const
+    {
+      o.pack_array(v.size());
+      for (const T& x : v) {
+        o.pack(x);
+      }
+      return o;
+    }
+  };
+
+  template<class T, size_t N>
+  struct convert<dunedaq::trigger::SmallVector<T, N>>
+  {
+    const msgpack::object& operator()(const msgpack::object& o, dunedaq::trigger::SmallVector<T, N>& v) const
+    {
+      if (o.type != msgpack::type::ARRAY) {
+        throw msgpack::type_error();
+      }
+      v.clear();
+      v.reserve(o.via.array.size);
+      for (uint32_t i = 0; i < o.via.array.size; ++i) { // NOLINT(build/unsigned)
+        v.push_back(o.via.array.ptr[i].as<T>());
+      }
+      return o;
+    }
+  };
+
+  } // namespace adaptor
+} // MSGPACK_API_VERSION_NAMESPACE(MSGPACK_DEFAULT_API_NS)
+} // namespace msgpack
+
+namespace dunedaq::trigger {
+
+template<class T, size_t N>
+void
+to_json(nlohmann::json& j, const SmallVector<T, N>& v)
+{
+  j = nlohmann::json::array();
+  for (const T& x : v) {
+    j.push_back(x);
+  }
+}
+
+template<class T, size_t N>
+void
+from_json(const nlohmann::json& j, SmallVector<T, N>& v)
+{
+  v.clear();
+  v.reserve(j.size());
+  for (const auto& x : j) {
+    v.push_back(x.template get<T>());
+  }
+}
+
+} // namespace dunedaq::trigger
+
+#endif // TRIGGER_INCLUDE_TRIGGER_SMALLVECTOR_SERIALIZATION_HPP_
+
+// Local Variables:
+// c-basic-offset: 2
+// End:
@@ -12,6 +12,7 @@
 #include "dfmessages/SourceID_serialization.hpp"
 #include "serialization/Serialization.hpp"
 #include "trigger/Set.hpp"
+#include "trigger/SmallVector_serialization.hpp"
 #include "trigger/TriggerActivity_serialization.hpp"
 #include "triggeralgs/TriggerActivity.hpp"
 
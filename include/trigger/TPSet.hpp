@@ -12,9 +12,13 @@
 #include "dfmessages/SourceID_serialization.hpp"
 #include "serialization/Serialization.hpp"
 #include "trigger/Set.hpp"
+#include "trigger/SmallVector_serialization.hpp"
 #include "trigger/TriggerPrimitive_serialization.hpp"
 #include "trgdataformats/TriggerPrimitive.hpp"
 
+#include <cstring>
+#include <type_traits>
+
 namespace dunedaq::trigger {
 
 using TPSet = Set<trgdataformats::TriggerPrimitive>;
@@ -22,6 +26,111 @@ using TPSet = Set<trgdataformats::TriggerPrimitive>;
 } // namespace dunedaq::trigger
 
 MSGPACK_ADD_ENUM(dunedaq::trigger::TPSet::Type)
-DUNE_DAQ_SERIALIZE_NON_INTRUSIVE(dunedaq::trigger, TPSet, seqno, run_number, origin, type, start_time, end_time, objects)
+
+// TriggerPrimitive is a POD overlay layout, so the msgpack encoding for
+// TPSet packs the header fields individually and the whole objects array
+// as one contiguous BIN blob: a memcpy on the send side and a cast-and-copy
+// on the receive side, instead of a per-field encode/decode of every TP.
+// Cross-host TPSet fan-out is the biggest inter-app bandwidth consumer and
+// per-field msgpack dominates its CPU cost (see
+// test/apps/set_serialization_speed.cxx)
+static_assert(std::is_trivially_copyable_v<dunedaq::trgdataformats::TriggerPrimitive>,
+              "the TPSet overlay-blob serialization requires a trivially copyable TriggerPrimitive");
+
+namespace msgpack {
+MSGPACK_API_VERSION_NAMESPACE(MSGPACK_DEFAULT_API_NS)
+{
+  namespace adaptor {
+
+  template<>
+  struct pack<dunedaq::trigger::TPSet>
+  {
+    template<typename Stream>
+    msgpack::packer<Stream>& operator()(msgpack::packer<Stream>& o, const dunedaq::trigger::TPSet& v) const
+    {
+      o.pack_array(7);
+      o.pack(v.seqno);
+      o.pack(v.run_number);
+      o.pack(v.origin);
+      o.pack(v.type);
+      o.pack(v.start_time);
+      o.pack(v.end_time);
+      const uint32_t n_bytes = // NOLINT(build/unsigned)
+        v.objects.size() * sizeof(dunedaq::trgdataformats::TriggerPrimitive);
+      o.pack_bin(n_bytes);
+      o.pack_bin_body(reinterpret_cast<const char*>(v.objects.begin()), n_bytes);
+      return o;
+    }
+  };
+
+  template<>
+  struct convert<dunedaq::trigger::TPSet>
+  {
+    const msgpack::object& operator()(const msgpack::object& o, dunedaq::trigger::TPSet& v) const
+    {
+      if (o.type != msgpack::type::ARRAY || o.via.array.size != 7) {
+        throw msgpack::type_error();
+      }
+      v.seqno = o.via.array.ptr[0].as<dunedaq::trigger::TPSet::seqno_t>();
+      v.run_number = o.via.array.ptr[1].as<dunedaq::daqdataformats::run_number_t>();
+      v.origin = o.via.array.ptr[2].as<dunedaq::trigger::TPSet::origin_t>();
+      v.type = o.via.array.ptr[3].as<dunedaq::trigger::TPSet::Type>();
+      v.start_time = o.via.array.ptr[4].as<dunedaq::trigger::TPSet::timestamp_t>();
+      v.end_time = o.via.array.ptr[5].as<dunedaq::trigger::TPSet::timestamp_t>();
+      const msgpack::object& blob = o.via.array.ptr[6];
+      if (blob.type != msgpack::type::BIN ||
+          blob.via.bin.size % sizeof(dunedaq::trgdataformats::TriggerPrimitive) != 0) {
+        throw msgpack::type_error();
+      }
+      const size_t n_tps = blob.via.bin.size / sizeof(dunedaq::trgdataformats::TriggerPrimitive);
+      v.objects.clear();
+      v.objects.reserve(n_tps);
+      dunedaq::trgdataformats::TriggerPrimitive tp;
+      for (size_t i = 0; i < n_tps; ++i) {
+        std::memcpy(&tp, blob.via.bin.ptr + i * sizeof(tp), sizeof(tp));
+        v.objects.push_back(tp);
+      }
+      return o;
+    }
+  };
+
+  } // namespace adaptor
+} // MSGPACK_API_VERSION_NAMESPACE(MSGPACK_DEFAULT_API_NS)
+} // namespace msgpack
+
+// The JSON form stays field-by-field: it is only used for debugging and
+// config-style dumps, where readability beats throughput
+
+namespace dunedaq::trigger {
+
+inline void
+to_json(nlohmann::json& j, const TPSet& v)
+{
+  j["seqno"] = v.seqno;
+  j["run_number"] = v.run_number;
+  j["origin"] = v.origin;
+  j["type"] = v.type;
+  j["start_time"] = v.start_time;
+  j["end_time"] = v.end_time;
+  j["objects"] = v.objects;
+}
+
+inline void
+from_json(const nlohmann::json& j, TPSet& v)
+{
+  j.at("seqno").get_to(v.seqno);
+  j.at("run_number").get_to(v.run_number);
+  j.at("origin").get_to(v.origin);
+  j.at("type").get_to(v.type);
+  j.at("start_time").get_to(v.start_time);
+  j.at("end_time").get_to(v.end_time);
+  j.at("objects").get_to(v.objects);
+}
+
+} // namespace dunedaq::trigger
 
 #endif // TRIGGER_INCLUDE_TRIGGER_TPSET_HPP_
+
+// Local Variables:
+// c-basic-offset: 2
+// End:
@@ -0,0 +1,216 @@
+/**
+ * @file TPSoASet.hpp
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#ifndef TRIGGER_INCLUDE_TRIGGER_TPSOASET_HPP_
+#define TRIGGER_INCLUDE_TRIGGER_TPSOASET_HPP_
+
+#include "trigger/TPSet.hpp"
+
+#include "trgdataformats/TriggerPrimitive.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+namespace dunedaq::trigger {
+
+/**
+ * @brief Structure-of-arrays counterpart of TPSet::objects
+ *
+ * TPSet::objects is an array-of-structs, so a kernel that only scans TP
+ * times or channels strides over whole TriggerPrimitive records to touch
+ * a few bytes per TP. TPSoAColumns keeps each field in its own contiguous
+ * array, so such kernels (channel filtering, window slicing, vectorized
+ * clustering) get unit-stride loads over exactly the fields they read.
+ *
+ * The container deliberately mimics the subset of the std::vector
+ * interface used by TimeSliceInputBuffer, so a slice can be assembled
+ * directly into columns without building the AoS form first.
+ */
+class TPSoAColumns
+{
+public:
+  using tp_t = trgdataformats::TriggerPrimitive;
+
+  // One column per TriggerPrimitive field, index-aligned across columns
+  std::vector<decltype(tp_t::time_start)> time_start;
+  std::vector<decltype(tp_t::time_peak)> time_peak;
+  std::vector<decltype(tp_t::time_over_threshold)> time_over_threshold;
+  std::vector<decltype(tp_t::channel)> channel;
+  std::vector<decltype(tp_t::adc_integral)> adc_integral;
+  std::vector<decltype(tp_t::adc_peak)> adc_peak;
+  std::vector<decltype(tp_t::detid)> detid;
+  std::vector<decltype(tp_t::type)> type;
+  std::vector<decltype(tp_t::algorithm)> algorithm;
+  std::vector<decltype(tp_t::version)> version;
+  std::vector<decltype(tp_t::flag)> flag;
+
+  size_t size() const { return time_start.size(); }
+  bool empty() const { return time_start.empty(); }
+
+  void clear()
+  {
+    time_start.clear();
+    time_peak.clear();
+    time_over_threshold.clear();
+    channel.clear();
+    adc_integral.clear();
+    adc_peak.clear();
+    detid.clear();
+    type.clear();
+    algorithm.clear();
+    version.clear();
+    flag.clear();
+  }
+
+  void reserve(size_t n)
+  {
+    time_start.reserve(n);
+    time_peak.reserve(n);
+    time_over_threshold.reserve(n);
+    channel.reserve(n);
+    adc_integral.reserve(n);
+    adc_peak.reserve(n);
+    detid.reserve(n);
+    type.reserve(n);
+    algorithm.reserve(n);
+    version.reserve(n);
+    flag.reserve(n);
+  }
+
+  void push_back(const tp_t& tp)
+  {
+    time_start.push_back(tp.time_start);
+    time_peak.push_back(tp.time_peak);
+    time_over_threshold.push_back(tp.time_over_threshold);
+    channel.push_back(tp.channel);
+    adc_integral.push_back(tp.adc_integral);
+    adc_peak.push_back(tp.adc_peak);
+    detid.push_back(tp.detid);
+    type.push_back(tp.type);
+    algorithm.push_back(tp.algorithm);
+    version.push_back(tp.version);
+    flag.push_back(tp.flag);
+  }
+
+  // Reassemble the AoS record at index i, for consumers that need a whole TP
+  tp_t get(size_t i) const
+  {
+    tp_t tp;
+    tp.time_start = time_start[i];
+    tp.time_peak = time_peak[i];
+    tp.time_over_threshold = time_over_threshold[i];
+    tp.channel = channel[i];
+    tp.adc_integral = adc_integral[i];
+    tp.adc_peak = adc_peak[i];
+    tp.detid = detid[i];
+    tp.type = type[i];
+    tp.algorithm = algorithm[i];
+    tp.version = version[i];
+    tp.flag = flag[i];
+    return tp;
+  }
+
+  // Restore time order after an unsorted append: sort an index permutation
+  // on the time_start column alone, then apply it to every column. Used by
+  // the TimeSliceInputBuffer fallback path for unsorted producers
+  void sort_by_time_start()
+  {
+    std::vector<uint32_t> perm(size()); // NOLINT(build/unsigned)
+    std::iota(perm.begin(), perm.end(), 0);
+    std::stable_sort(perm.begin(), perm.end(),
+                     [this](uint32_t a, uint32_t b) { return time_start[a] < time_start[b]; }); // NOLINT(build/unsigned)
+    apply_permutation(perm, time_start);
+    apply_permutation(perm, time_peak);
+    apply_permutation(perm, time_over_threshold);
+    apply_permutation(perm, channel);
+    apply_permutation(perm, adc_integral);
+    apply_permutation(perm, adc_peak);
+    apply_permutation(perm, detid);
+    apply_permutation(perm, type);
+    apply_permutation(perm, algorithm);
+    apply_permutation(perm, version);
+    apply_permutation(perm, flag);
+  }
+
+private:
+  template<class C>
+  static void apply_permutation(const std::vector<uint32_t>& perm, std::vector<C>& column) // NOLINT(build/unsigned)
+  {
+    std::vector<C> tmp;
+    tmp.reserve(column.size());
+    for (uint32_t i : perm) { // NOLINT(build/unsigned)
+      tmp.push_back(column[i]);
+    }
+    column.swap(tmp);
+  }
+};
+
+/**
+ * @brief A TPSet with its payload transposed into columns
+ *
+ * Carries the same header fields as Set<T>, so conversion at a module
+ * boundary is lossless in both directions.
+ */
+class TPSoASet
+{
+public:
+  TPSet::seqno_t seqno{ 0 };
+  daqdataformats::run_number_t run_number{ 0 };
+  TPSet::origin_t origin{ daqdataformats::SourceID(daqdataformats::SourceID::Subsystem::kTrigger,
+                                                   daqdataformats::SourceID::s_invalid_id) };
+  TPSet::Type type{ TPSet::kUnknown };
+  TPSet::timestamp_t start_time{ 0 };
+  TPSet::timestamp_t end_time{ 0 };
+
+  TPSoAColumns objects;
+};
+
+// Conversion shims for module boundaries: transpose an AoS TPSet into
+// columns and back. Both are a single pass over the payload
+
+inline void
+to_soa(const TPSet& in, TPSoASet& out)
+{
+  out.seqno = in.seqno;
+  out.run_number = in.run_number;
+  out.origin = in.origin;
+  out.type = in.type;
+  out.start_time = in.start_time;
+  out.end_time = in.end_time;
+  out.objects.clear();
+  out.objects.reserve(in.objects.size());
+  for (const auto& tp : in.objects) {
+    out.objects.push_back(tp);
+  }
+}
+
+inline void
+from_soa(const TPSoASet& in, TPSet& out)
+{
+  out.seqno = in.seqno;
+  out.run_number = in.run_number;
+  out.origin = in.origin;
+  out.type = in.type;
+  out.start_time = in.start_time;
+  out.end_time = in.end_time;
+  out.objects.clear();
+  out.objects.reserve(in.objects.size());
+  for (size_t i = 0; i < in.objects.size(); ++i) {
+    out.objects.push_back(in.objects.get(i));
+  }
+}
+
+} // namespace dunedaq::trigger
+
+#endif // TRIGGER_INCLUDE_TRIGGER_TPSOASET_HPP_
+
+// Local Variables:
+// c-basic-offset: 2
+// End:
@@ -14,6 +14,11 @@
 #include "iomanager/Sender.hpp"
 #include "utilities/WorkerThread.hpp"
 
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
 namespace dunedaq {
 namespace trigger {
 template<class T>
@@ -28,6 +33,7 @@ public:
   Tee& operator=(Tee&&) = delete;
 
   void init(const nlohmann::json& iniobj) override;
+  void get_info(opmonlib::InfoCollector& ci, int level) override;
 
 private:
   void do_conf(const nlohmann::json& config);
@@ -41,8 +47,13 @@ private:
   using source_t = dunedaq::iomanager::ReceiverConcept<T>;
   std::shared_ptr<source_t> m_input_queue;
   using sink_t = dunedaq::iomanager::SenderConcept<T>;
-  std::shared_ptr<sink_t> m_output_queue1;
-  std::shared_ptr<sink_t> m_output_queue2;
+  // Outputs named "output1".."outputN" in the init connections; the fan-out
+  // width follows whatever is wired up
+  std::vector<std::shared_ptr<sink_t>> m_output_queues;
+
+  std::atomic<uint64_t> m_received_count{ 0 };            // NOLINT(build/unsigned)
+  std::vector<std::atomic<uint64_t>> m_sent_counts;       // NOLINT(build/unsigned)
+  std::vector<std::atomic<uint64_t>> m_dropped_counts;    // NOLINT(build/unsigned)
 
 };
 } // namespace trigger
@@ -10,10 +10,14 @@
 #include "appfwk/DAQModuleHelper.hpp"
 #include "iomanager/IOManager.hpp"
 #include "rcif/cmd/Nljs.hpp"
+#include "trigger/AdaptiveReceiver.hpp"
 #include "trigger/Issues.hpp"
 #include "trigger/Logging.hpp"
+#include "trigger/teeinfo/InfoNljs.hpp"
 
+#include <optional>
 #include <string>
+#include <utility>
 
 using dunedaq::trigger::logging::TLVL_GENERAL;
 
@@ -25,8 +29,6 @@ Tee<T>::Tee(const std::string& name)
   : DAQModule(name)
   , m_thread(std::bind(&Tee<T>::do_work, this, std::placeholders::_1))
   , m_input_queue(nullptr)
-  , m_output_queue1(nullptr)
-  , m_output_queue2(nullptr)
 {
 
   register_command("conf", &Tee<T>::do_conf);
@@ -41,11 +43,43 @@ Tee<T>::init(const nlohmann::json& iniobj)
 {
   try {
     m_input_queue = get_iom_receiver<T>(appfwk::connection_uid(iniobj, "input"));
-    m_output_queue1 = get_iom_sender<T>(appfwk::connection_uid(iniobj, "output1"));
-    m_output_queue2 = get_iom_sender<T>(appfwk::connection_uid(iniobj, "output2"));
   } catch (const ers::Issue& excpt) {
     throw dunedaq::trigger::InvalidQueueFatalError(ERS_HERE, get_name(), "input/output", excpt);
   }
+
+  // Collect however many "output<i>" connections are wired up, starting at 1
+  m_output_queues.clear();
+  for (size_t i = 1;; ++i) {
+    try {
+      m_output_queues.push_back(get_iom_sender<T>(appfwk::connection_uid(iniobj, "output" + std::to_string(i))));
+    } catch (const ers::Issue&) {
+      break;
+    }
+  }
+  if (m_output_queues.empty()) {
+    throw dunedaq::trigger::InvalidQueueFatalError(ERS_HERE, get_name(), "output1", {});
+  }
+
+  m_sent_counts = std::vector<std::atomic<uint64_t>>(m_output_queues.size());    // NOLINT(build/unsigned)
+  m_dropped_counts = std::vector<std::atomic<uint64_t>>(m_output_queues.size()); // NOLINT(build/unsigned)
+}
+
+template<class T>
+void
+Tee<T>::get_info(opmonlib::InfoCollector& ci, int /*level*/)
+{
+  teeinfo::Info i;
+  i.received_count = m_received_count.load();
+  ci.add(i);
+
+  for (size_t idx = 0; idx < m_output_queues.size(); ++idx) {
+    teeinfo::PerOutputInfo per_output;
+    per_output.sent_count = m_sent_counts[idx].load();
+    per_output.dropped_count = m_dropped_counts[idx].load();
+    opmonlib::InfoCollector output_ci;
+    output_ci.add(per_output);
+    ci.add("output" + std::to_string(idx + 1), output_ci);
+  }
 }
 
 template<class T>
@@ -59,6 +93,13 @@ template<class T>
 void
 Tee<T>::do_start(const nlohmann::json&)
 {
+  m_received_count.store(0);
+  for (auto& count : m_sent_counts) {
+    count.store(0);
+  }
+  for (auto& count : m_dropped_counts) {
+    count.store(0);
+  }
   m_thread.start_working_thread("tee");
   TLOG_DEBUG(TLVL_GENERAL) << "[Tee] " << get_name() + " successfully started.";
 }
@@ -81,13 +122,11 @@ void
 Tee<T>::do_work(std::atomic<bool>& running_flag)
 {
   size_t n_objects = 0;
-  
+
+  AdaptiveReceiver<T> input_policy(m_input_queue, std::chrono::milliseconds(100));
   while (running_flag.load()) {
-    T object;
-    try {
-      object = m_input_queue->receive(std::chrono::milliseconds(100));
-      ++n_objects;
-    } catch (const dunedaq::iomanager::TimeoutExpired& excpt) {
+    std::optional<T> received = input_policy.receive();
+    if (!received.has_value()) {
       // The condition to exit the loop is that we've been stopped and
       // there's nothing left on the input queue
       if (!running_flag.load()) {
@@ -96,19 +135,25 @@ Tee<T>::do_work(std::atomic<bool>& running_flag)
         continue;
       }
     }
+    T object = std::move(*received);
+    ++n_objects;
+    ++m_received_count;
 
     size_t timeout_ms = 20;
-    try {
-      T object1(object);
-      m_output_queue1->send(std::move(object1), std::chrono::milliseconds(timeout_ms));
-    } catch (const dunedaq::iomanager::TimeoutExpired& excpt) {
-      ers::warning(dunedaq::iomanager::TimeoutExpired(ERS_HERE, get_name(), "push to output queue 1", timeout_ms));
-    }
-    try {
-      T object2(object);
-      m_output_queue2->send(std::move(object2), std::chrono::milliseconds(timeout_ms));
-    } catch (const dunedaq::iomanager::TimeoutExpired& excpt) {
-      ers::warning(dunedaq::iomanager::TimeoutExpired(ERS_HERE, get_name(), "push to output queue 2", timeout_ms));
+    // Copy for all outputs but the last, which takes the received object by
+    // move: an N-way fan-out costs N-1 copies instead of N. A branch that
+    // backs up drops its copy and is counted, without holding up the others
+    for (size_t idx = 0; idx < m_output_queues.size(); ++idx) {
+      bool last = (idx + 1 == m_output_queues.size());
+      try {
+        T to_send = last ? std::move(object) : T(object);
+        m_output_queues[idx]->send(std::move(to_send), std::chrono::milliseconds(timeout_ms));
+        ++m_sent_counts[idx];
+      } catch (const dunedaq::iomanager::TimeoutExpired& excpt) {
+        ++m_dropped_counts[idx];
+        ers::warning(dunedaq::iomanager::TimeoutExpired(
+          ERS_HERE, get_name(), "push to output queue " + std::to_string(idx + 1), timeout_ms));
+      }
     }
   }
   TLOG() << get_name() << ": Exiting do_work() method after receiving " << n_objects << " objects";
@@ -116,4 +161,3 @@ Tee<T>::do_work(std::atomic<bool>& running_flag)
 
 } // namespace trigger
 } // namespace dunedaq
-
@@ -0,0 +1,152 @@
+/**
+ * @file BackpressureObservatory.cpp
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2021.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#include "BackpressureObservatory.hpp"
+#include "trigger/Logging.hpp"
+
+#include <algorithm>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using dunedaq::trigger::logging::TLVL_GENERAL;
+
+namespace dunedaq {
+namespace trigger {
+
+BackpressureObservatory::BackpressureObservatory(const std::string& name)
+  : DAQModule(name)
+  , m_thread(std::bind(&BackpressureObservatory::do_work, this))
+{
+  register_command("conf", &BackpressureObservatory::do_conf);
+  register_command("start", &BackpressureObservatory::do_start);
+  register_command("stop", &BackpressureObservatory::do_stop);
+}
+
+void
+BackpressureObservatory::init(const nlohmann::json& /*iniobj*/)
+{
+  // Deliberately connectionless: everything this module reports arrives
+  // through the QueueSpy registry
+}
+
+void
+BackpressureObservatory::get_info(opmonlib::InfoCollector& ci, int /*level*/)
+{
+  QueueSpy& spy = QueueSpy::get_instance();
+  const size_t n = spy.size();
+
+  auto now = std::chrono::steady_clock::now();
+  double elapsed_s =
+    std::chrono::duration_cast<std::chrono::duration<double>>(now - m_prev_poll_time).count();
+
+  backpressureobservatoryinfo::Info i;
+  i.n_queues = n;
+  ci.add(i);
+
+  for (size_t q = 0; q < n; ++q) {
+    const QueueSpy::QueueStats& qs = spy.stats(q);
+    backpressureobservatoryinfo::QueueInfo qi;
+    qi.items = qs.n_items.load(std::memory_order_relaxed);
+    qi.items_per_s = (elapsed_s > 0 && qi.items >= m_prev_items[q])
+                       ? static_cast<uint64_t>((qi.items - m_prev_items[q]) / elapsed_s) // NOLINT(build/unsigned)
+                       : 0;
+    m_prev_items[q] = qi.items;
+    qi.depth_last = qs.last_depth.load(std::memory_order_relaxed);
+    qi.depth_high_water = qs.high_water.load(std::memory_order_relaxed);
+    qi.depth_p50 = qs.depth.quantile(0.5);
+    qi.depth_p99 = qs.depth.quantile(0.99);
+    qi.saturated_samples = qs.n_saturated.load(std::memory_order_relaxed);
+    qi.send_wait_p50_us = qs.send_wait_us.quantile(0.5);
+    qi.send_wait_p99_us = qs.send_wait_us.quantile(0.99);
+    opmonlib::InfoCollector sub;
+    sub.add(qi);
+    ci.add(qs.name, sub);
+  }
+
+  m_prev_poll_time = now;
+}
+
+void
+BackpressureObservatory::do_conf(const nlohmann::json& conf_arg)
+{
+  m_conf = conf_arg.get<dunedaq::trigger::backpressureobservatory::Conf>();
+  TLOG_DEBUG(TLVL_GENERAL) << "[BPO] Configured the BackpressureObservatory!";
+}
+
+void
+BackpressureObservatory::do_start(const nlohmann::json&)
+{
+  m_prev_items.fill(0);
+  m_prev_poll_time = std::chrono::steady_clock::now();
+  m_running_flag.store(true);
+  m_thread.start_working_thread("bp-observer");
+  TLOG_DEBUG(TLVL_GENERAL) << "[BPO] " << get_name() + " successfully started.";
+}
+
+void
+BackpressureObservatory::do_stop(const nlohmann::json&)
+{
+  m_running_flag.store(false);
+  m_thread.stop_working_thread();
+  TLOG_DEBUG(TLVL_GENERAL) << "[BPO] " << get_name() + " successfully stopped.";
+}
+
+std::string
+BackpressureObservatory::consolidated_line() const
+{
+  QueueSpy& spy = QueueSpy::get_instance();
+  const size_t n = spy.size();
+
+  // Rank by p99 depth so a chronically backed-up queue beats a briefly
+  // spiky one; ties (typically all-zero, a healthy chain) keep registration
+  // order
+  std::vector<size_t> order(n);
+  for (size_t q = 0; q < n; ++q) {
+    order[q] = q;
+  }
+  std::stable_sort(order.begin(), order.end(), [&spy](size_t a, size_t b) {
+    return spy.stats(a).depth.quantile(0.99) > spy.stats(b).depth.quantile(0.99);
+  });
+
+  std::ostringstream oss;
+  oss << n << " queues";
+  for (size_t q : order) {
+    const QueueSpy::QueueStats& qs = spy.stats(q);
+    oss << " | " << qs.name << " depth_p99=" << qs.depth.quantile(0.99)
+        << " hw=" << qs.high_water.load(std::memory_order_relaxed)
+        << " sat=" << qs.n_saturated.load(std::memory_order_relaxed)
+        << " send_p99_us=" << qs.send_wait_us.quantile(0.99);
+  }
+  return oss.str();
+}
+
+void
+BackpressureObservatory::do_work()
+{
+  auto last_report = std::chrono::steady_clock::now();
+  while (m_running_flag.load()) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    if (m_conf.report_interval_ms == 0) {
+      continue;
+    }
+    auto now = std::chrono::steady_clock::now();
+    if (now - last_report >= std::chrono::milliseconds(m_conf.report_interval_ms)) {
+      last_report = now;
+      TLOG() << "[BPO] " << consolidated_line();
+    }
+  }
+  TLOG() << "[BPO] final: " << consolidated_line();
+}
+
+} // namespace trigger
+} // namespace dunedaq
+
+DEFINE_DUNE_DAQ_MODULE(dunedaq::trigger::BackpressureObservatory)
@@ -0,0 +1,72 @@
+/**
+ * @file BackpressureObservatory.hpp
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2021.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#ifndef TRIGGER_PLUGINS_BACKPRESSUREOBSERVATORY_HPP_
+#define TRIGGER_PLUGINS_BACKPRESSUREOBSERVATORY_HPP_
+
+#include "trigger/Issues.hpp"
+#include "trigger/QueueSpy.hpp"
+#include "trigger/backpressureobservatory/Nljs.hpp"
+#include "trigger/backpressureobservatoryinfo/InfoNljs.hpp"
+
+#include "appfwk/DAQModule.hpp"
+#include "utilities/WorkerThread.hpp"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <string>
+
+namespace dunedaq {
+namespace trigger {
+
+/**
+ * @brief BackpressureObservatory publishes the consolidated picture of
+ * inter-module queue congestion collected by the QueueSpy registry: the
+ * modules that drain trigger connections report each drained batch as a
+ * depth sample and each send's blocking time, and this module turns
+ * those into per-queue depth/high-water/fill-rate records through opmon
+ * plus a periodic one-line ranking of the most backed-up connections.
+ * One instance per process is enough; it owns no connections itself.
+ */
+class BackpressureObservatory : public dunedaq::appfwk::DAQModule
+{
+public:
+  explicit BackpressureObservatory(const std::string& name);
+
+  BackpressureObservatory(const BackpressureObservatory&) = delete;
+  BackpressureObservatory& operator=(const BackpressureObservatory&) = delete;
+  BackpressureObservatory(BackpressureObservatory&&) = delete;
+  BackpressureObservatory& operator=(BackpressureObservatory&&) = delete;
+
+  void init(const nlohmann::json& iniobj) override;
+  void get_info(opmonlib::InfoCollector& ci, int level) override;
+
+private:
+  void do_conf(const nlohmann::json& config);
+  void do_start(const nlohmann::json& obj);
+  void do_stop(const nlohmann::json& obj);
+  void do_work();
+
+  std::string consolidated_line() const;
+
+  dunedaq::utilities::WorkerThread m_thread;
+
+  dunedaq::trigger::backpressureobservatory::Conf m_conf;
+
+  // Previous poll's cumulative item counts and timestamp, for the per-queue
+  // fill-rate derivative. Only touched from the opmon thread in get_info()
+  std::array<uint64_t, QueueSpy::s_max_queues> m_prev_items{}; // NOLINT(build/unsigned)
+  std::chrono::steady_clock::time_point m_prev_poll_time;
+
+  std::atomic<bool> m_running_flag{ false };
+};
+} // namespace trigger
+} // namespace dunedaq
+
+#endif // TRIGGER_PLUGINS_BACKPRESSUREOBSERVATORY_HPP_
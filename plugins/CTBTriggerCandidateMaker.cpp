@@ -40,44 +40,6 @@ CTBTriggerCandidateMaker::CTBTriggerCandidateMaker(const std::string& name)
   register_command("scrap", &CTBTriggerCandidateMaker::do_scrap);
 }
 
-std::vector<triggeralgs::TriggerCandidate>
-CTBTriggerCandidateMaker::HSIEventToTriggerCandidate(const dfmessages::HSIEvent& data)
-{
-  TLOG_DEBUG(TLVL_DEBUG_MEDIUM) << "[CTB] Converting HSI event, signal: " << data.signal_map;
-
-  std::vector<triggeralgs::TriggerCandidate> candidates;
-  std::bitset<32> bits(data.signal_map);
-  TLOG_DEBUG(TLVL_DEBUG_HIGH) << "[CTB] BITS: " << bits;
-
-  for (size_t i = 0; i < bits.size(); ++i) {
-    if (bits.test(i)) {
-
-      TLOG_DEBUG(TLVL_DEBUG_ALL) << "[CTB] this bit: " << i;
-
-      if (m_HLT_TC_map.count(i)) {
-        TLOG_DEBUG(TLVL_DEBUG_ALL) << "[CTB] TC type: " << static_cast<int>(m_HLT_TC_map[i]);
-
-        triggeralgs::TriggerCandidate candidate;
-        candidate.time_candidate = data.timestamp;
-        candidate.time_start = data.timestamp - m_time_before;
-        candidate.time_end = data.timestamp + m_time_after;
-        // candidate.detid = 1;
-        candidate.detid = data.header;
-        candidate.type = m_HLT_TC_map[i];
-        candidate.algorithm = triggeralgs::TriggerCandidate::Algorithm::kHSIEventToTriggerCandidate;
-        candidate.inputs = {};
-
-        candidates.push_back(candidate);
-      } else {
-        ers::error(
-          dunedaq::trigger::InvalidCTBSignal(ERS_HERE, get_name(), data.signal_map, bits, m_HLT_TC_map.size()));
-      }
-    }
-  }
-
-  return candidates;
-}
-
 void
 CTBTriggerCandidateMaker::do_conf(const nlohmann::json& config)
 {
@@ -153,21 +115,42 @@ CTBTriggerCandidateMaker::receive_hsievent(dfmessages::HSIEvent& data)
     }
   }
 
-  std::vector<triggeralgs::TriggerCandidate> candidates;
-  try {
-    candidates = HSIEventToTriggerCandidate(data);
-  } catch (SignalTypeError& e) {
-    m_tc_sig_type_err_count++;
-    ers::error(e);
-    return;
-  }
+  TLOG_DEBUG(TLVL_DEBUG_MEDIUM) << "[CTB] Converting HSI event, signal: " << data.signal_map;
+
+  std::bitset<s_n_hlt_bits> bits(data.signal_map);
+  TLOG_DEBUG(TLVL_DEBUG_HIGH) << "[CTB] BITS: " << bits;
+
+  // Decode and emit in one pass: per triggered bit, a table index picks the
+  // TC type and the candidate goes straight to the output queue, with no
+  // conditional chain or intermediate vector
+  for (size_t i = 0; i < bits.size(); ++i) {
+    if (!bits.test(i)) {
+      continue;
+    }
+
+    TLOG_DEBUG(TLVL_DEBUG_ALL) << "[CTB] this bit: " << i;
+
+    trgdataformats::TriggerCandidateData::Type type = s_hlt_tc_table[i];
+    if (type == trgdataformats::TriggerCandidateData::Type::kUnknown) {
+      m_tc_sig_type_err_count++;
+      ers::error(dunedaq::trigger::InvalidCTBSignal(ERS_HERE, get_name(), data.signal_map, bits, s_n_hlt_bits));
+      continue;
+    }
+    TLOG_DEBUG(TLVL_DEBUG_ALL) << "[CTB] TC type: " << static_cast<int>(type);
 
-  for (const auto& candidate : candidates) {
     bool successfullyWasSent = false;
     while (!successfullyWasSent) {
       try {
-        triggeralgs::TriggerCandidate candidate_copy(candidate);
-        m_output_queue->send(std::move(candidate_copy), m_queue_timeout);
+        triggeralgs::TriggerCandidate candidate;
+        candidate.time_candidate = data.timestamp;
+        candidate.time_start = data.timestamp - m_time_before;
+        candidate.time_end = data.timestamp + m_time_after;
+        // candidate.detid = 1;
+        candidate.detid = data.header;
+        candidate.type = type;
+        candidate.algorithm = triggeralgs::TriggerCandidate::Algorithm::kHSIEventToTriggerCandidate;
+        candidate.inputs = {};
+        m_output_queue->send(std::move(candidate), m_queue_timeout);
         successfullyWasSent = true;
         ++m_tc_sent_count;
       } catch (const dunedaq::iomanager::TimeoutExpired& excpt) {
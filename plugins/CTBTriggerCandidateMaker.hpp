@@ -22,14 +22,45 @@
 #include "triggeralgs/TriggerCandidate.hpp"
 #include "utilities/WorkerThread.hpp"
 
+#include <array>
 #include <chrono>
-#include <map>
 #include <memory>
 #include <string>
 #include <utility>
 
 namespace dunedaq {
 namespace trigger {
+
+// HLT bit to TC type lookup table, one slot per signal bit; unmapped
+// slots hold kUnknown. Decoding a word is an array index per bit, with
+// no map probes in the burst path. Namespace scope (not class scope)
+// because a constexpr member initializer may not call a member function
+// of the still-incomplete class
+inline constexpr size_t s_n_hlt_bits = 32;
+
+constexpr std::array<trgdataformats::TriggerCandidateData::Type, s_n_hlt_bits>
+make_hlt_tc_table()
+{
+  std::array<trgdataformats::TriggerCandidateData::Type, s_n_hlt_bits> table{};
+  for (auto& entry : table) {
+    entry = trgdataformats::TriggerCandidateData::Type::kUnknown;
+  }
+  table[0] = trgdataformats::TriggerCandidateData::Type::kCTBFakeTrigger;
+  table[1] = trgdataformats::TriggerCandidateData::Type::kCTBBeam;
+  table[2] = trgdataformats::TriggerCandidateData::Type::kCTBBeamHiLoPressChkv;
+  table[3] = trgdataformats::TriggerCandidateData::Type::kCTBBeamLoPressChkv;
+  table[4] = trgdataformats::TriggerCandidateData::Type::kCTBBeamHiPressChkv;
+  table[5] = trgdataformats::TriggerCandidateData::Type::kCTBOffSpillCosmic;
+  table[6] = trgdataformats::TriggerCandidateData::Type::kCTBCosmic;
+  table[7] = trgdataformats::TriggerCandidateData::Type::kCTBBeamNoChkv;
+  table[8] = trgdataformats::TriggerCandidateData::Type::kCTBCosmicJura;
+  table[9] = trgdataformats::TriggerCandidateData::Type::kCTBCosmicSaleve;
+  return table;
+}
+
+inline constexpr std::array<trgdataformats::TriggerCandidateData::Type, s_n_hlt_bits> s_hlt_tc_table =
+  make_hlt_tc_table();
+
 class CTBTriggerCandidateMaker : public dunedaq::appfwk::DAQModule
 {
 public:
@@ -59,7 +90,6 @@ private:
   int m_time_before;
   int m_time_after;
 
-  std::vector<triggeralgs::TriggerCandidate> HSIEventToTriggerCandidate(const dfmessages::HSIEvent& data);
   void receive_hsievent(dfmessages::HSIEvent& data);
 
   using sink_t = dunedaq::iomanager::SenderConcept<triggeralgs::TriggerCandidate>;
@@ -68,20 +98,6 @@ private:
 
   std::chrono::milliseconds m_queue_timeout;
 
-  // HLT to TC type map
-  std::map<int, trgdataformats::TriggerCandidateData::Type> m_HLT_TC_map = {
-    { 0, trgdataformats::TriggerCandidateData::Type::kCTBFakeTrigger },
-    { 1, trgdataformats::TriggerCandidateData::Type::kCTBBeam },
-    { 2, trgdataformats::TriggerCandidateData::Type::kCTBBeamHiLoPressChkv },
-    { 3, trgdataformats::TriggerCandidateData::Type::kCTBBeamLoPressChkv },
-    { 4, trgdataformats::TriggerCandidateData::Type::kCTBBeamHiPressChkv },
-    { 5, trgdataformats::TriggerCandidateData::Type::kCTBOffSpillCosmic },
-    { 6, trgdataformats::TriggerCandidateData::Type::kCTBCosmic },
-    { 7, trgdataformats::TriggerCandidateData::Type::kCTBBeamNoChkv },
-    { 8, trgdataformats::TriggerCandidateData::Type::kCTBCosmicJura },
-    { 9, trgdataformats::TriggerCandidateData::Type::kCTBCosmicSaleve },
-  };
-
   // Opmon variables
   using metric_counter_type = decltype(ctbtriggercandidatemakerinfo::Info::tsd_received_count);
   std::atomic<metric_counter_type> m_tsd_received_count{ 0 };
@@ -34,19 +34,10 @@
 #include <string>
 #include <vector>
 
-// This is used to sort vector of pairs based on the value (ie second element) of the pair
-bool
-sortbysec(const std::pair<int, dunedaq::dfmessages::timestamp_t>& a,
-          const std::pair<int, dunedaq::dfmessages::timestamp_t>& b)
-{
-  return (a.second < b.second);
-}
-
 using dunedaq::trigger::logging::TLVL_GENERAL;
 using dunedaq::trigger::logging::TLVL_DEBUG_LOW;
 using dunedaq::trigger::logging::TLVL_DEBUG_MEDIUM;
 using dunedaq::trigger::logging::TLVL_DEBUG_HIGH;
-using dunedaq::trigger::logging::TLVL_DEBUG_ALL;
 
 namespace dunedaq {
 namespace trigger {
@@ -92,10 +83,6 @@ CustomTriggerCandidateMaker::do_configure(const nlohmann::json& obj)
   }
 
   print_config();
-
-  // This parameter controls how many new timestamps are calculated when needed
-  // Currently precalculates events for the next 60 seconds
-  m_sorting_size_limit = 60 * m_conf.clock_frequency_hz;
 }
 
 void
@@ -134,7 +121,7 @@ CustomTriggerCandidateMaker::do_stop(const nlohmann::json& /*obj*/)
   m_timestamp_estimator.reset(nullptr); // Calls TimestampEstimator dtor
 
   // Prints final counts of each used TC type
-  print_final_tc_counts(m_tc_sent_count_type);
+  print_final_tc_counts();
 }
 
 void
@@ -143,21 +130,29 @@ CustomTriggerCandidateMaker::do_scrap(const nlohmann::json& /*obj*/)
   m_configured_flag.store(false);
 }
 
-// This creates TCs of given type at the provided timestamp
-// The algo used is kCustom
-// Other parameters are default
-triggeralgs::TriggerCandidate
-CustomTriggerCandidateMaker::create_candidate(dfmessages::timestamp_t timestamp, int tc_type)
-{
-  triggeralgs::TriggerCandidate candidate;
-  candidate.time_start = (timestamp - 1000);
-  candidate.time_end = (timestamp + 1000);
-  candidate.time_candidate = timestamp;
-  candidate.detid = { 0 };
-  candidate.type = static_cast<dunedaq::trgdataformats::TriggerCandidateData::Type>(tc_type);
-  candidate.algorithm = triggeralgs::TriggerCandidate::Algorithm::kCustom;
-
-  return candidate;
+// This sets up one schedule slot per configured TC type: the first due
+// timestamp (with a small per-type offset so we don't start with all at
+// once, rounded up to the next multiple of the interval ticks) and a
+// preconstructed TC with everything but the timestamps filled in.
+// The algo used is kCustom, other parameters are default
+void
+CustomTriggerCandidateMaker::init_schedules(dfmessages::timestamp_t initial_timestamp)
+{
+  TLOG_DEBUG(TLVL_DEBUG_LOW) << "[CTCM] init schedules, init ts: " << initial_timestamp;
+  m_schedules.clear();
+  for (int i = 0; i < static_cast<int>(m_tc_settings.size()); i++) {
+    TypeSchedule schedule;
+    schedule.tc_type = m_tc_settings[i].first;
+    schedule.interval = m_tc_settings[i].second;
+    schedule.next_timestamp =
+      ((initial_timestamp + i * 5000) / schedule.interval + 1) * schedule.interval;
+    schedule.tc_template.detid = { 0 };
+    schedule.tc_template.type = static_cast<dunedaq::trgdataformats::TriggerCandidateData::Type>(schedule.tc_type);
+    schedule.tc_template.algorithm = triggeralgs::TriggerCandidate::Algorithm::kCustom;
+    m_schedules.push_back(schedule);
+    TLOG_DEBUG(TLVL_DEBUG_MEDIUM) << "[CTCM] schedule slot, type: " << schedule.tc_type
+                  << ", inter: " << schedule.interval << ", ts: " << schedule.next_timestamp;
+  }
 }
 
 void
@@ -175,115 +170,55 @@ CustomTriggerCandidateMaker::send_trigger_candidates()
 
   m_initial_timestamp = m_timestamp_estimator->get_timestamp_estimate();
 
-  m_tc_timestamps = get_initial_timestamps(m_initial_timestamp);
-  //print_timestamps_vector(m_tc_timestamps);
-
-  m_next_trigger_timestamp = m_tc_timestamps.front().second;
-  m_next_trigger_type = m_tc_timestamps.front().first;
+  init_schedules(m_initial_timestamp);
+  if (m_schedules.empty()) {
+    ers::error(TCTimestampsSizeError(ERS_HERE, get_name(), m_schedules.size()));
+    return;
+  }
 
-  TLOG_DEBUG(TLVL_DEBUG_LOW) << "[CTCM] " << get_name() << " initial timestamp estimate is " << m_initial_timestamp
-                << ", next_trigger_timestamp is " << m_next_trigger_timestamp;
+  TLOG_DEBUG(TLVL_DEBUG_LOW) << "[CTCM] " << get_name() << " initial timestamp estimate is " << m_initial_timestamp;
 
+  // The old implementation merged per-type timestamp vectors, sorted them
+  // and erased from the front for every emitted TC. With one slot per type
+  // the earliest deadline is a scan over a handful of entries, each wakeup
+  // batch-emits everything that has come due, and advancing a slot is one
+  // division: no allocation or sorting in steady state, and since the
+  // schedule is in absolute timestamps, wakeup jitter does not accumulate
   while (m_running_flag.load()) {
+    dfmessages::timestamp_t next_trigger_timestamp = m_schedules.front().next_timestamp;
+    for (auto const& schedule : m_schedules) {
+      if (schedule.next_timestamp < next_trigger_timestamp) {
+        next_trigger_timestamp = schedule.next_timestamp;
+      }
+    }
+
     TLOG_DEBUG(TLVL_DEBUG_HIGH) << "[CTCM] waiting for next timestamp ...";
-    if ((m_timestamp_estimator->wait_for_timestamp(m_next_trigger_timestamp, m_running_flag)) ==
+    if ((m_timestamp_estimator->wait_for_timestamp(next_trigger_timestamp, m_running_flag)) ==
         utilities::TimestampEstimatorBase::kInterrupted) {
       break;
     }
 
-    triggeralgs::TriggerCandidate candidate = create_candidate(m_next_trigger_timestamp, m_tc_timestamps.front().first);
-
-    TLOG_DEBUG(TLVL_DEBUG_HIGH) << "[CTCM] " << get_name() << " at timestamp " << m_timestamp_estimator->get_timestamp_estimate()
-                  << ", pushing a candidate with timestamp " << candidate.time_candidate;
-    m_trigger_candidate_sink->send(std::move(candidate), std::chrono::milliseconds(10));
-    m_tc_sent_count++;
-    m_tc_sent_count_type[m_tc_timestamps.front().first] += 1;
-
-    // Need to record last used TS for calculation of next ones
-    m_last_timestamps_of_type[m_tc_timestamps.front().first] = m_tc_timestamps.front().second;
-
-    // Progress the vector of next TCs
-    m_tc_timestamps.erase(m_tc_timestamps.begin());
-
-    // Generate new timestamps for each source
-    if (m_tc_timestamps.size() < 1) {
-      TLOG_DEBUG(TLVL_DEBUG_ALL) << "[CTCM] Need next timestamps!";
-      m_tc_timestamps.clear();
-      m_tc_timestamps = get_next_timestamps(m_last_timestamps_of_type);
-    }
-
-    // Set new TS and type
-    m_next_trigger_timestamp = m_tc_timestamps.front().second;
-    m_next_trigger_type = m_tc_timestamps.front().first;
-
-    // Should not happen
-    if (m_tc_timestamps.size() == 0) {
-      ers::error(TCTimestampsSizeError(ERS_HERE, get_name(), m_tc_timestamps.size()));
+    // Emit every candidate that has come due by this wakeup
+    dfmessages::timestamp_t timestamp_estimate = m_timestamp_estimator->get_timestamp_estimate();
+    for (auto& schedule : m_schedules) {
+      while (schedule.next_timestamp <= timestamp_estimate) {
+        triggeralgs::TriggerCandidate candidate(schedule.tc_template);
+        candidate.time_start = (schedule.next_timestamp - 1000);
+        candidate.time_end = (schedule.next_timestamp + 1000);
+        candidate.time_candidate = schedule.next_timestamp;
+
+        TLOG_DEBUG(TLVL_DEBUG_HIGH) << "[CTCM] " << get_name() << " at timestamp " << timestamp_estimate
+                      << ", pushing a candidate with timestamp " << candidate.time_candidate;
+        m_trigger_candidate_sink->send(std::move(candidate), std::chrono::milliseconds(10));
+        m_tc_sent_count++;
+        schedule.sent_count += 1;
+
+        schedule.next_timestamp = (schedule.next_timestamp / schedule.interval + 1) * schedule.interval;
+      }
     }
   }
 }
 
-// This function generates initial TS for each TC type
-// Small offset is applied so we don't start with all at once
-// Also rounds up to the next multiple of the interval ticks
-// The returning vector is sorted by TS
-std::vector<std::pair<int, dfmessages::timestamp_t>>
-CustomTriggerCandidateMaker::get_initial_timestamps(dfmessages::timestamp_t initial_timestamp)
-{
-  TLOG_DEBUG(TLVL_DEBUG_LOW) << "[CTCM] GIT, init ts: " << initial_timestamp;
-  std::vector<std::pair<int, dfmessages::timestamp_t>> initial_timestamps;
-  for (int i = 0; i < static_cast<int>(m_conf.trigger_types.size()); i++) {
-    dfmessages::timestamp_t next_trigger_timestamp =
-      ((initial_timestamp + i * 5000) / m_tc_settings[i].second + 1) * m_tc_settings[i].second;
-    std::pair<int, dfmessages::timestamp_t> initial_pair{ m_tc_settings[i].first, next_trigger_timestamp };
-    initial_timestamps.push_back(initial_pair);
-    m_last_timestamps_of_type[i] = next_trigger_timestamp;
-    TLOG_DEBUG(TLVL_DEBUG_MEDIUM) << "[CTCM] GIT TS pair, type: " << m_tc_settings[i].first << ", inter: " << m_tc_settings[i].second
-                  << ", ts: " << next_trigger_timestamp;
-  }
-  std::sort(initial_timestamps.begin(), initial_timestamps.end(), sortbysec);
-  return initial_timestamps;
-}
-
-// This function generates next {m_sorting_size_limit} timestamps for each TC type
-// Then merges to final vector and sorts it by value
-std::vector<std::pair<int, dfmessages::timestamp_t>>
-CustomTriggerCandidateMaker::get_next_timestamps(std::map<int, dfmessages::timestamp_t> last_timestamps)
-{
-  std::vector<std::pair<int, dfmessages::timestamp_t>> next_timestamps;
-  for (auto it = m_tc_settings.begin(); it != m_tc_settings.end(); it++) {
-    std::vector<std::pair<int, dfmessages::timestamp_t>> next_ts_of_type =
-      get_next_ts_of_type(it->first, it->second, last_timestamps[it->first]);
-    next_timestamps.insert(next_timestamps.end(), next_ts_of_type.begin(), next_ts_of_type.end());
-  }
-  sort(
-    next_timestamps.begin(), next_timestamps.end(), sortbysec);
-  //TLOG_DEBUG(TLVL_DEBUG_HIGH) << "[CTCM] New next ts (all):";
-  //print_timestamps_vector(next_timestamps);
-  return next_timestamps;
-}
-
-// This function calculates next {m_sorting_size_limit} TS for a given TC type
-// Uses the configurable interval and the last TS of this type as base
-std::vector<std::pair<int, dfmessages::timestamp_t>>
-CustomTriggerCandidateMaker::get_next_ts_of_type(int tc_type,
-                                                 long int tc_interval,
-                                                 dfmessages::timestamp_t last_ts_of_type)
-{
-  std::vector<std::pair<int, dfmessages::timestamp_t>> next_ts_of_type;
-  dfmessages::timestamp_t ts_limit = last_ts_of_type + m_sorting_size_limit;
-  dfmessages::timestamp_t loop_ts = last_ts_of_type;
-  while (loop_ts < ts_limit) {
-    dfmessages::timestamp_t next_trigger_timestamp = ((loop_ts) / tc_interval + 1) * tc_interval;
-    std::pair<int, dfmessages::timestamp_t> next_pair{ tc_type, next_trigger_timestamp };
-    next_ts_of_type.push_back(next_pair);
-    loop_ts = next_trigger_timestamp;
-  }
-  //TLOG_DEBUG(TLVL_DEBUG_HIGH) << "[CTCM] Next calculated ts for type: " << tc_type << ":";
-  //TLOG_DEBUG(TLVL_DEBUG_HIGH) << print_timestamps_vector(next_ts_of_type);
-  return next_ts_of_type;
-}
-
 void
 CustomTriggerCandidateMaker::print_config()
 {
@@ -295,21 +230,11 @@ CustomTriggerCandidateMaker::print_config()
 }
 
 void
-CustomTriggerCandidateMaker::print_timestamps_vector(std::vector<std::pair<int, dfmessages::timestamp_t>> timestamps)
-{
-  TLOG_DEBUG(TLVL_DEBUG_HIGH) << "[CTCM] Next timestamps:";
-  for (auto it = timestamps.begin(); it != timestamps.end(); it++) {
-    TLOG_DEBUG(TLVL_DEBUG_HIGH) << "[CTCM] TC type: " << it->first << ", timestamp: " << it->second;
-  }
-  return;
-}
-
-void
-CustomTriggerCandidateMaker::print_final_tc_counts(std::map<int, int> counts)
+CustomTriggerCandidateMaker::print_final_tc_counts()
 {
   TLOG() << "[CTCM] Final counts:";
-  for (auto it = m_tc_settings.begin(); it != m_tc_settings.end(); it++) {
-    TLOG() << "[CTCM] TC type: " << it->first << ", interval: " << it->second << ", count: " << counts[it->first];
+  for (auto it = m_schedules.begin(); it != m_schedules.end(); it++) {
+    TLOG() << "[CTCM] TC type: " << it->tc_type << ", interval: " << it->interval << ", count: " << it->sent_count;
   }
   return;
 }
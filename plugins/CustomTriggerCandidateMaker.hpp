@@ -70,9 +70,6 @@ private:
 
   std::unique_ptr<utilities::TimestampEstimatorBase> m_timestamp_estimator;
 
-  // Create the next trigger decision
-  triggeralgs::TriggerCandidate create_candidate(dfmessages::timestamp_t timestamp, int tc_type);
-
   // Queue sources and sinks
   std::shared_ptr<iomanager::ReceiverConcept<dfmessages::TimeSync>> m_time_sync_source;
   std::shared_ptr<iomanager::SenderConcept<triggeralgs::TriggerCandidate>> m_trigger_candidate_sink;
@@ -82,23 +79,22 @@ private:
   std::vector<std::pair<int, long int>> m_tc_settings;
   void print_config();
 
-  // Logic for timestamps
-  uint64_t m_sorting_size_limit;
-  std::vector<std::pair<int, dfmessages::timestamp_t>> m_tc_timestamps;
+  // Logic for timestamps. Each configured TC type gets one schedule slot
+  // holding its fixed interval, the next due timestamp, and a
+  // preconstructed TC to copy and stamp when the slot fires, so
+  // steady-state generation is allocation-free
+  struct TypeSchedule
+  {
+    int tc_type;
+    long int interval;            // NOLINT(runtime/int)
+    dfmessages::timestamp_t next_timestamp;
+    triggeralgs::TriggerCandidate tc_template;
+    int sent_count{ 0 };
+  };
+  std::vector<TypeSchedule> m_schedules;
   dfmessages::timestamp_t m_initial_timestamp;
-  dfmessages::timestamp_t m_next_trigger_timestamp;
-  int m_next_trigger_type;
-  std::map<int, dfmessages::timestamp_t> m_last_timestamps_of_type;
-  std::vector<std::pair<int, dfmessages::timestamp_t>> get_initial_timestamps(
-    dfmessages::timestamp_t initial_timestamp);
-  std::vector<std::pair<int, dfmessages::timestamp_t>> get_next_timestamps(
-    std::map<int, dfmessages::timestamp_t> last_timestamps);
-  std::vector<std::pair<int, dfmessages::timestamp_t>> get_next_ts_of_type(int tc_type,
-                                                                           long int tc_interval,
-                                                                           dfmessages::timestamp_t last_ts_of_type);
-  void print_timestamps_vector(std::vector<std::pair<int, dfmessages::timestamp_t>> timestamps);
-  std::map<int, int> m_tc_sent_count_type;
-  void print_final_tc_counts(std::map<int, int> counts);
+  void init_schedules(dfmessages::timestamp_t initial_timestamp);
+  void print_final_tc_counts();
 
   // Are we in the RUNNING state?
   std::atomic<bool> m_running_flag{ false };
@@ -53,6 +53,7 @@ FakeTPCreatorHeartbeatMaker::get_info(opmonlib::InfoCollector& ci, int /*level*/
   i.tpset_received_count = m_tpset_received_count.load();
   i.tpset_sent_count = m_tpset_sent_count.load();
   i.heartbeats_sent = m_heartbeats_sent.load();
+  i.heartbeats_suppressed = m_heartbeats_suppressed.load();
 
   ci.add(i);
 }
@@ -60,7 +61,9 @@ FakeTPCreatorHeartbeatMaker::get_info(opmonlib::InfoCollector& ci, int /*level*/
 void
 FakeTPCreatorHeartbeatMaker::do_conf(const nlohmann::json& conf)
 {
-  m_heartbeat_interval = conf.get<dunedaq::trigger::faketpcreatorheartbeatmaker::Conf>().heartbeat_interval;
+  auto params = conf.get<dunedaq::trigger::faketpcreatorheartbeatmaker::Conf>();
+  m_heartbeat_interval = params.heartbeat_interval;
+  m_busy_decimation = params.busy_decimation;
   TLOG_DEBUG(TLVL_GENERAL) << "[FHM] " << get_name() + " configured.";
 }
 
@@ -92,6 +95,9 @@ FakeTPCreatorHeartbeatMaker::do_work(std::atomic<bool>& running_flag)
   m_tpset_received_count.store(0);
   m_tpset_sent_count.store(0);
   m_heartbeats_sent.store(0);
+  m_heartbeats_suppressed.store(0);
+  m_due_slots = 0;
+  m_last_payload_time = 0;
 
   bool is_first_tpset_received = true;
 
@@ -120,8 +126,15 @@ FakeTPCreatorHeartbeatMaker::do_work(std::atomic<bool>& running_flag)
 
     daqdataformats::timestamp_t current_tpset_start_time = tpset->start_time;
 
-    bool send_heartbeat =
+    bool heartbeat_due =
       should_send_heartbeat(last_sent_heartbeat_time, current_tpset_start_time, is_first_tpset_received);
+    bool send_heartbeat = heartbeat_due && !suppress_heartbeat(current_tpset_start_time, is_first_tpset_received);
+    if (heartbeat_due && !send_heartbeat) {
+      // The payload set about to go out advances the downstream watermark
+      // on its own, so consume this heartbeat slot without sending one
+      last_sent_heartbeat_time = current_tpset_start_time;
+      m_heartbeats_suppressed++;
+    }
 
     bool successfully_sent_real_tpset = false;
     bool successfully_sent_heartbeat = false;
@@ -149,6 +162,7 @@ FakeTPCreatorHeartbeatMaker::do_work(std::atomic<bool>& running_flag)
     
     tpset->seqno = sequence_number;
     ++sequence_number;
+    m_last_payload_time = current_tpset_start_time;
 
     while (!successfully_sent_real_tpset) {
       try {
@@ -164,7 +178,8 @@ FakeTPCreatorHeartbeatMaker::do_work(std::atomic<bool>& running_flag)
   }
 
   TLOG() << "[FHM] Received " << m_tpset_received_count << " and sent " << m_tpset_sent_count << " real TPSets. Sent "
-         << m_heartbeats_sent << " fake heartbeats." << std::endl;
+         << m_heartbeats_sent << " fake heartbeats, suppressed " << m_heartbeats_suppressed
+         << " by busy-stream decimation." << std::endl;
   TLOG_DEBUG(TLVL_GENERAL) << "[FHM] Exiting do_work() method";
 }
 
@@ -183,6 +198,29 @@ FakeTPCreatorHeartbeatMaker::should_send_heartbeat(daqdataformats::timestamp_t c
     return last_sent_heartbeat_time + m_heartbeat_interval < current_tpset_start_time;
 }
 
+bool
+FakeTPCreatorHeartbeatMaker::suppress_heartbeat(daqdataformats::timestamp_t const& current_tpset_start_time,
+                                                bool const& is_first_tpset_received)
+{
+  // Called only when a heartbeat is due at the base cadence. The very first
+  // heartbeat is never thinned: it seeds the downstream watermark
+  if (m_busy_decimation <= 1 || is_first_tpset_received) {
+    return false;
+  }
+  // A payload gap longer than the heartbeat interval means the stream went
+  // quiet, so heartbeats are the only watermark progress: full cadence
+  if (m_last_payload_time + m_heartbeat_interval < current_tpset_start_time) {
+    m_due_slots = 0;
+    return false;
+  }
+  // Busy stream: emit every m_busy_decimation-th due heartbeat
+  if (++m_due_slots >= m_busy_decimation) {
+    m_due_slots = 0;
+    return false;
+  }
+  return true;
+}
+
 void
 FakeTPCreatorHeartbeatMaker::get_heartbeat(TPSet& tpset_heartbeat,
                                            daqdataformats::timestamp_t const& current_tpset_start_time)
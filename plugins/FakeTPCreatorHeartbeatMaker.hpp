@@ -50,6 +50,8 @@ private:
   bool should_send_heartbeat(daqdataformats::timestamp_t const& last_sent_heartbeat_time,
                              daqdataformats::timestamp_t const& current_tpset_start_time,
                              bool const& is_first_tpset_received);
+  bool suppress_heartbeat(daqdataformats::timestamp_t const& current_tpset_start_time,
+                          bool const& is_first_tpset_received);
   void get_heartbeat(TPSet& tpset_heartbeat, daqdataformats::timestamp_t const& current_tpset_start_time);
 
   dunedaq::utilities::WorkerThread m_thread;
@@ -63,6 +65,16 @@ private:
 
   triggeralgs::timestamp_t m_heartbeat_interval;
 
+  // Busy-stream heartbeat decimation (busy_decimation config field): while
+  // payload TPSets are flowing they advance the downstream watermarks
+  // themselves, so only every m_busy_decimation-th due heartbeat is
+  // actually emitted. A payload gap longer than the heartbeat interval
+  // means the stream went quiet and full cadence resumes. Both state
+  // variables are only touched by the worker thread
+  uint64_t m_busy_decimation{ 1 }; // NOLINT(build/unsigned)
+  uint64_t m_due_slots{ 0 };       // NOLINT(build/unsigned)
+  daqdataformats::timestamp_t m_last_payload_time{ 0 };
+
   daqdataformats::run_number_t m_run_number{ daqdataformats::TypeDefaults::s_invalid_run_number };
 
   daqdataformats::SourceID m_sourceid{
@@ -73,6 +85,7 @@ private:
   std::atomic<metric_counter_type> m_tpset_received_count{ 0 };
   std::atomic<metric_counter_type> m_tpset_sent_count{ 0 };
   std::atomic<metric_counter_type> m_heartbeats_sent{ 0 };
+  std::atomic<metric_counter_type> m_heartbeats_suppressed{ 0 };
 };
 } // namespace trigger
 } // namespace dunedaq
@@ -0,0 +1,228 @@
+/**
+ * @file HeartbeatService.cpp
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2021.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#include "HeartbeatService.hpp"
+#include "trigger/Logging.hpp"
+
+#include "appfwk/DAQModuleHelper.hpp"
+#include "iomanager/IOManager.hpp"
+#include "rcif/cmd/Nljs.hpp"
+
+#include <string>
+#include <thread>
+
+using dunedaq::trigger::logging::TLVL_GENERAL;
+using dunedaq::trigger::logging::TLVL_DEBUG_HIGH;
+
+namespace dunedaq {
+namespace trigger {
+HeartbeatService::HeartbeatService(const std::string& name)
+  : DAQModule(name)
+  , m_thread(std::bind(&HeartbeatService::do_work, this, std::placeholders::_1))
+  , m_queue_timeout(100)
+{
+
+  register_command("conf", &HeartbeatService::do_conf);
+  register_command("start", &HeartbeatService::do_start);
+  register_command("stop", &HeartbeatService::do_stop);
+  register_command("scrap", &HeartbeatService::do_scrap);
+}
+
+void
+HeartbeatService::init(const nlohmann::json& iniobj)
+{
+  // Collect however many tpset_source<i>/tpset_sink<i> pairs are wired up,
+  // starting at 1
+  m_streams.clear();
+  for (size_t i = 1;; ++i) {
+    std::string suffix = std::to_string(i);
+    Stream stream;
+    try {
+      stream.input_queue = get_iom_receiver<trigger::TPSet>(appfwk::connection_uid(iniobj, "tpset_source" + suffix));
+    } catch (const ers::Issue&) {
+      break;
+    }
+    try {
+      stream.output_queue = get_iom_sender<trigger::TPSet>(appfwk::connection_uid(iniobj, "tpset_sink" + suffix));
+    } catch (const ers::Issue& excpt) {
+      throw dunedaq::trigger::InvalidQueueFatalError(ERS_HERE, get_name(), "tpset_sink" + suffix, excpt);
+    }
+    m_streams.push_back(std::move(stream));
+  }
+  if (m_streams.empty()) {
+    throw dunedaq::trigger::InvalidQueueFatalError(ERS_HERE, get_name(), "tpset_source1", {});
+  }
+}
+
+void
+HeartbeatService::get_info(opmonlib::InfoCollector& ci, int /*level*/)
+{
+  heartbeatserviceinfo::Info i;
+
+  i.n_streams = m_streams.size();
+  i.tpset_received_count = m_tpset_received_count.load();
+  i.tpset_sent_count = m_tpset_sent_count.load();
+  i.heartbeats_sent = m_heartbeats_sent.load();
+
+  ci.add(i);
+}
+
+void
+HeartbeatService::do_conf(const nlohmann::json& conf)
+{
+  m_heartbeat_interval = conf.get<dunedaq::trigger::heartbeatservice::Conf>().heartbeat_interval;
+  TLOG_DEBUG(TLVL_GENERAL) << "[HBS] " << get_name() + " configured with " << m_streams.size() << " streams.";
+}
+
+void
+HeartbeatService::do_start(const nlohmann::json& args)
+{
+  rcif::cmd::StartParams start_params = args.get<rcif::cmd::StartParams>();
+  m_run_number = start_params.run;
+
+  for (auto& stream : m_streams) {
+    stream.sourceid = daqdataformats::SourceID{ daqdataformats::SourceID::Subsystem::kTrigger,
+                                                daqdataformats::SourceID::s_invalid_id };
+    stream.last_sent_heartbeat_time = 0;
+    stream.is_first_tpset_received = true;
+    stream.sequence_number = 0;
+  }
+
+  m_thread.start_working_thread("heartbeater");
+  TLOG_DEBUG(TLVL_GENERAL) << "[HBS] " << get_name() + " successfully started.";
+}
+
+void
+HeartbeatService::do_stop(const nlohmann::json&)
+{
+  m_thread.stop_working_thread();
+  TLOG_DEBUG(TLVL_GENERAL) << "[HBS] " << get_name() + " successfully stopped.";
+}
+
+void
+HeartbeatService::do_scrap(const nlohmann::json&)
+{}
+
+void
+HeartbeatService::do_work(std::atomic<bool>& running_flag)
+{
+  // OpMon.
+  m_tpset_received_count.store(0);
+  m_tpset_sent_count.store(0);
+  m_heartbeats_sent.store(0);
+
+  while (true) {
+    // One sweep over all streams, draining whatever is immediately
+    // available. A stream with nothing pending costs one non-blocking
+    // try_receive rather than a parked thread of its own
+    bool any_received = false;
+    for (auto& stream : m_streams) {
+      while (process_stream(stream)) {
+        any_received = true;
+      }
+    }
+
+    if (!any_received) {
+      // The condition to exit the loop is that we've been stopped and
+      // there's nothing left on the input queues
+      if (!running_flag.load()) {
+        break;
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  }
+
+  TLOG() << "[HBS] Received " << m_tpset_received_count << " and sent " << m_tpset_sent_count
+         << " real TPSets over " << m_streams.size() << " streams. Sent " << m_heartbeats_sent
+         << " fake heartbeats." << std::endl;
+  TLOG_DEBUG(TLVL_GENERAL) << "[HBS] Exiting do_work() method";
+}
+
+bool
+HeartbeatService::process_stream(Stream& stream)
+{
+  std::optional<TPSet> tpset = stream.input_queue->try_receive(std::chrono::milliseconds(0));
+  if (!tpset.has_value()) {
+    return false;
+  }
+
+  // We got a TPSet
+  m_tpset_received_count++;
+  if (stream.sourceid.id == daqdataformats::SourceID::s_invalid_id) {
+    stream.sourceid = tpset->origin;
+  }
+  TLOG_DEBUG(TLVL_DEBUG_HIGH) << "[HBS] Activity received.";
+
+  daqdataformats::timestamp_t current_tpset_start_time = tpset->start_time;
+
+  if (should_send_heartbeat(stream, current_tpset_start_time)) {
+    TPSet tpset_heartbeat;
+    get_heartbeat(stream, tpset_heartbeat, current_tpset_start_time);
+    tpset_heartbeat.seqno = stream.sequence_number;
+    ++stream.sequence_number;
+    send_with_retries(stream, std::move(tpset_heartbeat));
+    m_heartbeats_sent++;
+    stream.last_sent_heartbeat_time = current_tpset_start_time;
+    stream.is_first_tpset_received = false;
+  }
+
+  tpset->seqno = stream.sequence_number;
+  ++stream.sequence_number;
+
+  send_with_retries(stream, std::move(*tpset));
+  m_tpset_sent_count++;
+
+  return true;
+}
+
+void
+HeartbeatService::send_with_retries(Stream& stream, TPSet&& tpset)
+{
+  bool successfully_sent = false;
+  while (!successfully_sent) {
+    try {
+      stream.output_queue->send(std::move(tpset), m_queue_timeout);
+      successfully_sent = true;
+    } catch (const dunedaq::iomanager::TimeoutExpired& excpt) {
+      std::ostringstream oss_warn;
+      oss_warn << "push to output queue \"" << stream.output_queue->get_name() << "\"";
+      ers::warning(dunedaq::iomanager::TimeoutExpired(ERS_HERE, get_name(), oss_warn.str(), m_queue_timeout.count()));
+    }
+  }
+}
+
+bool
+HeartbeatService::should_send_heartbeat(Stream const& stream,
+                                        daqdataformats::timestamp_t const& current_tpset_start_time)
+{
+  // If it is the first TPSet received on this stream, send out a heartbeat.
+  // Else, can assume that the TPSets are already ordered by start_time. Therefore, check only
+  // that the difference between the start_time of the current TPSet and the time that the
+  // last heartbeat was sent out is greater than the specified heartbeat interval.
+  if (stream.is_first_tpset_received)
+    return true;
+  else
+    return stream.last_sent_heartbeat_time + m_heartbeat_interval < current_tpset_start_time;
+}
+
+void
+HeartbeatService::get_heartbeat(Stream const& stream,
+                                TPSet& tpset_heartbeat,
+                                daqdataformats::timestamp_t const& current_tpset_start_time)
+{
+  tpset_heartbeat.type = TPSet::Type::kHeartbeat;
+  tpset_heartbeat.start_time = current_tpset_start_time;
+  tpset_heartbeat.end_time = current_tpset_start_time;
+  tpset_heartbeat.run_number = m_run_number;
+  tpset_heartbeat.origin = stream.sourceid;
+}
+
+} // namespace trigger
+} // namespace dunedaq
+
+DEFINE_DUNE_DAQ_MODULE(dunedaq::trigger::HeartbeatService)
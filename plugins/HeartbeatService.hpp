@@ -0,0 +1,104 @@
+/**
+ * @file HeartbeatService.hpp
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2021.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#ifndef TRIGGER_PLUGINS_HEARTBEATSERVICE_HPP_
+#define TRIGGER_PLUGINS_HEARTBEATSERVICE_HPP_
+
+#include "trigger/Issues.hpp"
+#include "trigger/TPSet.hpp"
+#include "trigger/heartbeatservice/Nljs.hpp"
+#include "trigger/heartbeatserviceinfo/InfoNljs.hpp"
+
+#include "appfwk/DAQModule.hpp"
+#include "iomanager/Receiver.hpp"
+#include "iomanager/Sender.hpp"
+#include "utilities/WorkerThread.hpp"
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace dunedaq {
+namespace trigger {
+
+/**
+ * @brief HeartbeatService injects kHeartbeat TPSets into many TP streams from
+ * a single thread
+ *
+ * It implements the same per-stream heartbeat logic as
+ * FakeTPCreatorHeartbeatMaker, but over N tpset_source<i>/tpset_sink<i>
+ * connection pairs instead of one, so a full detector app needs one
+ * heartbeater thread rather than one per link. Per-stream state (source ID,
+ * sequence numbers, last heartbeat time) is kept separately, preserving the
+ * timestamp-alignment guarantees that TimeSliceOutputBuffer relies on.
+ */
+class HeartbeatService : public dunedaq::appfwk::DAQModule
+{
+public:
+  explicit HeartbeatService(const std::string& name);
+
+  HeartbeatService(const HeartbeatService&) = delete;
+  HeartbeatService& operator=(const HeartbeatService&) = delete;
+  HeartbeatService(HeartbeatService&&) = delete;
+  HeartbeatService& operator=(HeartbeatService&&) = delete;
+
+  void init(const nlohmann::json& iniobj) override;
+  void get_info(opmonlib::InfoCollector& ci, int level) override;
+
+private:
+  void do_conf(const nlohmann::json& config);
+  void do_start(const nlohmann::json& obj);
+  void do_stop(const nlohmann::json& obj);
+  void do_scrap(const nlohmann::json& obj);
+  void do_work(std::atomic<bool>&);
+
+  using source_t = dunedaq::iomanager::ReceiverConcept<TPSet>;
+  using sink_t = dunedaq::iomanager::SenderConcept<TPSet>;
+
+  // The state the per-link module kept as member variables, one copy per
+  // stream
+  struct Stream
+  {
+    std::shared_ptr<source_t> input_queue;
+    std::shared_ptr<sink_t> output_queue;
+    daqdataformats::SourceID sourceid{ daqdataformats::SourceID::Subsystem::kTrigger,
+                                       daqdataformats::SourceID::s_invalid_id };
+    daqdataformats::timestamp_t last_sent_heartbeat_time{ 0 };
+    bool is_first_tpset_received{ true };
+    TPSet::seqno_t sequence_number{ 0 };
+  };
+
+  bool should_send_heartbeat(Stream const& stream, daqdataformats::timestamp_t const& current_tpset_start_time);
+  void get_heartbeat(Stream const& stream,
+                     TPSet& tpset_heartbeat,
+                     daqdataformats::timestamp_t const& current_tpset_start_time);
+  void send_with_retries(Stream& stream, TPSet&& tpset);
+  bool process_stream(Stream& stream);
+
+  dunedaq::utilities::WorkerThread m_thread;
+
+  std::vector<Stream> m_streams;
+
+  std::chrono::milliseconds m_queue_timeout;
+
+  triggeralgs::timestamp_t m_heartbeat_interval;
+
+  daqdataformats::run_number_t m_run_number{ daqdataformats::TypeDefaults::s_invalid_run_number };
+
+  // Opmon variables
+  using metric_counter_type = decltype(heartbeatserviceinfo::Info::tpset_received_count);
+  std::atomic<metric_counter_type> m_tpset_received_count{ 0 };
+  std::atomic<metric_counter_type> m_tpset_sent_count{ 0 };
+  std::atomic<metric_counter_type> m_heartbeats_sent{ 0 };
+};
+} // namespace trigger
+} // namespace dunedaq
+
+#endif // TRIGGER_PLUGINS_HEARTBEATSERVICE_HPP_
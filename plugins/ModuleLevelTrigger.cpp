@@ -12,6 +12,8 @@
 #include "trigger/Issues.hpp"
 #include "trigger/Logging.hpp"
 #include "trigger/LivetimeCounter.hpp"
+#include "trigger/QueueSpy.hpp"
+#include "trigger/ThreadPlacement.hpp"
 #include "trigger/moduleleveltrigger/Nljs.hpp"
 
 #include "appfwk/DAQModuleHelper.hpp"
@@ -28,6 +30,7 @@
 #include <cassert>
 #include <pthread.h>
 #include <random>
+#include <sstream>
 #include <string>
 #include <type_traits>
 #include <vector>
@@ -64,6 +67,7 @@ ModuleLevelTrigger::init(const nlohmann::json& iniobj)
   auto ci = appfwk::connection_index(iniobj, { "trigger_candidate_input", "dfo_inhibit_input", "td_output" });
 
   m_candidate_input = get_iom_receiver<triggeralgs::TriggerCandidate>(ci["trigger_candidate_input"]);
+  m_candidate_spy = QueueSpy::get_instance().register_queue(ci["trigger_candidate_input"]);
 
   m_inhibit_input = get_iom_receiver<dfmessages::TriggerInhibit>(ci["dfo_inhibit_input"]);
 
@@ -72,16 +76,46 @@ ModuleLevelTrigger::init(const nlohmann::json& iniobj)
 
 void
 ModuleLevelTrigger::get_info(opmonlib::InfoCollector& ci, int /*level*/)
+{
+  // Copy the snapshot the decision thread last published, so the opmon
+  // poll neither reads decision-loop counters nor takes the livetime
+  // counter's lock
+  moduleleveltriggerinfo::Info i;
+  m_info_snapshot.read(i);
+
+  // The "new since last report" deltas are derived from the cumulative
+  // counts against values only this (opmon) thread keeps. The cumulative
+  // counters restart from zero each run, so a smaller value resets the
+  // baseline rather than wrapping the delta
+  if (i.td_sent_count < m_last_reported_td_sent) {
+    m_last_reported_td_sent = 0;
+  }
+  if (i.td_inhibited_count < m_last_reported_td_inhibited) {
+    m_last_reported_td_inhibited = 0;
+  }
+  if (i.td_total_count < m_last_reported_td_total) {
+    m_last_reported_td_total = 0;
+  }
+  i.new_td_sent_count = i.td_sent_count - m_last_reported_td_sent;
+  i.new_td_inhibited_count = i.td_inhibited_count - m_last_reported_td_inhibited;
+  i.new_td_total_count = i.td_total_count - m_last_reported_td_total;
+  m_last_reported_td_sent = i.td_sent_count;
+  m_last_reported_td_inhibited = i.td_inhibited_count;
+  m_last_reported_td_total = i.td_total_count;
+
+  ci.add(i);
+}
+
+void
+ModuleLevelTrigger::publish_info()
 {
   moduleleveltriggerinfo::Info i;
 
   i.tc_received_count = m_tc_received_count.load();
   i.tc_ignored_count = m_tc_ignored_count.load();
   i.td_sent_count = m_td_sent_count.load();
-  i.new_td_sent_count = m_new_td_sent_count.exchange(0);
   i.td_sent_tc_count = m_td_sent_tc_count.load();
   i.td_inhibited_count = m_td_inhibited_count.load();
-  i.new_td_inhibited_count = m_new_td_inhibited_count.exchange(0);
   i.td_inhibited_tc_count = m_td_inhibited_tc_count.load();
   i.td_paused_count = m_td_paused_count.load();
   i.td_paused_tc_count = m_td_paused_tc_count.load();
@@ -91,8 +125,16 @@ ModuleLevelTrigger::get_info(opmonlib::InfoCollector& ci, int /*level*/)
   i.td_cleared_tc_count = m_td_cleared_tc_count.load();
   i.td_not_triggered_count = m_td_not_triggered_count.load();
   i.td_not_triggered_tc_count = m_td_not_triggered_tc_count.load();
+  i.td_parked_count = m_td_parked_count.load();
+  i.td_merged_count = m_td_merged_count.load();
+  i.td_standalone_count = m_td_standalone_count.load();
+  i.tc_to_td_latency_p50_us = m_tc_to_td_latency.quantile(0.5);
+  i.tc_to_td_latency_p99_us = m_tc_to_td_latency.quantile(0.99);
+  i.pending_td_depth = m_pending_td_depth.load();
+  i.td_park_expired_count = m_td_park_expired_count.load();
+  i.td_park_overflow_count = m_td_park_overflow_count.load();
+  i.td_park_depth = m_park_tail.load() - m_park_head.load();
   i.td_total_count = m_td_total_count.load();
-  i.new_td_total_count = m_new_td_total_count.exchange(0);
 
   if (m_livetime_counter.get() != nullptr) {
     i.lc_kLive = m_livetime_counter->get_time(LivetimeCounter::State::kLive);
@@ -100,7 +142,17 @@ ModuleLevelTrigger::get_info(opmonlib::InfoCollector& ci, int /*level*/)
     i.lc_kDead = m_livetime_counter->get_time(LivetimeCounter::State::kDead);
   }
 
-  ci.add(i);
+  m_info_snapshot.publish(i);
+}
+
+void
+ModuleLevelTrigger::maybe_publish_info()
+{
+  auto now = std::chrono::steady_clock::now();
+  if (now - m_last_snapshot_time >= s_snapshot_interval) {
+    m_last_snapshot_time = now;
+    publish_info();
+  }
 }
 
 void
@@ -114,11 +166,11 @@ ModuleLevelTrigger::do_configure(const nlohmann::json& confobj)
       dfmessages::SourceID{ daqdataformats::SourceID::string_to_subsystem(link.subsystem), link.element });
   }
   m_group_links.clear();
-  m_group_links_data = params.groups_links;
-  parse_group_links(m_group_links_data);
+  parse_group_links(params.groups_links);
   print_group_links();
   m_total_group_links = m_group_links.size();
   TLOG_DEBUG(TLVL_DEBUG_INFO) << "[MLT] Total group links: " << m_total_group_links;
+  build_request_templates();
 
   // m_trigger_decision_connection = params.dfo_connection;
   // m_inhibit_connection = params.dfo_busy_connection;
@@ -126,7 +178,12 @@ ModuleLevelTrigger::do_configure(const nlohmann::json& confobj)
   m_configured_flag.store(true);
 
   m_tc_merging = params.merge_overlapping_tcs;
+  m_merge_horizon_ticks = static_cast<triggeralgs::timestamp_t>(params.merge_horizon_ticks);
   m_buffer_timeout = params.buffer_timeout;
+  m_park_capacity = (params.td_park_ring_size > 0) ? static_cast<size_t>(params.td_park_ring_size) : 0;
+  m_park_ring = std::vector<ParkedDecision>(m_park_capacity);
+  m_park_head.store(0);
+  m_park_tail.store(0);
   m_send_timed_out_tds = params.td_out_of_timeout;
   m_td_readout_limit = params.td_readout_limit;
   m_ignored_tc_types = params.ignore_tc;
@@ -134,7 +191,10 @@ ModuleLevelTrigger::do_configure(const nlohmann::json& confobj)
   m_use_readout_map = params.use_readout_map;
   m_use_roi_readout = params.use_roi_readout;
   m_use_bitwords = params.use_bitwords;
+  m_cpu_affinity = params.cpu_affinity;
+  m_numa_node = params.numa_node;
   TLOG_DEBUG(TLVL_DEBUG_INFO) << "[MLT] Allow merging: " << m_tc_merging;
+  TLOG_DEBUG(TLVL_DEBUG_INFO) << "[MLT] Merge horizon [ticks]: " << m_merge_horizon_ticks;
   TLOG_DEBUG(TLVL_DEBUG_INFO) << "[MLT] Buffer timeout: " << m_buffer_timeout;
   TLOG_DEBUG(TLVL_DEBUG_INFO) << "[MLT] Should send timed out TDs: " << m_send_timed_out_tds;
   TLOG_DEBUG(TLVL_DEBUG_INFO) << "[MLT] TD readout limit: " << m_td_readout_limit;
@@ -142,16 +202,14 @@ ModuleLevelTrigger::do_configure(const nlohmann::json& confobj)
 
   // ROI map
   if (m_use_roi_readout) {
-    m_roi_conf_data = params.roi_conf;
-    parse_roi_conf(m_roi_conf_data);
+    parse_roi_conf(params.roi_conf);
     print_roi_conf(m_roi_conf);
   }
 
   // Custom readout map
   TLOG_DEBUG(TLVL_DEBUG_INFO) << "[MLT] Use readout map: " << m_use_readout_map;
   if (m_use_readout_map) {
-    m_readout_window_map_data = params.td_readout_map;
-    parse_readout_map(m_readout_window_map_data);
+    parse_readout_map(params.td_readout_map);
     print_readout_map(m_readout_window_map);
   }
 
@@ -168,8 +226,8 @@ ModuleLevelTrigger::do_configure(const nlohmann::json& confobj)
   // Trigger bitwords
   TLOG_DEBUG(TLVL_DEBUG_INFO) << "[MLT] Use bitwords: " << m_use_bitwords;
   if (m_use_bitwords) {
-    m_trigger_bitwords_json = params.trigger_bitwords;
-    print_bitword_flags(m_trigger_bitwords_json);
+    m_trigger_bitwords_data = params.trigger_bitwords;
+    print_bitword_flags(m_trigger_bitwords_data);
     set_trigger_bitwords();
     print_trigger_bitwords(m_trigger_bitwords);
   }
@@ -253,6 +311,8 @@ ModuleLevelTrigger::do_scrap(const nlohmann::json& /*scrapobj*/)
 {
   m_mandatory_links.clear();
   m_group_links.clear();
+  m_mandatory_request_template.clear();
+  m_full_request_template.clear();
   m_configured_flag.store(false);
 }
 
@@ -282,17 +342,16 @@ ModuleLevelTrigger::create_decision(const ModuleLevelTrigger::PendingTD& pending
                 << ", request window begin: " << pending_td.readout_start
                 << ", request window end: " << pending_td.readout_end;
 
-  std::vector<dfmessages::ComponentRequest> requests =
-    create_all_decision_requests(m_mandatory_links, pending_td.readout_start, pending_td.readout_end);
-  add_requests_to_decision(decision, requests);
+  // Bulk copy of the configure-time template (mandatory plus group links, or
+  // mandatory only when ROI readout appends its own), then a single pass to
+  // stamp the readout window
+  decision.components = m_use_roi_readout ? m_mandatory_request_template : m_full_request_template;
+  for (auto& request : decision.components) {
+    request.window_begin = pending_td.readout_start;
+    request.window_end = pending_td.readout_end;
+  }
 
-  if (!m_use_roi_readout) {
-    for (const auto& [key, value] : m_group_links) {
-      std::vector<dfmessages::ComponentRequest> group_requests =
-        create_all_decision_requests(value, pending_td.readout_start, pending_td.readout_end);
-      add_requests_to_decision(decision, group_requests);
-    }
-  } else { // using ROI readout
+  if (m_use_roi_readout) {
     roi_readout_make_requests(decision);
   }
 
@@ -302,6 +361,8 @@ ModuleLevelTrigger::create_decision(const ModuleLevelTrigger::PendingTD& pending
 void
 ModuleLevelTrigger::send_trigger_decisions()
 {
+  thread_placement::pin_current_thread(m_cpu_affinity, get_name());
+  thread_placement::prefer_numa_node(m_numa_node, get_name());
 
   // We get here at start of run, so reset the trigger number
   m_last_trigger_number = 0;
@@ -322,45 +383,76 @@ ModuleLevelTrigger::send_trigger_decisions()
   m_td_not_triggered_count.store(0);
   m_td_not_triggered_tc_count.store(0);
   m_td_total_count.store(0);
+  m_td_parked_count.store(0);
+  m_td_merged_count.store(0);
+  m_td_standalone_count.store(0);
+  m_td_park_expired_count.store(0);
+  m_td_park_overflow_count.store(0);
+  m_park_head.store(0);
+  m_park_tail.store(0);
+  m_tc_to_td_latency.reset();
+  m_pending_td_depth.store(0);
   m_lc_kLive.store(0);
   m_lc_kPaused.store(0);
   m_lc_kDead.store(0);
 
+  std::vector<triggeralgs::TriggerCandidate> tc_batch;
+  tc_batch.reserve(s_max_tc_batch);
+
   // New buffering logic here
   while (m_running_flag) {
+    // First chance to send anything parked while the DFO was busy
+    drain_parked_decisions();
+
+    // Drain the current TC backlog in one go: the first receive waits
+    // briefly, the rest only poll, so bursts are absorbed as a batch (one
+    // lock, merge across the whole batch) before the ready-TD pass runs
+    tc_batch.clear();
     std::optional<triggeralgs::TriggerCandidate> tc = m_candidate_input->try_receive(std::chrono::milliseconds(10));
-    if (tc.has_value()) {
-      if ( (m_use_readout_map) && (m_readout_window_map.count(tc->type)) ) {
-        TLOG_DEBUG(TLVL_DEBUG_HIGH) << "[MLT] Got TC of type " << static_cast<int>(tc->type) << ", timestamp " << tc->time_candidate
-                      << ", start/end " << tc->time_start << "/" << tc->time_end << ", readout start/end "
-                      << tc->time_candidate - m_readout_window_map[tc->type].first << "/"
-                      << tc->time_candidate + m_readout_window_map[tc->type].second;
-      } else {
-        TLOG_DEBUG(TLVL_DEBUG_HIGH) << "[MLT] Got TC of type " << static_cast<int>(tc->type) << ", timestamp " << tc->time_candidate
-                      << ", start/end " << tc->time_start << "/" << tc->time_end;
+    while (tc.has_value()) {
+      tc_batch.push_back(std::move(*tc));
+      if (tc_batch.size() >= s_max_tc_batch) {
+        break;
       }
-      ++m_tc_received_count;
-
-      // Option to ignore TC types (if given by config)
-      if (m_ignoring_tc_types == true) {
-        TLOG_DEBUG(TLVL_DEBUG_HIGH) << "[MLT] TC type: " << static_cast<int>(tc->type);
-        if (check_trigger_type_ignore(static_cast<int>(tc->type)) == true) {
-          TLOG_DEBUG(TLVL_DEBUG_HIGH) << "[MLT] ignoring...";
-          m_tc_ignored_count++;
-
-          if (m_tc_merging) {
-            // Still need to check for overlap with existing TD, if overlaps, include in the TD, but don't extend
-            // readout
-            std::lock_guard<std::mutex> lock(m_td_vector_mutex);
-            add_tc_ignored(*tc);
+      tc = m_candidate_input->try_receive(std::chrono::milliseconds(0));
+    }
+    // Each drained batch is a depth sample for the backpressure observatory
+    QueueSpy::get_instance().record_drain(m_candidate_spy, tc_batch.size(), tc_batch.size() >= s_max_tc_batch);
+
+    if (!tc_batch.empty()) {
+      std::lock_guard<std::mutex> lock(m_td_vector_mutex);
+      for (const auto& batched_tc : tc_batch) {
+        if (has_readout_window(batched_tc.type)) {
+          TLOG_DEBUG(TLVL_DEBUG_HIGH) << "[MLT] Got TC of type " << static_cast<int>(batched_tc.type) << ", timestamp " << batched_tc.time_candidate
+                        << ", start/end " << batched_tc.time_start << "/" << batched_tc.time_end << ", readout start/end "
+                        << batched_tc.time_candidate - readout_window(batched_tc.type).first << "/"
+                        << batched_tc.time_candidate + readout_window(batched_tc.type).second;
+        } else {
+          TLOG_DEBUG(TLVL_DEBUG_HIGH) << "[MLT] Got TC of type " << static_cast<int>(batched_tc.type) << ", timestamp " << batched_tc.time_candidate
+                        << ", start/end " << batched_tc.time_start << "/" << batched_tc.time_end;
+        }
+        ++m_tc_received_count;
+
+        // Option to ignore TC types (if given by config)
+        if (m_ignoring_tc_types == true) {
+          TLOG_DEBUG(TLVL_DEBUG_HIGH) << "[MLT] TC type: " << static_cast<int>(batched_tc.type);
+          if (check_trigger_type_ignore(static_cast<int>(batched_tc.type)) == true) {
+            TLOG_DEBUG(TLVL_DEBUG_HIGH) << "[MLT] ignoring...";
+            m_tc_ignored_count++;
+
+            if (m_tc_merging) {
+              // Still need to check for overlap with existing TD, if overlaps, include in the TD, but don't extend
+              // readout
+              add_tc_ignored(batched_tc);
+            }
+            continue;
           }
-          continue;
         }
-      }
 
-      std::lock_guard<std::mutex> lock(m_td_vector_mutex);
-      add_tc(*tc);
-      TLOG_DEBUG(TLVL_DEBUG_ALL) << "[MLT] pending tds size: " << m_pending_tds.size();
+        add_tc(batched_tc);
+        TLOG_DEBUG(TLVL_DEBUG_ALL) << "[MLT] pending tds size: " << m_pending_tds.size();
+      }
+      m_pending_td_depth.store(m_pending_tds.size(), std::memory_order_relaxed);
     } else {
       // The condition to exit the loop is that we've been stopped and
       // there's nothing left on the input queue
@@ -371,6 +463,7 @@ ModuleLevelTrigger::send_trigger_decisions()
 
     std::lock_guard<std::mutex> lock(m_td_vector_mutex);
     auto ready_tds = get_ready_tds(m_pending_tds);
+    m_pending_td_depth.store(m_pending_tds.size(), std::memory_order_relaxed);
     TLOG_DEBUG(TLVL_DEBUG_ALL) << "[MLT] ready tds: " << ready_tds.size() << ", updated pending tds: " << m_pending_tds.size()
                    << ", sent tds: " << m_sent_tds.size();
 
@@ -405,6 +498,20 @@ ModuleLevelTrigger::send_trigger_decisions()
     }
 
     TLOG_DEBUG(TLVL_DEBUG_ALL) << "[MLT] updated sent tds: " << m_sent_tds.size();
+
+    maybe_publish_info();
+  }
+
+  // Anything still parked when the run stops is dropped and counted cleared
+  {
+    size_t head = m_park_head.load();
+    size_t tail = m_park_tail.load();
+    while (head != tail && m_park_capacity > 0) {
+      m_td_cleared_count++;
+      m_td_cleared_tc_count += m_park_ring[head % m_park_capacity].n_tcs;
+      ++head;
+    }
+    m_park_head.store(head);
   }
 
   TLOG() << "[MLT] Run " << m_run_number << ": "
@@ -431,6 +538,9 @@ ModuleLevelTrigger::send_trigger_decisions()
 
   m_lc_deadtime = m_livetime_counter->get_time(LivetimeCounter::State::kDead) +
                   m_livetime_counter->get_time(LivetimeCounter::State::kPaused);
+
+  // Final snapshot so the end-of-run totals are what opmon reports
+  publish_info();
 }
 
 void
@@ -463,8 +573,8 @@ ModuleLevelTrigger::call_tc_decision(const ModuleLevelTrigger::PendingTD& pendin
         auto td_sender = get_iom_sender<dfmessages::TriggerDecision>(m_td_output_connection);
         td_sender->send(std::move(decision), std::chrono::milliseconds(1));
         m_td_sent_count++;
-        m_new_td_sent_count++;
         m_td_sent_tc_count += pending_td.contributing_tcs.size();
+        m_tc_to_td_latency.record(std::chrono::steady_clock::now() - pending_td.earliest_arrival);
         m_last_trigger_number++;
         add_td(pending_td);
       } catch (const ers::Issue& e) {
@@ -482,42 +592,126 @@ ModuleLevelTrigger::call_tc_decision(const ModuleLevelTrigger::PendingTD& pendin
                     << pending_td.readout_start << "/" << pending_td.readout_end;
     } else {
       ers::warning(TriggerInhibited(ERS_HERE, m_run_number));
-      TLOG_DEBUG(TLVL_IMPORTANT) << "[MLT] The DFO is busy. Not sending a TriggerDecision for candidate timestamp "
+      TLOG_DEBUG(TLVL_IMPORTANT) << "[MLT] The DFO is busy. Parking TriggerDecision for candidate timestamp "
                     << pending_td.contributing_tcs[m_earliest_tc_index].time_candidate;
-      m_td_inhibited_count++;
-      m_new_td_inhibited_count++;
-      m_td_inhibited_tc_count += pending_td.contributing_tcs.size();
+      park_decision(std::move(decision), pending_td.contributing_tcs.size(), pending_td.earliest_arrival);
+      if (m_park_capacity > 0) {
+        // The parked decision keeps its trigger number and reserves its
+        // readout window, whether or not it makes it out before its deadline
+        m_last_trigger_number++;
+        add_td(pending_td);
+      }
+    }
+    if (pending_td.contributing_tcs.size() > 1) {
+      m_td_merged_count++;
+    } else {
+      m_td_standalone_count++;
     }
     m_td_total_count++;
-    m_new_td_total_count++;
   } else { // trigger bitword check
     m_td_not_triggered_count++;
     m_td_not_triggered_tc_count += pending_td.contributing_tcs.size();
   }
 }
 
+void
+ModuleLevelTrigger::park_decision(dfmessages::TriggerDecision&& decision,
+                                  size_t n_tcs,
+                                  std::chrono::steady_clock::time_point earliest_arrival)
+{
+  if (m_park_capacity == 0) {
+    // Ring disabled: old behaviour, the decision is inhibited on the spot
+    m_td_inhibited_count++;
+    m_td_inhibited_tc_count += n_tcs;
+    return;
+  }
+
+  size_t head = m_park_head.load(std::memory_order_relaxed);
+  size_t tail = m_park_tail.load(std::memory_order_relaxed);
+  if (tail - head == m_park_capacity) {
+    // Full: drop the oldest so memory stays strictly bounded during
+    // sustained backpressure
+    ParkedDecision& oldest = m_park_ring[head % m_park_capacity];
+    m_td_park_overflow_count++;
+    m_td_inhibited_count++;
+    m_td_inhibited_tc_count += oldest.n_tcs;
+    m_park_head.store(head + 1, std::memory_order_release);
+  }
+
+  int64_t now_ms =
+    std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+  ParkedDecision& slot = m_park_ring[tail % m_park_capacity];
+  slot.decision = std::move(decision);
+  slot.deadline = now_ms + m_buffer_timeout;
+  slot.n_tcs = n_tcs;
+  slot.earliest_arrival = earliest_arrival;
+  m_td_parked_count++;
+  m_park_tail.store(tail + 1, std::memory_order_release);
+}
+
+void
+ModuleLevelTrigger::drain_parked_decisions()
+{
+  if (m_park_capacity == 0) {
+    return;
+  }
+  size_t head = m_park_head.load(std::memory_order_relaxed);
+  size_t tail = m_park_tail.load(std::memory_order_relaxed);
+  while (head != tail) {
+    ParkedDecision& slot = m_park_ring[head % m_park_capacity];
+    int64_t now_ms =
+      std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+    if (now_ms > slot.deadline) {
+      // Too old to be worth requesting: count it as inhibited and move on
+      m_td_park_expired_count++;
+      m_td_inhibited_count++;
+      m_td_inhibited_tc_count += slot.n_tcs;
+      m_park_head.store(++head, std::memory_order_release);
+      continue;
+    }
+    if (m_paused.load() || m_dfo_is_busy.load()) {
+      break;
+    }
+    try {
+      auto td_sender = get_iom_sender<dfmessages::TriggerDecision>(m_td_output_connection);
+      td_sender->send(std::move(slot.decision), std::chrono::milliseconds(1));
+      m_td_sent_count++;
+      m_td_sent_tc_count += slot.n_tcs;
+      m_tc_to_td_latency.record(std::chrono::steady_clock::now() - slot.earliest_arrival);
+    } catch (const ers::Issue& e) {
+      ers::error(e);
+      m_td_queue_timeout_expired_err_count++;
+      m_td_queue_timeout_expired_err_tc_count += slot.n_tcs;
+    }
+    m_park_head.store(++head, std::memory_order_release);
+  }
+}
+
 void
 ModuleLevelTrigger::add_tc(const triggeralgs::TriggerCandidate& tc)
 {
   bool added_to_existing = false;
+  auto tc_arrival = std::chrono::steady_clock::now();
   int64_t tc_wallclock_arrived =
-    std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    std::chrono::duration_cast<std::chrono::milliseconds>(tc_arrival.time_since_epoch()).count();
 
   if (m_tc_merging) {
 
     for (std::vector<PendingTD>::iterator it = m_pending_tds.begin(); it != m_pending_tds.end();) {
       if (check_overlap(tc, *it)) {
 	it->contributing_tcs.push_back(tc);
-        if ( (m_use_readout_map) && (m_readout_window_map.count(tc.type)) ){
-          TLOG_DEBUG(TLVL_DEBUG_LOW) << "[MLT] TC with start/end times " << tc.time_candidate - m_readout_window_map[tc.type].first << "/"
-                        << tc.time_candidate + m_readout_window_map[tc.type].second
+        if (has_readout_window(tc.type)) {
+          const auto& window = readout_window(tc.type);
+          TLOG_DEBUG(TLVL_DEBUG_LOW) << "[MLT] TC with start/end times " << tc.time_candidate - window.first << "/"
+                        << tc.time_candidate + window.second
                         << " overlaps with pending TD with start/end times " << it->readout_start << "/"
                         << it->readout_end;
-          it->readout_start = ((tc.time_candidate - m_readout_window_map[tc.type].first) >= it->readout_start)
+          it->readout_start = ((tc.time_candidate - window.first) >= it->readout_start)
                                 ? it->readout_start
-                                : (tc.time_candidate - m_readout_window_map[tc.type].first);
-          it->readout_end = ((tc.time_candidate + m_readout_window_map[tc.type].second) >= it->readout_end)
-                              ? (tc.time_candidate + m_readout_window_map[tc.type].second)
+                                : (tc.time_candidate - window.first);
+          it->readout_end = ((tc.time_candidate + window.second) >= it->readout_end)
+                              ? (tc.time_candidate + window.second)
                               : it->readout_end;
         } else {
           TLOG_DEBUG(TLVL_DEBUG_LOW) << "[MLT] TC with start/end times " << tc.time_start << "/" << tc.time_end
@@ -537,14 +731,15 @@ ModuleLevelTrigger::add_tc(const triggeralgs::TriggerCandidate& tc)
   if (!added_to_existing) {
     PendingTD td_candidate;
     td_candidate.contributing_tcs.push_back(tc);
-    if ( (m_use_readout_map) && (m_readout_window_map.count(tc.type)) ){
-      td_candidate.readout_start = tc.time_candidate - m_readout_window_map[tc.type].first;
-      td_candidate.readout_end = tc.time_candidate + m_readout_window_map[tc.type].second;
+    if (has_readout_window(tc.type)) {
+      td_candidate.readout_start = tc.time_candidate - readout_window(tc.type).first;
+      td_candidate.readout_end = tc.time_candidate + readout_window(tc.type).second;
     } else {
       td_candidate.readout_start = tc.time_start;
       td_candidate.readout_end = tc.time_end;
     }
     td_candidate.walltime_expiration = tc_wallclock_arrived + m_buffer_timeout;
+    td_candidate.earliest_arrival = tc_arrival;
     m_pending_tds.push_back(td_candidate);
   }
   return;
@@ -555,9 +750,9 @@ ModuleLevelTrigger::add_tc_ignored(const triggeralgs::TriggerCandidate& tc)
 {
   for (std::vector<PendingTD>::iterator it = m_pending_tds.begin(); it != m_pending_tds.end();) {
     if (check_overlap(tc, *it)) {
-      if ( (m_use_readout_map) && (m_readout_window_map.count(tc.type)) ) {
-        TLOG_DEBUG(TLVL_DEBUG_LOW) << "[MLT] !Ignored! TC with start/end times " << tc.time_candidate - m_readout_window_map[tc.type].first
-                      << "/" << tc.time_candidate + m_readout_window_map[tc.type].second
+      if (has_readout_window(tc.type)) {
+        TLOG_DEBUG(TLVL_DEBUG_LOW) << "[MLT] !Ignored! TC with start/end times " << tc.time_candidate - readout_window(tc.type).first
+                      << "/" << tc.time_candidate + readout_window(tc.type).second
                       << " overlaps with pending TD with start/end times " << it->readout_start << "/"
                       << it->readout_end;
       } else {
@@ -576,11 +771,16 @@ ModuleLevelTrigger::add_tc_ignored(const triggeralgs::TriggerCandidate& tc)
 bool
 ModuleLevelTrigger::check_overlap(const triggeralgs::TriggerCandidate& tc, const PendingTD& pending_td)
 {
-  if ( (m_use_readout_map) && (m_readout_window_map.count(tc.type)) ) {
-    return !(((tc.time_candidate + m_readout_window_map[tc.type].second) < pending_td.readout_start) ||
-             ((tc.time_candidate - m_readout_window_map[tc.type].first > pending_td.readout_end)));
+  // Windows within m_merge_horizon_ticks of each other count as overlapping,
+  // so closely spaced TCs collapse into one TD instead of producing near
+  // duplicate data requests downstream
+  if (has_readout_window(tc.type)) {
+    const auto& window = readout_window(tc.type);
+    return !(((tc.time_candidate + window.second + m_merge_horizon_ticks) < pending_td.readout_start) ||
+             ((tc.time_candidate - window.first > pending_td.readout_end + m_merge_horizon_ticks)));
   } else {
-    return !((tc.time_end < pending_td.readout_start) || (tc.time_start > pending_td.readout_end));
+    return !((tc.time_end + m_merge_horizon_ticks < pending_td.readout_start) ||
+             (tc.time_start > pending_td.readout_end + m_merge_horizon_ticks));
   }
 }
 
@@ -718,17 +918,10 @@ ModuleLevelTrigger::check_trigger_type_ignore(int tc_type)
 std::bitset<64>
 ModuleLevelTrigger::get_TD_bitword(const PendingTD& ready_td)
 {
-  // get only unique types
-  std::vector<int> tc_types;
-  for (auto tc : ready_td.contributing_tcs) {
-    tc_types.push_back(static_cast<int>(tc.type));
-  }
-  tc_types.erase(std::unique(tc_types.begin(), tc_types.end()), tc_types.end());
-
-  // form TD bitword
+  // form TD bitword; the bitset deduplicates repeated types by itself
   std::bitset<64> td_bitword;
-  for (auto tc_type : tc_types) {
-    td_bitword.set(tc_type);
+  for (const auto& tc : ready_td.contributing_tcs) {
+    td_bitword.set(static_cast<int>(tc.type));
   }
   return td_bitword;
 }
@@ -744,11 +937,15 @@ ModuleLevelTrigger::print_trigger_bitwords(std::vector<std::bitset<64>> trigger_
 }
 
 void
-ModuleLevelTrigger::print_bitword_flags(nlohmann::json m_trigger_bitwords_json)
+ModuleLevelTrigger::print_bitword_flags(const moduleleveltrigger::Bitwords& bitwords)
 {
   TLOG_DEBUG(TLVL_DEBUG_INFO) << "[MLT] Configured trigger flags:";
-  for (auto bitflag : m_trigger_bitwords_json) {
-    TLOG_DEBUG(TLVL_DEBUG_INFO) << bitflag;
+  for (auto const& bitflag : bitwords) {
+    std::ostringstream oss;
+    for (auto bit : bitflag) {
+      oss << bit << " ";
+    }
+    TLOG_DEBUG(TLVL_DEBUG_INFO) << oss.str();
   }
   return;
 }
@@ -756,38 +953,54 @@ ModuleLevelTrigger::print_bitword_flags(nlohmann::json m_trigger_bitwords_json)
 bool
 ModuleLevelTrigger::check_trigger_bitwords()
 {
-  bool trigger_check = false;
-  for (auto bitword : m_trigger_bitwords) {
-    TLOG_DEBUG(TLVL_DEBUG_ALL) << "[MLT] TD word: " << m_TD_bitword << ", bitword: " << bitword;
-    trigger_check = ((m_TD_bitword & bitword) == bitword);
-    TLOG_DEBUG(TLVL_DEBUG_ALL) << "[MLT] &: " << (m_TD_bitword & bitword);
-    TLOG_DEBUG(TLVL_DEBUG_ALL) << "[MLT] trigger?: " << trigger_check;
-    if (trigger_check == true)
-      break;
+  const uint64_t td_word = m_TD_bitword.to_ullong(); // NOLINT(build/unsigned)
+  // All single-bit requirement words are folded into one mask: any bit in
+  // common means one of them is fully contained in the TD word
+  bool trigger_check = (td_word & m_bitword_single_mask) != 0;
+  // Multi-bit words can't be folded the same way (each needs its own
+  // all-bits-present test), so they keep a scan - over plain 64-bit masks
+  // with no early exit, which the compiler turns into straight-line code
+  for (uint64_t word : m_bitword_multi_masks) { // NOLINT(build/unsigned)
+    trigger_check |= ((td_word & word) == word);
   }
+  TLOG_DEBUG(TLVL_DEBUG_ALL) << "[MLT] TD word: " << m_TD_bitword << ", trigger?: " << trigger_check;
   return trigger_check;
 }
 
 void
 ModuleLevelTrigger::set_trigger_bitwords()
 {
-  for (auto flag : m_trigger_bitwords_json) {
+  for (auto const& flag : m_trigger_bitwords_data) {
     std::bitset<64> temp_bitword;
     for (auto bit : flag) {
       temp_bitword.set(bit);
     }
     m_trigger_bitwords.push_back(temp_bitword);
+    // Compile the flattened masks check_trigger_bitwords() runs against
+    if (temp_bitword.count() == 1) {
+      m_bitword_single_mask |= temp_bitword.to_ullong();
+    } else if (temp_bitword.any()) {
+      m_bitword_multi_masks.push_back(temp_bitword.to_ullong());
+    }
   }
   return;
 }
 
 void
-ModuleLevelTrigger::parse_readout_map(const nlohmann::json& data)
+ModuleLevelTrigger::parse_readout_map(const moduleleveltrigger::tc_readout_map& data)
 {
-  for (auto readout_type : data) {
-    m_readout_window_map[static_cast<trgdataformats::TriggerCandidateData::Type>(readout_type["candidate_type"])] = {
-      readout_type["time_before"], readout_type["time_after"]
+  for (auto const& readout_type : data) {
+    m_readout_window_map[static_cast<trgdataformats::TriggerCandidateData::Type>(readout_type.candidate_type)] = {
+      readout_type.time_before, readout_type.time_after
     };
+    // Mirror into the dense table the per-TC path actually probes
+    auto idx = static_cast<size_t>(readout_type.candidate_type);
+    if (idx < s_tc_type_table_size) {
+      m_readout_window_table[idx] = { readout_type.time_before, readout_type.time_after };
+      m_readout_window_valid.set(idx);
+    } else {
+      ers::warning(UnknownReadoutType(ERS_HERE, get_name(), readout_type.candidate_type));
+    }
   }
   return;
 }
@@ -804,16 +1017,15 @@ ModuleLevelTrigger::print_readout_map(std::map<trgdataformats::TriggerCandidateD
 }
 
 void
-ModuleLevelTrigger::parse_group_links(const nlohmann::json& data)
+ModuleLevelTrigger::parse_group_links(const moduleleveltrigger::group_links& data)
 {
-  for (auto group : data) {
-    const nlohmann::json& temp_links_data = group["links"];
+  for (auto const& group : data) {
     std::vector<dfmessages::SourceID> temp_links;
-    for (auto link : temp_links_data) {
+    for (auto const& link : group.links) {
       temp_links.push_back(
-        dfmessages::SourceID{ daqdataformats::SourceID::string_to_subsystem(link["subsystem"]), link["element"] });
+        dfmessages::SourceID{ daqdataformats::SourceID::string_to_subsystem(link.subsystem), link.element });
     }
-    m_group_links.insert({ group["group"], temp_links });
+    m_group_links.insert({ group.group, temp_links });
   }
   return;
 }
@@ -871,26 +1083,104 @@ ModuleLevelTrigger::add_requests_to_decision(dfmessages::TriggerDecision& decisi
 }
 
 void
-ModuleLevelTrigger::parse_roi_conf(const nlohmann::json& data)
+ModuleLevelTrigger::build_request_templates()
+{
+  m_mandatory_request_template.clear();
+  m_full_request_template.clear();
+  for (auto const& link : m_mandatory_links) {
+    dfmessages::ComponentRequest request;
+    request.component = link;
+    m_mandatory_request_template.push_back(request);
+  }
+  m_full_request_template = m_mandatory_request_template;
+  m_group_request_templates.clear();
+  m_group_request_templates.resize(m_group_links.size());
+  for (auto const& [group, links] : m_group_links) {
+    for (auto const& link : links) {
+      dfmessages::ComponentRequest request;
+      request.component = link;
+      m_full_request_template.push_back(request);
+      if (group >= 0 && group < static_cast<int>(m_group_request_templates.size())) {
+        m_group_request_templates[group].push_back(request);
+      }
+    }
+  }
+  TLOG_DEBUG(TLVL_DEBUG_INFO) << "[MLT] Built request templates: " << m_mandatory_request_template.size()
+                              << " mandatory, " << m_full_request_template.size() << " total requests";
+}
+
+void
+ModuleLevelTrigger::parse_roi_conf(const moduleleveltrigger::roi_conf_map& data)
 {
   int counter = 0;
   float run_sum = 0;
-  for (auto group : data) {
+  for (auto const& group : data) {
     roi_group temp_roi_group;
-    temp_roi_group.n_links = group["number_of_link_groups"];
-    temp_roi_group.prob = group["probability"];
-    temp_roi_group.time_window = group["time_window"];
-    temp_roi_group.mode = group["groups_selection_mode"];
+    temp_roi_group.n_links = group.number_of_link_groups;
+    temp_roi_group.prob = group.probability;
+    temp_roi_group.time_window = group.time_window;
+    temp_roi_group.mode =
+      (group.groups_selection_mode == moduleleveltrigger::GroupSelection::kSequential) ? "kSequential" : "kRandom";
     m_roi_conf.insert({ counter, temp_roi_group });
     m_roi_conf_ids.push_back(counter);
-    m_roi_conf_probs.push_back(group["probability"]);
-    run_sum += static_cast<float>(group["probability"]);
+    m_roi_conf_probs.push_back(group.probability);
+    run_sum += group.probability;
     m_roi_conf_probs_c.push_back(run_sum);
     counter++;
   }
+  build_roi_sampling_tables();
   return;
 }
 
+void
+ModuleLevelTrigger::build_roi_sampling_tables()
+{
+  // Walker alias table over the configured group probabilities
+  size_t n = m_roi_conf_probs.size();
+  m_roi_alias_prob.assign(n, 1.0F);
+  m_roi_alias.assign(n, 0);
+  float prob_sum = m_roi_conf_probs_c.empty() ? 0.0F : m_roi_conf_probs_c.back();
+  if (n > 0 && prob_sum > 0.0F) {
+    std::vector<float> scaled(n);
+    std::vector<int> small;
+    std::vector<int> large;
+    for (size_t i = 0; i < n; ++i) {
+      scaled[i] = m_roi_conf_probs[i] * static_cast<float>(n) / prob_sum;
+      (scaled[i] < 1.0F ? small : large).push_back(static_cast<int>(i));
+    }
+    while (!small.empty() && !large.empty()) {
+      int s_idx = small.back();
+      small.pop_back();
+      int l_idx = large.back();
+      large.pop_back();
+      m_roi_alias_prob[s_idx] = scaled[s_idx];
+      m_roi_alias[s_idx] = l_idx;
+      scaled[l_idx] = (scaled[l_idx] + scaled[s_idx]) - 1.0F;
+      (scaled[l_idx] < 1.0F ? small : large).push_back(l_idx);
+    }
+    // Whatever remains has weight 1 after rounding
+    for (int idx : small) {
+      m_roi_alias_prob[idx] = 1.0F;
+    }
+    for (int idx : large) {
+      m_roi_alias_prob[idx] = 1.0F;
+    }
+  }
+
+  // Concatenated request templates for the sequential-selection configs
+  m_roi_seq_request_templates.clear();
+  for (const auto& [id, group] : m_roi_conf) {
+    std::vector<dfmessages::ComponentRequest> seq_template;
+    if (group.mode != "kRandom") {
+      for (int r_id = 0; r_id < group.n_links && r_id < static_cast<int>(m_group_request_templates.size()); r_id++) {
+        seq_template.insert(
+          seq_template.end(), m_group_request_templates[r_id].begin(), m_group_request_templates[r_id].end());
+      }
+    }
+    m_roi_seq_request_templates.push_back(seq_template);
+  }
+}
+
 void
 ModuleLevelTrigger::print_roi_conf(std::map<int, roi_group> roi_conf)
 {
@@ -916,13 +1206,13 @@ ModuleLevelTrigger::get_random_num_float(float limit)
 int
 ModuleLevelTrigger::pick_roi_group_conf()
 {
-  float rnd_num = get_random_num_float(m_roi_conf_probs_c.back());
-  for (int i = 0; i < static_cast<int>(m_roi_conf_probs_c.size()); i++) {
-    if (rnd_num < m_roi_conf_probs_c[i]) {
-      return i;
-    }
+  // Alias method: one uniform slot pick plus one biased coin flip
+  if (m_roi_alias_prob.empty()) {
+    return -1;
   }
-  return -1;
+  int slot = rand() % static_cast<int>(m_roi_alias_prob.size());
+  float coin = get_random_num_float(1.0F);
+  return (coin < m_roi_alias_prob[slot]) ? slot : m_roi_alias[slot];
 }
 
 int
@@ -940,9 +1230,9 @@ ModuleLevelTrigger::roi_readout_make_requests(dfmessages::TriggerDecision& decis
   int group_pick = pick_roi_group_conf();
   if (group_pick != -1) {
     roi_group this_group = m_roi_conf[m_roi_conf_ids[group_pick]];
-    std::vector<dfmessages::SourceID> links;
+    size_t first_new_request = decision.components.size();
 
-    // If mode is random, pick groups to request at random
+    // If mode is random, bulk-copy the template of each randomly picked group
     if (this_group.mode == "kRandom") {
       TLOG_DEBUG(TLVL_DEBUG_HIGH) << "[MLT] RAND";
       std::set<int> groups;
@@ -950,27 +1240,25 @@ ModuleLevelTrigger::roi_readout_make_requests(dfmessages::TriggerDecision& decis
         groups.insert(get_random_num_int());
       }
       for (auto r_id : groups) {
-        links.insert(links.end(), m_group_links[r_id].begin(), m_group_links[r_id].end());
+        decision.components.insert(decision.components.end(),
+                                   m_group_request_templates[r_id].begin(),
+                                   m_group_request_templates[r_id].end());
       }
-      // Otherwise, read sequntially by IDs, starting at 0
+      // Otherwise, copy the preassembled sequential template in one go
     } else {
       TLOG_DEBUG(TLVL_DEBUG_HIGH) << "[MLT] SEQ";
-      int r_id = 0;
-      while (r_id < this_group.n_links) {
-        links.insert(links.end(), m_group_links[r_id].begin(), m_group_links[r_id].end());
-        r_id++;
-      }
+      const auto& seq_template = m_roi_seq_request_templates[group_pick];
+      decision.components.insert(decision.components.end(), seq_template.begin(), seq_template.end());
     }
 
     TLOG_DEBUG(TLVL_DEBUG_HIGH) << "[MLT] TD timestamp: " << decision.trigger_timestamp;
     TLOG_DEBUG(TLVL_DEBUG_HIGH) << "[MLT] group window: " << this_group.time_window;
 
-    // Once the components are prepared, create requests and append them to decision
-    std::vector<dfmessages::ComponentRequest> requests =
-      create_all_decision_requests(links, decision.trigger_timestamp - this_group.time_window,
-                                   decision.trigger_timestamp + this_group.time_window);
-    add_requests_to_decision(decision, requests);
-    links.clear();
+    // Stamp the ROI window on the requests just appended
+    for (size_t i = first_new_request; i < decision.components.size(); ++i) {
+      decision.components[i].window_begin = decision.trigger_timestamp - this_group.time_window;
+      decision.components[i].window_end = decision.trigger_timestamp + this_group.time_window;
+    }
   }
   return;
 }
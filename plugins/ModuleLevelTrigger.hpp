@@ -15,8 +15,11 @@
 #define TRIGGER_PLUGINS_MODULELEVELTRIGGER_HPP_
 
 #include "trigger/Issues.hpp"
+#include "trigger/LatencyHistogram.hpp"
 #include "trigger/LivetimeCounter.hpp"
+#include "trigger/MetricSnapshot.hpp"
 #include "trigger/TokenManager.hpp"
+#include "trigger/moduleleveltrigger/Nljs.hpp"
 #include "trigger/moduleleveltriggerinfo/InfoNljs.hpp"
 
 #include "appfwk/DAQModule.hpp"
@@ -30,6 +33,10 @@
 #include "trgdataformats/Types.hpp"
 #include "triggeralgs/TriggerCandidate.hpp"
 
+#include <array>
+#include <bitset>
+#include <chrono>
+#include <cstdint>
 #include <map>
 #include <memory>
 #include <set>
@@ -74,19 +81,24 @@ private:
   void send_trigger_decisions();
   std::thread m_send_trigger_decisions_thread;
 
+  // Declarative placement for the decision thread (cpu_affinity/numa_node
+  // conf fields); applied at the top of send_trigger_decisions
+  std::vector<uint16_t> m_cpu_affinity; // NOLINT(build/unsigned)
+  int32_t m_numa_node{ -1 };
+
   void dfo_busy_callback(dfmessages::TriggerInhibit& inhibit);
 
   // Queue sources and sinks
   std::shared_ptr<iomanager::ReceiverConcept<triggeralgs::TriggerCandidate>> m_candidate_input;
+  size_t m_candidate_spy{ 0 }; // QueueSpy handle for the TC input
   std::shared_ptr<iomanager::ReceiverConcept<dfmessages::TriggerInhibit>> m_inhibit_input;
   std::string m_td_output_connection;
 
   // TD requests
   std::vector<dfmessages::SourceID> m_mandatory_links;
   std::map<int, std::vector<dfmessages::SourceID>> m_group_links;
-  nlohmann::json m_group_links_data;
   int m_total_group_links;
-  void parse_group_links(const nlohmann::json& data);
+  void parse_group_links(const moduleleveltrigger::group_links& data);
   void print_group_links();
   dfmessages::ComponentRequest create_request_for_link(dfmessages::SourceID link,
                                                        triggeralgs::timestamp_t start,
@@ -97,6 +109,14 @@ private:
   void add_requests_to_decision(dfmessages::TriggerDecision& decision,
                                 std::vector<dfmessages::ComponentRequest> requests);
 
+  // Precomputed ComponentRequest templates: the SourceID lists are fixed at
+  // configure time, so decisions are assembled by bulk-copying a template and
+  // fixing up the window bounds in one pass instead of rebuilding each
+  // request on every TD
+  std::vector<dfmessages::ComponentRequest> m_mandatory_request_template;
+  std::vector<dfmessages::ComponentRequest> m_full_request_template;
+  void build_request_templates();
+
   // ROI
   bool m_use_roi_readout;
   struct roi_group
@@ -107,12 +127,22 @@ private:
     std::string mode;
   };
   std::map<int, roi_group> m_roi_conf;
-  nlohmann::json m_roi_conf_data;
-  void parse_roi_conf(const nlohmann::json& data);
+  void parse_roi_conf(const moduleleveltrigger::roi_conf_map& data);
   void print_roi_conf(std::map<int, roi_group> roi_conf);
   std::vector<int> m_roi_conf_ids;
   std::vector<float> m_roi_conf_probs;
   std::vector<float> m_roi_conf_probs_c;
+  // Alias-method sampling table over the ROI group configurations, built at
+  // parse time so picking a configuration is two table lookups instead of a
+  // cumulative scan per decision
+  std::vector<float> m_roi_alias_prob;
+  std::vector<int> m_roi_alias;
+  // Preassembled ComponentRequest templates: one per link group (for random
+  // selection) and one concatenated list per sequential ROI configuration,
+  // so request emission is a bulk copy plus window stamping
+  std::vector<std::vector<dfmessages::ComponentRequest>> m_group_request_templates;
+  std::vector<std::vector<dfmessages::ComponentRequest>> m_roi_seq_request_templates;
+  void build_roi_sampling_tables();
   float get_random_num_float(float limit);
   int get_random_num_int();
   int pick_roi_group_conf();
@@ -124,6 +154,9 @@ private:
   std::atomic<bool> m_paused;
   std::atomic<bool> m_dfo_is_busy;
   std::atomic<bool> m_tc_merging;
+  // Extra slack when merging: TC windows within this many ticks of a pending
+  // TD's window are combined into it even without strict overlap
+  triggeralgs::timestamp_t m_merge_horizon_ticks{ 0 };
 
   dfmessages::trigger_number_t m_last_trigger_number;
 
@@ -148,11 +181,40 @@ private:
     triggeralgs::timestamp_t readout_start;
     triggeralgs::timestamp_t readout_end;
     int64_t walltime_expiration;
+    // Receipt time of the earliest contributing TC, for TC-to-TD latency
+    std::chrono::steady_clock::time_point earliest_arrival;
   };
   std::vector<PendingTD> m_pending_tds;
   std::vector<PendingTD> m_sent_tds;
   std::mutex m_td_vector_mutex;
 
+  // Bounded backpressure ring: decisions created while the DFO is busy are
+  // parked here instead of being dropped on the spot. The decision thread is
+  // both producer and consumer and the inhibit callback only flips
+  // m_dfo_is_busy, so the TC path takes no lock; storage is preallocated at
+  // configure time so inhibit flapping never allocates, and overflow drops
+  // the oldest parked decision. Each parked TD carries a wall-clock deadline
+  // (buffer_timeout ms) after which it is counted as expired rather than sent
+  struct ParkedDecision
+  {
+    dfmessages::TriggerDecision decision;
+    int64_t deadline{ 0 };
+    size_t n_tcs{ 0 };
+    std::chrono::steady_clock::time_point earliest_arrival;
+  };
+  std::vector<ParkedDecision> m_park_ring;
+  size_t m_park_capacity{ 0 };
+  std::atomic<size_t> m_park_head{ 0 };
+  std::atomic<size_t> m_park_tail{ 0 };
+  void park_decision(dfmessages::TriggerDecision&& decision,
+                     size_t n_tcs,
+                     std::chrono::steady_clock::time_point earliest_arrival);
+  void drain_parked_decisions();
+
+  // Upper bound on TCs drained from the input in one batch, so the ready-TD
+  // pass still runs regularly during sustained bursts
+  static constexpr size_t s_max_tc_batch = 64;
+
   void add_tc(const triggeralgs::TriggerCandidate& tc);
   void add_td(const PendingTD& pending_td);
   void add_tc_ignored(const triggeralgs::TriggerCandidate& tc);
@@ -171,22 +233,45 @@ private:
 
   // Bitwords logic
   bool m_use_bitwords;
-  nlohmann::json m_trigger_bitwords_json;
+  moduleleveltrigger::Bitwords m_trigger_bitwords_data;
   bool m_bitword_check;
   std::bitset<64> m_TD_bitword;
   std::vector<std::bitset<64>> m_trigger_bitwords;
+  // Flattened form of m_trigger_bitwords for the per-TD check: all
+  // single-bit requirement words collapse into one OR-mask (any hit means
+  // one of them is satisfied), and only multi-bit words - rare in practice
+  // - remain as a flat array of plain 64-bit require-masks
+  uint64_t m_bitword_single_mask{ 0 };        // NOLINT(build/unsigned)
+  std::vector<uint64_t> m_bitword_multi_masks; // NOLINT(build/unsigned)
   std::bitset<64> get_TD_bitword(const PendingTD& ready_td);
   void print_trigger_bitwords(std::vector<std::bitset<64>> trigger_bitwords);
   bool check_trigger_bitwords();
-  void print_bitword_flags(nlohmann::json m_trigger_bitwords_json);
+  void print_bitword_flags(const moduleleveltrigger::Bitwords& bitwords);
   void set_trigger_bitwords();
 
   // Readout map config
   bool m_use_readout_map;
-  nlohmann::json m_readout_window_map_data;
   std::map<trgdataformats::TriggerCandidateData::Type, std::pair<triggeralgs::timestamp_t, triggeralgs::timestamp_t>>
     m_readout_window_map;
-  void parse_readout_map(const nlohmann::json& data);
+  // Dense mirror of m_readout_window_map indexed by the TC type value, so
+  // the per-TC probe is a bit test and one load instead of a tree walk.
+  // Type values already fit in 64: get_TD_bitword packs them into a
+  // bitset<64>
+  static constexpr size_t s_tc_type_table_size = 64;
+  std::bitset<s_tc_type_table_size> m_readout_window_valid;
+  std::array<std::pair<triggeralgs::timestamp_t, triggeralgs::timestamp_t>, s_tc_type_table_size>
+    m_readout_window_table{};
+  bool has_readout_window(trgdataformats::TriggerCandidateData::Type type) const
+  {
+    auto idx = static_cast<size_t>(type);
+    return m_use_readout_map && idx < s_tc_type_table_size && m_readout_window_valid.test(idx);
+  }
+  const std::pair<triggeralgs::timestamp_t, triggeralgs::timestamp_t>& readout_window(
+    trgdataformats::TriggerCandidateData::Type type) const
+  {
+    return m_readout_window_table[static_cast<size_t>(type)];
+  }
+  void parse_readout_map(const moduleleveltrigger::tc_readout_map& data);
   void print_readout_map(std::map<trgdataformats::TriggerCandidateData::Type,
                                   std::pair<triggeralgs::timestamp_t, triggeralgs::timestamp_t>> map);
 
@@ -204,10 +289,8 @@ private:
   std::atomic<metric_counter_type> m_tc_received_count{ 0 };
   std::atomic<metric_counter_type> m_tc_ignored_count{ 0 };
   std::atomic<metric_counter_type> m_td_sent_count{ 0 };
-  std::atomic<metric_counter_type> m_new_td_sent_count{ 0 };
   std::atomic<metric_counter_type> m_td_sent_tc_count{ 0 };
   std::atomic<metric_counter_type> m_td_inhibited_count{ 0 };
-  std::atomic<metric_counter_type> m_new_td_inhibited_count{ 0 };
   std::atomic<metric_counter_type> m_td_inhibited_tc_count{ 0 };
   std::atomic<metric_counter_type> m_td_paused_count{ 0 };
   std::atomic<metric_counter_type> m_td_paused_tc_count{ 0 };
@@ -215,15 +298,36 @@ private:
   std::atomic<metric_counter_type> m_td_dropped_tc_count{ 0 };
   std::atomic<metric_counter_type> m_td_cleared_count{ 0 };
   std::atomic<metric_counter_type> m_td_cleared_tc_count{ 0 };
+  std::atomic<metric_counter_type> m_td_merged_count{ 0 };
+  std::atomic<metric_counter_type> m_td_standalone_count{ 0 };
   std::atomic<metric_counter_type> m_td_not_triggered_count{ 0 };
   std::atomic<metric_counter_type> m_td_not_triggered_tc_count{ 0 };
   std::atomic<metric_counter_type> m_td_total_count{ 0 };
-  std::atomic<metric_counter_type> m_new_td_total_count{ 0 };
+  std::atomic<metric_counter_type> m_td_parked_count{ 0 };
+  std::atomic<metric_counter_type> m_td_park_expired_count{ 0 };
+  std::atomic<metric_counter_type> m_td_park_overflow_count{ 0 };
   std::atomic<metric_counter_type> m_td_queue_timeout_expired_err_count{ 0 };
   std::atomic<metric_counter_type> m_td_queue_timeout_expired_err_tc_count{ 0 };
+  // TC receipt to TD dispatch wall-clock latency, log-binned; written only
+  // by the decision thread and snapshotted lock-free from get_info
+  LatencyHistogram m_tc_to_td_latency;
+  std::atomic<size_t> m_pending_td_depth{ 0 };
   std::atomic<metric_counter_type> m_lc_kLive{ 0 };
   std::atomic<metric_counter_type> m_lc_kPaused{ 0 };
   std::atomic<metric_counter_type> m_lc_kDead{ 0 };
+
+  // Latest complete Info record, published by the decision thread on its
+  // own cadence and copied out by get_info() on the opmon thread. The
+  // "new since last report" fields are derived in get_info() from the
+  // cumulative counts, against values only the opmon thread keeps
+  void publish_info();
+  void maybe_publish_info();
+  MetricSnapshot<moduleleveltriggerinfo::Info> m_info_snapshot;
+  static constexpr std::chrono::milliseconds s_snapshot_interval{ 100 };
+  std::chrono::steady_clock::time_point m_last_snapshot_time;
+  metric_counter_type m_last_reported_td_sent{ 0 };
+  metric_counter_type m_last_reported_td_inhibited{ 0 };
+  metric_counter_type m_last_reported_td_total{ 0 };
 };
 } // namespace trigger
 } // namespace dunedaq
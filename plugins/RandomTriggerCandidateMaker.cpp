@@ -168,20 +168,44 @@ RandomTriggerCandidateMaker::send_trigger_candidates()
   TLOG_DEBUG(TLVL_DEBUG_LOW) << "[RTCM] " << get_name() << " initial timestamp estimate is " << initial_timestamp
                 << ", next_trigger_timestamp is " << next_trigger_timestamp;
 
+  // Candidate times are precomputed in batches of absolute timestamps, so
+  // the per-candidate work in the loop is just a comparison and a send. At
+  // kHz rates several candidates can fall due within one wakeup; all of
+  // them are emitted before sleeping again, and since the schedule holds
+  // absolute deadlines, emission jitter does not accumulate.
+  static constexpr size_t s_schedule_batch_size = 256;
+  std::vector<dfmessages::timestamp_t> schedule;
+  schedule.reserve(s_schedule_batch_size);
+  size_t schedule_index = 0;
+
   while (m_running_flag.load()) {
-    if (m_timestamp_estimator->wait_for_timestamp(next_trigger_timestamp, m_running_flag) ==
+    if (schedule_index == schedule.size()) {
+      // Draw the next batch of intervals in one pass
+      schedule.clear();
+      for (size_t i = 0; i < s_schedule_batch_size; ++i) {
+        schedule.push_back(next_trigger_timestamp);
+        next_trigger_timestamp += get_interval(gen);
+      }
+      schedule_index = 0;
+    }
+
+    if (m_timestamp_estimator->wait_for_timestamp(schedule[schedule_index], m_running_flag) ==
         utilities::TimestampEstimatorBase::kInterrupted) {
       break;
     }
 
-    triggeralgs::TriggerCandidate candidate = create_candidate(next_trigger_timestamp);
+    // Emit every candidate whose scheduled time has arrived by this wakeup
+    dfmessages::timestamp_t timestamp_estimate = m_timestamp_estimator->get_timestamp_estimate();
+    while (schedule_index < schedule.size() && schedule[schedule_index] <= timestamp_estimate) {
+      triggeralgs::TriggerCandidate candidate = create_candidate(schedule[schedule_index]);
 
-    TLOG_DEBUG(TLVL_DEBUG_MEDIUM) << "[RTCM] " << get_name() << " at timestamp " << m_timestamp_estimator->get_timestamp_estimate()
-                  << ", pushing a candidate with timestamp " << candidate.time_candidate;
-    m_trigger_candidate_sink->send(std::move(candidate), std::chrono::milliseconds(10));
-    m_tc_sent_count++;
+      TLOG_DEBUG(TLVL_DEBUG_MEDIUM) << "[RTCM] " << get_name() << " at timestamp " << timestamp_estimate
+                    << ", pushing a candidate with timestamp " << candidate.time_candidate;
+      m_trigger_candidate_sink->send(std::move(candidate), std::chrono::milliseconds(10));
+      m_tc_sent_count++;
 
-    next_trigger_timestamp += get_interval(gen);
+      ++schedule_index;
+    }
   }
 }
 
@@ -0,0 +1,117 @@
+/**
+ * @file StallWatchdog.cpp
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2021.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#include "StallWatchdog.hpp"
+#include "trigger/Logging.hpp"
+
+#include <string>
+#include <thread>
+
+using dunedaq::trigger::logging::TLVL_GENERAL;
+
+namespace dunedaq {
+namespace trigger {
+
+StallWatchdog::StallWatchdog(const std::string& name)
+  : DAQModule(name)
+  , m_thread(std::bind(&StallWatchdog::do_work, this))
+{
+  register_command("conf", &StallWatchdog::do_conf);
+  register_command("start", &StallWatchdog::do_start);
+  register_command("stop", &StallWatchdog::do_stop);
+}
+
+void
+StallWatchdog::init(const nlohmann::json& /*iniobj*/)
+{
+  // Deliberately connectionless: everything this module watches arrives
+  // through the WorkerLiveness registry
+}
+
+void
+StallWatchdog::get_info(opmonlib::InfoCollector& ci, int /*level*/)
+{
+  stallwatchdoginfo::Info i;
+  i.n_workers = WorkerLiveness::get_instance().size();
+  i.stalled_workers = m_stalled_workers.load();
+  i.stall_events = m_stall_events.load();
+  ci.add(i);
+}
+
+void
+StallWatchdog::do_conf(const nlohmann::json& conf_arg)
+{
+  m_conf = conf_arg.get<dunedaq::trigger::stallwatchdog::Conf>();
+  TLOG_DEBUG(TLVL_GENERAL) << "[SW] Configured the StallWatchdog!";
+}
+
+void
+StallWatchdog::do_start(const nlohmann::json&)
+{
+  m_prev_iterations.fill(0);
+  m_last_progress.fill(std::chrono::steady_clock::now());
+  m_flagged.fill(false);
+  m_stall_events = 0;
+  m_stalled_workers = 0;
+  m_running_flag.store(true);
+  m_thread.start_working_thread("stall-watchdog");
+  TLOG_DEBUG(TLVL_GENERAL) << "[SW] " << get_name() + " successfully started.";
+}
+
+void
+StallWatchdog::do_stop(const nlohmann::json&)
+{
+  m_running_flag.store(false);
+  m_thread.stop_working_thread();
+  TLOG_DEBUG(TLVL_GENERAL) << "[SW] " << get_name() + " successfully stopped.";
+}
+
+void
+StallWatchdog::do_work()
+{
+  WorkerLiveness& liveness = WorkerLiveness::get_instance();
+  while (m_running_flag.load()) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(m_conf.poll_interval_ms));
+    auto now = std::chrono::steady_clock::now();
+
+    const size_t n = liveness.size();
+    uint64_t stalled = 0; // NOLINT(build/unsigned)
+    for (size_t w = 0; w < n; ++w) {
+      const WorkerLiveness::WorkerStats& ws = liveness.stats(w);
+      uint64_t iterations = ws.iterations.load(std::memory_order_relaxed); // NOLINT(build/unsigned)
+      if (iterations != m_prev_iterations[w] || !ws.active.load(std::memory_order_relaxed)) {
+        // Progress (or between runs): clear any standing flag
+        m_prev_iterations[w] = iterations;
+        m_last_progress[w] = now;
+        if (m_flagged[w]) {
+          m_flagged[w] = false;
+          TLOG() << "[SW] Worker " << ws.name << " is making progress again";
+        }
+        continue;
+      }
+      auto stalled_ms =
+        std::chrono::duration_cast<std::chrono::milliseconds>(now - m_last_progress[w]).count();
+      if (stalled_ms >= static_cast<int64_t>(m_conf.stall_deadline_ms)) {
+        ++stalled;
+        if (!m_flagged[w]) {
+          m_flagged[w] = true;
+          ++m_stall_events;
+          const char* stage = ws.stage.load(std::memory_order_relaxed);
+          ers::warning(WorkerStalled(
+            ERS_HERE, ws.name, static_cast<uint64_t>(stalled_ms), stage ? stage : "unknown")); // NOLINT(build/unsigned)
+        }
+      }
+    }
+    m_stalled_workers.store(stalled);
+  }
+}
+
+} // namespace trigger
+} // namespace dunedaq
+
+DEFINE_DUNE_DAQ_MODULE(dunedaq::trigger::StallWatchdog)
@@ -0,0 +1,73 @@
+/**
+ * @file StallWatchdog.hpp
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2021.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#ifndef TRIGGER_PLUGINS_STALLWATCHDOG_HPP_
+#define TRIGGER_PLUGINS_STALLWATCHDOG_HPP_
+
+#include "trigger/Issues.hpp"
+#include "trigger/WorkerLiveness.hpp"
+#include "trigger/stallwatchdog/Nljs.hpp"
+#include "trigger/stallwatchdoginfo/InfoNljs.hpp"
+
+#include "appfwk/DAQModule.hpp"
+#include "utilities/WorkerThread.hpp"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <string>
+
+namespace dunedaq {
+namespace trigger {
+
+/**
+ * @brief StallWatchdog samples the WorkerLiveness registry and flags any
+ * active worker whose iteration counter has not moved within the
+ * configured deadline: a wedged maker thread is reported within a second
+ * instead of surfacing as silently rising queue depths until the run
+ * dies. The warning carries the stage the worker was last seen entering
+ * (receive/process/send), and recovery is logged when the counter moves
+ * again. One instance per process is enough; it owns no connections.
+ */
+class StallWatchdog : public dunedaq::appfwk::DAQModule
+{
+public:
+  explicit StallWatchdog(const std::string& name);
+
+  StallWatchdog(const StallWatchdog&) = delete;
+  StallWatchdog& operator=(const StallWatchdog&) = delete;
+  StallWatchdog(StallWatchdog&&) = delete;
+  StallWatchdog& operator=(StallWatchdog&&) = delete;
+
+  void init(const nlohmann::json& iniobj) override;
+  void get_info(opmonlib::InfoCollector& ci, int level) override;
+
+private:
+  void do_conf(const nlohmann::json& config);
+  void do_start(const nlohmann::json& obj);
+  void do_stop(const nlohmann::json& obj);
+  void do_work();
+
+  dunedaq::utilities::WorkerThread m_thread;
+
+  dunedaq::trigger::stallwatchdog::Conf m_conf;
+
+  // Per-worker sampling state; watchdog thread only
+  std::array<uint64_t, WorkerLiveness::s_max_workers> m_prev_iterations{}; // NOLINT(build/unsigned)
+  std::array<std::chrono::steady_clock::time_point, WorkerLiveness::s_max_workers> m_last_progress;
+  std::array<bool, WorkerLiveness::s_max_workers> m_flagged{};
+
+  std::atomic<uint64_t> m_stall_events{ 0 };    // NOLINT(build/unsigned)
+  std::atomic<uint64_t> m_stalled_workers{ 0 }; // NOLINT(build/unsigned)
+
+  std::atomic<bool> m_running_flag{ false };
+};
+} // namespace trigger
+} // namespace dunedaq
+
+#endif // TRIGGER_PLUGINS_STALLWATCHDOG_HPP_
@@ -9,128 +9,108 @@
 #ifndef TRIGGER_PLUGINS_TCBUFFER_HPP_
 #define TRIGGER_PLUGINS_TCBUFFER_HPP_
 
-#include "appfwk/DAQModule.hpp"
-#include "daqdataformats/Fragment.hpp"
-#include "iomanager/Receiver.hpp"
-
-#include "readoutlibs/FrameErrorRegistry.hpp"
-#include "readoutlibs/models/DefaultRequestHandlerModel.hpp"
-#include "readoutlibs/models/SkipListLatencyBufferModel.hpp"
-#include "readoutlibs/models/DefaultSkipListRequestHandler.hpp"
+#include "TXBuffer.hpp"
 #include "triggeralgs/TriggerActivity.hpp"
-#include "triggeralgs/TriggerObjectOverlay.hpp"
-#include "utilities/WorkerThread.hpp"
-
-#include "trigger/Issues.hpp"
 #include "triggeralgs/TriggerCandidate.hpp"
-
-#include <chrono>
-#include <map>
-#include <memory>
-#include <string>
-#include <utility>
+#include "triggeralgs/TriggerObjectOverlay.hpp"
 
 namespace dunedaq {
 namespace trigger {
-class TCBuffer : public dunedaq::appfwk::DAQModule
+
+// Stores the TC as its flat overlay blob only, serialized once at insert
+// time with a single-pass size calculation and direct write into the
+// payload buffer. The overlay is what fragments are built from anyway, and
+// dropping the embedded triggeralgs::TriggerCandidate (whose inputs vector
+// of TAs made every buffered TC a multi-allocation object) means a TC is
+// flattened exactly once in its lifetime.
+struct TCWrapper
 {
-public:
-  explicit TCBuffer(const std::string& name);
+  std::vector<uint8_t> candidate_overlay_buffer;
 
-  TCBuffer(const TCBuffer&) = delete;
-  TCBuffer& operator=(const TCBuffer&) = delete;
-  TCBuffer(TCBuffer&&) = delete;
-  TCBuffer& operator=(TCBuffer&&) = delete;
+  // Don't really want this default ctor, but IterableQueueModel requires it
+  TCWrapper() {}
 
-  void init(const nlohmann::json& iniobj) override;
-  void get_info(opmonlib::InfoCollector& ci, int level) override;
+  TCWrapper(const triggeralgs::TriggerCandidate& c)
+  {
+    candidate_overlay_buffer.resize(triggeralgs::get_overlay_nbytes(c));
+    triggeralgs::write_overlay(c, candidate_overlay_buffer.data());
+  }
 
-private:
+  trgdataformats::TriggerCandidate* overlay()
+  {
+    return reinterpret_cast<trgdataformats::TriggerCandidate*>(candidate_overlay_buffer.data());
+  }
 
-  struct TCWrapper
+  const trgdataformats::TriggerCandidate* overlay() const
   {
-    triggeralgs::TriggerCandidate candidate;
-    std::vector<uint8_t> candidate_overlay_buffer;
-    // Don't really want this default ctor, but IterableQueueModel requires it
-    TCWrapper() {}
-    
-    TCWrapper(triggeralgs::TriggerCandidate c)
-      : candidate(c)
-    {
-      populate_buffer();
-    }
-
-    void populate_buffer()
-    {
-      candidate_overlay_buffer.resize(triggeralgs::get_overlay_nbytes(candidate));
-      triggeralgs::write_overlay(candidate, candidate_overlay_buffer.data());
-    }
-    
-    // comparable based on first timestamp
-    bool operator<(const TCWrapper& other) const
-    {
-      return this->candidate.time_start < other.candidate.time_start;
-    }
-
-    uint64_t get_first_timestamp() const // NOLINT(build/unsigned)
-    {
-      return candidate.time_start;
-    }
-
-    void set_first_timestamp(uint64_t ts) // NOLINT(build/unsigned)
-    {
-      candidate.time_start = ts;
-    }
-
-    size_t get_payload_size() { return candidate_overlay_buffer.size(); }
-
-    size_t get_num_frames() { return 1; }
-
-    size_t get_frame_size() { return get_payload_size(); }
-
-    uint8_t* begin()
-    {
-      return candidate_overlay_buffer.data();
-    }
-    
-    uint8_t* end()
-    {
-      return candidate_overlay_buffer.data()+candidate_overlay_buffer.size();
-    }
-
-    //static const constexpr size_t fixed_payload_size = 5568;
-    static const constexpr daqdataformats::SourceID::Subsystem subsystem = daqdataformats::SourceID::Subsystem::kTrigger;
-    static const constexpr daqdataformats::FragmentType fragment_type = daqdataformats::FragmentType::kTriggerCandidate;
-    // No idea what this should really be set to
-    static const constexpr uint64_t expected_tick_difference = 16; // NOLINT(build/unsigned)
+    return reinterpret_cast<const trgdataformats::TriggerCandidate*>(candidate_overlay_buffer.data());
+  }
 
-};
+  // comparable based on first timestamp
+  bool operator<(const TCWrapper& other) const
+  {
+    return this->get_first_timestamp() < other.get_first_timestamp();
+  }
 
-  void do_conf(const nlohmann::json& config);
-  void do_start(const nlohmann::json& obj);
-  void do_stop(const nlohmann::json& obj);
-  void do_scrap(const nlohmann::json& obj);
-  void do_work(std::atomic<bool>&);
+  uint64_t get_first_timestamp() const // NOLINT(build/unsigned)
+  {
+    return overlay()->data.time_start;
+  }
 
-  dunedaq::utilities::WorkerThread m_thread;
+  void set_first_timestamp(uint64_t ts) // NOLINT(build/unsigned)
+  {
+    overlay()->data.time_start = ts;
+  }
 
-  using tcs_source_t = iomanager::ReceiverConcept<triggeralgs::TriggerCandidate>;
-  std::shared_ptr<tcs_source_t> m_input_queue_tcs{nullptr};
+  size_t get_payload_size() { return candidate_overlay_buffer.size(); }
 
-  using dr_source_t = iomanager::ReceiverConcept<dfmessages::DataRequest>;
-  std::shared_ptr<dr_source_t> m_input_queue_dr{nullptr};
+  size_t get_num_frames() { return 1; }
 
-  std::chrono::milliseconds m_queue_timeout;
+  size_t get_frame_size() { return get_payload_size(); }
 
-  using buffer_object_t = TCWrapper;
-  using latency_buffer_t = readoutlibs::SkipListLatencyBufferModel<buffer_object_t>;
-  std::unique_ptr<latency_buffer_t> m_latency_buffer_impl{nullptr};
-  using request_handler_t = readoutlibs::DefaultSkipListRequestHandler<buffer_object_t>;
-  std::unique_ptr<request_handler_t> m_request_handler_impl{nullptr};
+  uint8_t* begin()
+  {
+    return candidate_overlay_buffer.data();
+  }
 
-  // Don't actually use this, but it's currently needed as arg to request handler ctor
-  std::unique_ptr<readoutlibs::FrameErrorRegistry> m_error_registry;
+  uint8_t* end()
+  {
+    return candidate_overlay_buffer.data()+candidate_overlay_buffer.size();
+  }
+
+  //static const constexpr size_t fixed_payload_size = 5568;
+  static const constexpr daqdataformats::SourceID::Subsystem subsystem = daqdataformats::SourceID::Subsystem::kTrigger;
+  static const constexpr daqdataformats::FragmentType fragment_type = daqdataformats::FragmentType::kTriggerCandidate;
+  // No idea what this should really be set to
+  static const constexpr uint64_t expected_tick_difference = 16; // NOLINT(build/unsigned)
+
+};
+
+struct TCBufferTraits
+{
+  using wrapper_t = TCWrapper;
+  using input_t = triggeralgs::TriggerCandidate;
+
+  static constexpr const char* input_connection = "tc_source";
+  static constexpr const char* log_prefix = "[TCB] ";
+  static constexpr const char* thread_name = "tcbuffer";
+  static constexpr const char* object_name = "TCs";
+  static constexpr bool send_partial_fragments = true;
+
+  static uint64_t shard_key(const triggeralgs::TriggerCandidate& tc) // NOLINT(build/unsigned)
+  {
+    return tc.time_start;
+  }
+
+  template<typename F>
+  static void for_each_object(const input_t& in, F&& f)
+  {
+    f(in);
+  }
 };
+
+using TCBuffer = TXBuffer<TCBufferTraits>;
+
 } // namespace trigger
 } // namespace dunedaq
 
@@ -13,7 +13,13 @@
 #include "iomanager/IOManager.hpp"
 #include "triggeralgs/TriggerPrimitive.hpp"
 
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#include <cstring>
 #include <string>
+#include <utility>
 
 using dunedaq::trigger::logging::TLVL_GENERAL;
 using dunedaq::trigger::logging::TLVL_IMPORTANT;
@@ -50,12 +56,30 @@ TPChannelFilter::init(const nlohmann::json& iniobj)
 void 
 TPChannelFilter::get_info(opmonlib::InfoCollector& ci, int /*level*/)
 {
+  // Report the snapshot the worker thread last published, so the opmon
+  // poll doesn't read the filter loop's counters directly
   tpchannelfilterinfo::Info i;
+  m_info_snapshot.read(i);
+  ci.add(i);
+}
 
+void
+TPChannelFilter::publish_info()
+{
+  tpchannelfilterinfo::Info i;
   i.received_count = m_received_count.load();
   i.sent_count = m_sent_count.load();
+  m_info_snapshot.publish(i);
+}
 
-  ci.add(i);
+void
+TPChannelFilter::maybe_publish_info()
+{
+  auto now = std::chrono::steady_clock::now();
+  if (now - m_last_snapshot_time >= s_snapshot_interval) {
+    m_last_snapshot_time = now;
+    publish_info();
+  }
 }
 
 void
@@ -63,6 +87,16 @@ TPChannelFilter::do_conf(const nlohmann::json& conf_arg)
 {
   m_conf = conf_arg.get<dunedaq::trigger::tpchannelfilter::Conf>();
   m_channel_map = dunedaq::detchannelmaps::make_map(m_conf.channel_map_name);
+
+  // Precompute the keep/remove decision for the whole channel range once,
+  // so the hot path never touches the channel map. Three guard bytes past
+  // the logical table keep the vector kernel's 4-byte gathers at the very
+  // last channels in bounds
+  m_remove_table.resize(s_channel_table_size + 3);
+  for (size_t channel = 0; channel < s_channel_table_size; ++channel) {
+    m_remove_table[channel] = compute_channel_should_be_removed(static_cast<int>(channel)) ? 1 : 0;
+  }
+
   TLOG_DEBUG(TLVL_GENERAL) << "[TPCF] Configured the TPChannelFilter!";
 }
 
@@ -86,10 +120,88 @@ TPChannelFilter::do_stop(const nlohmann::json&)
 
 void
 TPChannelFilter::do_scrap(const nlohmann::json&)
-{}
+{
+  m_remove_table.clear();
+}
 
 bool
 TPChannelFilter::channel_should_be_removed(int channel) const
+{
+  if (channel >= 0 && static_cast<size_t>(channel) < s_channel_table_size && !m_remove_table.empty()) {
+    return m_remove_table[channel] != 0;
+  }
+  return compute_channel_should_be_removed(channel);
+}
+
+size_t
+TPChannelFilter::filter_tpset(TPSet& tpset)
+{
+  const size_t n = tpset.objects.size();
+  m_scratch_channel.resize(n);
+  m_scratch_remove.resize(n);
+
+  // Pass 1: peel the tested fields out of the AoS TriggerPrimitives into
+  // flat arrays. The ToT test needs no table lookup, so it is folded into
+  // the initial mask here
+  for (size_t i = 0; i < n; ++i) {
+    const triggeralgs::TriggerPrimitive& p = tpset.objects[i];
+    m_scratch_channel[i] = p.channel;
+    m_scratch_remove[i] = p.time_over_threshold > m_conf.max_time_over_threshold ? 1 : 0;
+  }
+
+  // Pass 2: remove-table classification over the flat channel array. This
+  // is the highest-frequency loop in the chain (every TP of every link
+  // crosses it), hence the explicit 8-channels-per-gather AVX2 kernel;
+  // the scalar tail below is also the whole story on other targets
+  size_t i = 0;
+#if defined(__AVX2__)
+  {
+    const int* table32 = reinterpret_cast<const int*>(m_remove_table.data()); // NOLINT
+    const __m256i upper = _mm256_set1_epi32(static_cast<int>(s_channel_table_size));
+    const __m256i minus_one = _mm256_set1_epi32(-1);
+    const __m256i bytemask = _mm256_set1_epi32(0xff);
+    for (; i + 8 <= n; i += 8) {
+      __m256i ch = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&m_scratch_channel[i])); // NOLINT
+      // Any channel outside the table (negative or huge) needs the channel
+      // map; finish on the scalar path. None occur for the supported maps
+      __m256i in_range = _mm256_and_si256(_mm256_cmpgt_epi32(upper, ch), _mm256_cmpgt_epi32(ch, minus_one));
+      if (_mm256_movemask_epi8(in_range) != -1) {
+        break;
+      }
+      __m256i removed = _mm256_and_si256(_mm256_i32gather_epi32(table32, ch, 1), bytemask);
+      // Pack the 8 lane results down to bytes and OR them into the mask
+      __m128i packed16 = _mm_packs_epi32(_mm256_castsi256_si128(removed), _mm256_extracti128_si256(removed, 1));
+      __m128i packed8 = _mm_packus_epi16(packed16, _mm_setzero_si128());
+      uint64_t lanes = static_cast<uint64_t>(_mm_cvtsi128_si64(packed8)); // NOLINT(build/unsigned)
+      uint64_t mask_bytes;                                                // NOLINT(build/unsigned)
+      std::memcpy(&mask_bytes, &m_scratch_remove[i], sizeof(mask_bytes));
+      mask_bytes |= lanes;
+      std::memcpy(&m_scratch_remove[i], &mask_bytes, sizeof(mask_bytes));
+    }
+  }
+#endif
+  for (; i < n; ++i) {
+    m_scratch_remove[i] |= channel_should_be_removed(m_scratch_channel[i]) ? 1 : 0;
+  }
+
+  // Pass 3: compact survivors in place, preserving order. As before, when
+  // nothing is removed - the common case for a well-mapped detector - the
+  // moves are all self-assignment-free no-ops and no allocation happens
+  size_t kept = 0;
+  for (size_t j = 0; j < n; ++j) {
+    if (m_scratch_remove[j] == 0) {
+      if (kept != j) {
+        tpset.objects[kept] = std::move(tpset.objects[j]);
+      }
+      ++kept;
+    }
+  }
+  tpset.objects.erase(tpset.objects.begin() + kept, tpset.objects.end());
+  return n - kept;
+}
+
+bool
+TPChannelFilter::compute_channel_should_be_removed(int channel) const
 {
   // The plane numbering convention is found in detchannelmaps/plugins/VDColdboxChannelMap.cpp and is:
   // U (induction) = 0, Y (induction) = 1, Z (induction) = 2, unconnected channel = 9999
@@ -127,6 +239,7 @@ TPChannelFilter::do_work()
       if (!m_running_flag.load()) {
         break;
       } else {
+        maybe_publish_info();
         continue;
       }
     }
@@ -134,15 +247,19 @@ TPChannelFilter::do_work()
     // If we got here, we got a TPSet
     ++m_received_count;
 
-    // Actually do the removal for payload TPSets. Leave heartbeat TPSets unmolested
+    // Actually do the removal for payload TPSets. Leave heartbeat TPSets
+    // unmolested. The compaction is in place in the received set's own
+    // vector and the set is forwarded by move below
     if (tpset->type == TPSet::kPayload) {
       size_t n_before = tpset->objects.size();
-      auto it = std::remove_if(tpset->objects.begin(), tpset->objects.end(), [this](triggeralgs::TriggerPrimitive p) {
-        return channel_should_be_removed(p.channel) || 
-               (p.time_over_threshold > m_conf.max_time_over_threshold);
-      });
-      tpset->objects.erase(it, tpset->objects.end());
-      size_t n_after = tpset->objects.size();
+      size_t n_removed = filter_tpset(*tpset);
+      size_t n_after = n_before - n_removed;
+      if (n_after != n_before && !tpset->objects.empty()) {
+        // Patch the set's window to what actually survived (TPs within a
+        // set are time-ordered)
+        tpset->start_time = tpset->objects.front().time_start;
+        tpset->end_time = tpset->objects.back().time_start;
+      }
       TLOG_DEBUG(TLVL_DEBUG_MEDIUM) << "[TPCF] Removed " << (n_before - n_after) << " TPs out of " << n_before << " TPs remaining: " << n_after;
     }
 
@@ -159,7 +276,10 @@ TPChannelFilter::do_work()
       }
     }
 
+    maybe_publish_info();
   } // while
+  // Final snapshot so the end-of-run totals are what opmon reports
+  publish_info();
   TLOG_DEBUG(TLVL_GENERAL) << "[TPCF] Exiting do_work() method";
 }
 
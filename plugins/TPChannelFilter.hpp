@@ -10,6 +10,7 @@
 #define TRIGGER_PLUGINS_TPCHANNELFILTER_HPP_
 
 #include "trigger/Issues.hpp"
+#include "trigger/MetricSnapshot.hpp"
 #include "trigger/TPSet.hpp"
 #include "trigger/tpchannelfilter/Nljs.hpp"
 #include "trigger/tpchannelfilterinfo/InfoNljs.hpp"
@@ -21,11 +22,13 @@
 #include "utilities/WorkerThread.hpp"
 
 #include <chrono>
+#include <cstdint>
 #include <map>
 #include <memory>
 #include <string>
 #include <unordered_set>
 #include <utility>
+#include <vector>
 
 namespace dunedaq {
 namespace trigger {
@@ -50,12 +53,39 @@ private:
   void do_work();
 
   bool channel_should_be_removed(int channel) const;
+  bool compute_channel_should_be_removed(int channel) const;
+
+  // Filter a payload set's TPs in place and return how many were removed.
+  // Runs as a mask-then-compact kernel over flat per-set scratch arrays
+  // (see the comments in the implementation), with a vectorized
+  // classification pass on targets built with AVX2
+  size_t filter_tpset(TPSet& tpset);
+
+  // SoA view of the fields the filter tests, peeled out of the set's
+  // TriggerPrimitives per call and reused across sets
+  std::vector<int32_t> m_scratch_channel;
+  std::vector<uint8_t> m_scratch_remove;
+
+  // Dense per-channel removal decisions, precomputed at do_conf so the
+  // per-TP check is one array load instead of a channel-map virtual call.
+  // Channels beyond the table (none, for the supported maps) fall back to
+  // the channel map
+  static constexpr size_t s_channel_table_size = 1 << 21;
+  std::vector<uint8_t> m_remove_table;
   dunedaq::utilities::WorkerThread m_thread;
 
   using metric_counter_type = decltype(tpchannelfilterinfo::Info::received_count);
   std::atomic<metric_counter_type> m_received_count;
   std::atomic<metric_counter_type> m_sent_count;
 
+  // Latest Info record, published by the worker thread on its own cadence
+  // and copied out by get_info() on the opmon thread
+  void publish_info();
+  void maybe_publish_info();
+  MetricSnapshot<tpchannelfilterinfo::Info> m_info_snapshot;
+  static constexpr std::chrono::milliseconds s_snapshot_interval{ 100 };
+  std::chrono::steady_clock::time_point m_last_snapshot_time;
+
   using source_t = dunedaq::iomanager::ReceiverConcept<TPSet>;
   std::shared_ptr<source_t> m_input_queue;
   using sink_t = dunedaq::iomanager::SenderConcept<TPSet>;
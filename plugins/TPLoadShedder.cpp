@@ -0,0 +1,263 @@
+/**
+ * @file TPLoadShedder.cpp
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2021.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#include "TPLoadShedder.hpp"
+#include "trigger/Logging.hpp"
+
+#include "appfwk/DAQModuleHelper.hpp"
+#include "iomanager/IOManager.hpp"
+#include "triggeralgs/TriggerPrimitive.hpp"
+
+#include <algorithm>
+#include <string>
+
+using dunedaq::trigger::logging::TLVL_GENERAL;
+using dunedaq::trigger::logging::TLVL_DEBUG_MEDIUM;
+
+namespace dunedaq {
+namespace trigger {
+
+TPLoadShedder::TPLoadShedder(const std::string& name)
+  : DAQModule(name)
+  , m_thread(std::bind(&TPLoadShedder::do_work, this))
+  , m_received_count(0)
+  , m_sent_count(0)
+  , m_shed_tp_count(0)
+  , m_shed_set_count(0)
+  , m_pressure_event_count(0)
+  , m_level_change_count(0)
+  , m_input_queue(nullptr)
+  , m_output_queue(nullptr)
+  , m_queue_timeout(100)
+{
+  register_command("conf", &TPLoadShedder::do_conf);
+  register_command("start", &TPLoadShedder::do_start);
+  register_command("stop", &TPLoadShedder::do_stop);
+}
+
+void
+TPLoadShedder::init(const nlohmann::json& iniobj)
+{
+  try {
+    m_input_queue = get_iom_receiver<TPSet>(appfwk::connection_uid(iniobj, "tpset_source"));
+    m_output_queue = get_iom_sender<TPSet>(appfwk::connection_uid(iniobj, "tpset_sink"));
+  } catch (const ers::Issue& excpt) {
+    throw dunedaq::trigger::InvalidQueueFatalError(ERS_HERE, get_name(), "input/output", excpt);
+  }
+}
+
+void
+TPLoadShedder::get_info(opmonlib::InfoCollector& ci, int /*level*/)
+{
+  // Report the snapshot the worker thread last published, so the opmon
+  // poll doesn't read the shedding loop's state directly
+  tploadshedderinfo::Info i;
+  m_info_snapshot.read(i);
+  ci.add(i);
+}
+
+void
+TPLoadShedder::publish_info()
+{
+  tploadshedderinfo::Info i;
+  i.received_count = m_received_count.load();
+  i.sent_count = m_sent_count.load();
+  i.shed_tp_count = m_shed_tp_count.load();
+  i.shed_set_count = m_shed_set_count.load();
+  i.pressure_event_count = m_pressure_event_count.load();
+  i.level_change_count = m_level_change_count.load();
+  i.current_level = m_level;
+  i.current_adc_floor = m_adc_floor;
+  m_info_snapshot.publish(i);
+}
+
+void
+TPLoadShedder::maybe_publish_info()
+{
+  auto now = std::chrono::steady_clock::now();
+  if (now - m_last_snapshot_time >= s_snapshot_interval) {
+    m_last_snapshot_time = now;
+    publish_info();
+  }
+}
+
+void
+TPLoadShedder::do_conf(const nlohmann::json& conf_arg)
+{
+  m_conf = conf_arg.get<dunedaq::trigger::tploadshedder::Conf>();
+  TLOG_DEBUG(TLVL_GENERAL) << "[TPLS] Configured the TPLoadShedder!";
+}
+
+void
+TPLoadShedder::do_start(const nlohmann::json&)
+{
+  m_running_flag.store(true);
+  m_received_count.store(0);
+  m_sent_count.store(0);
+  m_shed_tp_count.store(0);
+  m_shed_set_count.store(0);
+  m_pressure_event_count.store(0);
+  m_level_change_count.store(0);
+  m_level = 0;
+  m_adc_floor = 0;
+  m_pressure_streak = 0;
+  m_clean_streak = 0;
+  m_thread.start_working_thread("loadshedder");
+  TLOG_DEBUG(TLVL_GENERAL) << "[TPLS] " << get_name() + " successfully started.";
+}
+
+void
+TPLoadShedder::do_stop(const nlohmann::json&)
+{
+  m_running_flag.store(false);
+  m_thread.stop_working_thread();
+  TLOG_DEBUG(TLVL_GENERAL) << "[TPLS] " << get_name() + " successfully stopped.";
+}
+
+uint64_t // NOLINT(build/unsigned)
+TPLoadShedder::channel_cap_for_level() const
+{
+  if (m_level == 0 || m_conf.channel_cap_base == 0) {
+    return 0; // no cap
+  }
+  uint64_t cap = m_conf.channel_cap_base >> (m_level - 1); // NOLINT(build/unsigned)
+  return std::max<uint64_t>(cap, 1);                       // NOLINT(build/unsigned)
+}
+
+void
+TPLoadShedder::set_level(uint64_t level) // NOLINT(build/unsigned)
+{
+  level = std::min(level, m_conf.max_level);
+  if (level == m_level) {
+    return;
+  }
+  m_level = level;
+  m_adc_floor = m_conf.adc_floor_step * m_level;
+  ++m_level_change_count;
+  if (m_level > 0) {
+    ers::warning(LoadSheddingLevelChanged(ERS_HERE, get_name(), m_level, m_adc_floor, channel_cap_for_level()));
+  } else {
+    TLOG() << "[TPLS] " << get_name() << ": output pressure relieved, shedding disengaged (pass-through)";
+  }
+}
+
+void
+TPLoadShedder::note_send(bool pressured)
+{
+  if (pressured) {
+    ++m_pressure_event_count;
+    m_clean_streak = 0;
+    if (++m_pressure_streak >= m_conf.escalate_after) {
+      m_pressure_streak = 0;
+      set_level(m_level + 1);
+    }
+  } else {
+    m_pressure_streak = 0;
+    if (m_level > 0 && ++m_clean_streak >= m_conf.relax_after) {
+      m_clean_streak = 0;
+      set_level(m_level - 1);
+    }
+  }
+}
+
+void
+TPLoadShedder::shed(TPSet& tpset)
+{
+  const uint64_t cap = channel_cap_for_level(); // NOLINT(build/unsigned)
+  if (cap > 0) {
+    m_channel_counts.clear();
+  }
+  size_t n_before = tpset.objects.size();
+  // In-place compaction as in TPChannelFilter: when nothing is shed - the
+  // usual case even under load, for quiet channels - no allocation happens
+  auto it =
+    std::remove_if(tpset.objects.begin(), tpset.objects.end(), [&](const triggeralgs::TriggerPrimitive& p) {
+      if (m_adc_floor > 0 && p.adc_integral < m_adc_floor) {
+        return true;
+      }
+      if (cap > 0 && ++m_channel_counts[p.channel] > cap) {
+        return true;
+      }
+      return false;
+    });
+  tpset.objects.erase(it, tpset.objects.end());
+  size_t n_after = tpset.objects.size();
+  if (n_after != n_before) {
+    m_shed_tp_count += n_before - n_after;
+    if (!tpset.objects.empty()) {
+      // Patch the set's window to what actually survived (TPs within a
+      // set are time-ordered)
+      tpset.start_time = tpset.objects.front().time_start;
+      tpset.end_time = tpset.objects.back().time_start;
+    }
+    TLOG_DEBUG(TLVL_DEBUG_MEDIUM) << "[TPLS] Shed " << (n_before - n_after) << " TPs out of " << n_before
+                                  << " at level " << m_level;
+  }
+}
+
+void
+TPLoadShedder::do_work()
+{
+  while (m_running_flag.load()) {
+
+    std::optional<TPSet> tpset = m_input_queue->try_receive(m_queue_timeout);
+
+    if (!tpset.has_value()) {
+      // The condition to exit the loop is that we've been stopped and
+      // there's nothing left on the input queue
+      if (!m_running_flag.load()) {
+        break;
+      } else {
+        maybe_publish_info();
+        continue;
+      }
+    }
+
+    ++m_received_count;
+
+    // Heartbeat TPSets pass through untouched at any level: downstream
+    // windowing depends on them, and they are cheap
+    if (m_level > 0 && tpset->type == TPSet::kPayload) {
+      shed(*tpset);
+      if (tpset->objects.empty()) {
+        // The rule is that we don't send empty TPSets
+        ++m_shed_set_count;
+        maybe_publish_info();
+        continue;
+      }
+    }
+
+    // The send itself is the pressure probe: a healthy downstream accepts
+    // within microseconds, so a slow or timed-out send means its queue is
+    // backed up. Sustained pressure escalates, sustained health relaxes
+    auto send_start = std::chrono::steady_clock::now();
+    bool pressured = false;
+    try {
+      m_output_queue->send(std::move(*tpset), m_queue_timeout);
+      ++m_sent_count;
+    } catch (const dunedaq::iomanager::TimeoutExpired& excpt) {
+      ers::warning(excpt);
+      pressured = true;
+    }
+    auto send_us =
+      std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - send_start).count();
+    pressured = pressured || static_cast<uint64_t>(send_us) >= m_conf.pressure_send_us; // NOLINT(build/unsigned)
+    note_send(pressured);
+
+    maybe_publish_info();
+  } // while
+  // Final snapshot so the end-of-run totals are what opmon reports
+  publish_info();
+  TLOG() << "[TPLS] " << get_name() << ": Exiting do_work() method. Received " << m_received_count << " sets, sent "
+         << m_sent_count << ", shed " << m_shed_tp_count << " TPs and " << m_shed_set_count << " whole sets";
+}
+
+} // namespace trigger
+} // namespace dunedaq
+
+DEFINE_DUNE_DAQ_MODULE(dunedaq::trigger::TPLoadShedder)
@@ -0,0 +1,111 @@
+/**
+ * @file TPLoadShedder.hpp
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2021.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#ifndef TRIGGER_PLUGINS_TPLOADSHEDDER_HPP_
+#define TRIGGER_PLUGINS_TPLOADSHEDDER_HPP_
+
+#include "trigger/Issues.hpp"
+#include "trigger/MetricSnapshot.hpp"
+#include "trigger/TPSet.hpp"
+#include "trigger/tploadshedder/Nljs.hpp"
+#include "trigger/tploadshedderinfo/InfoNljs.hpp"
+
+#include "appfwk/DAQModule.hpp"
+#include "iomanager/Receiver.hpp"
+#include "iomanager/Sender.hpp"
+#include "utilities/WorkerThread.hpp"
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+namespace dunedaq {
+namespace trigger {
+
+/**
+ * @brief TPLoadShedder sits in the TP stream and trades completeness for
+ * bounded latency when the chain downstream of it can't keep up (a noisy
+ * APA, a slow maker). It watches how long its own sends take: sustained
+ * slow or timed-out sends raise a shedding level, and at level L payload
+ * TPs are dropped by a deterministic policy (ADC-integral floor of
+ * L*adc_floor_step, per-channel per-set cap halving with each level).
+ * Sustained clean sends step the level back down to zero, so the module
+ * is an exact pass-through whenever the chain is healthy. Everything shed
+ * is counted and reported through opmon.
+ */
+class TPLoadShedder : public dunedaq::appfwk::DAQModule
+{
+public:
+  explicit TPLoadShedder(const std::string& name);
+
+  TPLoadShedder(const TPLoadShedder&) = delete;
+  TPLoadShedder& operator=(const TPLoadShedder&) = delete;
+  TPLoadShedder(TPLoadShedder&&) = delete;
+  TPLoadShedder& operator=(TPLoadShedder&&) = delete;
+
+  void init(const nlohmann::json& iniobj) override;
+  void get_info(opmonlib::InfoCollector& ci, int level) override;
+
+private:
+  void do_conf(const nlohmann::json& config);
+  void do_start(const nlohmann::json& obj);
+  void do_stop(const nlohmann::json& obj);
+  void do_work();
+
+  // Shedding policy, worker thread only
+  void shed(TPSet& tpset);
+  void note_send(bool pressured);
+  void set_level(uint64_t level); // NOLINT(build/unsigned)
+  uint64_t channel_cap_for_level() const; // NOLINT(build/unsigned)
+
+  dunedaq::utilities::WorkerThread m_thread;
+
+  using metric_counter_type = decltype(tploadshedderinfo::Info::received_count);
+  std::atomic<metric_counter_type> m_received_count;
+  std::atomic<metric_counter_type> m_sent_count;
+  std::atomic<metric_counter_type> m_shed_tp_count;
+  std::atomic<metric_counter_type> m_shed_set_count;
+  std::atomic<metric_counter_type> m_pressure_event_count;
+  std::atomic<metric_counter_type> m_level_change_count;
+
+  // Shedding state; owned by the worker thread, mirrored into the info
+  // snapshot for opmon
+  uint64_t m_level{ 0 };           // NOLINT(build/unsigned)
+  uint64_t m_adc_floor{ 0 };       // NOLINT(build/unsigned)
+  uint64_t m_pressure_streak{ 0 }; // NOLINT(build/unsigned)
+  uint64_t m_clean_streak{ 0 };    // NOLINT(build/unsigned)
+
+  // Per-set per-channel TP counts for the cap policy, reused across sets
+  // so the hot path stops allocating once it reaches steady-state size
+  std::unordered_map<int, uint64_t> m_channel_counts; // NOLINT(build/unsigned)
+
+  // Latest Info record, published by the worker thread on its own cadence
+  // and copied out by get_info() on the opmon thread
+  void publish_info();
+  void maybe_publish_info();
+  MetricSnapshot<tploadshedderinfo::Info> m_info_snapshot;
+  static constexpr std::chrono::milliseconds s_snapshot_interval{ 100 };
+  std::chrono::steady_clock::time_point m_last_snapshot_time;
+
+  using source_t = dunedaq::iomanager::ReceiverConcept<TPSet>;
+  std::shared_ptr<source_t> m_input_queue;
+  using sink_t = dunedaq::iomanager::SenderConcept<TPSet>;
+  std::shared_ptr<sink_t> m_output_queue;
+  std::chrono::milliseconds m_queue_timeout;
+
+  dunedaq::trigger::tploadshedder::Conf m_conf;
+
+  // Are we in the RUNNING state?
+  std::atomic<bool> m_running_flag{ false };
+};
+} // namespace trigger
+} // namespace dunedaq
+
+#endif // TRIGGER_PLUGINS_TPLOADSHEDDER_HPP_
@@ -24,6 +24,7 @@
 #include <cstdlib>
 #include <map>
 #include <memory>
+#include <optional>
 #include <string>
 #include <thread>
 #include <utility>
@@ -75,8 +76,17 @@ TPSetBufferCreator::init(const nlohmann::json& init_data)
 }
 
 void
-TPSetBufferCreator::get_info(opmonlib::InfoCollector& /*ci*/, int /*level*/)
-{}
+TPSetBufferCreator::get_info(opmonlib::InfoCollector& ci, int /*level*/)
+{
+  if (m_tps_buffer == nullptr) {
+    return;
+  }
+  tpsetbuffercreatorinfo::Info i;
+  i.stored_sets = m_tps_buffer->get_stored_size();
+  i.stored_bytes = m_tps_buffer->get_stored_bytes();
+  i.buffered_time_span_ticks = m_tps_buffer->get_buffered_time_span();
+  ci.add(i);
+}
 
 void
 TPSetBufferCreator::do_configure(const nlohmann::json& obj)
@@ -88,11 +98,24 @@ TPSetBufferCreator::do_configure(const nlohmann::json& obj)
   m_tps_buffer.reset(new TPSetBuffer(m_tps_buffer_size));
 
   m_tps_buffer->set_buffer_size(m_tps_buffer_size);
+  m_tps_buffer->set_buffer_byte_budget(m_conf.tpset_buffer_bytes);
+
+  m_frag_arena.reserve(m_conf.fragment_arena_tps);
 }
 
 void
 TPSetBufferCreator::do_start(const nlohmann::json& /*args*/)
 {
+  m_requested_count = 0;
+  m_request_sent_count = 0;
+  m_window_cache_hits = 0;
+  m_window_cache.clear();
+  m_request_running.store(true);
+  size_t n_workers = m_conf.n_request_threads > 0 ? m_conf.n_request_threads : 1;
+  for (size_t i = 0; i < n_workers; ++i) {
+    m_request_threads.emplace_back(&TPSetBufferCreator::request_worker, this);
+    pthread_setname_np(m_request_threads.back().native_handle(), ("buffer-req" + std::to_string(i)).c_str());
+  }
   m_thread.start_working_thread("buffer-man");
   TLOG_DEBUG(TLVL_GENERAL) << "[TPSetBufferCreator] " << get_name() << " successfully started";
 }
@@ -102,6 +125,11 @@ TPSetBufferCreator::do_stop(const nlohmann::json& /*args*/)
 {
   m_thread.stop_working_thread();
 
+  m_request_running.store(false);
+  for (auto& t : m_request_threads) {
+    t.join();
+  }
+  m_request_threads.clear();
 
   size_t sentCount = 0;
   TPSetBuffer::DataRequestOutput requested_tpset;
@@ -111,7 +139,7 @@ TPSetBufferCreator::do_stop(const nlohmann::json& /*args*/)
     while (it != m_dr_on_hold.end()) {
 
       requested_tpset.txsets_in_window = it->second;
-      std::unique_ptr<daqdataformats::Fragment> frag_out = convert_to_fragment(requested_tpset.txsets_in_window, it->first);
+      std::unique_ptr<daqdataformats::Fragment> frag_out = convert_to_fragment(requested_tpset.txsets_in_window, it->first, m_frag_arena);
       TLOG_DEBUG(TLVL_DEBUG_MEDIUM) << "[TPSetBufferCreator] " << get_name() << ": Sending late requested data (" << (it->first).request_information.window_begin << ", "
              << (it->first).request_information.window_end << "), containing "
              << requested_tpset.txsets_in_window.size() << " TPSets.";
@@ -140,30 +168,73 @@ TPSetBufferCreator::do_scrap(const nlohmann::json& /*args*/)
 }
 
 std::unique_ptr<daqdataformats::Fragment>
-TPSetBufferCreator::convert_to_fragment(std::vector<TPSet>& tpsets, dfmessages::DataRequest input_data_request)
+TPSetBufferCreator::convert_to_fragment(std::vector<TPSet>& tpsets,
+                                        dfmessages::DataRequest input_data_request,
+                                        fragment_arena_t& arena)
 {
+  std::vector<const TPSet*> tpset_ptrs;
+  tpset_ptrs.reserve(tpsets.size());
+  for (auto const& tpset : tpsets) {
+    tpset_ptrs.push_back(&tpset);
+  }
+  return convert_to_fragment(tpset_ptrs, input_data_request, arena);
+}
 
-  using trgdataformats::TriggerPrimitive;
+// Zero-copy variant: serializes straight out of the buffer through the
+// pinned pointers of a BufferManager::DataRequestView
+std::unique_ptr<daqdataformats::Fragment>
+TPSetBufferCreator::convert_to_fragment(const std::vector<const TPSet*>& tpsets,
+                                        dfmessages::DataRequest input_data_request,
+                                        fragment_arena_t& arena)
+{
+  stage_payload(tpsets, input_data_request, arena);
+  return build_fragment(arena, input_data_request);
+}
 
-  std::vector<TriggerPrimitive> tps;
-  
-  for (auto const& tpset : tpsets) {
-    for (auto const& tp : tpset.objects) {
+void
+TPSetBufferCreator::stage_payload(const std::vector<const TPSet*>& tpsets,
+                                  const dfmessages::DataRequest& input_data_request,
+                                  fragment_arena_t& tps)
+{
+  // The arena keeps its capacity across requests, so in steady state this
+  // stages the payload without allocating
+  tps.clear();
+
+  for (auto const* tpset : tpsets) {
+    auto const& objs = tpset->objects;
+    if (objs.empty()) {
+      continue;
+    }
+    // TPs within a set are time-ordered, so a set whose first and last TP
+    // both fall inside the window is copied as one contiguous run; only
+    // the window-edge sets pay the per-TP filter
+    if (objs.front().time_start >= input_data_request.request_information.window_begin &&
+        objs.back().time_start <= input_data_request.request_information.window_end) {
+      tps.insert(tps.end(), objs.begin(), objs.end());
+      continue;
+    }
+    for (auto const& tp : objs) {
       if (tp.time_start >= input_data_request.request_information.window_begin &&
           tp.time_start <= input_data_request.request_information.window_end) {
         tps.push_back(tp);
       }
     }
   }
+}
+
+std::unique_ptr<daqdataformats::Fragment>
+TPSetBufferCreator::build_fragment(const fragment_arena_t& tps, dfmessages::DataRequest input_data_request)
+{
+  using trgdataformats::TriggerPrimitive;
 
   std::unique_ptr<daqdataformats::Fragment> ret;
 
   // If tps is empty, tps.data() will be nullptr, so we need this `if`
-  if(tps.empty()){
+  if (tps.empty()) {
     ret = std::make_unique<daqdataformats::Fragment>(std::vector<std::pair<void*, size_t>>());
-  }
-  else{
-    ret = std::make_unique<daqdataformats::Fragment>(tps.data(), sizeof(TriggerPrimitive)*tps.size());
+  } else {
+    ret = std::make_unique<daqdataformats::Fragment>(const_cast<TriggerPrimitive*>(tps.data()),
+                                                     sizeof(TriggerPrimitive) * tps.size());
   }
   auto& frag = *ret.get();
 
@@ -184,6 +255,32 @@ TPSetBufferCreator::convert_to_fragment(std::vector<TPSet>& tpsets, dfmessages::
   return ret;
 }
 
+std::shared_ptr<TPSetBufferCreator::fragment_arena_t>
+TPSetBufferCreator::window_cache_lookup(daqdataformats::timestamp_t window_begin,
+                                        daqdataformats::timestamp_t window_end)
+{
+  std::lock_guard<std::mutex> lock(m_window_cache_mtx);
+  for (auto it = m_window_cache.begin(); it != m_window_cache.end(); ++it) {
+    if (it->window_begin == window_begin && it->window_end == window_end) {
+      m_window_cache.splice(m_window_cache.begin(), m_window_cache, it);
+      return m_window_cache.front().tps;
+    }
+  }
+  return nullptr;
+}
+
+void
+TPSetBufferCreator::window_cache_store(daqdataformats::timestamp_t window_begin,
+                                       daqdataformats::timestamp_t window_end,
+                                       std::shared_ptr<fragment_arena_t> tps)
+{
+  std::lock_guard<std::mutex> lock(m_window_cache_mtx);
+  m_window_cache.push_front(CachedWindow{ window_begin, window_end, std::move(tps) });
+  while (m_window_cache.size() > static_cast<size_t>(m_conf.request_cache_size)) {
+    m_window_cache.pop_back();
+  }
+}
+
 void
 TPSetBufferCreator::send_out_fragment(std::unique_ptr<daqdataformats::Fragment> frag_out,
                                       std::string data_destination,
@@ -234,7 +331,6 @@ TPSetBufferCreator::do_work(std::atomic<bool>& running_flag)
 {
   size_t addedCount = 0;
   size_t addFailedCount = 0;
-  size_t requestedCount = 0;
   size_t sentCount = 0;
 
   bool first = true;
@@ -242,7 +338,6 @@ TPSetBufferCreator::do_work(std::atomic<bool>& running_flag)
   while (running_flag.load()) {
 
     trigger::TPSet input_tpset;
-    dfmessages::DataRequest input_data_request;
     TPSetBuffer::DataRequestOutput requested_tpset;
 
     // Block that receives TPSets and add them in buffer and check for pending data requests
@@ -263,6 +358,7 @@ TPSetBufferCreator::do_work(std::atomic<bool>& running_flag)
         ++addFailedCount;
       }
 
+      std::lock_guard<std::mutex> hold_lock(m_dr_on_hold_mtx);
       if (!m_dr_on_hold.empty()) { // check if new data is part of data request on hold
 
         // TLOG_DEBUG(TLVL_DEBUG_HIGH) << "[TPSetBufferCreator] On hold DRs: "<<m_dr_on_hold.size();
@@ -289,7 +385,7 @@ TPSetBufferCreator::do_work(std::atomic<bool>& running_flag)
                 .start_time) { // If more TPSet aren't expected to arrive then push and remove pending data request
             requested_tpset.txsets_in_window = std::move(it->second);
             std::unique_ptr<daqdataformats::Fragment> frag_out =
-              convert_to_fragment(requested_tpset.txsets_in_window, it->first);
+              convert_to_fragment(requested_tpset.txsets_in_window, it->first, m_frag_arena);
             TLOG_DEBUG(TLVL_DEBUG_MEDIUM) << "[TPSetBufferCreator] " << get_name() << ": Sending late requested data (" << (it->first).request_information.window_begin
                    << ", " << (it->first).request_information.window_end << "), containing "
                    << requested_tpset.txsets_in_window.size() << " TPSets.";
@@ -308,57 +404,110 @@ TPSetBufferCreator::do_work(std::atomic<bool>& running_flag)
     } catch (const dunedaq::iomanager::TimeoutExpired& excpt) {
     }
 
-    // Block that receives data requests and return fragments from buffer
-    try {
-      input_data_request = m_input_queue_dr->receive(std::chrono::milliseconds(0));
-      requested_tpset = m_tps_buffer->get_txsets_in_window(input_data_request.request_information.window_begin,
-                                                           input_data_request.request_information.window_end);
-      ++requestedCount;
-
-      TLOG_DEBUG(TLVL_DEBUG_HIGH) << "[TPSetBufferCreator] " << get_name() << ": Got request number " << input_data_request.request_number << ", trigger number "
-                    << input_data_request.trigger_number << " begin/end ("
-                    << input_data_request.request_information.window_begin << ", "
-                    << input_data_request.request_information.window_end << ")";
-
-      auto frag_out = convert_to_fragment(requested_tpset.txsets_in_window, input_data_request);
-
-      switch (requested_tpset.ds_outcome) {
-        case TPSetBuffer::kEmpty:
-          TLOG_DEBUG(TLVL_DEBUG_HIGH) << "[TPSetBufferCreator] " << get_name() << ": Requested data (" << input_data_request.request_information.window_begin << ", "
-                 << input_data_request.request_information.window_end << ") not in buffer, which contains "
-                 << m_tps_buffer->get_stored_size() << " TPSets between (" << m_tps_buffer->get_earliest_start_time()
-                 << ", " << m_tps_buffer->get_latest_end_time() << "). Returning empty fragment.";
-          frag_out->set_error_bit(daqdataformats::FragmentErrorBits::kDataNotFound, true);
-          send_out_fragment(std::move(frag_out), input_data_request.data_destination, sentCount, running_flag);
-          break;
-        case TPSetBuffer::kLate:
-          TLOG_DEBUG(TLVL_DEBUG_HIGH) << "[TPSetBufferCreator] " << get_name() << ": Requested data (" << input_data_request.request_information.window_begin << ", "
-                 << input_data_request.request_information.window_end << ") has not arrived in buffer, which contains "
-                 << m_tps_buffer->get_stored_size() << " TPSets between (" << m_tps_buffer->get_earliest_start_time()
-                 << ", " << m_tps_buffer->get_latest_end_time() << "). Holding request until more data arrives.";
-          m_dr_on_hold.insert(std::make_pair(input_data_request, requested_tpset.txsets_in_window));
-          break; // don't send anything yet. Wait for more data to arrived.
-        case TPSetBuffer::kSuccess:
-          TLOG_DEBUG(TLVL_DEBUG_HIGH) << "[TPSetBufferCreator] " << get_name() << ": Sending requested data (" << input_data_request.request_information.window_begin
-                 << ", " << input_data_request.request_information.window_end << "), containing "
-                 << requested_tpset.txsets_in_window.size() << " TPSets.";
-
-          send_out_fragment(std::move(frag_out), input_data_request.data_destination, sentCount, running_flag);
-          break;
-        default:
-          TLOG_DEBUG(TLVL_DEBUG_LOW) << "[TPSetBufferCreator] " << get_name() << ": Data request failed!";
-      }
+  } // end while(running_flag.load())
 
-    } catch (const dunedaq::iomanager::TimeoutExpired& excpt) {
-      // skip if no data request in the queue
+  TLOG() << "[TPSetBufferCreator] " << get_name() << ": Exiting the do_work() method: received " << addedCount
+         << " Sets. " << addFailedCount << " Sets failed to add. Sent " << sentCount << " late fragments";
+
+} // NOLINT Function length
+
+void
+TPSetBufferCreator::request_worker()
+{
+  // Per-worker assembly arena, so workers never contend on staging storage
+  fragment_arena_t arena;
+  arena.reserve(m_conf.fragment_arena_tps);
+  size_t sentCount = 0;
+
+  while (m_request_running.load()) {
+
+    std::optional<dfmessages::DataRequest> opt_dr = m_input_queue_dr->try_receive(std::chrono::milliseconds(10));
+    if (!opt_dr.has_value()) {
       continue;
     }
-  } // end while(running_flag.load())
+    dfmessages::DataRequest input_data_request = std::move(*opt_dr);
+
+    if (m_conf.request_cache_size > 0) {
+      // A decision fan-out with the same readout window was serviced
+      // recently: rebuild the fragment from the cached payload without
+      // touching the buffer
+      auto cached = window_cache_lookup(input_data_request.request_information.window_begin,
+                                        input_data_request.request_information.window_end);
+      if (cached != nullptr) {
+        ++m_requested_count;
+        ++m_window_cache_hits;
+        auto frag_out = build_fragment(*cached, input_data_request);
+        send_out_fragment(std::move(frag_out), input_data_request.data_destination, sentCount, m_request_running);
+        continue;
+      }
+    }
 
-  TLOG() << "[TPSetBufferCreator] " << get_name() << ": Exiting the do_work() method: received " << addedCount << " Sets and " << requestedCount
-         << " data requests. " << addFailedCount << " Sets failed to add. Sent " << sentCount << " fragments";
+    // The view pins the buffer (deferring evictions) instead of copying
+    // every overlapping TPSet, so the fragment is serialized straight out
+    // of the buffer storage while ingest continues
+    TPSetBuffer::DataRequestView requested_view =
+      m_tps_buffer->get_txsets_in_window_view(input_data_request.request_information.window_begin,
+                                              input_data_request.request_information.window_end);
+    ++m_requested_count;
+
+    TLOG_DEBUG(TLVL_DEBUG_HIGH) << "[TPSetBufferCreator] " << get_name() << ": Got request number " << input_data_request.request_number << ", trigger number "
+                  << input_data_request.trigger_number << " begin/end ("
+                  << input_data_request.request_information.window_begin << ", "
+                  << input_data_request.request_information.window_end << ")";
+
+    std::unique_ptr<daqdataformats::Fragment> frag_out;
+    if (m_conf.request_cache_size > 0 && requested_view.ds_outcome == TPSetBuffer::kSuccess) {
+      // stage into a fresh shared payload so the cache entry costs no
+      // extra copy on top of fragment building
+      auto entry = std::make_shared<fragment_arena_t>();
+      entry->reserve(arena.capacity());
+      stage_payload(requested_view.txsets_in_window, input_data_request, *entry);
+      requested_view.release();
+      frag_out = build_fragment(*entry, input_data_request);
+      window_cache_store(input_data_request.request_information.window_begin,
+                         input_data_request.request_information.window_end,
+                         std::move(entry));
+    } else {
+      frag_out = convert_to_fragment(requested_view.txsets_in_window, input_data_request, arena);
+      requested_view.release();
+    }
 
-} // NOLINT Function length
+    switch (requested_view.ds_outcome) {
+      case TPSetBuffer::kEmpty:
+        TLOG_DEBUG(TLVL_DEBUG_HIGH) << "[TPSetBufferCreator] " << get_name() << ": Requested data (" << input_data_request.request_information.window_begin << ", "
+               << input_data_request.request_information.window_end << ") not in buffer, which contains "
+               << m_tps_buffer->get_stored_size() << " TPSets between (" << m_tps_buffer->get_earliest_start_time()
+               << ", " << m_tps_buffer->get_latest_end_time() << "). Returning empty fragment.";
+        frag_out->set_error_bit(daqdataformats::FragmentErrorBits::kDataNotFound, true);
+        send_out_fragment(std::move(frag_out), input_data_request.data_destination, sentCount, m_request_running);
+        break;
+      case TPSetBuffer::kLate:
+        TLOG_DEBUG(TLVL_DEBUG_HIGH) << "[TPSetBufferCreator] " << get_name() << ": Requested data (" << input_data_request.request_information.window_begin << ", "
+               << input_data_request.request_information.window_end << ") has not arrived in buffer, which contains "
+               << m_tps_buffer->get_stored_size() << " TPSets between (" << m_tps_buffer->get_earliest_start_time()
+               << ", " << m_tps_buffer->get_latest_end_time() << "). Holding request until more data arrives.";
+        {
+          std::lock_guard<std::mutex> hold_lock(m_dr_on_hold_mtx);
+          m_dr_on_hold.insert(std::make_pair(input_data_request, std::vector<trigger::TPSet>()));
+        }
+        break; // don't send anything yet. Wait for more data to arrived.
+      case TPSetBuffer::kSuccess:
+        TLOG_DEBUG(TLVL_DEBUG_HIGH) << "[TPSetBufferCreator] " << get_name() << ": Sending requested data (" << input_data_request.request_information.window_begin
+               << ", " << input_data_request.request_information.window_end << "), containing "
+               << requested_view.txsets_in_window.size() << " TPSets.";
+
+        send_out_fragment(std::move(frag_out), input_data_request.data_destination, sentCount, m_request_running);
+        break;
+      default:
+        TLOG_DEBUG(TLVL_DEBUG_LOW) << "[TPSetBufferCreator] " << get_name() << ": Data request failed!";
+    }
+  } // end while(m_request_running.load())
+
+  m_request_sent_count += sentCount;
+
+  TLOG() << "[TPSetBufferCreator] " << get_name() << ": Exiting request_worker: serviced " << m_requested_count
+         << " data requests so far, this worker sent " << sentCount << " fragments";
+}
 
 } // namespace trigger
 } // namespace dunedaq
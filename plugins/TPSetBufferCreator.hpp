@@ -9,6 +9,7 @@
 
 #include "daqdataformats/Fragment.hpp"
 #include "daqdataformats/Types.hpp"
+#include "trgdataformats/TriggerPrimitive.hpp"
 
 #include "dfmessages/DataRequest.hpp"
 #include "dfmessages/HSIEvent.hpp"
@@ -17,6 +18,7 @@
 #include "trigger/TPSetBuffer.hpp"
 #include "trigger/tpsetbuffercreator/Nljs.hpp"
 #include "trigger/tpsetbuffercreator/Structs.hpp"
+#include "trigger/tpsetbuffercreatorinfo/InfoNljs.hpp"
 
 #include "appfwk/DAQModule.hpp"
 #include "iomanager/Receiver.hpp"
@@ -25,10 +27,14 @@
 
 #include <ers/Issue.hpp>
 
+#include <atomic>
 #include <chrono>
+#include <list>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 
 namespace dunedaq {
@@ -65,6 +71,15 @@ private:
   dunedaq::utilities::WorkerThread m_thread;
   void do_work(std::atomic<bool>&);
 
+  // Data-request servicing pool: ingest keeps feeding the buffer on
+  // m_thread while these workers dequeue requests and build/send
+  // fragments concurrently against the reader-safe buffer
+  std::vector<std::thread> m_request_threads;
+  std::atomic<bool> m_request_running{ false };
+  std::atomic<size_t> m_requested_count{ 0 };
+  std::atomic<size_t> m_request_sent_count{ 0 };
+  void request_worker();
+
   // Configuration
 
   tpsetbuffercreator::Conf m_conf;
@@ -94,9 +109,42 @@ private:
 
   std::map<dfmessages::DataRequest, std::vector<trigger::TPSet>, DataRequestComp>
     m_dr_on_hold; ///< Holds data request when data has not arrived in the buffer yet
+  std::mutex m_dr_on_hold_mtx; ///< Request workers insert, the ingest thread completes
+
+  // Preallocated staging buffer for fragment payloads, reused across
+  // requests so trigger-record building does not allocate per request. An
+  // arena is single-threaded; callers on other threads pass their own
+  using fragment_arena_t = std::vector<trgdataformats::TriggerPrimitive>;
+  fragment_arena_t m_frag_arena;
 
   std::unique_ptr<daqdataformats::Fragment> convert_to_fragment(std::vector<TPSet>&,
-                                                                dfmessages::DataRequest);
+                                                                dfmessages::DataRequest,
+                                                                fragment_arena_t& arena);
+  std::unique_ptr<daqdataformats::Fragment> convert_to_fragment(const std::vector<const TPSet*>&,
+                                                                dfmessages::DataRequest,
+                                                                fragment_arena_t& arena);
+  void stage_payload(const std::vector<const TPSet*>&, const dfmessages::DataRequest&, fragment_arena_t& out);
+  std::unique_ptr<daqdataformats::Fragment> build_fragment(const fragment_arena_t&, dfmessages::DataRequest);
+
+  // Small LRU cache of recently built fragment payloads keyed on the exact
+  // request window, shared by the request workers. Overlapping-TC
+  // configurations fan the same window out across several decisions, so a
+  // hit skips the whole extract-and-pack step; entries are shared_ptrs, so
+  // a hit never copies the payload either
+  struct CachedWindow
+  {
+    daqdataformats::timestamp_t window_begin;
+    daqdataformats::timestamp_t window_end;
+    std::shared_ptr<fragment_arena_t> tps;
+  };
+  std::mutex m_window_cache_mtx;
+  std::list<CachedWindow> m_window_cache; // front = most recently used
+  std::atomic<size_t> m_window_cache_hits{ 0 };
+  std::shared_ptr<fragment_arena_t> window_cache_lookup(daqdataformats::timestamp_t window_begin,
+                                                        daqdataformats::timestamp_t window_end);
+  void window_cache_store(daqdataformats::timestamp_t window_begin,
+                          daqdataformats::timestamp_t window_end,
+                          std::shared_ptr<fragment_arena_t> tps);
 
   void send_out_fragment(std::unique_ptr<daqdataformats::Fragment>, std::string, size_t&, std::atomic<bool>&);
   void send_out_fragment(std::unique_ptr<daqdataformats::Fragment>, std::string);
@@ -0,0 +1,527 @@
+/**
+ * @file TXBuffer.hpp
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2021.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#ifndef TRIGGER_PLUGINS_TXBUFFER_HPP_
+#define TRIGGER_PLUGINS_TXBUFFER_HPP_
+
+#include "trigger/AdaptiveReceiver.hpp"
+#include "trigger/HugePageArena.hpp"
+#include "trigger/Issues.hpp"
+#include "trigger/Logging.hpp"
+#include "trigger/RingLatencyBuffer.hpp"
+#include "trigger/ThreadPlacement.hpp"
+#include "trigger/txbufferinfo/InfoNljs.hpp"
+
+#include "appfwk/DAQModule.hpp"
+#include "appfwk/DAQModuleHelper.hpp"
+#include "daqdataformats/Fragment.hpp"
+#include "daqdataformats/FragmentHeader.hpp"
+#include "daqdataformats/SourceID.hpp"
+#include "detdataformats/DetID.hpp"
+#include "dfmessages/DataRequest.hpp"
+#include "iomanager/IOManager.hpp"
+#include "iomanager/Receiver.hpp"
+#include "readoutlibs/FrameErrorRegistry.hpp"
+#include "readoutlibs/models/DefaultSkipListRequestHandler.hpp"
+#include "readoutlibs/models/SkipListLatencyBufferModel.hpp"
+#include "utilities/WorkerThread.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace dunedaq::trigger {
+
+/**
+ * @brief TXBuffer is the common engine behind TPBuffer, TABuffer and
+ * TCBuffer: it ingests a stream of trigger objects into a latency buffer
+ * and services DataRequests against it. The three plugins were previously
+ * near-identical copies differing only in wrapper struct and connection
+ * names, so every buffer improvement had to land three times; they are now
+ * aliases of this template over a traits struct.
+ *
+ * TRAITS must provide:
+ *   wrapper_t           - the buffered object (TPWrapper and friends)
+ *   input_t             - the type received on the input connection
+ *   for_each_object(in, f) - invoke f on each wrapped object in an input_t
+ *   input_connection, log_prefix, thread_name, object_name
+ *   send_partial_fragments - flag forwarded to issue_request()
+ *   shard_key(obj)      - key used to spread objects over ring shards
+ */
+template<typename TRAITS>
+class TXBuffer : public dunedaq::appfwk::DAQModule
+{
+public:
+  using wrapper_t = typename TRAITS::wrapper_t;
+  using input_t = typename TRAITS::input_t;
+
+  explicit TXBuffer(const std::string& name)
+    : DAQModule(name)
+    , m_thread(std::bind(&TXBuffer::do_work, this, std::placeholders::_1))
+    , m_queue_timeout(100)
+  {
+    register_command("conf", &TXBuffer::do_conf);
+    register_command("start", &TXBuffer::do_start);
+    register_command("stop", &TXBuffer::do_stop);
+    register_command("scrap", &TXBuffer::do_scrap);
+  }
+
+  TXBuffer(const TXBuffer&) = delete;
+  TXBuffer& operator=(const TXBuffer&) = delete;
+  TXBuffer(TXBuffer&&) = delete;
+  TXBuffer& operator=(TXBuffer&&) = delete;
+
+  void init(const nlohmann::json& init_data) override
+  {
+    try {
+      m_input_queue_tx = get_iom_receiver<input_t>(appfwk::connection_uid(init_data, TRAITS::input_connection));
+      m_input_queue_dr =
+        get_iom_receiver<dfmessages::DataRequest>(appfwk::connection_uid(init_data, "data_request_source"));
+    } catch (const ers::Issue& excpt) {
+      throw dunedaq::trigger::InvalidQueueFatalError(ERS_HERE, get_name(), "input/output", excpt);
+    }
+    m_error_registry = std::make_unique<readoutlibs::FrameErrorRegistry>();
+    m_latency_buffer_impl = std::make_unique<latency_buffer_t>();
+    m_request_handler_impl = std::make_unique<request_handler_t>(m_latency_buffer_impl, m_error_registry);
+    m_request_handler_impl->init(init_data);
+  }
+
+  void get_info(opmonlib::InfoCollector& ci, int /*level*/) override
+  {
+    txbufferinfo::Info i;
+    i.hugepages_obtained = m_arena.huge_pages_obtained() ? 1 : 0;
+    i.arena_bytes_used = m_arena.bytes_used();
+    i.arena_fallback_allocations = m_arena.fallback_allocations();
+    size_t occupancy = 0;
+    if (m_use_ring) {
+      for (const auto& shard : m_shards) {
+        occupancy += shard.ring.occupancy();
+      }
+    } else if (m_latency_buffer_impl) {
+      occupancy = m_latency_buffer_impl->occupancy();
+    }
+    i.buffer_occupancy = occupancy;
+    {
+      std::lock_guard<std::mutex> lk(m_send_mtx);
+      i.async_send_backlog = m_send_queue.size();
+    }
+    ci.add(i);
+  }
+
+private:
+  void do_conf(const nlohmann::json& args)
+  {
+    m_cpu_affinity = args.value("cpu_affinity", std::vector<uint16_t>{}); // NOLINT(build/unsigned)
+    m_numa_node = args.value("numa_node", -1);
+    // The latency buffer (ring or skip list) is allocated right here at conf
+    // time, so a scoped preferred-node policy is enough to land its pages on
+    // the configured node; the worker threads pin themselves at start
+    thread_placement::ScopedNumaPreference scoped_node(m_numa_node, get_name());
+
+    m_use_ring = args.value("use_ring_buffer", false);
+    if (m_use_ring) {
+      m_n_shards = std::max<size_t>(1, args.value("ring_n_shards", static_cast<size_t>(1)));
+      size_t elements = args.value("ring_buffer_elements", static_cast<size_t>(10000000));
+      m_async_send_depth = args.value("async_send_depth", static_cast<size_t>(4));
+
+      // Optional explicit huge-page backing for the ring storage; sized
+      // from the element count unless overridden, with ~25% headroom for
+      // the deque's block rounding
+      size_t hugepage_bytes = args.value("hugepage_bytes", static_cast<size_t>(0));
+      if (args.value("use_hugepages", false) && hugepage_bytes == 0) {
+        hugepage_bytes = elements * sizeof(wrapper_t) + (elements * sizeof(wrapper_t)) / 4;
+      }
+      auto page_kind =
+        args.value("hugepage_use_1g", false) ? HugePageArena::PageKind::k1GB : HugePageArena::PageKind::k2MB;
+
+      // Tear down any previous shards before re-backing the arena: their
+      // storage must return to the old mapping while it is still alive
+      m_shards = std::vector<Shard>(m_n_shards);
+      m_arena.conf(hugepage_bytes, page_kind, get_name());
+      for (auto& shard : m_shards) {
+        shard.ring.conf(std::max<size_t>(1, elements / m_n_shards),
+                        HugePageAllocator<wrapper_t>(hugepage_bytes > 0 ? &m_arena : nullptr));
+      }
+      TLOG_DEBUG(logging::TLVL_GENERAL) << TRAITS::log_prefix << get_name() + " configured in ring-buffer mode with "
+                                        << m_n_shards << " shard(s)"
+                                        << (hugepage_bytes > 0
+                                              ? (m_arena.huge_pages_obtained() ? ", hugetlb-backed." : ", hugepage fallback.")
+                                              : ".");
+      return;
+    }
+
+    // Configure the latency buffer before the request handler so the request handler can check for alignment
+    // restrictions. The skip list allocates its nodes inside readoutlibs, so
+    // the explicit huge-page arena only applies to the ring variant
+
+    m_latency_buffer_impl->conf(args);
+    m_request_handler_impl->conf(args);
+
+    TLOG_DEBUG(logging::TLVL_GENERAL) << TRAITS::log_prefix << get_name() + " configured.";
+  }
+
+  void do_start(const nlohmann::json& args)
+  {
+    if (!m_use_ring) {
+      m_request_handler_impl->start(args);
+    } else {
+      if (m_n_shards > 1) {
+        start_shard_pool();
+      }
+      if (m_async_send_depth > 0) {
+        start_sender();
+      }
+    }
+    m_thread.start_working_thread(TRAITS::thread_name);
+    TLOG_DEBUG(logging::TLVL_GENERAL) << TRAITS::log_prefix << get_name() + " successfully started.";
+  }
+
+  void do_stop(const nlohmann::json& args)
+  {
+    m_thread.stop_working_thread();
+    if (m_use_ring) {
+      stop_shard_pool();
+      stop_sender();
+      for (auto& shard : m_shards) {
+        shard.ring.flush();
+      }
+    } else {
+      m_request_handler_impl->stop(args);
+      m_latency_buffer_impl->flush();
+    }
+    TLOG_DEBUG(logging::TLVL_GENERAL) << TRAITS::log_prefix << get_name() + " successfully stopped.";
+  }
+
+  void do_scrap(const nlohmann::json& args)
+  {
+    if (m_use_ring) {
+      for (auto& shard : m_shards) {
+        shard.ring.flush();
+      }
+      return;
+    }
+    m_request_handler_impl->scrap(args);
+    m_latency_buffer_impl->scrap(args);
+  }
+
+  // One time-sorted sub-ring plus the scratch its extraction worker fills.
+  // Objects are spread over shards by TRAITS::shard_key, so each shard holds
+  // ~1/N of any window and extraction cost is bounded by shard size
+  struct Shard
+  {
+    RingLatencyBuffer<wrapper_t, HugePageAllocator<wrapper_t>> ring;
+    std::mutex mtx;
+    std::vector<wrapper_t> out;
+  };
+
+  void start_shard_pool()
+  {
+    m_pool_running = true;
+    m_job_seq = 0;
+    m_jobs_left = 0;
+    for (size_t i = 0; i < m_n_shards; ++i) {
+      m_shard_threads.emplace_back([this, i]() { shard_worker(i); });
+    }
+  }
+
+  void stop_shard_pool()
+  {
+    {
+      std::lock_guard<std::mutex> lk(m_job_mtx);
+      m_pool_running = false;
+    }
+    m_job_cv.notify_all();
+    for (auto& t : m_shard_threads) {
+      t.join();
+    }
+    m_shard_threads.clear();
+  }
+
+  void shard_worker(size_t idx)
+  {
+    thread_placement::pin_current_thread(m_cpu_affinity, get_name());
+    thread_placement::prefer_numa_node(m_numa_node, get_name());
+    uint64_t seen_seq = 0; // NOLINT(build/unsigned)
+    while (true) {
+      uint64_t begin; // NOLINT(build/unsigned)
+      uint64_t end;   // NOLINT(build/unsigned)
+      {
+        std::unique_lock<std::mutex> lk(m_job_mtx);
+        m_job_cv.wait(lk, [&]() { return !m_pool_running || m_job_seq != seen_seq; });
+        if (!m_pool_running) {
+          return;
+        }
+        seen_seq = m_job_seq;
+        begin = m_job_begin;
+        end = m_job_end;
+      }
+      Shard& shard = m_shards[idx];
+      shard.out.clear();
+      {
+        std::lock_guard<std::mutex> lk(shard.mtx);
+        shard.ring.extract_window(begin, end, shard.out);
+      }
+      {
+        std::lock_guard<std::mutex> lk(m_job_mtx);
+        --m_jobs_left;
+      }
+      m_done_cv.notify_one();
+    }
+  }
+
+  void service_request_from_ring(const dfmessages::DataRequest& data_request)
+  {
+    m_ring_scratch.clear();
+    if (m_n_shards == 1) {
+      m_shards.front().ring.extract_window(
+        data_request.request_information.window_begin, data_request.request_information.window_end, m_ring_scratch);
+    } else {
+      // Fan the window out to the shard workers and stitch their (individually
+      // time-sorted) results back into one time-ordered run
+      {
+        std::unique_lock<std::mutex> lk(m_job_mtx);
+        m_job_begin = data_request.request_information.window_begin;
+        m_job_end = data_request.request_information.window_end;
+        m_jobs_left = m_n_shards;
+        ++m_job_seq;
+        m_job_cv.notify_all();
+        m_done_cv.wait(lk, [&]() { return m_jobs_left == 0; });
+      }
+      for (auto& shard : m_shards) {
+        m_ring_scratch.insert(m_ring_scratch.end(), shard.out.begin(), shard.out.end());
+      }
+      std::sort(m_ring_scratch.begin(), m_ring_scratch.end());
+    }
+
+    std::vector<std::pair<void*, size_t>> pieces;
+    pieces.reserve(m_ring_scratch.size());
+    for (auto& wrapper : m_ring_scratch) {
+      pieces.emplace_back(wrapper.begin(), wrapper.get_payload_size());
+    }
+    auto frag = std::make_unique<daqdataformats::Fragment>(pieces);
+
+    daqdataformats::FragmentHeader frag_h;
+    frag_h.trigger_number = data_request.trigger_number;
+    frag_h.trigger_timestamp = data_request.trigger_timestamp;
+    frag_h.window_begin = data_request.request_information.window_begin;
+    frag_h.window_end = data_request.request_information.window_end;
+    frag_h.run_number = data_request.run_number;
+    frag_h.element_id = data_request.request_information.component;
+    frag_h.fragment_type = static_cast<daqdataformats::fragment_type_t>(wrapper_t::fragment_type);
+    frag_h.sequence_number = data_request.sequence_number;
+    frag_h.detector_id = static_cast<uint16_t>(detdataformats::DetID::Subdetector::kDAQ); // NOLINT(build/unsigned)
+    frag->set_header_fields(frag_h);
+
+    if (m_ring_scratch.empty()) {
+      frag->set_error_bit(daqdataformats::FragmentErrorBits::kDataNotFound, true);
+    }
+
+    dispatch_fragment(std::move(frag), data_request.data_destination);
+  }
+
+  // Hand a built fragment to the sender thread (bounded in-flight count),
+  // or send inline when async sending is off. When the in-flight bound is
+  // reached the builder waits for space: the bound is there to absorb
+  // transient consumer stalls, not to drop data
+  void dispatch_fragment(std::unique_ptr<daqdataformats::Fragment> frag, const std::string& destination)
+  {
+    if (m_async_send_depth == 0 || !m_sender_running) {
+      send_fragment(std::move(frag), destination);
+      return;
+    }
+    std::unique_lock<std::mutex> lk(m_send_mtx);
+    m_send_space_cv.wait(lk, [&]() { return !m_sender_running || m_send_queue.size() < m_async_send_depth; });
+    if (!m_sender_running) {
+      lk.unlock();
+      send_fragment(std::move(frag), destination);
+      return;
+    }
+    m_send_queue.push_back(BuiltFragment{ std::move(frag), destination });
+    lk.unlock();
+    m_send_cv.notify_one();
+  }
+
+  void send_fragment(std::unique_ptr<daqdataformats::Fragment> frag, const std::string& destination)
+  {
+    try {
+      get_iom_sender<std::unique_ptr<daqdataformats::Fragment>>(destination)->send(std::move(frag), m_queue_timeout);
+    } catch (const iomanager::TimeoutExpired& err) {
+      ers::error(err);
+    }
+  }
+
+  void start_sender()
+  {
+    m_sender_running = true;
+    m_sender_thread = std::thread([this]() { sender_loop(); });
+  }
+
+  void stop_sender()
+  {
+    if (!m_sender_thread.joinable()) {
+      return;
+    }
+    {
+      std::lock_guard<std::mutex> lk(m_send_mtx);
+      m_sender_running = false;
+    }
+    m_send_cv.notify_all();
+    m_send_space_cv.notify_all();
+    // The sender drains whatever is queued before exiting, so stopping
+    // never discards a built fragment
+    m_sender_thread.join();
+  }
+
+  void sender_loop()
+  {
+    thread_placement::pin_current_thread(m_cpu_affinity, get_name());
+    thread_placement::prefer_numa_node(m_numa_node, get_name());
+    while (true) {
+      BuiltFragment item;
+      {
+        std::unique_lock<std::mutex> lk(m_send_mtx);
+        m_send_cv.wait(lk, [&]() { return !m_sender_running || !m_send_queue.empty(); });
+        if (m_send_queue.empty()) {
+          return; // only reachable when stopping
+        }
+        item = std::move(m_send_queue.front());
+        m_send_queue.pop_front();
+      }
+      m_send_space_cv.notify_one();
+      send_fragment(std::move(item.frag), item.destination);
+    }
+  }
+
+  void do_work(std::atomic<bool>& running_flag)
+  {
+    thread_placement::pin_current_thread(m_cpu_affinity, get_name());
+    thread_placement::prefer_numa_node(m_numa_node, get_name());
+    size_t n_objects_received = 0;
+    size_t n_requests_received = 0;
+
+    AdaptiveReceiver<input_t> input_policy(m_input_queue_tx, std::chrono::milliseconds(10));
+
+    while (running_flag.load()) {
+
+      // Poll data requests non-blockingly first, so a busy input stream can't
+      // starve them
+      std::optional<dfmessages::DataRequest> data_request = m_input_queue_dr->try_receive(std::chrono::milliseconds(0));
+      if (data_request.has_value()) {
+        ++n_requests_received;
+        if (m_use_ring) {
+          service_request_from_ring(*data_request);
+        } else {
+          m_request_handler_impl->issue_request(*data_request, TRAITS::send_partial_fragments);
+        }
+      }
+
+      // Spin on the input queue while traffic is hot; when idle, park on the
+      // queue for at most the duration of the old fixed sleep, so data request
+      // latency stays bounded as before
+      std::optional<input_t> input = input_policy.receive();
+      if (input.has_value()) {
+        TRAITS::for_each_object(*input, [&](const auto& obj) {
+          if (m_use_ring) {
+            Shard& shard = m_shards[m_n_shards == 1 ? 0 : TRAITS::shard_key(obj) % m_n_shards];
+            if (m_n_shards == 1) {
+              shard.ring.write(wrapper_t(obj));
+            } else {
+              std::lock_guard<std::mutex> lk(shard.mtx);
+              shard.ring.write(wrapper_t(obj));
+            }
+          } else {
+            m_latency_buffer_impl->write(wrapper_t(obj));
+          }
+          ++n_objects_received;
+        });
+      }
+    } // while (running_flag.load())
+
+    TLOG() << TRAITS::log_prefix << get_name() << " exiting do_work() method. Received " << n_objects_received << " "
+           << TRAITS::object_name << " and " << n_requests_received << " data requests";
+  }
+
+  dunedaq::utilities::WorkerThread m_thread;
+
+  using tx_source_t = iomanager::ReceiverConcept<input_t>;
+  std::shared_ptr<tx_source_t> m_input_queue_tx{ nullptr };
+
+  using dr_source_t = iomanager::ReceiverConcept<dfmessages::DataRequest>;
+  std::shared_ptr<dr_source_t> m_input_queue_dr{ nullptr };
+
+  std::chrono::milliseconds m_queue_timeout;
+
+  using latency_buffer_t = readoutlibs::SkipListLatencyBufferModel<wrapper_t>;
+  std::unique_ptr<latency_buffer_t> m_latency_buffer_impl{ nullptr };
+  using request_handler_t = readoutlibs::DefaultSkipListRequestHandler<wrapper_t>;
+  std::unique_ptr<request_handler_t> m_request_handler_impl{ nullptr };
+
+  // Don't actually use this, but it's currently needed as arg to request handler ctor
+  std::unique_ptr<readoutlibs::FrameErrorRegistry> m_error_registry;
+
+  // Contiguous ring mode (use_ring_buffer in conf): objects live in
+  // time-indexed ring shards instead of the skip list, and data requests are
+  // serviced here by binary search plus sequential reads, with fragments
+  // sent straight to the requester's data_destination. With ring_n_shards > 1
+  // a worker per shard extracts its slice of each window in parallel
+  bool m_use_ring{ false };
+  size_t m_n_shards{ 1 };
+
+  // Optional explicit huge-page backing for the ring storage (use_hugepages
+  // or hugepage_bytes in conf). Declared before m_shards so the shards -
+  // whose deques hold arena blocks - are destroyed first
+  HugePageArena m_arena;
+
+  // Declarative placement (cpu_affinity/numa_node conf fields): worker and
+  // shard threads pin themselves, and do_conf steers the latency buffer's
+  // pages to the configured node while it is allocated
+  std::vector<uint16_t> m_cpu_affinity; // NOLINT(build/unsigned)
+  int m_numa_node{ -1 };
+
+  std::vector<Shard> m_shards{ std::vector<Shard>(1) };
+  std::vector<wrapper_t> m_ring_scratch;
+
+  // Async fragment sending (async_send_depth in conf, ring mode): the
+  // worker builds fragments and parks them here, and a dedicated thread
+  // drains them, so window extraction keeps servicing requests while a
+  // slow consumer absorbs earlier fragments. m_sender_running is only
+  // toggled by the start/stop transitions
+  struct BuiltFragment
+  {
+    std::unique_ptr<daqdataformats::Fragment> frag;
+    std::string destination;
+  };
+  size_t m_async_send_depth{ 0 };
+  std::deque<BuiltFragment> m_send_queue;
+  std::mutex m_send_mtx;
+  std::condition_variable m_send_cv;
+  std::condition_variable m_send_space_cv;
+  std::thread m_sender_thread;
+  bool m_sender_running{ false };
+
+  std::vector<std::thread> m_shard_threads;
+  std::mutex m_job_mtx;
+  std::condition_variable m_job_cv;
+  std::condition_variable m_done_cv;
+  bool m_pool_running{ false };
+  uint64_t m_job_seq{ 0 };   // NOLINT(build/unsigned)
+  uint64_t m_job_begin{ 0 }; // NOLINT(build/unsigned)
+  uint64_t m_job_end{ 0 };   // NOLINT(build/unsigned)
+  size_t m_jobs_left{ 0 };
+};
+
+} // namespace dunedaq::trigger
+
+#endif // TRIGGER_PLUGINS_TXBUFFER_HPP_
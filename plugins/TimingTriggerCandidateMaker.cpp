@@ -38,60 +38,16 @@ TimingTriggerCandidateMaker::TimingTriggerCandidateMaker(const std::string& name
   register_command("scrap", &TimingTriggerCandidateMaker::do_scrap);
 }
 
-template<typename T> 
-std::vector<int> 
-TimingTriggerCandidateMaker::GetTriggeredBits(T signal_map)
-{
-  std::vector<int> triggered_bits;
-  int nbits = std::numeric_limits<T>::digits;
-  for (int i = 0; i < nbits; ++i) {
-    if ((signal_map >> i) & 1 ) {
-      triggered_bits.push_back(i);
-    }
-  }
-  return triggered_bits;
-}
-
-std::vector<triggeralgs::TriggerCandidate>
-TimingTriggerCandidateMaker::HSIEventToTriggerCandidate(const dfmessages::HSIEvent& data)
-{
-  std::vector<triggeralgs::TriggerCandidate> candidates;
-  // TODO Trigger Team <dune-daq@github.com> Nov-18-2021: the signal field ia now a signal bit map, rather than unique
-  // value -> change logic of below?
-
-  std::vector<int> triggered_bits = GetTriggeredBits(data.signal_map);
-  for (int bit_index : triggered_bits) {
-    uint32_t signal = 1 << bit_index;
-
-    if (!m_hsisignal_map.count(signal)) {
-      throw dunedaq::trigger::SignalTypeError(ERS_HERE, get_name(), data.signal_map);
-    }
-
-    triggeralgs::TriggerCandidate candidate;
-    candidate.time_start = data.timestamp - m_hsisignal_map[data.signal_map].time_before;  // time_start
-    candidate.time_end   = data.timestamp + m_hsisignal_map[data.signal_map].time_after; // time_end,
-    candidate.time_candidate = data.timestamp;
-    // throw away bits 31-16 of header, that's OK for now
-    candidate.detid = data.header; // NOLINT(build/unsigned)
-
-    candidate.type = m_hsisignal_map[signal].type; // type,
-
-    candidate.algorithm = triggeralgs::TriggerCandidate::Algorithm::kHSIEventToTriggerCandidate;
-    candidate.inputs = {};
-    candidates.push_back(candidate);
-  }
-
-  return candidates;
-}
-
-
 void
 TimingTriggerCandidateMaker::do_conf(const nlohmann::json& config)
 {
   auto params = config.get<dunedaq::trigger::timingtriggercandidatemaker::Conf>();
 
-  // Fill the internal hsi signal map. The map contains signal ID, TC type to
-  // create, and the readout time window.
+  // Fill the dispatch table. Each configured signal ID is a single-bit mask;
+  // its slot holds the readout time window and a preconstructed TC to copy
+  // on the hot path.
+  m_dispatch_table = {};
+  bool any_signal_configured = false;
   for (auto hsi_input : params.hsi_configs) {
     triggeralgs::TriggerCandidate::Type type;
     type = static_cast<triggeralgs::TriggerCandidate::Type>(
@@ -101,24 +57,32 @@ TimingTriggerCandidateMaker::do_conf(const nlohmann::json& config)
           "Unknown TriggerCandidate supplied to TTCM HSI map");
     }
 
-    if (m_hsisignal_map.count(hsi_input.signal)) {
-      throw TTCMConfigurationProblem(ERS_HERE, get_name(),
-          "Supplied more than one of the same hsi signal ID to TTCM HSI map");
+    for (int bit = 0; bit < s_n_signal_bits; ++bit) {
+      if (hsi_input.signal != (1u << bit)) {
+        continue;
+      }
+      HSIDispatchEntry& entry = m_dispatch_table[bit];
+      if (entry.valid) {
+        throw TTCMConfigurationProblem(ERS_HERE, get_name(),
+            "Supplied more than one of the same hsi signal ID to TTCM HSI map");
+      }
+      entry.valid = true;
+      entry.time_before = hsi_input.time_before;
+      entry.time_after = hsi_input.time_after;
+      entry.tc_template.type = type;
+      entry.tc_template.algorithm = triggeralgs::TriggerCandidate::Algorithm::kHSIEventToTriggerCandidate;
+      entry.tc_template.inputs = {};
+      any_signal_configured = true;
     }
 
-    m_hsisignal_map[hsi_input.signal] = { type,
-                                          hsi_input.time_before,
-                                          hsi_input.time_after };
-
     TLOG() << "[TTCM] will convert HSI signal id: " << hsi_input.signal << " to TC type: " << hsi_input.tc_type_name;
   }
 
-  if (m_hsisignal_map.empty()) {
+  if (!any_signal_configured) {
       throw TTCMConfigurationProblem(ERS_HERE, get_name(),
           "Created TTCM, but supplied an empty signal map!");
   }
 
-  auto first_entry = *std::begin(m_hsisignal_map);
   m_prescale = params.prescale;
   m_prescale_flag = (m_prescale > 1) ? true : false;
   TLOG_DEBUG(TLVL_GENERAL) << "[TTCM] " << get_name() + " configured.";
@@ -186,23 +150,35 @@ TimingTriggerCandidateMaker::receive_hsievent(dfmessages::HSIEvent& data)
     } 
   }
 
-  // Retreive all the potential TCs from HSI signal
-  std::vector<triggeralgs::TriggerCandidate> candidates;
-  try {
-    candidates = HSIEventToTriggerCandidate(data);
-  } catch (SignalTypeError& e) {
-    m_tc_sig_type_err_count++;
-    ers::error(e);
-    return;
+  // Validate every triggered bit against the dispatch table before sending
+  // anything, so an event with an unconfigured bit produces no TCs at all
+  for (int bit = 0; bit < s_n_signal_bits; ++bit) {
+    if (((data.signal_map >> bit) & 1) && !m_dispatch_table[bit].valid) {
+      m_tc_sig_type_err_count++;
+      ers::error(dunedaq::trigger::SignalTypeError(ERS_HERE, get_name(), data.signal_map));
+      return;
+    }
   }
 
-  // Send each TC to the output queue separately
-  for(const triggeralgs::TriggerCandidate& candidate: candidates){
+  // Emit one TC per triggered bit: copy the slot's preconstructed template
+  // and stamp the event timestamp and header, with no map probes or
+  // intermediate vector
+  for (int bit = 0; bit < s_n_signal_bits; ++bit) {
+    if (!((data.signal_map >> bit) & 1)) {
+      continue;
+    }
+    const HSIDispatchEntry& entry = m_dispatch_table[bit];
+
     bool successfullyWasSent = false;
     while (!successfullyWasSent) {
       try {
-        triggeralgs::TriggerCandidate candidate_copy(candidate);
-        m_output_queue->send(std::move(candidate_copy), m_queue_timeout);
+        triggeralgs::TriggerCandidate candidate(entry.tc_template);
+        candidate.time_start = data.timestamp - entry.time_before;
+        candidate.time_end = data.timestamp + entry.time_after;
+        candidate.time_candidate = data.timestamp;
+        // throw away bits 31-16 of header, that's OK for now
+        candidate.detid = data.header; // NOLINT(build/unsigned)
+        m_output_queue->send(std::move(candidate), m_queue_timeout);
         successfullyWasSent = true;
         ++m_tc_sent_count;
       } catch (const dunedaq::iomanager::TimeoutExpired& excpt) {
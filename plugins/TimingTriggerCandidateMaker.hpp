@@ -22,8 +22,9 @@
 #include "triggeralgs/TriggerCandidate.hpp"
 #include "utilities/WorkerThread.hpp"
 
+#include <array>
 #include <chrono>
-#include <map>
+#include <limits>
 #include <memory>
 #include <string>
 #include <utility>
@@ -39,6 +40,16 @@ struct HSISignal
   triggeralgs::timestamp_t time_after;
 };
 
+// One slot per HSI signal bit: the readout window offsets plus a
+// preconstructed TriggerCandidate to copy and stamp on the hot path
+struct HSIDispatchEntry
+{
+  bool valid{ false };
+  triggeralgs::timestamp_t time_before{ 0 };
+  triggeralgs::timestamp_t time_after{ 0 };
+  triggeralgs::TriggerCandidate tc_template;
+};
+
 class TimingTriggerCandidateMaker : public dunedaq::appfwk::DAQModule
 {
 public:
@@ -58,16 +69,12 @@ private:
   void do_stop(const nlohmann::json& obj);
   void do_scrap(const nlohmann::json& obj);
 
-  template<typename T>
-  std::vector<int> GetTriggeredBits(T signal_map);
-
   std::string m_hsievent_receive_connection;
 
   // Prescale functionality
   bool m_prescale_flag;
   int m_prescale;
 
-  std::vector<triggeralgs::TriggerCandidate> HSIEventToTriggerCandidate(const dfmessages::HSIEvent& data);
   void receive_hsievent(dfmessages::HSIEvent& data);
 
   using sink_t = dunedaq::iomanager::SenderConcept<triggeralgs::TriggerCandidate>;
@@ -76,8 +83,10 @@ private:
 
   std::chrono::milliseconds m_queue_timeout;
 
-  // NOLINTNEXTLINE(build/unsigned)
-  std::map<uint32_t, HSISignal> m_hsisignal_map;
+  // Dense signal-bit -> dispatch entry table, built once at configure time
+  // so the HSI hot path is a table index with no map probes
+  static constexpr int s_n_signal_bits = std::numeric_limits<uint32_t>::digits; // NOLINT(build/unsigned)
+  std::array<HSIDispatchEntry, s_n_signal_bits> m_dispatch_table;
 
   // Opmon variables
   using metric_counter_type = decltype(timingtriggercandidatemakerinfo::Info::tsd_received_count);
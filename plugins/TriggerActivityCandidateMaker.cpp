@@ -0,0 +1,38 @@
+/**
+ * @file TriggerActivityCandidateMaker.cpp
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#include "TriggerActivityCandidateMaker.hpp"
+
+#include "trigger/AlgorithmPlugins.hpp"
+#include "trigger/triggeractivitycandidatemaker/Nljs.hpp"
+
+#include <memory>
+#include <utility>
+
+namespace dunedaq::trigger {
+
+std::unique_ptr<FusedActivityCandidateAlgorithm>
+TriggerActivityCandidateMaker::make_maker(const nlohmann::json& obj)
+{
+  auto params = obj.get<triggeractivitycandidatemaker::Conf>();
+  set_algorithm_name(params.activity_maker + "+" + params.candidate_maker);
+  set_shared_work_pool(params.use_shared_work_pool);
+  set_thread_placement(params.cpu_affinity, params.numa_node);
+
+  std::unique_ptr<triggeralgs::TriggerActivityMaker> activity_maker = make_ta_maker(params.activity_maker);
+  activity_maker->configure(params.activity_maker_config);
+
+  std::unique_ptr<triggeralgs::TriggerCandidateMaker> candidate_maker = make_tc_maker(params.candidate_maker);
+  candidate_maker->configure(params.candidate_maker_config);
+
+  return std::make_unique<FusedActivityCandidateAlgorithm>(std::move(activity_maker), std::move(candidate_maker));
+}
+
+} // namespace dunedaq::trigger
+
+DEFINE_DUNE_DAQ_MODULE(dunedaq::trigger::TriggerActivityCandidateMaker)
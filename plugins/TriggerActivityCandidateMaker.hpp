@@ -0,0 +1,98 @@
+/**
+ * @file TriggerActivityCandidateMaker.hpp
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#ifndef TRIGGER_PLUGINS_TRIGGERACTIVITYCANDIDATEMAKER_HPP_
+#define TRIGGER_PLUGINS_TRIGGERACTIVITYCANDIDATEMAKER_HPP_
+
+#include "trigger/TriggerGenericMaker.hpp"
+
+#include "triggeralgs/TriggerActivity.hpp"
+#include "triggeralgs/TriggerActivityMaker.hpp"
+#include "triggeralgs/TriggerCandidate.hpp"
+#include "triggeralgs/TriggerCandidateMaker.hpp"
+#include "triggeralgs/TriggerPrimitive.hpp"
+#include "trigger/TPSet.hpp"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace dunedaq::trigger {
+
+/**
+ * @brief An activity maker and a candidate maker fused into one
+ * algorithm instance: TAs flow from the activity maker's output vector
+ * straight into the candidate maker on the same thread
+ *
+ * Running the two stages as separate modules pays TASet windowing in
+ * TimeSliceOutputBuffer, a serialization-capable transport hop and
+ * re-buffering in the TCM's TimeSliceInputBuffer - a full copy of
+ * every TA for nothing when both stages live in the same app. Fused,
+ * the intermediate TAs never leave the scratch vector.
+ */
+class FusedActivityCandidateAlgorithm
+{
+public:
+  FusedActivityCandidateAlgorithm(std::unique_ptr<triggeralgs::TriggerActivityMaker> activity_maker,
+                                  std::unique_ptr<triggeralgs::TriggerCandidateMaker> candidate_maker)
+    : m_activity_maker(std::move(activity_maker))
+    , m_candidate_maker(std::move(candidate_maker))
+  {}
+
+  void operator()(const triggeralgs::TriggerPrimitive& input_tp, std::vector<triggeralgs::TriggerCandidate>& output_tcs)
+  {
+    m_scratch_tas.clear();
+    (*m_activity_maker)(input_tp, m_scratch_tas);
+    for (const auto& ta : m_scratch_tas) {
+      (*m_candidate_maker)(ta, output_tcs);
+    }
+    m_data_vs_system_time = m_activity_maker->m_data_vs_system_time;
+  }
+
+  void flush(triggeralgs::timestamp_t until, std::vector<triggeralgs::TriggerCandidate>& output_tcs)
+  {
+    m_scratch_tas.clear();
+    m_activity_maker->flush(until, m_scratch_tas);
+    for (const auto& ta : m_scratch_tas) {
+      (*m_candidate_maker)(ta, output_tcs);
+    }
+    m_candidate_maker->flush(until, output_tcs);
+  }
+
+  // Mirrors the activity maker's value so TriggerGenericMaker can export
+  // it like it does for the standalone modules
+  uint64_t m_data_vs_system_time{ 0 }; // NOLINT(build/unsigned)
+
+private:
+  std::unique_ptr<triggeralgs::TriggerActivityMaker> m_activity_maker;
+  std::unique_ptr<triggeralgs::TriggerCandidateMaker> m_candidate_maker;
+  std::vector<triggeralgs::TriggerActivity> m_scratch_tas;
+};
+
+class TriggerActivityCandidateMaker
+  : public TriggerGenericMaker<Set<triggeralgs::TriggerPrimitive>,
+                               triggeralgs::TriggerCandidate,
+                               FusedActivityCandidateAlgorithm>
+{
+public:
+  explicit TriggerActivityCandidateMaker(const std::string& name)
+    : TriggerGenericMaker(name)
+  {}
+
+  TriggerActivityCandidateMaker(const TriggerActivityCandidateMaker&) = delete;
+  TriggerActivityCandidateMaker& operator=(const TriggerActivityCandidateMaker&) = delete;
+  TriggerActivityCandidateMaker(TriggerActivityCandidateMaker&&) = delete;
+  TriggerActivityCandidateMaker& operator=(TriggerActivityCandidateMaker&&) = delete;
+
+private:
+  virtual std::unique_ptr<FusedActivityCandidateAlgorithm> make_maker(const nlohmann::json& obj) override;
+};
+
+} // namespace dunedaq::trigger
+
+#endif // TRIGGER_PLUGINS_TRIGGERACTIVITYCANDIDATEMAKER_HPP_
@@ -22,6 +22,10 @@ TriggerActivityMaker::make_maker(const nlohmann::json& obj)
   set_algorithm_name(params.activity_maker);
   set_sourceid(params.geoid_element);
   set_windowing(params.window_time, params.buffer_time);
+  set_worker_shards(params.n_shards);
+  set_pipeline_depth(params.pipeline_depth);
+  set_shared_work_pool(params.use_shared_work_pool);
+  set_thread_placement(params.cpu_affinity, params.numa_node);
   std::unique_ptr<triggeralgs::TriggerActivityMaker> maker = make_ta_maker(params.activity_maker);
   maker->configure(params.activity_maker_config);
   std::cout << "Made a TAMaker - data_vs_system_time param: " << maker->m_data_vs_system_time << "\n";
@@ -20,6 +20,8 @@ TriggerCandidateMaker::make_maker(const nlohmann::json& obj)
 {
   auto params = obj.get<triggercandidatemaker::Conf>();
   set_algorithm_name(params.candidate_maker);
+  set_shared_work_pool(params.use_shared_work_pool);
+  set_thread_placement(params.cpu_affinity, params.numa_node);
   std::unique_ptr<triggeralgs::TriggerCandidateMaker> maker = make_tc_maker(params.candidate_maker);
   maker->configure(params.candidate_maker_config);
   return maker;
@@ -20,6 +20,8 @@ TriggerDecisionMaker::make_maker(const nlohmann::json& obj)
 {
   auto params = obj.get<triggerdecisionmaker::Conf>();
   set_algorithm_name(params.decision_maker);
+  set_shared_work_pool(params.use_shared_work_pool);
+  set_thread_placement(params.cpu_affinity, params.numa_node);
   std::unique_ptr<triggeralgs::TriggerDecisionMaker> maker = make_td_maker(params.decision_maker);
   maker->configure(params.decision_maker_config);
   return maker;
@@ -0,0 +1,157 @@
+/**
+ * @file TriggerDecisionMakerSupernovaIncremental.hpp
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#ifndef TRIGGER_PLUGINS_TRIGGERDECISIONMAKERSUPERNOVAINCREMENTAL_HPP_
+#define TRIGGER_PLUGINS_TRIGGERDECISIONMAKERSUPERNOVAINCREMENTAL_HPP_
+
+#include "triggeralgs/TriggerCandidate.hpp"
+#include "triggeralgs/TriggerDecision.hpp"
+#include "triggeralgs/TriggerDecisionMaker.hpp"
+#include "triggeralgs/Types.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace dunedaq::trigger {
+
+/**
+ * @brief Supernova-burst multiplicity trigger with incremental window
+ * maintenance.
+ *
+ * Same condition as triggeralgs::TriggerDecisionMakerSupernova - at least
+ * `threshold` qualifying candidates within the trailing `time_window` -
+ * but instead of keeping the candidate list and rescanning it on every
+ * update, the window is divided into fixed-width time buckets held in a
+ * ring, with a running sum maintained on add and expiry. Each candidate
+ * costs O(1) amortized regardless of how wide the window is, so the
+ * window can be tens of seconds without the decision path growing with
+ * it. The trade for that is bucket-width granularity on expiry: a
+ * candidate leaves the sum when its whole bucket ages out, so the
+ * effective window is up to one bucket longer than configured.
+ *
+ * Configuration (same names as the list-based maker, plus the bucket
+ * size):
+ *  - time_window: trailing window in timestamp ticks
+ *  - threshold: candidate multiplicity that fires the trigger
+ *  - hit_threshold: minimum inputs per candidate for it to count
+ *  - bucket_width: ticks per ring bucket; 0 (default) derives
+ *    time_window/1024, floored at 1
+ */
+class TriggerDecisionMakerSupernovaIncremental : public triggeralgs::TriggerDecisionMaker
+{
+public:
+  void operator()(const triggeralgs::TriggerCandidate& cand,
+                  std::vector<triggeralgs::TriggerDecision>& decisions) override
+  {
+    using triggeralgs::timestamp_t;
+
+    if (cand.inputs.size() < m_hit_threshold) {
+      return;
+    }
+
+    const timestamp_t time = cand.time_start;
+    const uint64_t bucket = time / m_bucket_width; // NOLINT(build/unsigned)
+
+    if (!m_started) {
+      m_started = true;
+      m_newest_bucket = bucket;
+    }
+
+    if (bucket > m_newest_bucket) {
+      advance_to(bucket);
+    } else if (m_newest_bucket - bucket >= m_counts.size()) {
+      // Late candidate from before the window: already expired, don't count
+      return;
+    }
+
+    ++m_counts[bucket % m_counts.size()];
+    ++m_window_count;
+
+    if (m_window_count >= m_threshold) {
+      triggeralgs::TriggerDecision dec{};
+      dec.time_start = (time > m_time_window) ? time - m_time_window : 0;
+      dec.time_end = time;
+      dec.time_triggered = time;
+      decisions.push_back(dec);
+      // Re-arm empty, as the list-based maker does by clearing its
+      // candidate list: the burst that fired shouldn't fire again on its
+      // own tail
+      reset_window();
+    }
+  }
+
+  void configure(const nlohmann::json& config) override
+  {
+    if (config.is_object()) {
+      if (config.contains("time_window")) {
+        m_time_window = config["time_window"];
+      }
+      if (config.contains("threshold")) {
+        m_threshold = config["threshold"];
+      }
+      if (config.contains("hit_threshold")) {
+        m_hit_threshold = config["hit_threshold"];
+      }
+      if (config.contains("bucket_width")) {
+        m_bucket_width = config["bucket_width"];
+      }
+    }
+    if (m_bucket_width == 0) {
+      m_bucket_width = std::max<triggeralgs::timestamp_t>(1, m_time_window / 1024);
+    }
+    const size_t n_buckets = std::max<size_t>(1, (m_time_window + m_bucket_width - 1) / m_bucket_width);
+    m_counts.assign(n_buckets, 0);
+    reset_window();
+    m_started = false;
+  }
+
+private:
+  // Move the newest edge of the ring forward to `bucket`, expiring each
+  // slot that rotates out of the window. Cost is one slot per bucket of
+  // real time elapsed, independent of how many candidates they held
+  void advance_to(uint64_t bucket) // NOLINT(build/unsigned)
+  {
+    const size_t n = m_counts.size();
+    uint64_t steps = bucket - m_newest_bucket; // NOLINT(build/unsigned)
+    if (steps >= n) {
+      // Jumped past the whole window; nothing old survives
+      reset_window();
+    } else {
+      while (steps-- > 0) {
+        ++m_newest_bucket;
+        uint32_t& slot = m_counts[m_newest_bucket % n]; // NOLINT(build/unsigned)
+        m_window_count -= slot;
+        slot = 0;
+      }
+    }
+    m_newest_bucket = bucket;
+  }
+
+  void reset_window()
+  {
+    std::fill(m_counts.begin(), m_counts.end(), 0);
+    m_window_count = 0;
+  }
+
+  triggeralgs::timestamp_t m_time_window = 500000000;
+  uint64_t m_threshold = 12;     // NOLINT(build/unsigned)
+  uint64_t m_hit_threshold = 2;  // NOLINT(build/unsigned)
+  triggeralgs::timestamp_t m_bucket_width = 0;
+
+  std::vector<uint32_t> m_counts; // NOLINT(build/unsigned)
+  uint64_t m_newest_bucket = 0;   // NOLINT(build/unsigned)
+  uint64_t m_window_count = 0;    // NOLINT(build/unsigned)
+  bool m_started = false;
+};
+
+} // namespace dunedaq::trigger
+
+#endif // TRIGGER_PLUGINS_TRIGGERDECISIONMAKERSUPERNOVAINCREMENTAL_HPP_
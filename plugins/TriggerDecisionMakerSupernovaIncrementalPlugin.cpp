@@ -0,0 +1,12 @@
+/**
+ * @file TriggerDecisionMakerSupernovaIncrementalPlugin.cpp
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#include "TriggerDecisionMakerSupernovaIncremental.hpp"
+#include "trigger/AlgorithmPlugins.hpp"
+
+DEFINE_DUNE_TD_MAKER(dunedaq::trigger::TriggerDecisionMakerSupernovaIncremental)
@@ -8,6 +8,8 @@
 
 #include "TriggerPrimitiveMaker.hpp"
 
+#include "trigger/TPStreamFile.hpp"
+
 #include "trigger/Issues.hpp" // For TLVL_*
 #include "trigger/Logging.hpp"
 
@@ -70,15 +72,63 @@ TriggerPrimitiveMaker::do_configure(const nlohmann::json& obj)
     TPStream this_stream;
     this_stream.tpset_sink = get_iom_sender<TPSet>(appfwk::connection_uid(m_init_obj, stream.output_sink_name));
 
-    this_stream.tpsets = read_tpsets(stream.filename, stream.element_id);
+    if (m_conf.streaming) {
+      // Streaming mode: only peek at the first and last TP timestamps here,
+      // so configure is quick and memory stays bounded by the prefetch
+      // window. The file itself is read during the run
+      this_stream.filename = stream.filename;
+      this_stream.element_id = stream.element_id;
+      auto time_range = peek_tpset_time_range(stream.filename);
+      m_earliest_first_tpset_timestamp = std::min(m_earliest_first_tpset_timestamp, time_range.first);
+      m_latest_last_tpset_timestamp = std::max(m_latest_last_tpset_timestamp, time_range.second);
+    } else {
+      // Each file load is independent, so run them in parallel and collect
+      // the results in finish_loading(), letting the reads overlap
+      // whatever happens between conf and start
+      std::string filename = stream.filename;
+      int element_id = stream.element_id;
+      m_load_futures.push_back(std::async(std::launch::async, [this, filename, element_id] {
+        auto load_start_time = std::chrono::steady_clock::now();
+        std::vector<TPSet> tpsets = read_tpsets(filename, element_id);
+        auto load_time_ms =
+          std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - load_start_time)
+            .count();
+        TLOG() << "[TPM] Loaded " << tpsets.size() << " TPSets from file " << filename << " in " << load_time_ms
+               << " ms";
+        return tpsets;
+      }));
+    }
 
-    m_earliest_first_tpset_timestamp =
-      std::min(m_earliest_first_tpset_timestamp, this_stream.tpsets.front().start_time);
+    m_tp_streams.push_back(std::move(this_stream));
+  }
+}
+
+void
+TriggerPrimitiveMaker::finish_loading()
+{
+  if (m_load_futures.empty()) {
+    return;
+  }
 
-    m_latest_last_tpset_timestamp = std::max(m_latest_last_tpset_timestamp, this_stream.tpsets.back().start_time);
+  auto wait_start_time = std::chrono::steady_clock::now();
+  size_t future_index = 0;
+  for (auto& stream : m_tp_streams) {
+    if (!stream.tpsets.empty()) {
+      continue;
+    }
+    stream.tpsets = m_load_futures.at(future_index).get();
+    ++future_index;
 
-    m_tp_streams.push_back(std::move(this_stream));
+    m_earliest_first_tpset_timestamp =
+      std::min(m_earliest_first_tpset_timestamp, stream.tpsets.front().start_time);
+    m_latest_last_tpset_timestamp = std::max(m_latest_last_tpset_timestamp, stream.tpsets.back().start_time);
   }
+  m_load_futures.clear();
+
+  auto wait_time_ms =
+    std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - wait_start_time).count();
+  TLOG() << "[TPM] All " << m_tp_streams.size() << " streams loaded; waited " << wait_time_ms
+         << " ms for outstanding loads at start";
 }
 
 void
@@ -89,6 +139,10 @@ TriggerPrimitiveMaker::do_start(const nlohmann::json& args)
   rcif::cmd::StartParams start_params = args.get<rcif::cmd::StartParams>();
   m_run_number = start_params.run;
 
+  // In eager mode, block here until any stream loads still in flight from
+  // do_configure have landed
+  finish_loading();
+
   m_running_flag.store(true);
 
   // We need the wall-clock time at which we'll send out the TPSet
@@ -98,12 +152,23 @@ TriggerPrimitiveMaker::do_start(const nlohmann::json& args)
   auto earliest_timestamp_time = std::chrono::steady_clock::now() + std::chrono::milliseconds(10);
 
   for (auto& stream : m_tp_streams) {
-    m_threads.push_back(std::make_unique<std::thread>(&TriggerPrimitiveMaker::do_work,
-                                                      this,
-                                                      std::ref(m_running_flag),
-                                                      std::ref(stream.tpsets),
-                                                      std::ref(stream.tpset_sink),
-                                                      earliest_timestamp_time));
+    if (m_conf.streaming) {
+      stream.prefetch_buffer = std::make_unique<PrefetchBuffer>(m_conf.prefetch_capacity_tpsets);
+      m_threads.push_back(std::make_unique<std::thread>(
+        &TriggerPrimitiveMaker::do_read_streaming, this, std::ref(m_running_flag), std::ref(stream)));
+      m_threads.push_back(std::make_unique<std::thread>(&TriggerPrimitiveMaker::do_work_streaming,
+                                                        this,
+                                                        std::ref(m_running_flag),
+                                                        std::ref(stream),
+                                                        earliest_timestamp_time));
+    } else {
+      m_threads.push_back(std::make_unique<std::thread>(&TriggerPrimitiveMaker::do_work,
+                                                        this,
+                                                        std::ref(m_running_flag),
+                                                        std::cref(stream.tpsets),
+                                                        std::ref(stream.tpset_sink),
+                                                        earliest_timestamp_time));
+    }
   }
   for (size_t i = 0; i < m_threads.size(); ++i) {
     std::string name("replay");
@@ -131,6 +196,8 @@ void
 TriggerPrimitiveMaker::do_scrap(const nlohmann::json& /*args*/)
 {
   TLOG_DEBUG(TLVL_GENERAL) << "[TPM] " << get_name() << ": Entering do_scrap() method";
+  // Don't leave loader tasks running against streams we are about to drop
+  finish_loading();
   m_tp_streams.clear();
   TLOG_DEBUG(TLVL_GENERAL) << "[TPM] " << get_name() << ": Exiting do_scrap() method";
 }
@@ -145,6 +212,21 @@ TriggerPrimitiveMaker::read_tpsets(std::string filename, int element)
   uint32_t seqno = 0;             // NOLINT(build/unsigned)
   uint64_t old_time_start = 0;    // NOLINT(build/unsigned)
 
+  // Pre-formed TPSet stream files skip the fragment walk and TPSet
+  // building entirely: the sets are read back chunk by chunk, with only
+  // the origin and seqno restamped for this stream
+  if (is_tpstream_file(filename)) {
+    TPStreamReader reader(filename);
+    while (reader.read_next(tpset)) {
+      tpset.origin.id = element;
+      tpset.seqno = seqno;
+      ++seqno;
+      tpsets.push_back(tpset);
+    }
+    TLOG_DEBUG(TLVL_DEBUG_INFO) << "[TPM] Read " << tpsets.size() << " TPSets from stream file " << filename;
+    return tpsets;
+  }
+
   // Prepare input file
   std::unique_ptr<hdf5libs::HDF5RawDataFile> input_file = std::make_unique<hdf5libs::HDF5RawDataFile>(filename);
 
@@ -214,9 +296,313 @@ TriggerPrimitiveMaker::read_tpsets(std::string filename, int element)
   return tpsets;
 }
 
+// Find the start times of the first and last TPSets in the file by reading
+// only the first and last TriggerPrimitive fragments, so streaming mode can
+// establish the replay time range without loading the file
+std::pair<triggeralgs::timestamp_t, triggeralgs::timestamp_t>
+TriggerPrimitiveMaker::peek_tpset_time_range(std::string filename)
+{
+  // Stream files carry a time index in their footer, so the range is two
+  // index reads away
+  if (is_tpstream_file(filename)) {
+    TPStreamReader reader(filename);
+    auto range = reader.time_range();
+    TLOG_DEBUG(TLVL_DEBUG_INFO) << "[TPM] Peeked TPSet time range [" << range.first << ", " << range.second
+                                << "] from stream file " << filename;
+    return range;
+  }
+
+  std::unique_ptr<hdf5libs::HDF5RawDataFile> input_file = std::make_unique<hdf5libs::HDF5RawDataFile>(filename);
+
+  if (!input_file->is_timeslice_type()) {
+    throw BadTPInputFile(ERS_HERE, get_name(), filename);
+  }
+
+  std::vector<std::string> fragment_paths = input_file->get_all_fragment_dataset_paths();
+
+  auto is_tp_fragment = [](std::unique_ptr<daqdataformats::Fragment> const& frag) {
+    return frag->get_fragment_type() == daqdataformats::FragmentType::kTriggerPrimitive &&
+           frag->get_element_id().subsystem == daqdataformats::SourceID::Subsystem::kTrigger &&
+           frag->get_data_size() >= sizeof(trgdataformats::TriggerPrimitive);
+  };
+
+  triggeralgs::timestamp_t first_tp_time = 0;
+  triggeralgs::timestamp_t last_tp_time = 0;
+  bool found_first = false;
+  bool found_last = false;
+
+  for (auto it = fragment_paths.begin(); it != fragment_paths.end() && !found_first; ++it) {
+    std::unique_ptr<daqdataformats::Fragment> frag = input_file->get_frag_ptr(*it);
+    if (is_tp_fragment(frag)) {
+      first_tp_time = static_cast<trgdataformats::TriggerPrimitive*>(frag->get_data())->time_start;
+      found_first = true;
+    }
+  }
+  for (auto it = fragment_paths.rbegin(); it != fragment_paths.rend() && !found_last; ++it) {
+    std::unique_ptr<daqdataformats::Fragment> frag = input_file->get_frag_ptr(*it);
+    if (is_tp_fragment(frag)) {
+      size_t num_tps = frag->get_data_size() / sizeof(trgdataformats::TriggerPrimitive);
+      last_tp_time = static_cast<trgdataformats::TriggerPrimitive*>(frag->get_data())[num_tps - 1].time_start;
+      found_last = true;
+    }
+  }
+
+  if (!found_first || !found_last) {
+    throw BadTPInputFile(ERS_HERE, get_name(), filename);
+  }
+
+  // Convert TP times to the start times of the TPSets that would contain
+  // them, matching the boundary convention used in read_tpsets
+  triggeralgs::timestamp_t first_tpset_start =
+    ((first_tp_time + m_conf.tpset_time_offset) / m_conf.tpset_time_width) * m_conf.tpset_time_width +
+    m_conf.tpset_time_offset;
+  triggeralgs::timestamp_t last_tpset_start =
+    ((last_tp_time + m_conf.tpset_time_offset) / m_conf.tpset_time_width) * m_conf.tpset_time_width +
+    m_conf.tpset_time_offset;
+
+  TLOG_DEBUG(TLVL_DEBUG_INFO) << "[TPM] Peeked TPSet time range [" << first_tpset_start << ", " << last_tpset_start
+                              << "] from file " << filename;
+  return { first_tpset_start, last_tpset_start };
+}
+
+bool
+TriggerPrimitiveMaker::PrefetchBuffer::push(TPSet&& tpset, std::atomic<bool>& running_flag)
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+  while (m_queue.size() >= m_capacity) {
+    if (!running_flag.load()) {
+      return false;
+    }
+    m_cv_not_full.wait_for(lock, std::chrono::milliseconds(10));
+  }
+  m_queue.push_back(std::move(tpset));
+  m_cv_not_empty.notify_one();
+  return true;
+}
+
+std::optional<TPSet>
+TriggerPrimitiveMaker::PrefetchBuffer::pop(std::atomic<bool>& running_flag)
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+  while (m_queue.empty()) {
+    if (m_done || !running_flag.load()) {
+      return std::nullopt;
+    }
+    m_cv_not_empty.wait_for(lock, std::chrono::milliseconds(10));
+  }
+  TPSet tpset = std::move(m_queue.front());
+  m_queue.pop_front();
+  m_cv_not_full.notify_one();
+  return tpset;
+}
+
+void
+TriggerPrimitiveMaker::PrefetchBuffer::set_done()
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_done = true;
+  m_cv_not_empty.notify_all();
+}
+
+// Streaming-mode producer: reads the stream's file ahead of the replay
+// cursor and pushes TPSets into the bounded prefetch buffer, blocking when
+// the replay thread falls behind. The TPSet-building logic mirrors
+// read_tpsets; on every loop over the file the timestamps are shifted by
+// the total stream duration, as the replay thread does in eager mode
+void
+TriggerPrimitiveMaker::do_read_streaming(std::atomic<bool>& running_flag, TPStream& stream)
+{
+  TLOG_DEBUG(TLVL_GENERAL) << "[TPM] " << get_name() << ": Entering do_read_streaming() method";
+
+  uint64_t current_iteration = 0; // NOLINT(build/unsigned)
+  uint32_t seqno = 0;             // NOLINT(build/unsigned)
+  auto const total_stream_duration = m_latest_last_tpset_timestamp - m_earliest_first_tpset_timestamp;
+
+  while (running_flag.load()) {
+    if (m_conf.number_of_loops > 0 && current_iteration >= m_conf.number_of_loops) {
+      break;
+    }
+    triggeralgs::timestamp_t const time_shift = current_iteration * total_stream_duration;
+
+    TPSet tpset;
+    uint64_t prev_tpset_number = 0; // NOLINT(build/unsigned)
+    uint64_t old_time_start = 0;    // NOLINT(build/unsigned)
+
+    // Stream files hold pre-formed TPSets, so the prefetch pass is just
+    // decompress, restamp and shift
+    if (is_tpstream_file(stream.filename)) {
+      TPStreamReader reader(stream.filename);
+      while (running_flag.load() && reader.read_next(tpset)) {
+        tpset.start_time += time_shift;
+        tpset.end_time += time_shift;
+        tpset.seqno = seqno;
+        ++seqno;
+        tpset.origin.id = stream.element_id;
+        tpset.run_number = m_run_number;
+        for (auto& tp : tpset.objects) {
+          tp.time_start += time_shift;
+          tp.time_peak += time_shift;
+        }
+        if (!stream.prefetch_buffer->push(std::move(tpset), running_flag)) {
+          return;
+        }
+      }
+      ++current_iteration;
+      continue;
+    }
+
+    std::unique_ptr<hdf5libs::HDF5RawDataFile> input_file =
+      std::make_unique<hdf5libs::HDF5RawDataFile>(stream.filename);
+    if (!input_file->is_timeslice_type()) {
+      throw BadTPInputFile(ERS_HERE, get_name(), stream.filename);
+    }
+
+    std::vector<std::string> fragment_paths = input_file->get_all_fragment_dataset_paths();
+
+    for (std::string& fragment_path : fragment_paths) {
+      if (!running_flag.load()) {
+        break;
+      }
+      std::unique_ptr<daqdataformats::Fragment> frag = input_file->get_frag_ptr(fragment_path);
+      if (frag->get_fragment_type() != daqdataformats::FragmentType::kTriggerPrimitive)
+        continue;
+      if (frag->get_element_id().subsystem != daqdataformats::SourceID::Subsystem::kTrigger)
+        continue;
+
+      size_t num_tps = frag->get_data_size() / sizeof(trgdataformats::TriggerPrimitive);
+      trgdataformats::TriggerPrimitive* tp_array = static_cast<trgdataformats::TriggerPrimitive*>(frag->get_data());
+
+      for (size_t i(0); i < num_tps; i++) {
+        auto& tp = tp_array[i];
+        if (tp.time_start < old_time_start) {
+          ers::warning(UnsortedTP(ERS_HERE, get_name(), tp.time_start));
+          continue;
+        }
+        // NOLINTNEXTLINE(build/unsigned)
+        uint64_t current_tpset_number = (tp.time_start + m_conf.tpset_time_offset) / m_conf.tpset_time_width;
+        old_time_start = tp.time_start;
+
+        // If we crossed a time boundary, hand the current TPSet to the
+        // replay thread and reset it
+        if (current_tpset_number > prev_tpset_number) {
+          tpset.start_time = prev_tpset_number * m_conf.tpset_time_width + m_conf.tpset_time_offset + time_shift;
+          tpset.end_time = tpset.start_time + m_conf.tpset_time_width;
+          tpset.seqno = seqno;
+          ++seqno;
+          tpset.origin.id = stream.element_id;
+          tpset.type = TPSet::Type::kPayload;
+          tpset.run_number = m_run_number;
+
+          if (!tpset.objects.empty()) {
+            // We don't send empty TPSets, so there's no point creating them
+            TPSet tpset_out(tpset);
+            if (!stream.prefetch_buffer->push(std::move(tpset_out), running_flag)) {
+              return;
+            }
+          }
+          prev_tpset_number = current_tpset_number;
+
+          tpset.objects.clear();
+        }
+        trgdataformats::TriggerPrimitive tp_shifted = tp;
+        tp_shifted.time_start += time_shift;
+        tp_shifted.time_peak += time_shift;
+        tpset.objects.push_back(tp_shifted);
+      }
+    }
+    if (!tpset.objects.empty() && running_flag.load()) {
+      tpset.run_number = m_run_number;
+      if (!stream.prefetch_buffer->push(std::move(tpset), running_flag)) {
+        return;
+      }
+    }
+    ++current_iteration;
+  }
+
+  stream.prefetch_buffer->set_done();
+  TLOG_DEBUG(TLVL_DEBUG_INFO) << "[TPM] Streamed " << seqno << " TPSets over " << current_iteration
+                              << " loops from file " << stream.filename;
+  TLOG_DEBUG(TLVL_GENERAL) << "[TPM] " << get_name() << ": Exiting do_read_streaming() method";
+}
+
+// Streaming-mode consumer: same pacing as do_work, but TPSets are popped
+// from the prefetch buffer (already timestamp-shifted per loop) instead of
+// iterated from a preloaded vector, and can be sent by move
+void
+TriggerPrimitiveMaker::do_work_streaming(std::atomic<bool>& running_flag,
+                                         TPStream& stream,
+                                         std::chrono::steady_clock::time_point earliest_timestamp_time)
+{
+  TLOG_DEBUG(TLVL_GENERAL) << "[TPM] " << get_name() << ": Entering do_work_streaming() method";
+  size_t generated_count = 0;
+  size_t push_failed_count = 0;
+  size_t generated_tp_count = 0;
+
+  uint64_t prev_tpset_start_time = 0; // NOLINT(build/unsigned)
+  auto prev_tpset_send_time = std::chrono::steady_clock::now();
+
+  auto run_start_time = std::chrono::steady_clock::now();
+
+  auto const clocks_per_us = m_conf.clock_frequency_hz / 1'000'000;
+
+  while (running_flag.load()) {
+    std::optional<TPSet> tpset = stream.prefetch_buffer->pop(running_flag);
+    if (!tpset.has_value()) {
+      break;
+    }
+
+    auto wait_time_us = 0;
+    std::chrono::steady_clock::time_point next_tpset_send_time;
+    if (prev_tpset_start_time == 0) {
+      wait_time_us = (tpset->start_time - m_earliest_first_tpset_timestamp) / clocks_per_us;
+      next_tpset_send_time = earliest_timestamp_time + std::chrono::microseconds(wait_time_us);
+    } else {
+      wait_time_us = (tpset->start_time - prev_tpset_start_time) / clocks_per_us;
+      next_tpset_send_time = prev_tpset_send_time + std::chrono::microseconds(wait_time_us);
+    }
+
+    // check running_flag periodically so we can stop punctually
+    auto slice_period = std::chrono::microseconds(m_conf.maximum_wait_time_us);
+    auto next_slice_send_time = prev_tpset_send_time + slice_period;
+    bool break_flag = false;
+    while (next_tpset_send_time > next_slice_send_time + slice_period) {
+      if (!running_flag.load()) {
+        TLOG_DEBUG(TLVL_IMPORTANT) << "[TPM] while waiting to send next TP, negative running flag detected.";
+        break_flag = true;
+        break;
+      }
+      std::this_thread::sleep_until(next_slice_send_time);
+      next_slice_send_time = next_slice_send_time + slice_period;
+    }
+    if (!break_flag) {
+      std::this_thread::sleep_until(next_tpset_send_time);
+    }
+    prev_tpset_send_time = next_tpset_send_time;
+    prev_tpset_start_time = tpset->start_time;
+
+    ++generated_count;
+    generated_tp_count += tpset->objects.size();
+    try {
+      stream.tpset_sink->send(std::move(*tpset), m_queue_timeout);
+    } catch (const dunedaq::iomanager::TimeoutExpired& e) {
+      ers::warning(e);
+      ++push_failed_count;
+    }
+  }
+
+  auto run_end_time = std::chrono::steady_clock::now();
+  auto time_ms = std::chrono::duration_cast<std::chrono::milliseconds>(run_end_time - run_start_time).count();
+  float rate_hz = 1e3 * static_cast<float>(generated_count) / time_ms;
+
+  TLOG() << "[TPM] Generated " << generated_count << " TP sets (" << generated_tp_count << " TPs) in " << time_ms
+         << " ms. (" << rate_hz << " TPSets/s). " << push_failed_count << " failed to push";
+
+  TLOG_DEBUG(TLVL_GENERAL) << "[TPM] " << get_name() << ": Exiting do_work_streaming() method";
+}
+
 void
 TriggerPrimitiveMaker::do_work(std::atomic<bool>& running_flag,
-                               std::vector<TPSet>& tpsets,
+                               const std::vector<TPSet>& tpsets,
                                std::shared_ptr<iomanager::SenderConcept<TPSet>>& tpset_sink,
                                std::chrono::steady_clock::time_point earliest_timestamp_time)
 {
@@ -242,12 +628,20 @@ TriggerPrimitiveMaker::do_work(std::atomic<bool>& running_flag,
       break;
     }
 
-    for (auto& tpset : tpsets) {
+    // The in-memory dataset is never mutated: each loop over the file
+    // applies a per-loop timestamp delta to the outgoing copy only, so
+    // timestamps and seqnos don't repeat across loops but the replay rate
+    // is the same on loop 1000 as on loop 1
+    triggeralgs::timestamp_t const time_shift = current_iteration * total_stream_duration;
+
+    for (auto const& tpset : tpsets) {
 
       if (!running_flag.load()) {
         break;
       }
 
+      triggeralgs::timestamp_t const shifted_start_time = tpset.start_time + time_shift;
+
       // The argument `earliest_timestamp_time` is the wall-clock time
       // of the earliest first tpset timestamp in _any_ of the input
       // streams. So for the first TPSet we send out, we wait until
@@ -255,10 +649,10 @@ TriggerPrimitiveMaker::do_work(std::atomic<bool>& running_flag,
       auto wait_time_us = 0;
       std::chrono::steady_clock::time_point next_tpset_send_time;
       if (prev_tpset_start_time == 0) {
-        wait_time_us = (tpset.start_time - m_earliest_first_tpset_timestamp) / clocks_per_us;
+        wait_time_us = (shifted_start_time - m_earliest_first_tpset_timestamp) / clocks_per_us;
         next_tpset_send_time = earliest_timestamp_time + std::chrono::microseconds(wait_time_us);
       } else {
-        wait_time_us = (tpset.start_time - prev_tpset_start_time) / clocks_per_us;
+        wait_time_us = (shifted_start_time - prev_tpset_start_time) / clocks_per_us;
         next_tpset_send_time = prev_tpset_send_time + std::chrono::microseconds(wait_time_us);
       }
 
@@ -279,30 +673,30 @@ TriggerPrimitiveMaker::do_work(std::atomic<bool>& running_flag,
         std::this_thread::sleep_until(next_tpset_send_time);
       }
       prev_tpset_send_time = next_tpset_send_time;
-      prev_tpset_start_time = tpset.start_time;
+      prev_tpset_start_time = shifted_start_time;
 
       ++generated_count;
       generated_tp_count += tpset.objects.size();
       try {
         TPSet tpset_copy(tpset);
+        if (current_iteration > 0) {
+          // Materialize the loop delta into the outgoing copy only
+          tpset_copy.run_number = m_run_number;
+          tpset_copy.seqno = seqno;
+          ++seqno;
+          tpset_copy.start_time += time_shift;
+          tpset_copy.end_time += time_shift;
+          for (auto& tp : tpset_copy.objects) {
+            tp.time_start += time_shift;
+            tp.time_peak += time_shift;
+          }
+        }
         tpset_sink->send(std::move(tpset_copy), m_queue_timeout);
       } catch (const dunedaq::iomanager::TimeoutExpired& e) {
         ers::warning(e);
         ++push_failed_count;
       }
 
-      tpset.run_number = m_run_number;
-      // Increase seqno and the timestamps in the TPSet and TPs so they don't
-      // repeat when we do multiple loops over the file
-      tpset.start_time += total_stream_duration;
-      tpset.end_time += total_stream_duration;
-      for (auto& tp : tpset.objects) {
-        tp.time_start += total_stream_duration;
-        tp.time_peak += total_stream_duration;
-      }
-      tpset.seqno = seqno;
-      ++seqno;
-
     } // end loop over tpsets
     ++current_iteration;
 
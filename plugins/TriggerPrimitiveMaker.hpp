@@ -20,8 +20,14 @@
 #include "triggeralgs/Types.hpp"
 #include "utilities/WorkerThread.hpp"
 
+#include <condition_variable>
+#include <deque>
+#include <future>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace dunedaq {
@@ -50,15 +56,59 @@ private:
   void do_stop(const nlohmann::json& obj);
   void do_scrap(const nlohmann::json& obj);
 
+  // Bounded handoff between a prefetch thread and its replay thread in
+  // streaming mode. push() blocks while the buffer is at capacity, pop()
+  // blocks while it is empty, and both give up periodically so the
+  // running flag can be honoured
+  struct PrefetchBuffer
+  {
+    explicit PrefetchBuffer(size_t capacity)
+      : m_capacity(capacity)
+    {}
+
+    bool push(TPSet&& tpset, std::atomic<bool>& running_flag);
+    std::optional<TPSet> pop(std::atomic<bool>& running_flag);
+    void set_done();
+
+    std::deque<TPSet> m_queue;
+    std::mutex m_mutex;
+    std::condition_variable m_cv_not_full;
+    std::condition_variable m_cv_not_empty;
+    size_t m_capacity;
+    bool m_done{ false };
+  };
+
+  struct TPStream; // defined below
+
   // Threading
   void do_work(std::atomic<bool>&,
-               std::vector<TPSet>& tpsets,
+               const std::vector<TPSet>& tpsets,
                std::shared_ptr<iomanager::SenderConcept<TPSet>>& tpset_sink,
                std::chrono::steady_clock::time_point earliest_timestamp_time);
+  void do_read_streaming(std::atomic<bool>&, TPStream& stream);
+  void do_work_streaming(std::atomic<bool>&,
+                         TPStream& stream,
+                         std::chrono::steady_clock::time_point earliest_timestamp_time);
   std::vector<std::unique_ptr<std::thread>> m_threads;
   std::atomic<bool> m_running_flag;
 
   std::vector<TPSet> read_tpsets(std::string filename, int element);
+  std::pair<triggeralgs::timestamp_t, triggeralgs::timestamp_t> peek_tpset_time_range(std::string filename);
+
+  // Input files ending in .tpstream hold pre-formed, compressed TPSets
+  // (see TPStreamFile.hpp) instead of raw HDF5 TP fragments
+  static bool is_tpstream_file(const std::string& filename)
+  {
+    static const std::string suffix = ".tpstream";
+    return filename.size() >= suffix.size() &&
+           filename.compare(filename.size() - suffix.size(), suffix.size(), suffix) == 0;
+  }
+
+  // Eager-mode loading runs in one async task per stream, launched at
+  // configure time; finish_loading() collects the results and is called
+  // from do_start, so file reads overlap the conf-to-start window
+  std::vector<std::future<std::vector<TPSet>>> m_load_futures;
+  void finish_loading();
 
   // Configuration
   triggerprimitivemaker::ConfParams m_conf;
@@ -71,6 +121,12 @@ private:
   {
     std::shared_ptr<iomanager::SenderConcept<TPSet>> tpset_sink;
     std::vector<TPSet> tpsets;
+    // Streaming mode: the file is read during the run by a prefetch
+    // thread, bounded by the buffer capacity, instead of into `tpsets`
+    // at configure time
+    std::string filename;
+    int element_id{ 0 };
+    std::unique_ptr<PrefetchBuffer> prefetch_buffer;
   };
 
   std::vector<TPStream> m_tp_streams;
@@ -9,10 +9,17 @@
 #ifndef TRIGGER_PLUGINS_TRIGGERZIPPER_HPP_
 #define TRIGGER_PLUGINS_TRIGGERZIPPER_HPP_
 
+#include "SlabPool.hpp"
 #include "zipper.hpp"
 
 #include "trigger/Issues.hpp"
+#include "trigger/IssueThrottler.hpp"
+#include "trigger/LatencyHistogram.hpp"
 #include "trigger/Logging.hpp"
+#include "trigger/MetricSnapshot.hpp"
+#include "trigger/QueueSpy.hpp"
+#include "trigger/WorkerLiveness.hpp"
+#include "trigger/ThreadPlacement.hpp"
 #include "trigger/triggerzipper/Nljs.hpp"
 #include "trigger/triggerzipperinfo/InfoNljs.hpp"
 
@@ -27,9 +34,18 @@
 #include "utilities/WorkerThread.hpp"
 
 
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <chrono>
-#include <list>
+#include <cstdint>
+#include <limits>
+#include <condition_variable>
+#include <deque>
 #include <map>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
 #include <memory>
 #include <sstream>
 #include <string>
@@ -66,28 +82,96 @@ public:
   using origin_type = typename TSET::origin_t; // GeoID
   using seqno_type = typename TSET::seqno_t;   // GeoID
 
-  using cache_type = std::list<TSET>;
-  using payload_type = typename cache_type::iterator;
+  using cache_type = SlabPool<TSET>;
+  using payload_type = TSET*;
   using identity_type = size_t;
 
   using node_type = zipper::Node<payload_type>;
+  using timepoint_type = typename node_type::timepoint_t;
   using zm_type = zipper::merge<node_type>;
+  using lt_type = zipper::loser_merge<node_type>;
+
+  // Cap on sets fed per batch, so draining keeps pace with feeding even on
+  // a persistently full input queue
+  static constexpr size_t s_max_feed_batch = 64;
   zm_type m_zm;
+  // Alternative merge engine for high stream cardinality, selected with the
+  // use_loser_tree config flag. Only one of the two engines is ever fed
+  lt_type m_lt;
+  bool m_use_lt{ false };
+
+  // Watermark ordering mode (use_heartbeat_watermarks): per-stream
+  // high-water data timestamps learned from kHeartbeat sets. Once every
+  // expected stream has reported, everything at or below the minimum
+  // watermark is known to be safe to emit, with no wall-clock involvement
+  bool m_use_watermark{ false };
+  std::unordered_map<identity_type, ordering_type> m_watermarks;
+  ordering_type m_min_watermark{ 0 };
+  bool m_min_watermark_valid{ false };
+
+  // Hierarchical (tree) merge mode (n_first_stage >= 2): the input streams
+  // are partitioned across M first-stage merges, each on its own thread,
+  // feeding one small final merge of cardinality M run on the worker
+  // thread. This turns an APA-scale k-way merge into a parallel reduction
+  // without wiring intermediate zipper modules in the app config
+  struct Stage
+  {
+    zm_type engine;
+    std::deque<node_type> inbox;
+    std::mutex mtx;
+    std::condition_variable cv;
+    std::thread thread;
+  };
+  std::vector<std::unique_ptr<Stage>> m_stages;
+  // First-stage results, with identity rewritten to the stage index, and
+  // slots a first stage rejected (paired with that stage's origin)
+  std::deque<node_type> m_stage_out;
+  std::deque<std::pair<payload_type, ordering_type>> m_stage_tardy;
+  std::mutex m_stage_out_mtx;
+  std::unordered_map<uint32_t, size_t> m_shard_of; // SourceID.id -> stage
+
+  bool tree_mode() const { return m_cfg.n_first_stage >= 2; }
 
   // queues
   using source_t = iomanager::ReceiverConcept<TSET>;
   using sink_t = iomanager::SenderConcept<TSET>;
   std::shared_ptr<source_t> m_inq{};
+  QueueSpy::handle_t m_input_spy{ 0 };
   std::shared_ptr<sink_t> m_outq{};
 
+  // Multi-queue input mode: one receiver per stream ("input0", "input1",
+  // ... in the init data) polled round-robin by the worker thread, with
+  // the connection index as the stream identity in the merge. This removes
+  // the contention point of ~150 senders muxed onto one queue, and the
+  // completeness/watermark logic sees exactly which stream is starving
+  // instead of inferring it from origin hashes. Empty means the classic
+  // single muxed "input" connection
+  std::vector<std::shared_ptr<source_t>> m_inqs;
+  std::vector<QueueSpy::handle_t> m_input_spies;
+  size_t m_rr_next{ 0 };
+
+  bool multi_input() const { return !m_inqs.empty(); }
+
+  // Single-stream passthrough (effective cardinality 1, set in
+  // do_configure): cardinality-1 instances exist in several topologies
+  // purely for config uniformity, and with one stream the merge can never
+  // reorder anything. Sets bypass the engine and slab cache entirely:
+  // receive, stamp, send, one move per set
+  bool m_passthrough{ false };
+
   using cfg_t = triggerzipper::ConfParams;
   cfg_t m_cfg;
 
   std::thread m_thread;
   std::atomic<bool> m_running{ false };
 
-  // We store input TSETs in a list and send iterator though the
-  // zipper as payload so as to not suffer copy overhead.
+  // Liveness probe (see WorkerLiveness): the merge loop pulses it every
+  // pass; tree-mode stage threads register their own slots
+  WorkerLiveness::handle_t m_liveness{ 0 };
+
+  // We store input TSETs in a slab pool and send stable slot pointers
+  // through the zipper as payload so as to not suffer copy overhead.
+  // Released slots keep their objects-vector capacity for reuse
   cache_type m_cache;
   seqno_type m_next_seqno{ 0 };
 
@@ -98,6 +182,78 @@ public:
 
   std::map<daqdataformats::SourceID, size_t> m_tardy_counts;
 
+  // Rate limit on TardyInputSet emission; record_tardy() keeps the raw counts
+  IssueThrottler m_tardy_throttle;
+
+  // Latest top-level Info, published by the worker thread and copied out
+  // by get_info() on the opmon thread
+  MetricSnapshot<triggerzipperinfo::Info> m_info_snapshot;
+  static constexpr std::chrono::milliseconds s_snapshot_interval{ 100 };
+  std::chrono::steady_clock::time_point m_last_snapshot_time;
+
+  // Per-stream statistics in a fixed table of lock-free slots: the worker
+  // thread is the sole writer and claims a slot per stream by open
+  // addressing on SourceID.id, the opmon thread snapshots with atomic
+  // loads, so monitoring never stalls the merge. The lateness histogram
+  // records, for tardy sets only, how far behind the merge origin they
+  // arrived in timestamp ticks
+  struct StreamStats
+  {
+    static constexpr uint64_t s_unclaimed = std::numeric_limits<uint64_t>::max(); // NOLINT(build/unsigned)
+    std::atomic<uint64_t> key{ s_unclaimed }; // NOLINT(build/unsigned)
+    std::atomic<uint64_t> n_received{ 0 };    // NOLINT(build/unsigned)
+    std::atomic<uint64_t> n_tardy{ 0 };       // NOLINT(build/unsigned)
+    LatencyHistogram lateness;
+    // Seqno continuity for this stream. The cursor is only touched by the
+    // worker thread; the counters are read by opmon. A gap is counted per
+    // missing seqno, a reorder when an earlier seqno arrives late (the
+    // cursor is not moved back)
+    bool seqno_seen{ false };
+    uint64_t last_seqno{ 0 };                    // NOLINT(build/unsigned)
+    std::atomic<uint64_t> n_seq_gaps{ 0 };       // NOLINT(build/unsigned)
+    std::atomic<uint64_t> n_seq_duplicates{ 0 }; // NOLINT(build/unsigned)
+    std::atomic<uint64_t> n_seq_reorders{ 0 };   // NOLINT(build/unsigned)
+  };
+  static constexpr size_t s_max_stream_stats = 256;
+  std::unique_ptr<std::array<StreamStats, s_max_stream_stats>> m_stream_stats{
+    std::make_unique<std::array<StreamStats, s_max_stream_stats>>()
+  };
+
+  StreamStats& stream_stats(uint64_t id) // NOLINT(build/unsigned)
+  {
+    auto& slots = *m_stream_stats;
+    size_t i = std::hash<uint64_t>{}(id) % s_max_stream_stats;
+    for (size_t n = 0; n < s_max_stream_stats; ++n, i = (i + 1) % s_max_stream_stats) {
+      uint64_t key = slots[i].key.load(std::memory_order_relaxed); // NOLINT(build/unsigned)
+      if (key == id) {
+        return slots[i];
+      }
+      if (key == StreamStats::s_unclaimed) {
+        slots[i].key.store(id, std::memory_order_release);
+        return slots[i];
+      }
+    }
+    // Table full; overflow streams share the home slot rather than grow
+    return slots[std::hash<uint64_t>{}(id) % s_max_stream_stats];
+  }
+
+  void record_tardy(const origin_type& origin, ordering_type start_time, ordering_type merge_origin)
+  {
+    ++m_n_tardy;
+    ++m_tardy_counts[origin];
+    StreamStats& ss = stream_stats(origin.id);
+    ss.n_tardy.fetch_add(1, std::memory_order_relaxed);
+    ordering_type head = merge_origin >> 1;
+    ss.lateness.record_value(head > start_time ? head - start_time : 0);
+  }
+
+  void report_suppressed_tardy()
+  {
+    if (uint64_t n = m_tardy_throttle.take_suppressed()) { // NOLINT(build/unsigned)
+      ers::warning(IssuesSuppressed(ERS_HERE, get_name(), "TardyInputSet", n));
+    }
+  }
+
   explicit TriggerZipper(const std::string& name)
     : DAQModule(name)
     , m_zm()
@@ -112,24 +268,65 @@ public:
 
   void init(const nlohmann::json& ini)
   {
-    set_input(appfwk::connection_uid(ini, "input"));
+    // Numbered input labels select multi-queue mode; the sort makes the
+    // label-to-identity assignment deterministic across restarts
+    auto index = appfwk::connection_index(ini, {});
+    std::vector<std::string> stream_labels;
+    for (const auto& [label, uid] : index) {
+      if (label.rfind("input", 0) == 0 && label != "input") {
+        stream_labels.push_back(label);
+      }
+    }
+    if (!stream_labels.empty()) {
+      std::sort(stream_labels.begin(), stream_labels.end());
+      for (const auto& label : stream_labels) {
+        add_input(index[label]);
+      }
+    } else {
+      set_input(appfwk::connection_uid(ini, "input"));
+    }
     set_output(appfwk::connection_uid(ini, "output"));
+    m_liveness = WorkerLiveness::get_instance().register_worker(get_name());
   }
 
   void get_info(opmonlib::InfoCollector& ci, int /*level*/) override
   {
+    // Top-level counts come from the snapshot the worker thread last
+    // published, so the opmon poll doesn't read the merge loop's counters
+    // directly. The per-stream slots below are lock-free by construction
+    // (atomic loads of worker-written slots), so they are read in place
     triggerzipperinfo::Info i;
-
-    i.n_received = m_n_received.load();
-    i.n_sent = m_n_sent.load();
-    i.n_tardy = m_n_tardy.load();
-
+    m_info_snapshot.read(i);
     ci.add(i);
+
+    for (auto& ss : *m_stream_stats) {
+      uint64_t key = ss.key.load(std::memory_order_acquire); // NOLINT(build/unsigned)
+      if (key == StreamStats::s_unclaimed) {
+        continue;
+      }
+      triggerzipperinfo::PerStreamInfo psi;
+      psi.n_received = ss.n_received.load(std::memory_order_relaxed);
+      psi.n_tardy = ss.n_tardy.load(std::memory_order_relaxed);
+      psi.n_seq_gaps = ss.n_seq_gaps.load(std::memory_order_relaxed);
+      psi.n_seq_duplicates = ss.n_seq_duplicates.load(std::memory_order_relaxed);
+      psi.n_seq_reorders = ss.n_seq_reorders.load(std::memory_order_relaxed);
+      psi.tardy_lateness_p50_ticks = ss.lateness.quantile(0.5);
+      psi.tardy_lateness_p99_ticks = ss.lateness.quantile(0.99);
+      opmonlib::InfoCollector sub;
+      sub.add(psi);
+      ci.add("stream_" + std::to_string(key), sub);
+    }
   }
   
   void set_input(const std::string& name)
   {
     m_inq = get_iom_receiver<TSET>(name);
+    m_input_spy = QueueSpy::get_instance().register_queue(name);
+  }
+  void add_input(const std::string& name)
+  {
+    m_inqs.push_back(get_iom_receiver<TSET>(name));
+    m_input_spies.push_back(QueueSpy::get_instance().register_queue(name));
   }
   void set_output(const std::string& name)
   {
@@ -139,16 +336,52 @@ public:
   void do_configure(const nlohmann::json& cfgobj)
   {
     m_cfg = cfgobj.get<cfg_t>();
+    m_use_lt = m_cfg.use_loser_tree;
+    m_use_watermark = m_cfg.use_heartbeat_watermarks;
+    m_cache.configure(m_cfg.slab_size);
     m_zm.set_max_latency(std::chrono::milliseconds(m_cfg.max_latency_ms));
     m_zm.set_cardinality(m_cfg.cardinality);
     m_zm.set_tolerance(m_cfg.completeness_tolerance);
     m_zm.set_tolerate_incompleteness(m_cfg.tolerate_incompleteness);
+    m_lt.set_max_latency(std::chrono::milliseconds(m_cfg.max_latency_ms));
+    m_lt.set_cardinality(m_cfg.cardinality);
+    m_lt.set_tolerance(m_cfg.completeness_tolerance);
+    m_lt.set_tolerate_incompleteness(m_cfg.tolerate_incompleteness);
+    if (multi_input()) {
+      // With per-stream inputs the expected stream count is exactly the
+      // number of input connections; a stale configured cardinality would
+      // silently break completeness tracking
+      if (m_cfg.cardinality != m_inqs.size()) {
+        TLOG() << "[Zipper] cardinality " << m_cfg.cardinality << " overridden by " << m_inqs.size()
+               << " per-stream input connections";
+        m_cfg.cardinality = m_inqs.size();
+      }
+      m_zm.set_cardinality(m_inqs.size());
+      m_lt.set_cardinality(m_inqs.size());
+    }
+    m_shard_of.clear();
+    if (tree_mode()) {
+      for (const auto& a : m_cfg.first_stage_map) {
+        m_shard_of[a.stream] = a.shard % m_cfg.n_first_stage;
+      }
+      // The final merge sees one always-present stream per first stage;
+      // the alternative engine and watermark drains are single-stage ideas
+      m_zm.set_cardinality(m_cfg.n_first_stage);
+      m_use_lt = false;
+      m_use_watermark = false;
+    }
+    m_passthrough = !tree_mode() && (multi_input() ? m_inqs.size() == 1 : m_cfg.cardinality == 1);
+    if (m_passthrough) {
+      TLOG() << "[Zipper] single stream: sets will bypass the merge";
+    }
   }
 
   void do_scrap(const nlohmann::json& /*stopobj*/)
   {
     m_cfg = cfg_t{};
+    m_passthrough = false;
     m_zm.set_cardinality(0);
+    m_lt.set_cardinality(0);
   }
 
   void do_start(const nlohmann::json& /*startobj*/)
@@ -157,6 +390,23 @@ public:
     m_n_sent = 0;
     m_n_tardy = 0;
     m_tardy_counts.clear();
+    m_tardy_throttle.reset();
+    for (auto& ss : *m_stream_stats) {
+      ss.key.store(StreamStats::s_unclaimed);
+      ss.n_received.store(0);
+      ss.n_tardy.store(0);
+      ss.lateness.reset();
+      ss.seqno_seen = false;
+      ss.last_seqno = 0;
+      ss.n_seq_gaps.store(0);
+      ss.n_seq_duplicates.store(0);
+      ss.n_seq_reorders.store(0);
+    }
+    m_watermarks.clear();
+    m_min_watermark_valid = false;
+    if (tree_mode()) {
+      start_stages();
+    }
     m_running.store(true);
     m_thread = std::thread(&TriggerZipper::worker, this);
     pthread_setname_np(m_thread.native_handle(), "zipper");
@@ -166,8 +416,13 @@ public:
   {
     m_running.store(false);
     m_thread.join();
+    stop_stages(); // no-op outside tree mode
     flush();
     m_zm.clear();
+    m_lt.clear();
+    // flush() released every drained slot and the engines are now empty,
+    // but rebuild the freelist anyway in case a send timed out mid-flush
+    m_cache.reset();
     TLOG() << "[Zipper] Received " << m_n_received << " Sets. Sent " << m_n_sent << " Sets. " << m_n_tardy << " were tardy";
     std::stringstream ss;
     ss << std::endl;
@@ -180,33 +435,403 @@ public:
   // thread worker
   void worker()
   {
+    thread_placement::pin_current_thread(m_cfg.cpu_affinity, get_name());
+    thread_placement::prefer_numa_node(m_cfg.numa_node, get_name());
+    WorkerLiveness& liveness = WorkerLiveness::get_instance();
+    liveness.set_active(m_liveness, true);
     while (m_running.load()) {
+      // Every pass pulses the liveness counter, empty ones included, so an
+      // idle stream is not mistaken for a stall
+      liveness.pulse(m_liveness);
+      liveness.set_stage(m_liveness, "zip");
       // Once we've received a stop command, keep reading the input
       // queue until there's nothing left on it
       if (!proc_one() && !m_running.load()) {
         break;
       }
+      maybe_publish_info();
+    }
+    // Final snapshot so end-of-run totals are what opmon reports
+    publish_info();
+    liveness.set_active(m_liveness, false);
+  }
+
+  // Assemble and publish a top-level Info snapshot; worker thread only
+  void publish_info()
+  {
+    triggerzipperinfo::Info i;
+    i.n_received = m_n_received.load();
+    i.n_sent = m_n_sent.load();
+    i.n_tardy = m_n_tardy.load();
+    m_info_snapshot.publish(i);
+  }
+
+  void maybe_publish_info()
+  {
+    auto now = std::chrono::steady_clock::now();
+    if (now - m_last_snapshot_time >= s_snapshot_interval) {
+      m_last_snapshot_time = now;
+      publish_info();
     }
   }
 
   bool proc_one()
   {
-    m_cache.emplace_front(); // to be filled
-    auto& tset = m_cache.front();
-    std::optional<TSET> opt_tset= m_inq->try_receive(std::chrono::milliseconds(10));
-    if (opt_tset.has_value()) {
-      tset = *opt_tset;
-      ++m_n_received;
+    if (m_passthrough) {
+      return proc_one_passthrough();
     }
-    else {
-      m_cache.pop_front(); // vestigial
+    if (multi_input()) {
+      return proc_one_multi();
+    }
+    std::optional<TSET> opt_tset = m_inq->try_receive(std::chrono::milliseconds(10));
+    if (!opt_tset.has_value()) {
+      QueueSpy::get_instance().record_drain(m_input_spy, 0, false);
+      if (!m_stages.empty()) {
+        collect_stage_output();
+      }
       drain();
       return false;
     }
 
+    // Feed everything already queued behind the first set as one batch,
+    // stamping every node with a single clock acquisition; the same
+    // timestamp then serves the latency check in drain(). That is two
+    // steady_clock reads per batch instead of two per set. In watermark
+    // mode drains are driven by data time alone, so no clock is read at all
+    const timepoint_type now = m_use_watermark ? timepoint_type::min() : zm_type::clock_t::now();
+    size_t n_batch = 0;
+    while (true) {
+      ++m_n_received;
+      feed_one(std::move(*opt_tset), now);
+      if (++n_batch >= s_max_feed_batch) {
+        break;
+      }
+      opt_tset = m_inq->try_receive(std::chrono::milliseconds(0));
+      if (!opt_tset.has_value()) {
+        break;
+      }
+    }
+    // Each drained batch doubles as a depth sample for the backpressure
+    // observatory; hitting the batch cap means the queue held at least that
+    QueueSpy::get_instance().record_drain(m_input_spy, n_batch, n_batch >= s_max_feed_batch);
+    if (!m_stages.empty()) {
+      collect_stage_output();
+    }
+    drain(now);
+    return true;
+  }
+
+  // Single-stream fast path: nothing to merge, so each set is stamped and
+  // forwarded as soon as it arrives. Counters, per-stream seqno accounting
+  // and the queue-depth probe behave exactly as on the merge path, so a
+  // passthrough instance is indistinguishable in opmon
+  bool proc_one_passthrough()
+  {
+    auto& inq = multi_input() ? m_inqs[0] : m_inq;
+    const QueueSpy::handle_t spy = multi_input() ? m_input_spies[0] : m_input_spy;
+    std::optional<TSET> opt_tset = inq->try_receive(std::chrono::milliseconds(10));
+    if (!opt_tset.has_value()) {
+      QueueSpy::get_instance().record_drain(spy, 0, false);
+      return false;
+    }
+    size_t n_batch = 0;
+    while (true) {
+      ++m_n_received;
+      observe_arrival(*opt_tset);
+      send_through(std::move(*opt_tset));
+      if (++n_batch >= s_max_feed_batch) {
+        break;
+      }
+      opt_tset = inq->try_receive(std::chrono::milliseconds(0));
+      if (!opt_tset.has_value()) {
+        break;
+      }
+    }
+    QueueSpy::get_instance().record_drain(spy, n_batch, n_batch >= s_max_feed_batch);
+    return true;
+  }
+
+  // Stamp and send one set without touching the merge engines or the cache
+  void send_through(TSET&& tset)
+  {
+    tset.origin.id = m_cfg.element_id;
+    tset.seqno = m_next_seqno;
+    ++m_next_seqno;
+    try {
+      m_outq->send(std::move(tset), std::chrono::milliseconds(10));
+      ++m_n_sent;
+    } catch (const iomanager::TimeoutExpired& err) {
+      ers::error(err);
+    }
+  }
+
+  // Multi-queue input: one non-blocking sweep over every per-stream
+  // receiver per call, starting one past where the last sweep started so
+  // a hot stream can't monopolize service. Only when the sweep finds
+  // nothing anywhere does the loop park briefly on one queue, keeping the
+  // idle case as cheap as the single muxed receive
+  bool proc_one_multi()
+  {
+    const size_t n_streams = m_inqs.size();
+    const timepoint_type now = m_use_watermark ? timepoint_type::min() : zm_type::clock_t::now();
+    size_t n_batch = 0;
+    for (size_t k = 0; k < n_streams && n_batch < s_max_feed_batch; ++k) {
+      const size_t s = (m_rr_next + k) % n_streams;
+      size_t n_stream = 0;
+      while (n_batch < s_max_feed_batch) {
+        std::optional<TSET> opt_tset = m_inqs[s]->try_receive(std::chrono::milliseconds(0));
+        if (!opt_tset.has_value()) {
+          break;
+        }
+        ++m_n_received;
+        ++n_batch;
+        ++n_stream;
+        feed_one_stream(std::move(*opt_tset), now, s);
+      }
+      if (n_stream > 0) {
+        QueueSpy::get_instance().record_drain(m_input_spies[s], n_stream, n_batch >= s_max_feed_batch);
+      }
+    }
+    m_rr_next = (m_rr_next + 1) % n_streams;
+
+    if (n_batch == 0) {
+      const size_t s = m_rr_next;
+      std::optional<TSET> opt_tset = m_inqs[s]->try_receive(std::chrono::milliseconds(10));
+      if (!opt_tset.has_value()) {
+        QueueSpy::get_instance().record_drain(m_input_spies[s], 0, false);
+        if (!m_stages.empty()) {
+          collect_stage_output();
+        }
+        drain();
+        return false;
+      }
+      ++m_n_received;
+      // The sweep's timestamp is stale by up to the park above, so take a
+      // fresh one for this set's debut and the drain below
+      const timepoint_type fresh = m_use_watermark ? timepoint_type::min() : zm_type::clock_t::now();
+      feed_one_stream(std::move(*opt_tset), fresh, s);
+      QueueSpy::get_instance().record_drain(m_input_spies[s], 1, false);
+      if (!m_stages.empty()) {
+        collect_stage_output();
+      }
+      drain(fresh);
+      return true;
+    }
+
+    if (!m_stages.empty()) {
+      collect_stage_output();
+    }
+    drain(now);
+    return true;
+  }
+
+  size_t shard_for(const origin_type& origin) const
+  {
+    auto it = m_shard_of.find(origin.id);
+    if (it != m_shard_of.end()) {
+      return it->second;
+    }
+    return zipper_stream_id(origin) % m_stages.size();
+  }
+
+  void start_stages()
+  {
+    const size_t n_stages = m_cfg.n_first_stage;
+    // Expected stream count per stage: exact when an explicit map is given,
+    // otherwise an even split of the configured cardinality. With the even
+    // split a stage may expect more streams than it will ever see, so set a
+    // max_latency to keep such stages draining
+    std::vector<size_t> stage_card(n_stages, 0);
+    if (!m_shard_of.empty()) {
+      for (const auto& [id, shard] : m_shard_of) {
+        stage_card[shard] += 1;
+      }
+    } else {
+      for (auto& c : stage_card) {
+        c = (m_cfg.cardinality + n_stages - 1) / n_stages;
+      }
+    }
+    m_stages.clear();
+    for (size_t i = 0; i < n_stages; ++i) {
+      auto st = std::make_unique<Stage>();
+      st->engine.set_cardinality(stage_card[i]);
+      st->engine.set_max_latency(std::chrono::milliseconds(m_cfg.max_latency_ms));
+      st->engine.set_tolerance(m_cfg.completeness_tolerance);
+      st->engine.set_tolerate_incompleteness(m_cfg.tolerate_incompleteness);
+      m_stages.push_back(std::move(st));
+    }
+    for (size_t i = 0; i < n_stages; ++i) {
+      m_stages[i]->thread = std::thread(&TriggerZipper::stage_loop, this, i);
+      pthread_setname_np(m_stages[i]->thread.native_handle(), ("zipstage" + std::to_string(i)).c_str());
+    }
+  }
+
+  // Join the first-stage threads and push everything still queued in them
+  // through the final merge, ready for flush()
+  void stop_stages()
+  {
+    if (m_stages.empty()) {
+      return;
+    }
+    for (auto& st : m_stages) {
+      st->cv.notify_all();
+    }
+    for (auto& st : m_stages) {
+      if (st->thread.joinable()) {
+        st->thread.join();
+      }
+    }
+    for (size_t i = 0; i < m_stages.size(); ++i) {
+      Stage& st = *m_stages[i];
+      for (auto& node : st.inbox) {
+        st.engine.feed(node);
+      }
+      st.inbox.clear();
+      std::vector<node_type> got;
+      st.engine.drain_full(std::back_inserter(got));
+      for (auto& node : got) {
+        node.identity = i;
+        m_zm.feed(node);
+      }
+      st.engine.clear();
+    }
+    collect_stage_output();
+    m_stages.clear();
+  }
+
+  void stage_loop(size_t idx)
+  {
+    thread_placement::pin_current_thread(m_cfg.cpu_affinity, get_name());
+    thread_placement::prefer_numa_node(m_cfg.numa_node, get_name());
+    WorkerLiveness& liveness = WorkerLiveness::get_instance();
+    // Registration dedupes by name, so restarted runs reuse the slot
+    auto stage_liveness = liveness.register_worker(get_name() + "/stage" + std::to_string(idx));
+    liveness.set_active(stage_liveness, true);
+    liveness.set_stage(stage_liveness, "zip");
+    Stage& st = *m_stages[idx];
+    std::vector<node_type> fed;
+    std::vector<node_type> got;
+    std::vector<std::pair<payload_type, ordering_type>> tardy;
+    while (true) {
+      liveness.pulse(stage_liveness);
+      {
+        std::unique_lock<std::mutex> lk(st.mtx);
+        st.cv.wait_for(lk, std::chrono::milliseconds(10),
+                       [&] { return !st.inbox.empty() || !m_running.load(); });
+        if (st.inbox.empty() && !m_running.load()) {
+          liveness.set_active(stage_liveness, false);
+          return;
+        }
+        while (!st.inbox.empty()) {
+          fed.push_back(st.inbox.front());
+          st.inbox.pop_front();
+        }
+      }
+      const timepoint_type now = zm_type::clock_t::now();
+      for (auto& node : fed) {
+        if (!st.engine.feed(node)) {
+          tardy.emplace_back(node.payload, st.engine.get_origin());
+        }
+      }
+      fed.clear();
+      got.clear();
+      if (m_cfg.max_latency_ms) {
+        st.engine.drain_prompt(std::back_inserter(got), now);
+      } else {
+        st.engine.drain_waiting(std::back_inserter(got));
+      }
+      if (!got.empty() || !tardy.empty()) {
+        std::lock_guard<std::mutex> lk(m_stage_out_mtx);
+        for (auto& node : got) {
+          node.identity = idx; // the final merge sees each stage as one stream
+          m_stage_out.push_back(node);
+        }
+        for (auto& t : tardy) {
+          m_stage_tardy.push_back(t);
+        }
+      }
+      tardy.clear();
+    }
+  }
+
+  // Worker thread: move first-stage results into the final merge and
+  // account for slots the first stages rejected
+  void collect_stage_output()
+  {
+    std::deque<node_type> out;
+    std::deque<std::pair<payload_type, ordering_type>> tardy;
+    {
+      std::lock_guard<std::mutex> lk(m_stage_out_mtx);
+      out.swap(m_stage_out);
+      tardy.swap(m_stage_tardy);
+    }
+    for (auto& node : out) {
+      if (!m_zm.feed(node)) {
+        record_tardy(node.payload->origin, node.payload->start_time, m_zm.get_origin());
+        if (m_tardy_throttle.allow()) {
+          ers::warning(TardyInputSet(
+            ERS_HERE, get_name(), node.payload->origin.id, node.payload->start_time, m_zm.get_origin() >> 1));
+          report_suppressed_tardy();
+        }
+        m_cache.release(node.payload);
+      }
+    }
+    for (auto& [slot, stage_origin] : tardy) {
+      record_tardy(slot->origin, slot->start_time, stage_origin);
+      if (m_tardy_throttle.allow()) {
+        ers::warning(TardyInputSet(ERS_HERE, get_name(), slot->origin.id, slot->start_time, stage_origin >> 1));
+        report_suppressed_tardy();
+      }
+      m_cache.release(slot);
+    }
+  }
+
+  // Feed a single set into the active merge engine, with `now` as its debut
+  void feed_one(TSET&& in, const timepoint_type& now)
+  {
+    const identity_type ident = zipper_stream_id(in.origin);
+    feed_as(std::move(in), now, ident);
+  }
+
+  // Multi-queue mode: the stream identity is the input connection index,
+  // not a hash of the set origin, so completeness is tracked against the
+  // actual wiring
+  void feed_one_stream(TSET&& in, const timepoint_type& now, size_t stream)
+  {
+    feed_as(std::move(in), now, stream);
+  }
+
+  // Per-stream arrival accounting (receive counter and seqno continuity),
+  // shared by the merge path and the passthrough fast path
+  void observe_arrival(const TSET& tset)
+  {
+    StreamStats& ss = stream_stats(tset.origin.id);
+    ss.n_received.fetch_add(1, std::memory_order_relaxed);
+    if (!ss.seqno_seen) {
+      ss.seqno_seen = true;
+      ss.last_seqno = tset.seqno;
+    } else if (tset.seqno == ss.last_seqno + 1) {
+      ss.last_seqno = tset.seqno;
+    } else if (tset.seqno > ss.last_seqno + 1) {
+      ss.n_seq_gaps.fetch_add(tset.seqno - ss.last_seqno - 1, std::memory_order_relaxed);
+      ss.last_seqno = tset.seqno;
+    } else if (tset.seqno == ss.last_seqno) {
+      ss.n_seq_duplicates.fetch_add(1, std::memory_order_relaxed);
+    } else {
+      ss.n_seq_reorders.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+  void feed_as(TSET&& in, const timepoint_type& now, identity_type ident)
+  {
+    payload_type slot = m_cache.acquire(std::move(in));
+    auto& tset = *slot;
+
     if (!m_tardy_counts.count(tset.origin))
       m_tardy_counts[tset.origin] = 0;
 
+    observe_arrival(tset);
+
     // P. Rodrigues 2022-03-03 This is a bit of a hack to ensure that
     // heartbeat TSETs with the same start_time as payload TSETs will
     // be output _before_ the payload. I think this is what we want
@@ -232,25 +857,60 @@ public:
     if (tset.type != TSET::Type::kHeartbeat)
       sort_value |= 0x1;
 
-    bool accepted = m_zm.feed(m_cache.begin(), sort_value, zipper_stream_id(tset.origin));
+    if (m_use_watermark && tset.type == TSET::Type::kHeartbeat) {
+      // A heartbeat at time T promises its stream will send nothing with
+      // start time earlier than T. Track the per-stream high-water marks
+      // and the minimum across all expected streams
+      ordering_type& wm = m_watermarks[ident];
+      if (sort_value > wm) {
+        wm = sort_value;
+      }
+      if (m_cfg.cardinality > 0 && m_watermarks.size() >= m_cfg.cardinality) {
+        ordering_type min_wm = wm;
+        for (const auto& [ident, mark] : m_watermarks) {
+          min_wm = std::min(min_wm, mark);
+        }
+        m_min_watermark = min_wm;
+        m_min_watermark_valid = true;
+      }
+    }
 
-    if (!accepted) {
-      ++m_n_tardy;
-      ++m_tardy_counts[tset.origin];
+    if (!m_stages.empty()) {
+      // Hand the set to its first-stage merge; tardiness there is reported
+      // back through m_stage_tardy
+      Stage& st = *m_stages[shard_for(tset.origin)];
+      {
+        std::lock_guard<std::mutex> lk(st.mtx);
+        st.inbox.push_back(node_type{ slot, sort_value, ident, now });
+      }
+      st.cv.notify_one();
+      return;
+    }
 
-      ers::warning(TardyInputSet(
-                                 ERS_HERE, get_name(), tset.origin.id, tset.start_time, m_zm.get_origin() >> 1));
-      m_cache.pop_front(); // vestigial
+    bool accepted = m_use_lt ? m_lt.feed(slot, sort_value, ident, now)
+                             : m_zm.feed(slot, sort_value, ident, now);
+
+    if (!accepted) {
+      record_tardy(tset.origin, tset.start_time, m_use_lt ? m_lt.get_origin() : m_zm.get_origin());
+
+      // One persistently-late stream makes every one of its sets tardy, so
+      // the warning is rate limited; record_tardy() keeps the raw per-stream
+      // counts that get_info() exports
+      if (m_tardy_throttle.allow()) {
+        ers::warning(TardyInputSet(
+                                   ERS_HERE, get_name(), tset.origin.id, tset.start_time,
+                                   (m_use_lt ? m_lt.get_origin() : m_zm.get_origin()) >> 1));
+        report_suppressed_tardy();
+      }
+      m_cache.release(slot);
     }
-    drain();
-    return true;
   }
 
   void send_out(std::vector<node_type>& got)
   {
     for (auto& node : got) {
-      payload_type lit = node.payload;
-      auto& tset = *lit; // list iterator
+      payload_type slot = node.payload;
+      auto& tset = *slot;
 
       // tell consumer "where" the set was produced
       tset.origin.id = m_cfg.element_id;
@@ -265,18 +925,43 @@ public:
         // here than simply complain and drop?
         ers::error(err);
       }
-      m_cache.erase(lit);
+      m_cache.release(slot);
     }
   }
 
   // Maybe drain and send to out queue
-  void drain()
+  void drain(const timepoint_type& now = zm_type::clock_t::now())
   {
     std::vector<node_type> got;
-    if (m_cfg.max_latency_ms) {
-      m_zm.drain_prompt(std::back_inserter(got));
+    if (m_use_watermark) {
+      // Emit everything at or below the minimum heartbeat watermark: every
+      // stream has promised not to produce anything earlier, so this is
+      // deterministic under replay and independent of host scheduling. The
+      // completeness-based drain still runs for data ahead of the watermark
+      if (m_min_watermark_valid) {
+        if (m_use_lt) {
+          m_lt.drain_until(std::back_inserter(got), m_min_watermark);
+        } else {
+          m_zm.drain_until(std::back_inserter(got), m_min_watermark);
+        }
+      }
+      if (m_use_lt) {
+        m_lt.drain_waiting(std::back_inserter(got));
+      } else {
+        m_zm.drain_waiting(std::back_inserter(got));
+      }
+    } else if (m_cfg.max_latency_ms) {
+      if (m_use_lt) {
+        m_lt.drain_prompt(std::back_inserter(got), now);
+      } else {
+        m_zm.drain_prompt(std::back_inserter(got), now);
+      }
     } else {
-      m_zm.drain_waiting(std::back_inserter(got));
+      if (m_use_lt) {
+        m_lt.drain_waiting(std::back_inserter(got));
+      } else {
+        m_zm.drain_waiting(std::back_inserter(got));
+      }
     }
     send_out(got);
   }
@@ -285,7 +970,11 @@ public:
   void flush()
   {
     std::vector<node_type> got;
-    m_zm.drain_full(std::back_inserter(got));
+    if (m_use_lt) {
+      m_lt.drain_full(std::back_inserter(got));
+    } else {
+      m_zm.drain_full(std::back_inserter(got));
+    }
     send_out(got);
   }
 };
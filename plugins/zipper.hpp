@@ -11,7 +11,10 @@
 
 #include "logging/Logging.hpp"
 
+#include <algorithm>
 #include <chrono>
+#include <deque>
+#include <limits>
 #include <queue>
 #include <vector>
 #include <functional>
@@ -136,6 +139,9 @@ public:
     std::vector<node_t> got;
     drain_full(std::back_inserter(got));
     streams.clear();
+    n_represented = 0;
+    n_stale = 0;
+    expiry_heap = {};
     origin = 0;
   }
 
@@ -152,6 +158,13 @@ public:
       return false;
     }
     auto& s = streams[node.identity];
+    if (s.occupancy == 0) {
+      n_represented += 1;
+      if (s.counted_stale) {
+        s.counted_stale = false;
+        n_stale -= 1;
+      }
+    }
     s.occupancy += 1;
     s.last_seen = node.debut;
     this->push(node);
@@ -186,6 +199,10 @@ public:
 
     auto& s = streams.at(node.identity);
     s.occupancy -= 1;
+    if (s.occupancy == 0) {
+      n_represented -= 1;
+      expiry_heap.push(Expiry{ s.last_seen, node.identity });
+    }
     origin = node.ordering;
 
     return node;
@@ -239,6 +256,24 @@ public:
     return result;
   }
 
+  /**
+     Return all nodes whose ordering does not exceed the given bound,
+     regardless of completeness.
+
+     For callers with an external guarantee (e.g. a data-time watermark
+     from heartbeats) that no stream will produce anything at or below
+     the bound.
+  */
+  template<typename OutputIterator>
+  OutputIterator drain_until(OutputIterator result, const ordering_t& bound)
+  {
+    while (!this->empty() && this->top().ordering <= bound) {
+      *result = next(); // hey, dev: do not forget back_inserter
+      ++result;
+    }
+    return result;
+  }
+
   /**
      Return the next top node without removal.
 
@@ -278,78 +313,419 @@ public:
       }
     }
 
-    size_t completeness = 0;
+    // Streams represented by a queued node, not counting the top node. This
+    // is maintained incrementally by feed()/next(), so completeness is O(1)
+    // in the stream count rather than a scan of every known stream
+    size_t completeness = n_represented;
+    const auto& top_stream = streams.at(this->top().identity);
+    if (top_stream.occupancy == 1) {
+      completeness -= 1;
+    }
 
-    const auto top_ident = this->top().identity;
+    if (latency != duration_t::zero() && now != timepoint_t::min()) {
+      // To preserve max latency we will not consider a stale
+      // "unrepresented" stream to cause incompleteness. The top node's
+      // stream is checked directly; other unrepresented streams are
+      // counted through the expiry heap
+      if (top_stream.occupancy == 1 && now - top_stream.last_seen >= latency) {
+        completeness += 1;
+      }
+      count_stale(now);
+      completeness += n_stale;
+    }
+
+    // A known stream that is unrepresented and not stale blocks completeness
+    // outright, before the tolerance clause is consulted. This mirrors the
+    // original per-stream scan, whose early return on any fresh missing
+    // stream made the pseudo-complete state below reachable only once every
+    // missing stream had gone stale
+    if (completeness < target_cardinality) {
+      return false;
+    }
 
-    // check each known stream to see if it is "represented"
-    for (const auto& sit : streams) {
-      const auto& ident = sit.first;
-      auto have = sit.second.occupancy;
+    // If we are choosing to tolerate "incompleteness", then check we are within the
+    // configurable tolerance level, and return a "pseudo-complete" state.
+    auto d = cardinality - completeness;
+    if(tolerate_incompleteness && (completeness < target_cardinality) && d<=completeness_tolerance){
+      return true;
+    }
 
-      // Do not count the top node.
-      if (top_ident == ident) {
-        have -= 1;
+    // Otherwise, completeness has been achieved.
+    return completeness >= target_cardinality;
+  }
+
+private:
+  size_t cardinality;
+  duration_t latency{ 0 };
+  ordering_t origin;
+  bool tolerate_incompleteness = false;
+  size_t completeness_tolerance = 1;
+  struct Stream
+  {
+    size_t occupancy{ 0 };
+    timepoint_t last_seen{ duration_t::min() };
+    bool counted_stale{ false };
+  };
+  // mutable: complete() is const but lazily migrates unrepresented streams
+  // to "stale" via count_stale()
+  mutable std::unordered_map<identity_t, Stream> streams;
+  size_t n_represented{ 0 }; // streams with occupancy > 0
+
+  // Min-heap of unrepresented streams keyed by their last activity, so the
+  // stale-stream latency rule needs only to pop expired entries instead of
+  // scanning every stream. Entries are lazily invalidated: a stream fed
+  // again since its entry was pushed no longer matches it
+  struct Expiry
+  {
+    timepoint_t last_seen;
+    identity_t identity;
+    bool operator>(const Expiry& rhs) const { return last_seen > rhs.last_seen; }
+  };
+  mutable std::priority_queue<Expiry, std::vector<Expiry>, std::greater<Expiry>> expiry_heap;
+  mutable size_t n_stale{ 0 }; // unrepresented streams older than the latency bound
+
+  void count_stale(const timepoint_t& now) const
+  {
+    while (!expiry_heap.empty()) {
+      const Expiry& e = expiry_heap.top();
+      auto sit = streams.find(e.identity);
+      bool valid = sit != streams.end() && sit->second.occupancy == 0 && !sit->second.counted_stale &&
+                   sit->second.last_seen == e.last_seen;
+      if (!valid) {
+        expiry_heap.pop();
+        continue;
       }
-      if (have > 0) {
-        ++completeness;
-        continue; // stream is represented
+      if (now - e.last_seen < latency) {
+        break; // earliest-expiring entry is still fresh, so all are
       }
+      sit->second.counted_stale = true;
+      n_stale += 1;
+      expiry_heap.pop();
+    }
+  }
+};
 
-      // unbound latency, wait as long as needed
-      if (latency == duration_t::zero()) {
-        // std::cerr << "no latency " << ident << std::endl;
-        return false;
+/**
+   An alternative merge engine to @ref merge, intended for high stream
+   cardinality.
+
+   Each stream is individually time-ordered, so a full binary heap over
+   every queued node is overkill: nodes are kept in per-stream FIFO
+   deques and the overall minimum is tracked with a tournament (loser
+   tree) over the stream heads. Selecting the next node re-plays one
+   leaf-to-root path of ceil(log2 k) comparisons over a flat array,
+   with no per-node hash probe on the drain path.
+
+   Exposes the same feed/next/drain/complete API as @ref merge so
+   callers can select either engine.
+*/
+template<typename Node>
+class loser_merge
+{
+public:
+  using node_t = Node;
+  using payload_t = typename Node::payload_t;
+  using ordering_t = typename Node::ordering_t;
+  using identity_t = typename Node::identity_t;
+  using timepoint_t = typename Node::timepoint_t;
+  using duration_t = typename timepoint_t::duration;
+  using clock_t = typename timepoint_t::clock;
+
+  explicit loser_merge(size_t k = 0, duration_t max_latency = duration_t::zero())
+    : cardinality(k)
+    , latency(max_latency)
+    , origin(0)
+  {}
+
+  void set_cardinality(size_t k)           { cardinality = k; }
+  void set_tolerance(size_t t)             { completeness_tolerance = t; }
+  void set_tolerate_incompleteness(bool b) { tolerate_incompleteness = b; }
+  void set_max_latency(duration_t max_latency) { latency = max_latency; }
+
+  ordering_t get_origin() const { return origin; }
+
+  bool empty() const { return n_queued == 0; }
+  size_t size() const { return n_queued; }
+
+  void clear()
+  {
+    std::vector<node_t> got;
+    drain_full(std::back_inserter(got));
+    slot_of.clear();
+    slots.clear();
+    tree.clear();
+    n_leaves = 0;
+    n_represented = 0;
+    n_stale = 0;
+    expiry_heap = {};
+    origin = 0;
+  }
+
+  bool feed(const node_t& node)
+  {
+    if (node.ordering < origin) {
+      return false;
+    }
+    size_t slot = slot_index(node.identity);
+    Slot& s = slots[slot];
+    if (s.fifo.empty()) {
+      n_represented += 1;
+      if (s.counted_stale) {
+        s.counted_stale = false;
+        n_stale -= 1;
       }
+    }
+    bool head_changed = false;
+    if (!s.fifo.empty() && node.ordering < s.fifo.back().ordering) {
+      // a producer violated its own ordering; keep the FIFO sorted anyway
+      auto pos = std::upper_bound(s.fifo.begin(), s.fifo.end(), node, std::less<node_t>());
+      head_changed = pos == s.fifo.begin();
+      s.fifo.insert(pos, node);
+    } else {
+      head_changed = s.fifo.empty();
+      s.fifo.push_back(node);
+    }
+    s.last_seen = node.debut;
+    n_queued += 1;
+    if (head_changed) {
+      // the slot's contender in the tournament changed, including when a
+      // disordered producer's node displaced the previous FIFO head
+      replay(slot);
+    }
+    return true;
+  }
+
+  bool feed(const payload_t& pay,
+            const ordering_t& ord,
+            const identity_t& ident,
+            const timepoint_t& debut = clock_t::now())
+  {
+    return feed(node_t{ pay, ord, ident, debut });
+  }
+
+  node_t next()
+  {
+    if (empty()) {
+      throw std::out_of_range("attempt to drain empty queue");
+    }
+    size_t w = tree[1];
+    Slot& s = slots[w];
+    node_t node = s.fifo.front();
+    s.fifo.pop_front();
+    n_queued -= 1;
+    if (s.fifo.empty()) {
+      n_represented -= 1;
+      expiry_heap.push(Expiry{ s.last_seen, w });
+    }
+    origin = node.ordering;
+    replay(w);
+    return node;
+  }
+
+  template<typename OutputIterator>
+  OutputIterator drain_full(OutputIterator result)
+  {
+    while (!empty()) {
+      *result = next();
+      ++result;
+    }
+    return result;
+  }
 
-      if (now == timepoint_t::min()) { // my clock is broken
-        // std::cerr << "clock broken " << ident << std::endl;
+  template<typename OutputIterator>
+  OutputIterator drain_prompt(OutputIterator result, const timepoint_t& now = clock_t::now())
+  {
+    while (complete(now)) {
+      *result = next();
+      ++result;
+    }
+    return result;
+  }
+
+  template<typename OutputIterator>
+  OutputIterator drain_waiting(OutputIterator result)
+  {
+    while (complete()) {
+      *result = next();
+      ++result;
+    }
+    return result;
+  }
+
+  // See merge::drain_until()
+  template<typename OutputIterator>
+  OutputIterator drain_until(OutputIterator result, const ordering_t& bound)
+  {
+    while (!empty() && peek().ordering <= bound) {
+      *result = next();
+      ++result;
+    }
+    return result;
+  }
+
+  const node_t& peek() const
+  {
+    if (empty()) {
+      throw std::out_of_range("attempt to peek empty queue");
+    }
+    return slots[tree[1]].fifo.front();
+  }
+
+  // Same completeness semantics as @ref merge::complete(), evaluated from
+  // the incrementally maintained counters
+  bool complete(const timepoint_t& now = timepoint_t::min()) const
+  {
+    if (empty()) {
+      return false;
+    }
+
+    const size_t target_cardinality = slots.size();
+
+    if (target_cardinality < cardinality) { // absent streams
+      if (latency == duration_t::zero()) { // unbound latency
         return false;
+      } else if (now != timepoint_t::min()) {
+        auto delta = now - peek().debut;
+        if (delta < latency) {
+          return false;
+        }
       }
+    }
 
-      const auto& last_seen = sit.second.last_seen;
-      auto delta = now - last_seen;
-      auto delta_us = std::chrono::duration_cast<std::chrono::microseconds>(delta);
-      if (delta < latency) {
-        // std::cerr << "still active " << ident
-        //           << " [" << completeness
-        //           << "] " << delta_us.count() << " us"
-        //           << std::endl;
-        return false;
+    size_t completeness = n_represented;
+    const Slot& top_slot = slots[tree[1]];
+    if (top_slot.fifo.size() == 1) {
+      completeness -= 1;
+    }
+
+    if (latency != duration_t::zero() && now != timepoint_t::min()) {
+      if (top_slot.fifo.size() == 1 && now - top_slot.last_seen >= latency) {
+        completeness += 1;
       }
+      count_stale(now);
+      completeness += n_stale;
+    }
 
-      // std::cerr << "missing but stale " << ident
-      //           << " [" << completeness
-      //           << "] " << delta_us.count() << " us"
-      //           << std::endl;
-      // To preserve max latency we will not consider this
-      // stale "unrepresented" to cause incompleteness.
-      ++completeness;
+    // As in merge::complete(): a fresh unrepresented stream blocks
+    // completeness before the tolerance clause is consulted
+    if (completeness < target_cardinality) {
+      return false;
     }
 
-    // If we are choosing to tolerate "incompleteness", then check we are within the
-    // configurable tolerance level, and return a "pseudo-complete" state.
     auto d = cardinality - completeness;
-    if(tolerate_incompleteness && (completeness < target_cardinality) && d<=completeness_tolerance){
+    if (tolerate_incompleteness && (completeness < target_cardinality) && d <= completeness_tolerance) {
       return true;
-    }  
+    }
 
-    // Otherwise, completeness has been achieved.
     return completeness >= target_cardinality;
   }
 
 private:
+  static constexpr size_t npos = std::numeric_limits<size_t>::max();
+
   size_t cardinality;
   duration_t latency{ 0 };
   ordering_t origin;
   bool tolerate_incompleteness = false;
   size_t completeness_tolerance = 1;
-  struct Stream
+
+  struct Slot
   {
-    size_t occupancy{ 0 };
+    std::deque<node_t> fifo;
     timepoint_t last_seen{ duration_t::min() };
+    bool counted_stale{ false };
   };
-  std::unordered_map<identity_t, Stream> streams;
+  std::unordered_map<identity_t, size_t> slot_of; // identity -> index into slots
+  mutable std::vector<Slot> slots;
+  // Tournament tree over slot heads: tree[1] is the index of the slot with
+  // the smallest head, leaves live at [n_leaves, 2*n_leaves). npos marks an
+  // empty subtree
+  std::vector<size_t> tree;
+  size_t n_leaves = 0;
+  size_t n_queued = 0;
+  size_t n_represented = 0; // slots with a non-empty FIFO
+
+  // Stale-stream tracking, as in @ref merge
+  struct Expiry
+  {
+    timepoint_t last_seen;
+    size_t slot;
+    bool operator>(const Expiry& rhs) const { return last_seen > rhs.last_seen; }
+  };
+  mutable std::priority_queue<Expiry, std::vector<Expiry>, std::greater<Expiry>> expiry_heap;
+  mutable size_t n_stale = 0;
+
+  size_t slot_index(const identity_t& ident)
+  {
+    auto it = slot_of.find(ident);
+    if (it != slot_of.end()) {
+      return it->second;
+    }
+    size_t slot = slots.size();
+    slot_of.emplace(ident, slot);
+    slots.emplace_back();
+    if (slots.size() > n_leaves) {
+      grow();
+    } else {
+      tree[n_leaves + slot] = slot;
+    }
+    return slot;
+  }
+
+  size_t better(size_t a, size_t b) const
+  {
+    if (a == npos || slots[a].fifo.empty()) {
+      return (b == npos || slots[b].fifo.empty()) ? npos : b;
+    }
+    if (b == npos || slots[b].fifo.empty()) {
+      return a;
+    }
+    return slots[a].fifo.front().ordering <= slots[b].fifo.front().ordering ? a : b;
+  }
+
+  // Recompute the path from leaf `slot` to the root after its head changed
+  void replay(size_t slot)
+  {
+    for (size_t p = (n_leaves + slot) >> 1; p >= 1; p >>= 1) {
+      tree[p] = better(tree[2 * p], tree[2 * p + 1]);
+    }
+  }
+
+  // Double the leaf count and rebuild the tournament; only happens the
+  // first time a new stream pushes past the current capacity
+  void grow()
+  {
+    n_leaves = n_leaves == 0 ? 1 : n_leaves * 2;
+    while (n_leaves < slots.size()) {
+      n_leaves *= 2;
+    }
+    tree.assign(2 * n_leaves, npos);
+    for (size_t i = 0; i < slots.size(); ++i) {
+      tree[n_leaves + i] = i;
+    }
+    for (size_t p = n_leaves - 1; p >= 1; --p) {
+      tree[p] = better(tree[2 * p], tree[2 * p + 1]);
+    }
+  }
+
+  void count_stale(const timepoint_t& now) const
+  {
+    while (!expiry_heap.empty()) {
+      const Expiry& e = expiry_heap.top();
+      Slot& s = slots[e.slot];
+      bool valid = s.fifo.empty() && !s.counted_stale && s.last_seen == e.last_seen;
+      if (!valid) {
+        expiry_heap.pop();
+        continue;
+      }
+      if (now - e.last_seen < latency) {
+        break;
+      }
+      s.counted_stale = true;
+      n_stale += 1;
+      expiry_heap.pop();
+    }
+  }
 };
 
 } // namespace zipper
@@ -15,9 +15,9 @@ LivetimeCounter::LivetimeCounter(LivetimeCounter::State state)
   , m_last_state_change_time(now())
 {
   TLOG_DEBUG(TLVL_VERY_IMPORTANT) << "[Livetime] Starting LivetimeCounter in state " << get_state_name(state);
-  m_state_times[State::kLive]=0;
-  m_state_times[State::kDead]=0;
-  m_state_times[State::kPaused]=0;
+  for (auto& state_time : m_state_times) {
+    state_time.store(0, std::memory_order_relaxed);
+  }
 }
 
 LivetimeCounter::~LivetimeCounter()
@@ -27,39 +27,59 @@ LivetimeCounter::~LivetimeCounter()
 }
 
 void
-LivetimeCounter::update_map()
+LivetimeCounter::set_state(LivetimeCounter::State state)
 {
-  // Caller must lock the mutex, so we don't here
-  auto current_time=now();
-  auto delta=(current_time-m_last_state_change_time);
-  m_state_times[m_state]+=delta;
-  m_last_state_change_time=current_time;
+  std::lock_guard<std::mutex> l(m_write_mutex);
+  TLOG_DEBUG(TLVL_IMPORTANT) << "[Livetime] Changing state from " << get_state_name(m_state.load())
+                             << " to " << get_state_name(state);
+  // Seqlock write: odd sequence marks the update in progress so readers
+  // retry instead of seeing a half-applied transition
+  m_seq.fetch_add(1, std::memory_order_acquire);
+  auto current_time = now();
+  State old_state = m_state.load(std::memory_order_relaxed);
+  auto delta = current_time - m_last_state_change_time.load(std::memory_order_relaxed);
+  m_state_times[state_index(old_state)].fetch_add(delta, std::memory_order_relaxed);
+  m_last_state_change_time.store(current_time, std::memory_order_relaxed);
+  m_state.store(state, std::memory_order_relaxed);
+  m_seq.fetch_add(1, std::memory_order_release);
 }
 
-
-void
-LivetimeCounter::set_state(LivetimeCounter::State state)
+std::array<LivetimeCounter::state_time_t, LivetimeCounter::s_n_states>
+LivetimeCounter::snapshot()
 {
-  std::lock_guard<std::mutex> l(m_mutex);
-  update_map(); // Add the time to the old state
-  TLOG_DEBUG(TLVL_IMPORTANT) << "[Livetime] Changing state from " << get_state_name(m_state) << " to " << get_state_name(state);
-  m_state=state;
+  std::array<state_time_t, s_n_states> times;
+  while (true) {
+    uint64_t seq_before = m_seq.load(std::memory_order_acquire);
+    if (seq_before & 1) {
+      continue; // state change in progress
+    }
+    for (size_t i = 0; i < s_n_states; ++i) {
+      times[i] = m_state_times[i].load(std::memory_order_relaxed);
+    }
+    State state = m_state.load(std::memory_order_relaxed);
+    state_time_t last_change = m_last_state_change_time.load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (m_seq.load(std::memory_order_relaxed) == seq_before) {
+      // Fold in the time accruing in the current state since the last change
+      times[state_index(state)] += now() - last_change;
+      return times;
+    }
+  }
 }
 
 std::map<LivetimeCounter::State, LivetimeCounter::state_time_t>
 LivetimeCounter::get_time_map()
 {
-  std::lock_guard<std::mutex> l(m_mutex);
-  update_map();
-  return m_state_times;
+  auto times = snapshot();
+  return { { State::kLive, times[state_index(State::kLive)] },
+           { State::kDead, times[state_index(State::kDead)] },
+           { State::kPaused, times[state_index(State::kPaused)] } };
 }
 
 LivetimeCounter::state_time_t
 LivetimeCounter::get_time(LivetimeCounter::State state)
 {
-  std::lock_guard<std::mutex> l(m_mutex);
-  update_map();
-  return m_state_times[state];
+  return snapshot()[state_index(state)];
 }
 
 LivetimeCounter::state_time_t
@@ -72,10 +92,9 @@ LivetimeCounter::now() const
 std::string
 LivetimeCounter::get_report_string()
 {
-  std::lock_guard<std::mutex> l(m_mutex);
-  update_map();
+  auto time_map = get_time_map();
   std::ostringstream oss;
-  for(auto const& [state, t]: m_state_times){
+  for(auto const& [state, t]: time_map){
     oss << get_state_name(state) << ": " << t << "ms ";
   }
   return oss.str();
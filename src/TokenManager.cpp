@@ -33,6 +33,10 @@ TokenManager::TokenManager(const std::string& connection_name,
 {
   m_open_trigger_time = std::chrono::steady_clock::now();
 
+  for (auto& slot : m_open_trigger_decisions) {
+    slot.store(dfmessages::TypeDefaults::s_invalid_trigger_number, std::memory_order_relaxed);
+  }
+
   m_token_receiver = get_iom_receiver<dfmessages::TriggerDecisionToken>(m_connection_name);
   m_token_receiver->add_callback(std::bind(&TokenManager::receive_token, this, std::placeholders::_1));
 }
@@ -41,24 +45,24 @@ TokenManager::~TokenManager()
 {
   m_token_receiver->remove_callback();
 
-  if (!m_open_trigger_decisions.empty()) {
+  if (m_n_open_decisions.load() > 0) {
 
     auto now = std::chrono::steady_clock::now();
     if (std::chrono::duration_cast<std::chrono::milliseconds>(now - m_open_trigger_time) >
         std::chrono::milliseconds(3000)) {
       std::ostringstream o;
       o << "Open Trigger Decisions: [";
-      { // Scope for lock_guard
-        bool first = true;
-        std::lock_guard<std::mutex> lk(m_open_trigger_decisions_mutex);
-        for (auto& td : m_open_trigger_decisions) {
-          if (!first)
-            o << ", ";
-          o << td;
-          first = false;
-        }
-        o << "]";
+      bool first = true;
+      for (auto& slot : m_open_trigger_decisions) {
+        dfmessages::trigger_number_t td = slot.load(std::memory_order_relaxed);
+        if (td == dfmessages::TypeDefaults::s_invalid_trigger_number)
+          continue;
+        if (!first)
+          o << ", ";
+        o << td;
+        first = false;
       }
+      o << "]";
       TLOG_DEBUG(TLVL_DEBUG_INFO) << "[TokenManager] " << o.str();
     }
   }
@@ -73,8 +77,18 @@ TokenManager::get_n_tokens() const
 void
 TokenManager::trigger_sent(dfmessages::trigger_number_t trigger_number)
 {
-  std::lock_guard<std::mutex> lk(m_open_trigger_decisions_mutex);
-  m_open_trigger_decisions.insert(trigger_number);
+  // Claim an empty slot by CAS, probing linearly from the trigger number's
+  // home slot. The table is sized far above any realistic in-flight count,
+  // so failure to find a slot means something is very wrong upstream
+  size_t home = trigger_number % s_open_decision_slots;
+  for (size_t i = 0; i < s_open_decision_slots; ++i) {
+    auto& slot = m_open_trigger_decisions[(home + i) % s_open_decision_slots];
+    dfmessages::trigger_number_t expected = dfmessages::TypeDefaults::s_invalid_trigger_number;
+    if (slot.compare_exchange_strong(expected, trigger_number, std::memory_order_acq_rel)) {
+      m_n_open_decisions.fetch_add(1, std::memory_order_relaxed);
+      break;
+    }
+  }
   m_n_tokens--;
   if (m_n_tokens.load() == 0) {
     m_livetime_counter->set_state(LivetimeCounter::State::kDead);
@@ -93,11 +107,21 @@ TokenManager::receive_token(dfmessages::TriggerDecisionToken& token)
     TLOG_DEBUG(TLVL_DEBUG_LOW) << "[TokenManager] There are now " << m_n_tokens.load() << " tokens available";
 
     if (token.trigger_number != dfmessages::TypeDefaults::s_invalid_trigger_number) {
-      if (m_open_trigger_decisions.count(token.trigger_number)) {
-        std::lock_guard<std::mutex> lk(m_open_trigger_decisions_mutex);
-        m_open_trigger_decisions.erase(token.trigger_number);
+      bool found = false;
+      size_t home = token.trigger_number % s_open_decision_slots;
+      for (size_t i = 0; i < s_open_decision_slots; ++i) {
+        auto& slot = m_open_trigger_decisions[(home + i) % s_open_decision_slots];
+        dfmessages::trigger_number_t expected = token.trigger_number;
+        if (slot.compare_exchange_strong(
+              expected, dfmessages::TypeDefaults::s_invalid_trigger_number, std::memory_order_acq_rel)) {
+          found = true;
+          break;
+        }
+      }
+      if (found) {
+        int n_open = m_n_open_decisions.fetch_sub(1, std::memory_order_relaxed) - 1;
         TLOG_DEBUG(TLVL_DEBUG_MEDIUM) << "[TokenManager] Token indicates that trigger decision " << token.trigger_number
-                      << " has been completed. There are now " << m_open_trigger_decisions.size()
+                      << " has been completed. There are now " << n_open
                       << " triggers in flight";
       } else {
         // ERS warning: received token for trigger number I don't recognize
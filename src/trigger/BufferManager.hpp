@@ -11,8 +11,10 @@
 
 #include "daqdataformats/Types.hpp"
 
+#include <algorithm>
 #include <atomic>
-#include <set>
+#include <deque>
+#include <mutex>
 #include <vector>
 #include <cstddef>
 
@@ -22,6 +24,12 @@ namespace trigger {
 /**
  * @brief BufferManager description.
  *
+ * Safe for one writer (add) and multiple concurrent readers (window
+ * queries): a mutex guards structural changes to the ring, but every
+ * critical section is short -- readers only collect bound positions and
+ * pointers, never payload copies -- and pinned views keep their pointers
+ * valid outside the lock, so servicing a large data request on another
+ * thread does not stall ingest.
  */
 template<typename BSET>
 class BufferManager
@@ -37,9 +45,27 @@ public:
   virtual ~BufferManager() {}
 
   void set_buffer_size(size_t size) { m_buffer_max_size = size; }
-  void clear_buffer() { m_txset_buffer.clear(); }
+  // A non-zero budget evicts by total buffered payload bytes instead of
+  // set count, so buffer depth in seconds no longer collapses when TPSet
+  // payloads grow by an order of magnitude in noisy periods
+  void set_buffer_byte_budget(size_t bytes) { m_buffer_byte_budget = bytes; }
+  void clear_buffer()
+  {
+    std::lock_guard<std::mutex> lock(m_mtx);
+    m_txset_buffer.clear();
+    m_buffered_bytes = 0;
+    m_stored_size = 0;
+  }
   size_t get_buffer_size() { return m_buffer_max_size; }
-  size_t get_stored_size() { return m_txset_buffer.size(); }
+  size_t get_stored_size() const { return m_stored_size.load(std::memory_order_relaxed); }
+  size_t get_stored_bytes() const { return m_buffered_bytes.load(std::memory_order_relaxed); }
+  // Span of data time currently covered by the buffer, in timestamp ticks
+  daqdataformats::timestamp_t get_buffered_time_span() const
+  {
+    if (m_stored_size.load(std::memory_order_relaxed) == 0)
+      return 0;
+    return m_buffer_latest_end_time - m_buffer_earliest_start_time;
+  }
 
   BufferManager(BufferManager const&) = delete;
   BufferManager(BufferManager&&) = default;
@@ -51,12 +77,30 @@ public:
    */
   bool add(BSET& txs)
   {
+    std::lock_guard<std::mutex> lock(m_mtx);
     if (m_txset_buffer.size() >=
-        m_buffer_max_size) // delete oldest TxSet if buffer full (and updating earliest start time) -> circular buffer
+        m_buffer_max_size + m_n_deferred_evictions) // delete oldest TxSet if buffer full (and updating earliest start
+                                                    // time) -> circular buffer
     {
-      auto firstIt = m_txset_buffer.begin();
-      m_txset_buffer.erase(firstIt);
-      m_buffer_earliest_start_time = m_txset_buffer.begin()->start_time;
+      if (m_pin_count > 0) {
+        // popping the front could invalidate a pinned reference to it;
+        // remember the debt and settle it when the last view is released
+        m_n_deferred_evictions++;
+      } else {
+        evict_front();
+        m_buffer_earliest_start_time = m_txset_buffer.front().start_time;
+      }
+    }
+    if (m_buffer_byte_budget > 0 && m_pin_count == 0) {
+      // bulk trim: drop as many stale sets as it takes to make room
+      bool trimmed = false;
+      size_t incoming = set_bytes(txs);
+      while (m_buffered_bytes + incoming > m_buffer_byte_budget && m_txset_buffer.size() > 1) {
+        evict_front();
+        trimmed = true;
+      }
+      if (trimmed)
+        m_buffer_earliest_start_time = m_txset_buffer.front().start_time;
     }
     if ((m_buffer_earliest_start_time == 0) || (txs.start_time < m_buffer_earliest_start_time))
       m_buffer_earliest_start_time = txs.start_time;
@@ -64,7 +108,30 @@ public:
     if ((m_buffer_latest_end_time == 0) || (txs.end_time > m_buffer_latest_end_time))
       m_buffer_latest_end_time = txs.end_time;
 
-    return m_txset_buffer.insert(txs).second; // false if txs with same start_time already exists
+    // Sets arrive almost perfectly time-ordered, so appending at the back
+    // is the overwhelmingly common case; anything else falls back to a
+    // binary search and a positional insert to keep the ring sorted.
+    // Appending at the back of a deque never invalidates references, so it
+    // is safe even while views are pinned
+    if (m_txset_buffer.empty() || txs.start_time > m_txset_buffer.back().start_time) {
+      m_buffered_bytes += set_bytes(txs);
+      m_txset_buffer.push_back(txs);
+      m_stored_size.store(m_txset_buffer.size(), std::memory_order_relaxed);
+      return true;
+    }
+    if (m_pin_count > 0) {
+      // a middle insert would invalidate pinned references; park the set
+      // until the last view is released
+      m_pending_inserts.push_back(txs);
+      return true;
+    }
+    auto it = std::lower_bound(m_txset_buffer.begin(), m_txset_buffer.end(), txs, TxSetCmp());
+    if (it != m_txset_buffer.end() && it->start_time == txs.start_time)
+      return false; // txs with same start_time already exists
+    m_buffered_bytes += set_bytes(txs);
+    m_txset_buffer.insert(it, txs);
+    m_stored_size.store(m_txset_buffer.size(), std::memory_order_relaxed);
+    return true;
   }
 
   enum DataRequestOutcome
@@ -80,11 +147,61 @@ public:
     DataRequestOutcome ds_outcome;
   };
 
+  /**
+   * A zero-copy view of the sets overlapping a request window: stable
+   * pointers into the buffer instead of copies. The view holds a pin on
+   * the buffer for its lifetime, during which add() keeps accepting sets
+   * but defers evictions and out-of-order middle inserts, so the pointers
+   * stay valid while a fragment is built straight out of the buffer
+   */
+  class DataRequestView
+  {
+  public:
+    std::vector<const BSET*> txsets_in_window;
+    DataRequestOutcome ds_outcome{ kEmpty };
+
+    DataRequestView() = default;
+    DataRequestView(DataRequestView&& other) noexcept
+      : txsets_in_window(std::move(other.txsets_in_window))
+      , ds_outcome(other.ds_outcome)
+      , m_owner(other.m_owner)
+    {
+      other.m_owner = nullptr;
+    }
+    DataRequestView& operator=(DataRequestView&& other) noexcept
+    {
+      if (this != &other) {
+        release();
+        txsets_in_window = std::move(other.txsets_in_window);
+        ds_outcome = other.ds_outcome;
+        m_owner = other.m_owner;
+        other.m_owner = nullptr;
+      }
+      return *this;
+    }
+    DataRequestView(DataRequestView const&) = delete;
+    DataRequestView& operator=(DataRequestView const&) = delete;
+    ~DataRequestView() { release(); }
+
+    void release()
+    {
+      if (m_owner != nullptr) {
+        m_owner->unpin();
+        m_owner = nullptr;
+      }
+    }
+
+  private:
+    friend class BufferManager;
+    BufferManager* m_owner{ nullptr };
+  };
+
   /**
    * return a vector of all the TxSets in the buffer that overlap with [start_time, end_time]
    */
   DataRequestOutput get_txsets_in_window(daqdataformats::timestamp_t start_time, daqdataformats::timestamp_t end_time)
   {
+    std::lock_guard<std::mutex> lock(m_mtx);
     BufferManager::DataRequestOutput ds_out;
     std::vector<BSET> txsets_output;
 
@@ -104,12 +221,12 @@ public:
     txset_low.start_time = start_time;
     txset_up.start_time = end_time;
 
-    typename std::set<BSET, TxSetCmp>::iterator it, it_low, it_up;
-
-    // checking first and last TxSet of buffer that have a start_time within data request limits
-    it_low = m_txset_buffer.lower_bound(txset_low);
-    it_up = m_txset_buffer.upper_bound(txset_up);
-    it = it_low;
+    // checking first and last TxSet of buffer that have a start_time within data request limits;
+    // the ring is sorted and contiguous, so both bounds are binary searches
+    auto it_low = std::lower_bound(m_txset_buffer.begin(), m_txset_buffer.end(), txset_low, TxSetCmp());
+    auto it_up = std::upper_bound(it_low, m_txset_buffer.end(), txset_up, TxSetCmp());
+    auto it = it_low;
+    txsets_output.reserve(static_cast<size_t>(it_up - it_low) + 1);
 
     // checking if previous TxSet has a end_time that is after the data request's start time
     if (!(it == m_txset_buffer.begin())) {
@@ -131,6 +248,55 @@ public:
     return ds_out;
   }
 
+  /**
+   * Zero-copy variant of get_txsets_in_window(): same window and outcome
+   * semantics, but returns pinned pointers into the buffer. Drop or
+   * release() the view as soon as the fragment is built to let deferred
+   * evictions run
+   */
+  DataRequestView get_txsets_in_window_view(daqdataformats::timestamp_t start_time,
+                                            daqdataformats::timestamp_t end_time)
+  {
+    std::lock_guard<std::mutex> lock(m_mtx);
+    DataRequestView view;
+
+    if (end_time < m_buffer_earliest_start_time) {
+      view.ds_outcome = BufferManager::kEmpty;
+      return view;
+    }
+
+    if (start_time > m_buffer_latest_end_time) {
+      view.ds_outcome = BufferManager::kLate;
+      return view;
+    }
+
+    BSET txset_low, txset_up;
+    txset_low.start_time = start_time;
+    txset_up.start_time = end_time;
+
+    auto it_low = std::lower_bound(m_txset_buffer.begin(), m_txset_buffer.end(), txset_low, TxSetCmp());
+    auto it_up = std::upper_bound(it_low, m_txset_buffer.end(), txset_up, TxSetCmp());
+    auto it = it_low;
+    view.txsets_in_window.reserve(static_cast<size_t>(it_up - it_low) + 1);
+
+    if (!(it == m_txset_buffer.begin())) {
+      it--;
+      if ((*it).end_time > start_time)
+        view.txsets_in_window.push_back(&(*it));
+      it++;
+    }
+
+    while (it != it_up) {
+      view.txsets_in_window.push_back(&(*it));
+      it++;
+    }
+
+    pin();
+    view.m_owner = this;
+    view.ds_outcome = BufferManager::kSuccess;
+    return view;
+  }
+
   daqdataformats::timestamp_t get_earliest_start_time() const { return m_buffer_earliest_start_time; }
   daqdataformats::timestamp_t get_latest_end_time() const { return m_buffer_latest_end_time; }
 
@@ -146,17 +312,77 @@ private:
     }
   };
 
-  // Where the TxSet will be buffered
-  std::set<BSET, TxSetCmp> m_txset_buffer;
+  // Called with m_mtx held (from get_txsets_in_window_view)
+  void pin() { m_pin_count++; }
+
+  // Views are the reclamation epochs: structural work deferred while any
+  // view was live runs when the last one is released
+  void unpin()
+  {
+    std::lock_guard<std::mutex> lock(m_mtx);
+    m_pin_count--;
+    if (m_pin_count > 0) {
+      return;
+    }
+    // settle work deferred while views were live
+    while (m_n_deferred_evictions > 0 && !m_txset_buffer.empty()) {
+      evict_front();
+      m_n_deferred_evictions--;
+    }
+    while (m_buffer_byte_budget > 0 && m_buffered_bytes > m_buffer_byte_budget && m_txset_buffer.size() > 1) {
+      evict_front();
+    }
+    if (!m_txset_buffer.empty()) {
+      m_buffer_earliest_start_time = m_txset_buffer.front().start_time;
+    }
+    for (auto& txs : m_pending_inserts) {
+      auto it = std::lower_bound(m_txset_buffer.begin(), m_txset_buffer.end(), txs, TxSetCmp());
+      if (it == m_txset_buffer.end() || it->start_time != txs.start_time) {
+        m_buffered_bytes += set_bytes(txs);
+        m_txset_buffer.insert(it, txs);
+      }
+    }
+    m_pending_inserts.clear();
+    m_stored_size.store(m_txset_buffer.size(), std::memory_order_relaxed);
+  }
+
+  static size_t set_bytes(const BSET& txs) { return sizeof(BSET) + txs.objects.size() * sizeof(typename BSET::element_t); }
+
+  void evict_front()
+  {
+    m_buffered_bytes.fetch_sub(set_bytes(m_txset_buffer.front()), std::memory_order_relaxed);
+    m_txset_buffer.pop_front();
+  }
+
+  // Where the TxSet will be buffered, sorted by start_time. A deque keeps
+  // the slots contiguous in blocks and makes the circular-buffer eviction a
+  // pop at the front instead of a tree-node erase
+  std::deque<BSET> m_txset_buffer;
+
+  // View pinning state: while any view is live, front evictions are
+  // deferred and out-of-order inserts are parked in m_pending_inserts
+  size_t m_pin_count{ 0 };
+  size_t m_n_deferred_evictions{ 0 };
+  std::vector<BSET> m_pending_inserts;
 
   // Buffer maximum size.
   std::atomic<size_t> m_buffer_max_size;
 
+  // Byte-budget eviction: total payload bytes currently buffered and the
+  // budget they are trimmed to (0 = count-based eviction only)
+  std::atomic<size_t> m_buffered_bytes{ 0 };
+  std::atomic<size_t> m_buffer_byte_budget{ 0 };
+
+  // Guards structural changes to the ring and the pin bookkeeping; the
+  // monitored counters are atomics so get_*() never takes the lock
+  mutable std::mutex m_mtx;
+  std::atomic<size_t> m_stored_size{ 0 };
+
   // Earliest start time stored in the buffer
-  daqdataformats::timestamp_t m_buffer_earliest_start_time;
+  std::atomic<daqdataformats::timestamp_t> m_buffer_earliest_start_time;
 
   // Latest end time stored in the buffer
-  daqdataformats::timestamp_t m_buffer_latest_end_time;
+  std::atomic<daqdataformats::timestamp_t> m_buffer_latest_end_time;
 };
 
 } // namespace trigger
@@ -0,0 +1,286 @@
+/**
+ * @file HugePageArena.hpp
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2021.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#ifndef TRIGGER_SRC_TRIGGER_HUGEPAGEARENA_HPP_
+#define TRIGGER_SRC_TRIGGER_HUGEPAGEARENA_HPP_
+
+#include "trigger/Issues.hpp"
+
+#include <sys/mman.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <new>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace dunedaq {
+namespace trigger {
+
+/**
+ * @brief A fixed-capacity allocation arena backed by explicit huge pages.
+ *
+ * Latency buffers hold multi-second working sets - millions of small
+ * objects - and at that size TLB misses dominate window-extraction walks
+ * when the storage sits on 4kB pages. The arena mmaps its whole capacity
+ * up front from the hugetlb pool (1GB pages if asked and available,
+ * then 2MB, then ordinary pages with MADV_HUGEPAGE as a last resort, with
+ * a warning) and hands out blocks by bump allocation with per-size free
+ * lists, so steady-state container churn recycles blocks without touching
+ * the kernel. Requests that outgrow the arena fall back to the global
+ * heap and are counted.
+ *
+ * Allocation and deallocation take an internal mutex; callers on the hot
+ * path only reach it when their container actually grows or shrinks a
+ * block, which deque-style storage does at page-ish granularity.
+ */
+class HugePageArena
+{
+public:
+  enum class PageKind
+  {
+    k2MB,
+    k1GB
+  };
+
+  HugePageArena() = default;
+  HugePageArena(const HugePageArena&) = delete;
+  HugePageArena& operator=(const HugePageArena&) = delete;
+
+  ~HugePageArena() { release(); }
+
+  /**
+   * (Re)back the arena with `bytes` of storage, rounded up to a whole
+   * number of pages of the requested kind. `name` is the owning module,
+   * for the fallback warning. bytes == 0 releases the arena; allocation
+   * then goes straight to the global heap.
+   */
+  void conf(size_t bytes, PageKind kind, const std::string& name)
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    release_locked();
+    if (bytes == 0) {
+      return;
+    }
+
+    if (kind == PageKind::k1GB && try_map(bytes, s_1g_page, s_map_huge_1gb)) {
+      m_explicit_huge = true;
+      return;
+    }
+    if (try_map(bytes, s_2m_page, s_map_huge_2mb)) {
+      m_explicit_huge = true;
+      return;
+    }
+
+    // No hugetlb pages available: ordinary pages, with transparent huge
+    // pages requested so the kernel can still promote them
+    if (try_map(bytes, s_2m_page, 0)) {
+      madvise(m_base, m_capacity, MADV_HUGEPAGE);
+      m_explicit_huge = false;
+      ers::warning(HugePagesUnavailable(ERS_HERE, name, m_capacity));
+    }
+  }
+
+  void* allocate(size_t bytes)
+  {
+    const size_t size = round_up(bytes);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_free_lists.find(size);
+    if (it != m_free_lists.end() && !it->second.empty()) {
+      void* p = it->second.back();
+      it->second.pop_back();
+      return p;
+    }
+    if (m_base != nullptr && m_used + size <= m_capacity) {
+      void* p = static_cast<char*>(m_base) + m_used;
+      m_used += size;
+      return p;
+    }
+    ++m_fallback_allocations;
+    return ::operator new(size);
+  }
+
+  void deallocate(void* p, size_t bytes)
+  {
+    const size_t size = round_up(bytes);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (owns_locked(p)) {
+      m_free_lists[size].push_back(p);
+    } else {
+      ::operator delete(p);
+    }
+  }
+
+  /// Whether the backing mapping came from the hugetlb pool (as opposed
+  /// to the ordinary-page fallback or no arena at all)
+  bool huge_pages_obtained() const
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_base != nullptr && m_explicit_huge;
+  }
+
+  size_t capacity() const
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_capacity;
+  }
+
+  size_t bytes_used() const
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_used;
+  }
+
+  uint64_t fallback_allocations() const // NOLINT(build/unsigned)
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_fallback_allocations;
+  }
+
+  void release()
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    release_locked();
+  }
+
+private:
+  static constexpr size_t s_2m_page = 2UL * 1024 * 1024;
+  static constexpr size_t s_1g_page = 1024UL * 1024 * 1024;
+
+// Not all toolchain sysroots carry the MAP_HUGE_* encodings even though
+// the running kernels accept them, so mirror the uapi values locally
+#ifdef MAP_HUGE_SHIFT
+  static constexpr int s_map_huge_shift = MAP_HUGE_SHIFT;
+#else
+  static constexpr int s_map_huge_shift = 26;
+#endif
+  static constexpr int s_map_huge_2mb = 21 << s_map_huge_shift;
+  static constexpr int s_map_huge_1gb = 30 << s_map_huge_shift;
+
+  static size_t round_up(size_t bytes)
+  {
+    // Size-class granularity for the free lists; also keeps every block
+    // cache-line aligned off the page-aligned base
+    constexpr size_t granule = 64;
+    return ((bytes + granule - 1) / granule) * granule;
+  }
+
+  bool try_map(size_t bytes, size_t page, int huge_flag)
+  {
+    const size_t capacity = ((bytes + page - 1) / page) * page;
+    int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+    if (huge_flag != 0) {
+      flags |= MAP_HUGETLB | huge_flag;
+    }
+    void* base = mmap(nullptr, capacity, PROT_READ | PROT_WRITE, flags, -1, 0);
+    if (base == MAP_FAILED) { // NOLINT(cppcoreguidelines-pro-type-cstyle-cast)
+      return false;
+    }
+    m_base = base;
+    m_capacity = capacity;
+    m_used = 0;
+    return true;
+  }
+
+  bool owns_locked(const void* p) const
+  {
+    return m_base != nullptr && p >= m_base && p < static_cast<const char*>(m_base) + m_capacity;
+  }
+
+  void release_locked()
+  {
+    if (m_base != nullptr) {
+      munmap(m_base, m_capacity);
+    }
+    m_base = nullptr;
+    m_capacity = 0;
+    m_used = 0;
+    m_explicit_huge = false;
+    m_fallback_allocations = 0;
+    m_free_lists.clear();
+  }
+
+  mutable std::mutex m_mutex;
+  void* m_base{ nullptr };
+  size_t m_capacity{ 0 };
+  size_t m_used{ 0 };
+  bool m_explicit_huge{ false };
+  uint64_t m_fallback_allocations{ 0 }; // NOLINT(build/unsigned)
+  std::map<size_t, std::vector<void*>> m_free_lists;
+};
+
+/**
+ * @brief Minimal STL allocator drawing from a HugePageArena.
+ *
+ * Default-constructed (or with a null arena) it degrades to the global
+ * heap, so containers can be declared before the arena is configured.
+ */
+template<typename T>
+class HugePageAllocator
+{
+public:
+  using value_type = T;
+  // Containers are re-bound to an arena by assigning a fresh instance
+  // (RingLatencyBuffer::conf), so the allocator must travel with it
+  using propagate_on_container_move_assignment = std::true_type;
+  using propagate_on_container_swap = std::true_type;
+
+  HugePageAllocator() = default;
+  explicit HugePageAllocator(HugePageArena* arena)
+    : m_arena(arena)
+  {}
+
+  template<typename U>
+  HugePageAllocator(const HugePageAllocator<U>& other) // NOLINT(runtime/explicit)
+    : m_arena(other.arena())
+  {}
+
+  T* allocate(size_t n)
+  {
+    if (m_arena != nullptr) {
+      return static_cast<T*>(m_arena->allocate(n * sizeof(T)));
+    }
+    return static_cast<T*>(::operator new(n * sizeof(T)));
+  }
+
+  void deallocate(T* p, size_t n)
+  {
+    if (m_arena != nullptr) {
+      m_arena->deallocate(p, n * sizeof(T));
+    } else {
+      ::operator delete(p);
+    }
+  }
+
+  HugePageArena* arena() const { return m_arena; }
+
+private:
+  HugePageArena* m_arena{ nullptr };
+};
+
+template<typename T, typename U>
+bool
+operator==(const HugePageAllocator<T>& lhs, const HugePageAllocator<U>& rhs)
+{
+  return lhs.arena() == rhs.arena();
+}
+
+template<typename T, typename U>
+bool
+operator!=(const HugePageAllocator<T>& lhs, const HugePageAllocator<U>& rhs)
+{
+  return !(lhs == rhs);
+}
+
+} // namespace trigger
+} // namespace dunedaq
+
+#endif // TRIGGER_SRC_TRIGGER_HUGEPAGEARENA_HPP_
@@ -0,0 +1,106 @@
+/**
+ * @file LatencyHistogram.hpp
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#ifndef TRIGGER_SRC_TRIGGER_LATENCYHISTOGRAM_HPP_
+#define TRIGGER_SRC_TRIGGER_LATENCYHISTOGRAM_HPP_
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace dunedaq::trigger {
+
+// A fixed-size histogram of durations with log2-spaced microsecond bins:
+// bin n counts durations in [2^(n-1), 2^n) us, bin 0 counts sub-microsecond
+// durations. Designed for one writer (the module's worker thread) and one
+// reader (the opmon thread): record() is a single relaxed atomic increment,
+// so it is cheap enough for per-slice instrumentation on the hot path, and
+// quantile() gives bin-resolution percentiles without locking
+class LatencyHistogram
+{
+public:
+  static constexpr size_t s_n_bins = 64;
+
+  void record(std::chrono::steady_clock::duration duration)
+  {
+    record_value(std::chrono::duration_cast<std::chrono::microseconds>(duration).count());
+  }
+
+  // Bin an arbitrary non-negative value (e.g. a lateness in timestamp
+  // ticks); quantile() then reports edges in the same units
+  void record_value(uint64_t value) // NOLINT(build/unsigned)
+  {
+    size_t bin = value == 0 ? 0 : 64 - __builtin_clzll(value);
+    if (bin >= s_n_bins) {
+      bin = s_n_bins - 1;
+    }
+    m_bins[bin].fetch_add(1, std::memory_order_relaxed);
+  }
+
+  // Upper bin edge (in us) below which at least fraction q of recorded
+  // durations fall. Returns 0 when nothing has been recorded
+  uint64_t quantile(double q) const // NOLINT(build/unsigned)
+  {
+    uint64_t total = 0; // NOLINT(build/unsigned)
+    std::array<uint64_t, s_n_bins> counts; // NOLINT(build/unsigned)
+    for (size_t i = 0; i < s_n_bins; ++i) {
+      counts[i] = m_bins[i].load(std::memory_order_relaxed);
+      total += counts[i];
+    }
+    if (total == 0) {
+      return 0;
+    }
+    uint64_t target = static_cast<uint64_t>(q * total); // NOLINT(build/unsigned)
+    uint64_t running = 0;                               // NOLINT(build/unsigned)
+    for (size_t i = 0; i < s_n_bins; ++i) {
+      running += counts[i];
+      if (running > target) {
+        return bin_upper_edge_us(i);
+      }
+    }
+    return bin_upper_edge_us(s_n_bins - 1);
+  }
+
+  void reset()
+  {
+    for (auto& bin : m_bins) {
+      bin.store(0, std::memory_order_relaxed);
+    }
+  }
+
+private:
+  static uint64_t bin_upper_edge_us(size_t bin) // NOLINT(build/unsigned)
+  {
+    return bin == 0 ? 1 : (uint64_t(1) << bin); // NOLINT(build/unsigned)
+  }
+
+  std::array<std::atomic<uint64_t>, s_n_bins> m_bins{}; // NOLINT(build/unsigned)
+};
+
+// Convenience RAII timer recording the lifetime of a scope into a histogram
+class ScopedLatencyTimer
+{
+public:
+  explicit ScopedLatencyTimer(LatencyHistogram& histogram)
+    : m_histogram(histogram)
+    , m_start(std::chrono::steady_clock::now())
+  {}
+  ~ScopedLatencyTimer() { m_histogram.record(std::chrono::steady_clock::now() - m_start); }
+
+  ScopedLatencyTimer(const ScopedLatencyTimer&) = delete;
+  ScopedLatencyTimer& operator=(const ScopedLatencyTimer&) = delete;
+
+private:
+  LatencyHistogram& m_histogram;
+  std::chrono::steady_clock::time_point m_start;
+};
+
+} // namespace dunedaq::trigger
+
+#endif // TRIGGER_SRC_TRIGGER_LATENCYHISTOGRAM_HPP_
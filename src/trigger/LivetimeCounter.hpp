@@ -1,5 +1,7 @@
 #ifndef TRIGGER_PLUGINS_LIVETIMECOUNTER_HPP_
 #define TRIGGER_PLUGINS_LIVETIMECOUNTER_HPP_
+#include <array>
+#include <atomic>
 #include <chrono>
 #include <map>
 #include <mutex>
@@ -14,6 +16,12 @@ namespace dunedaq::trigger {
  ** set_state(). The accumulated time in a particular state can be
  ** retrieved with get_time(State), and the times spent in all the
  ** states with get_time_map()
+ **
+ ** Accounting is kept in per-state atomic accumulators guarded by a
+ ** seqlock: state changes (rare) take a writer mutex and bump the
+ ** sequence counter, while readers retry a consistent snapshot without
+ ** ever blocking. This keeps get_time() off the lock even when opmon
+ ** polling coincides with decision-path queries
  **/
 class LivetimeCounter
 {
@@ -63,18 +71,27 @@ public:
   std::string get_report_string();
 
   std::string get_state_name(State state) const;
-  
+
 private:
+  static constexpr size_t s_n_states = 3;
+
+  static size_t state_index(State state) { return static_cast<size_t>(state); }
+
   state_time_t now() const;
-  // Precondition:  m_mutex is locked by caller
-     void update_map();
-       
-     std::mutex m_mutex;
-     State m_state;
-     std::map<State, state_time_t> m_state_times;
-     state_time_t m_last_state_change_time;
-  
+
+  // Lock-free consistent snapshot of the accumulators, with the time
+  // currently accruing in the active state folded in
+  std::array<state_time_t, s_n_states> snapshot();
+
+  // Writers only: serializes set_state calls from different threads
+  std::mutex m_write_mutex;
+  // Even outside a state change, odd while one is in progress
+  std::atomic<uint64_t> m_seq{ 0 };
+  std::atomic<State> m_state;
+  std::array<std::atomic<state_time_t>, s_n_states> m_state_times;
+  std::atomic<state_time_t> m_last_state_change_time;
+
 };
 } // namespace dunedaq::trigger
- 
+
 #endif // TRIGGER_PLUGINS_LIVETIMECOUNTER_HPP_
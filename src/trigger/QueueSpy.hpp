@@ -0,0 +1,121 @@
+/**
+ * @file QueueSpy.hpp
+ *
+ * Process-wide registry of inter-module queue backpressure probes.
+ *
+ * iomanager does not expose the depth of a connection to anyone but its
+ * owner, so when the chain degrades the backed-up queue has to be guessed
+ * from per-module counts. Instead, the modules that already drain their
+ * input queues in batches (TriggerGenericMaker, TriggerZipper, the MLT)
+ * report each drained batch here: a batch that ends because the queue is
+ * empty IS a depth sample, and a batch that hits its cap marks the queue
+ * as saturated (depth at least the cap). Senders report how long each
+ * send blocked, which is the push-side view of the same congestion.
+ *
+ * Slots are claimed once at registration (under a mutex) and recorded
+ * into lock-free afterwards, so probes cost two or three relaxed atomic
+ * operations per batch. The BackpressureObservatory module reads the
+ * registry and publishes the consolidated picture.
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#ifndef TRIGGER_SRC_TRIGGER_QUEUESPY_HPP_
+#define TRIGGER_SRC_TRIGGER_QUEUESPY_HPP_
+
+#include "trigger/LatencyHistogram.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+namespace dunedaq::trigger {
+
+class QueueSpy
+{
+public:
+  using handle_t = size_t;
+  static constexpr size_t s_max_queues = 128;
+
+  struct QueueStats
+  {
+    std::string name; // written once at registration, before m_n_queues is bumped
+    std::atomic<uint64_t> n_items{ 0 };     // NOLINT(build/unsigned) cumulative items drained/sent
+    std::atomic<uint64_t> n_samples{ 0 };   // NOLINT(build/unsigned) depth samples taken
+    std::atomic<uint64_t> last_depth{ 0 };  // NOLINT(build/unsigned)
+    std::atomic<uint64_t> high_water{ 0 };  // NOLINT(build/unsigned)
+    std::atomic<uint64_t> n_saturated{ 0 }; // NOLINT(build/unsigned) samples that hit the probe's cap
+    LatencyHistogram depth;
+    LatencyHistogram send_wait_us;
+  };
+
+  static QueueSpy& get_instance()
+  {
+    static QueueSpy instance;
+    return instance;
+  }
+
+  // Claim (or find) the slot for the given connection name. Safe to call
+  // from several modules for the same connection; they share the slot
+  handle_t register_queue(const std::string& name)
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    size_t n = m_n_queues.load(std::memory_order_acquire);
+    for (size_t i = 0; i < n; ++i) {
+      if (m_slots[i].name == name) {
+        return i;
+      }
+    }
+    if (n == s_max_queues) {
+      // Table full; overflow connections share the last slot rather than
+      // grow, mirroring the per-stream stats tables elsewhere
+      return s_max_queues - 1;
+    }
+    m_slots[n].name = name;
+    m_n_queues.store(n + 1, std::memory_order_release);
+    return n;
+  }
+
+  // One drained batch: `depth` items were waiting (at least, when
+  // `saturated` - the probe's batch cap was hit before the queue emptied)
+  void record_drain(handle_t h, uint64_t depth, bool saturated) // NOLINT(build/unsigned)
+  {
+    QueueStats& q = m_slots[h];
+    q.n_items.fetch_add(depth, std::memory_order_relaxed);
+    q.n_samples.fetch_add(1, std::memory_order_relaxed);
+    q.last_depth.store(depth, std::memory_order_relaxed);
+    if (saturated) {
+      q.n_saturated.fetch_add(1, std::memory_order_relaxed);
+    }
+    uint64_t hw = q.high_water.load(std::memory_order_relaxed); // NOLINT(build/unsigned)
+    while (depth > hw && !q.high_water.compare_exchange_weak(hw, depth, std::memory_order_relaxed)) {
+    }
+    q.depth.record_value(depth);
+  }
+
+  // One send: how long the sender blocked before the item was accepted
+  void record_send_wait(handle_t h, uint64_t wait_us) // NOLINT(build/unsigned)
+  {
+    QueueStats& q = m_slots[h];
+    q.n_items.fetch_add(1, std::memory_order_relaxed);
+    q.send_wait_us.record_value(wait_us);
+  }
+
+  size_t size() const { return m_n_queues.load(std::memory_order_acquire); }
+  const QueueStats& stats(size_t i) const { return m_slots[i]; }
+
+private:
+  QueueSpy() = default;
+
+  std::mutex m_mutex;
+  std::atomic<size_t> m_n_queues{ 0 };
+  std::array<QueueStats, s_max_queues> m_slots;
+};
+
+} // namespace dunedaq::trigger
+
+#endif // TRIGGER_SRC_TRIGGER_QUEUESPY_HPP_
@@ -0,0 +1,104 @@
+/**
+ * @file RingLatencyBuffer.hpp
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2021.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#ifndef TRIGGER_SRC_TRIGGER_RINGLATENCYBUFFER_HPP_
+#define TRIGGER_SRC_TRIGGER_RINGLATENCYBUFFER_HPP_
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace dunedaq {
+namespace trigger {
+
+/**
+ * @brief A contiguous time-indexed latency buffer for nearly time-ordered
+ * objects, as an alternative to per-node skip-list storage.
+ *
+ * T must provide get_first_timestamp() (the ordering key), as the readout
+ * buffer wrapper structs do. In-order writes append at the back; small
+ * disorder falls back to a binary search and positional insert. When full,
+ * the oldest elements are dropped from the front. Window extraction is a
+ * binary search for both bounds followed by sequential reads, with no
+ * tower pointers or per-element allocation anywhere.
+ *
+ * The allocator parameter lets the storage be drawn from an explicit
+ * huge-page arena (see HugePageArena.hpp); the default is the global heap.
+ */
+template<typename T, typename Alloc = std::allocator<T>>
+class RingLatencyBuffer
+{
+public:
+  void conf(size_t max_elements, const Alloc& alloc = Alloc())
+  {
+    m_max_elements = max_elements ? max_elements : 1;
+    m_ring = ring_t(alloc);
+  }
+
+  void write(T&& element)
+  {
+    while (m_ring.size() >= m_max_elements) {
+      m_ring.pop_front();
+    }
+    if (m_ring.empty() || !(element.get_first_timestamp() < m_ring.back().get_first_timestamp())) {
+      m_ring.push_back(std::move(element));
+    } else {
+      auto pos = std::upper_bound(m_ring.begin(), m_ring.end(), element, [](const T& lhs, const T& rhs) {
+        return lhs.get_first_timestamp() < rhs.get_first_timestamp();
+      });
+      m_ring.insert(pos, std::move(element));
+    }
+    m_occupancy.store(m_ring.size(), std::memory_order_relaxed);
+  }
+
+  /**
+   * Append every element with timestamp in [window_begin, window_end] to
+   * `out`. Returns the number of elements appended.
+   */
+  size_t extract_window(uint64_t window_begin, uint64_t window_end, std::vector<T>& out) const // NOLINT(build/unsigned)
+  {
+    auto it_low = std::lower_bound(m_ring.begin(), m_ring.end(), window_begin, [](const T& lhs, uint64_t ts) { // NOLINT(build/unsigned)
+      return lhs.get_first_timestamp() < ts;
+    });
+    auto it_up = std::upper_bound(it_low, m_ring.end(), window_end, [](uint64_t ts, const T& rhs) { // NOLINT(build/unsigned)
+      return ts < rhs.get_first_timestamp();
+    });
+    out.reserve(out.size() + static_cast<size_t>(it_up - it_low));
+    size_t n = 0;
+    for (auto it = it_low; it != it_up; ++it, ++n) {
+      out.push_back(*it);
+    }
+    return n;
+  }
+
+  uint64_t get_earliest_timestamp() const { return m_ring.empty() ? 0 : m_ring.front().get_first_timestamp(); } // NOLINT(build/unsigned)
+  uint64_t get_latest_timestamp() const { return m_ring.empty() ? 0 : m_ring.back().get_first_timestamp(); }   // NOLINT(build/unsigned)
+
+  size_t occupancy() const { return m_occupancy.load(std::memory_order_relaxed); }
+
+  void flush()
+  {
+    m_ring.clear();
+    m_occupancy.store(0, std::memory_order_relaxed);
+  }
+
+private:
+  using ring_t = std::deque<T, Alloc>;
+  ring_t m_ring;
+  size_t m_max_elements{ 1 };
+  std::atomic<size_t> m_occupancy{ 0 };
+};
+
+} // namespace trigger
+} // namespace dunedaq
+
+#endif // TRIGGER_SRC_TRIGGER_RINGLATENCYBUFFER_HPP_
@@ -0,0 +1,334 @@
+/**
+ * @file TPStreamFile.hpp
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#ifndef TRIGGER_SRC_TRIGGER_TPSTREAMFILE_HPP_
+#define TRIGGER_SRC_TRIGGER_TPSTREAMFILE_HPP_
+
+#include "trigger/TPSet.hpp"
+
+#include <boost/iostreams/device/back_inserter.hpp>
+#include <boost/iostreams/filter/zlib.hpp>
+#include <boost/iostreams/filtering_stream.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace dunedaq::trigger {
+
+/**
+ * @brief Framed, compressed, seekable TPSet stream file (.tpstream)
+ *
+ * Replay libraries stored as raw HDF5 TP fragments are tens of TB and
+ * uncompressed, so replay rate is capped by disk I/O. This format stores
+ * already-formed TPSets in independently-compressed chunks with a time
+ * index in the footer:
+ *
+ *   FileHeader
+ *   chunk 0: ChunkHeader + deflate(SetRecord...)
+ *   chunk 1: ...
+ *   index:   IndexEntry per chunk
+ *   Trailer (fixed size, at EOF)
+ *
+ * Chunks close on TPSet boundaries once a target uncompressed size is
+ * reached, so a reader can start at any chunk; the index maps each
+ * chunk's first set start time to its file offset, which gives O(log n)
+ * seeks by time and a free first/last time range. TP payloads compress
+ * roughly 4x, turning replay from disk-bound into CPU-bound.
+ *
+ * Compression is deflate via the Boost::iostreams the package already
+ * links; the framing is codec-agnostic, so swapping the per-chunk codec
+ * is a local change.
+ */
+// On-disk structures. All fixed-width, written/read by memcpy on the
+// (little-endian) hosts this runs on
+struct TPStreamFileHeader
+{
+  uint64_t magic;   // NOLINT(build/unsigned)
+  uint32_t version; // NOLINT(build/unsigned)
+  uint32_t reserved; // NOLINT(build/unsigned)
+};
+
+struct TPStreamChunkHeader
+{
+  uint64_t first_start_time; // NOLINT(build/unsigned)
+  uint64_t last_start_time;  // NOLINT(build/unsigned)
+  uint32_t n_sets;             // NOLINT(build/unsigned)
+  uint32_t uncompressed_bytes; // NOLINT(build/unsigned)
+  uint32_t compressed_bytes;   // NOLINT(build/unsigned)
+  uint32_t reserved;           // NOLINT(build/unsigned)
+};
+
+struct TPStreamSetRecord
+{
+  uint64_t seqno;      // NOLINT(build/unsigned)
+  uint64_t start_time; // NOLINT(build/unsigned)
+  uint64_t end_time;   // NOLINT(build/unsigned)
+  uint32_t run_number; // NOLINT(build/unsigned)
+  uint32_t origin_id;  // NOLINT(build/unsigned)
+  int32_t type;
+  uint32_t n_tps; // NOLINT(build/unsigned)
+  // followed by n_tps TriggerPrimitive, flat
+};
+
+struct TPStreamIndexEntry
+{
+  uint64_t first_start_time; // NOLINT(build/unsigned)
+  uint64_t file_offset;      // NOLINT(build/unsigned)
+};
+
+struct TPStreamTrailer
+{
+  uint64_t index_offset; // NOLINT(build/unsigned)
+  uint64_t n_chunks;     // NOLINT(build/unsigned)
+  uint64_t magic;        // NOLINT(build/unsigned)
+};
+
+class TPStreamWriter
+{
+public:
+  static constexpr uint64_t s_magic = 0x545053545245414d; // "TPSTREAM" // NOLINT(build/unsigned)
+  static constexpr uint32_t s_version = 1;                // NOLINT(build/unsigned)
+
+  explicit TPStreamWriter(const std::string& filename, size_t chunk_target_bytes = 1 << 20)
+    : m_out(filename, std::ios::binary | std::ios::trunc)
+    , m_chunk_target_bytes(chunk_target_bytes)
+  {
+    if (!m_out) {
+      throw std::runtime_error("TPStreamWriter: cannot open " + filename);
+    }
+    TPStreamFileHeader hdr{ s_magic, s_version, 0 };
+    m_out.write(reinterpret_cast<const char*>(&hdr), sizeof(hdr));
+  }
+
+  ~TPStreamWriter() { close(); }
+
+  void write(const TPSet& tpset)
+  {
+    if (m_chunk.empty()) {
+      m_chunk_first_time = tpset.start_time;
+    }
+    m_chunk_last_time = tpset.start_time;
+    TPStreamSetRecord rec;
+    rec.seqno = tpset.seqno;
+    rec.start_time = tpset.start_time;
+    rec.end_time = tpset.end_time;
+    rec.run_number = tpset.run_number;
+    rec.origin_id = tpset.origin.id;
+    rec.type = static_cast<int32_t>(tpset.type);
+    rec.n_tps = tpset.objects.size();
+    append_raw(&rec, sizeof(rec));
+    append_raw(tpset.objects.begin(), rec.n_tps * sizeof(trgdataformats::TriggerPrimitive));
+    ++m_chunk_n_sets;
+    if (m_chunk.size() >= m_chunk_target_bytes) {
+      flush_chunk();
+    }
+  }
+
+  void close()
+  {
+    if (!m_out.is_open()) {
+      return;
+    }
+    flush_chunk();
+    uint64_t index_offset = m_out.tellp(); // NOLINT(build/unsigned)
+    for (const TPStreamIndexEntry& e : m_index) {
+      m_out.write(reinterpret_cast<const char*>(&e), sizeof(e));
+    }
+    TPStreamTrailer trailer{ index_offset, m_index.size(), s_magic };
+    m_out.write(reinterpret_cast<const char*>(&trailer), sizeof(trailer));
+    m_out.close();
+  }
+
+private:
+  void append_raw(const void* data, size_t bytes)
+  {
+    const char* p = static_cast<const char*>(data);
+    m_chunk.insert(m_chunk.end(), p, p + bytes);
+  }
+
+  void flush_chunk()
+  {
+    if (m_chunk.empty()) {
+      return;
+    }
+    std::vector<char> compressed;
+    {
+      namespace bio = boost::iostreams;
+      bio::filtering_ostream os;
+      os.push(bio::zlib_compressor());
+      os.push(bio::back_inserter(compressed));
+      os.write(m_chunk.data(), m_chunk.size());
+    } // destructor flushes the compressor
+    m_index.push_back(TPStreamIndexEntry{ m_chunk_first_time, static_cast<uint64_t>(m_out.tellp()) });
+    TPStreamChunkHeader hdr;
+    hdr.first_start_time = m_chunk_first_time;
+    hdr.last_start_time = m_chunk_last_time;
+    hdr.n_sets = m_chunk_n_sets;
+    hdr.uncompressed_bytes = m_chunk.size();
+    hdr.compressed_bytes = compressed.size();
+    hdr.reserved = 0;
+    m_out.write(reinterpret_cast<const char*>(&hdr), sizeof(hdr));
+    m_out.write(compressed.data(), compressed.size());
+    m_chunk.clear();
+    m_chunk_n_sets = 0;
+  }
+
+  std::ofstream m_out;
+  size_t m_chunk_target_bytes;
+  std::vector<char> m_chunk; // uncompressed records of the open chunk
+  uint64_t m_chunk_first_time{ 0 }; // NOLINT(build/unsigned)
+  uint64_t m_chunk_last_time{ 0 };  // NOLINT(build/unsigned)
+  uint32_t m_chunk_n_sets{ 0 };     // NOLINT(build/unsigned)
+  std::vector<TPStreamIndexEntry> m_index;
+};
+
+class TPStreamReader
+{
+public:
+  explicit TPStreamReader(const std::string& filename)
+    : m_in(filename, std::ios::binary)
+    , m_filename(filename)
+  {
+    if (!m_in) {
+      throw std::runtime_error("TPStreamReader: cannot open " + filename);
+    }
+    TPStreamFileHeader hdr;
+    m_in.read(reinterpret_cast<char*>(&hdr), sizeof(hdr));
+    if (!m_in || hdr.magic != TPStreamWriter::s_magic || hdr.version != TPStreamWriter::s_version) {
+      throw std::runtime_error("TPStreamReader: " + filename + " is not a TPSet stream file");
+    }
+    // Load the index from the trailer
+    m_in.seekg(-static_cast<std::streamoff>(sizeof(TPStreamTrailer)), std::ios::end);
+    TPStreamTrailer trailer;
+    m_in.read(reinterpret_cast<char*>(&trailer), sizeof(trailer));
+    if (!m_in || trailer.magic != TPStreamWriter::s_magic) {
+      throw std::runtime_error("TPStreamReader: " + filename + " has no valid trailer (truncated write?)");
+    }
+    m_index.resize(trailer.n_chunks);
+    m_in.seekg(trailer.index_offset);
+    m_in.read(reinterpret_cast<char*>(m_index.data()), m_index.size() * sizeof(TPStreamIndexEntry));
+    rewind();
+  }
+
+  // Time range covered by the file, from the index alone
+  std::pair<uint64_t, uint64_t> time_range() // NOLINT(build/unsigned)
+  {
+    if (m_index.empty()) {
+      return { 0, 0 };
+    }
+    // The last chunk's header has the last set start time
+    m_in.seekg(m_index.back().file_offset);
+    TPStreamChunkHeader hdr;
+    m_in.read(reinterpret_cast<char*>(&hdr), sizeof(hdr));
+    return { m_index.front().first_start_time, hdr.last_start_time };
+  }
+
+  void rewind()
+  {
+    m_next_chunk = 0;
+    m_buffer.clear();
+    m_buffer_pos = 0;
+  }
+
+  // Position the cursor at the first chunk that can contain sets with
+  // start_time >= t (binary search over the index)
+  void seek_time(uint64_t t) // NOLINT(build/unsigned)
+  {
+    size_t lo = 0;
+    size_t hi = m_index.size();
+    while (lo < hi) {
+      size_t mid = (lo + hi) / 2;
+      if (m_index[mid].first_start_time < t) {
+        lo = mid + 1;
+      } else {
+        hi = mid;
+      }
+    }
+    m_next_chunk = lo > 0 ? lo - 1 : 0; // previous chunk may still contain times >= t
+    m_buffer.clear();
+    m_buffer_pos = 0;
+  }
+
+  // Read the next TPSet in file order. Returns false at end of stream
+  bool read_next(TPSet& tpset)
+  {
+    if (m_buffer_pos >= m_buffer.size() && !load_next_chunk()) {
+      return false;
+    }
+    TPStreamSetRecord rec;
+    std::memcpy(&rec, m_buffer.data() + m_buffer_pos, sizeof(rec));
+    m_buffer_pos += sizeof(rec);
+    tpset.seqno = rec.seqno;
+    tpset.start_time = rec.start_time;
+    tpset.end_time = rec.end_time;
+    tpset.run_number = rec.run_number;
+    tpset.origin.id = rec.origin_id;
+    tpset.type = static_cast<TPSet::Type>(rec.type);
+    tpset.objects.clear();
+    tpset.objects.reserve(rec.n_tps);
+    trgdataformats::TriggerPrimitive tp;
+    for (uint32_t i = 0; i < rec.n_tps; ++i) { // NOLINT(build/unsigned)
+      std::memcpy(&tp, m_buffer.data() + m_buffer_pos, sizeof(tp));
+      m_buffer_pos += sizeof(tp);
+      tpset.objects.push_back(tp);
+    }
+    return true;
+  }
+
+private:
+  bool load_next_chunk()
+  {
+    if (m_next_chunk >= m_index.size()) {
+      return false;
+    }
+    m_in.clear();
+    m_in.seekg(m_index[m_next_chunk].file_offset);
+    TPStreamChunkHeader hdr;
+    m_in.read(reinterpret_cast<char*>(&hdr), sizeof(hdr));
+    std::vector<char> compressed(hdr.compressed_bytes);
+    m_in.read(compressed.data(), compressed.size());
+    if (!m_in) {
+      throw std::runtime_error("TPStreamReader: truncated chunk in " + m_filename);
+    }
+    m_buffer.clear();
+    m_buffer.reserve(hdr.uncompressed_bytes);
+    {
+      namespace bio = boost::iostreams;
+      bio::filtering_ostream os;
+      os.push(bio::zlib_decompressor());
+      os.push(bio::back_inserter(m_buffer));
+      os.write(compressed.data(), compressed.size());
+    }
+    if (m_buffer.size() != hdr.uncompressed_bytes) {
+      throw std::runtime_error("TPStreamReader: chunk size mismatch in " + m_filename);
+    }
+    m_buffer_pos = 0;
+    ++m_next_chunk;
+    return true;
+  }
+
+  std::ifstream m_in;
+  std::string m_filename;
+  std::vector<TPStreamIndexEntry> m_index;
+  size_t m_next_chunk{ 0 };
+  std::vector<char> m_buffer; // decompressed records of the current chunk
+  size_t m_buffer_pos{ 0 };
+};
+
+} // namespace dunedaq::trigger
+
+#endif // TRIGGER_SRC_TRIGGER_TPSTREAMFILE_HPP_
+
+// Local Variables:
+// c-basic-offset: 2
+// End:
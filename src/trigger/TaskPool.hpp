@@ -0,0 +1,182 @@
+/**
+ * @file TaskPool.hpp
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#ifndef TRIGGER_SRC_TRIGGER_TASKPOOL_HPP_
+#define TRIGGER_SRC_TRIGGER_TASKPOOL_HPP_
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace dunedaq::trigger {
+
+/**
+ * @brief Process-wide pool of threads cooperatively multiplexing module
+ * work loops
+ *
+ * A full trigger app instantiates dozens of maker modules, each of
+ * which normally owns a WorkerThread that spends most of its life
+ * parked on an empty queue; that is hundreds of threads per host and
+ * visible scheduler thrash at run start. Modules can instead register
+ * a cooperative task: a step function that performs one bounded unit
+ * of work (one input batch) without blocking and returns whether it
+ * found any. Pool threads sweep the registered tasks, claiming each
+ * with an atomic flag so a task never runs on two threads at once,
+ * and back off to a short sleep when a full sweep finds no work - so
+ * queue readiness drives scheduling and the host pays a thread count
+ * proportional to cores, not modules.
+ *
+ * The pool is sized from the TRIGGER_TASK_POOL_THREADS environment
+ * variable, defaulting to half the hardware concurrency, and its
+ * threads are started lazily at first registration. remove_task()
+ * deactivates a task and blocks until any in-progress step has
+ * finished, so a module's stop transition can safely drain and reset
+ * its worker afterwards.
+ */
+class TaskPool
+{
+public:
+  using task_id_t = uint64_t; // NOLINT(build/unsigned)
+
+  static TaskPool& get_instance()
+  {
+    static TaskPool instance;
+    return instance;
+  }
+
+  // `step` must not block: it should try the module's input, process at
+  // most one batch, and return whether it did any work
+  task_id_t add_task(const std::string& name, std::function<bool()> step)
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto task = std::make_shared<Task>();
+    task->id = ++m_next_id;
+    task->name = name;
+    task->step = std::move(step);
+    m_tasks.push_back(task);
+    start_threads();
+    return task->id;
+  }
+
+  // Deactivate the task and wait for any in-progress step to finish
+  // before deregistering it
+  void remove_task(task_id_t id)
+  {
+    std::shared_ptr<Task> task;
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      for (auto it = m_tasks.begin(); it != m_tasks.end(); ++it) {
+        if ((*it)->id == id) {
+          task = *it;
+          m_tasks.erase(it);
+          break;
+        }
+      }
+    }
+    if (!task) {
+      return;
+    }
+    task->active.store(false);
+    while (task->busy.load()) {
+      std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+  }
+
+  size_t thread_count() const { return m_threads.size(); }
+
+private:
+  struct Task
+  {
+    task_id_t id = 0;
+    std::string name;
+    std::function<bool()> step;
+    std::atomic<bool> active{ true };
+    std::atomic<bool> busy{ false };
+  };
+
+  TaskPool() = default;
+
+  ~TaskPool()
+  {
+    m_stopping.store(true);
+    for (auto& thread : m_threads) {
+      thread.join();
+    }
+  }
+
+  TaskPool(const TaskPool&) = delete;
+  TaskPool& operator=(const TaskPool&) = delete;
+
+  // Called with m_mutex held
+  void start_threads()
+  {
+    if (!m_threads.empty()) {
+      return;
+    }
+    size_t n_threads = std::max(1u, std::thread::hardware_concurrency() / 2);
+    if (const char* env = std::getenv("TRIGGER_TASK_POOL_THREADS")) { // NOLINT(concurrency-mt-unsafe)
+      n_threads = std::max<size_t>(1, std::atoi(env));                // NOLINT
+    }
+    for (size_t i = 0; i < n_threads; ++i) {
+      m_threads.emplace_back(&TaskPool::run, this);
+      pthread_setname_np(m_threads.back().native_handle(), ("trgtask" + std::to_string(i)).c_str());
+    }
+  }
+
+  void run()
+  {
+    std::vector<std::shared_ptr<Task>> sweep;
+    while (!m_stopping.load()) {
+      {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        sweep = m_tasks;
+      }
+      bool any_work = false;
+      for (auto& task : sweep) {
+        if (!task->active.load()) {
+          continue;
+        }
+        bool expected = false;
+        if (!task->busy.compare_exchange_strong(expected, true)) {
+          continue; // another pool thread is running this task
+        }
+        if (task->active.load() && task->step()) {
+          any_work = true;
+        }
+        task->busy.store(false);
+      }
+      if (!any_work) {
+        // No queue had anything: park briefly instead of spinning. Short
+        // enough to be invisible next to the queue timeouts modules use
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+      }
+    }
+  }
+
+  std::mutex m_mutex;
+  std::vector<std::shared_ptr<Task>> m_tasks;
+  std::vector<std::thread> m_threads;
+  std::atomic<bool> m_stopping{ false };
+  task_id_t m_next_id = 0;
+};
+
+} // namespace dunedaq::trigger
+
+#endif // TRIGGER_SRC_TRIGGER_TASKPOOL_HPP_
+
+// Local Variables:
+// c-basic-offset: 2
+// End:
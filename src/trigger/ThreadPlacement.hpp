@@ -0,0 +1,124 @@
+/**
+ * @file ThreadPlacement.hpp
+ *
+ * Helpers for pinning worker threads to CPUs and steering their
+ * allocations to a NUMA node, driven by per-module configuration.
+ *
+ * On dual-socket hosts the scheduler is free to migrate a maker's worker
+ * thread away from the core whose L2/LLC holds its input stream, and
+ * first-touch then spreads a module's buffers over whichever node the
+ * thread happened to run on at conf time. Declaring placement in the
+ * module conf keeps a pipeline's stages (and their buffers) on one node
+ * and survives restarts, unlike hand-run taskset/numactl.
+ *
+ * The memory-policy calls go through syscall() directly rather than
+ * libnuma: we need exactly set_mempolicy(MPOL_PREFERRED/MPOL_DEFAULT),
+ * which is not worth a new package dependency. Failures are reported as
+ * warnings and the module runs unplaced, so a conf written for one host
+ * is usable on another.
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#ifndef TRIGGER_SRC_TRIGGER_THREADPLACEMENT_HPP_
+#define TRIGGER_SRC_TRIGGER_THREADPLACEMENT_HPP_
+
+#include "trigger/Issues.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <pthread.h>
+#include <sched.h>
+#include <string>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <vector>
+
+namespace dunedaq::trigger::thread_placement {
+
+// Memory-policy modes from <numaif.h>, defined here so the two calls
+// below don't pull in a libnuma dependency
+constexpr int s_mpol_default = 0;
+constexpr int s_mpol_preferred = 1;
+
+inline long // NOLINT(runtime/int)
+set_mempolicy_raw(int mode, const unsigned long* nodemask, unsigned long maxnode) // NOLINT(runtime/int)
+{
+  return syscall(SYS_set_mempolicy, mode, nodemask, maxnode);
+}
+
+// Pin the calling thread to the given set of logical CPUs. An empty set
+// leaves the scheduler in charge. `name` identifies the module in the
+// warning issued if the kernel rejects the mask (e.g. a CPU id from a
+// conf written for a bigger host)
+inline void
+pin_current_thread(const std::vector<uint16_t>& cpus, const std::string& name) // NOLINT(build/unsigned)
+{
+  if (cpus.empty()) {
+    return;
+  }
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  for (uint16_t cpu : cpus) { // NOLINT(build/unsigned)
+    CPU_SET(cpu, &set);
+  }
+  int rc = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+  if (rc != 0) {
+    ers::warning(ThreadPlacementFailed(ERS_HERE, "cpu affinity", name, std::strerror(rc)));
+  }
+}
+
+// Prefer the given NUMA node for the calling thread's page allocations
+// (falling back to other nodes when it is full, so this can't OOM a
+// node). The policy is per-thread and applies to pages first touched
+// from here on; call it before the thread's large buffers are populated.
+// node < 0 is "no preference" and leaves the policy untouched
+inline void
+prefer_numa_node(int node, const std::string& name)
+{
+  if (node < 0) {
+    return;
+  }
+  if (node >= static_cast<int>(8 * sizeof(unsigned long))) { // NOLINT(runtime/int)
+    ers::warning(ThreadPlacementFailed(ERS_HERE, "numa policy", name, "node id out of range"));
+    return;
+  }
+  unsigned long mask = 1UL << node; // NOLINT(runtime/int)
+  if (set_mempolicy_raw(s_mpol_preferred, &mask, 8 * sizeof(mask)) != 0) {
+    ers::warning(ThreadPlacementFailed(ERS_HERE, "numa policy", name, std::strerror(errno)));
+  }
+}
+
+// Scoped preferred-node policy for the calling thread, for steering a
+// specific allocation (e.g. a latency buffer populated at conf time)
+// without changing where the rest of the thread's pages land
+class ScopedNumaPreference
+{
+public:
+  ScopedNumaPreference(int node, const std::string& name)
+    : m_active(node >= 0)
+  {
+    if (m_active) {
+      prefer_numa_node(node, name);
+    }
+  }
+
+  ~ScopedNumaPreference()
+  {
+    if (m_active) {
+      set_mempolicy_raw(s_mpol_default, nullptr, 0);
+    }
+  }
+
+  ScopedNumaPreference(const ScopedNumaPreference&) = delete;
+  ScopedNumaPreference& operator=(const ScopedNumaPreference&) = delete;
+
+private:
+  bool m_active;
+};
+
+} // namespace dunedaq::trigger::thread_placement
+
+#endif // TRIGGER_SRC_TRIGGER_THREADPLACEMENT_HPP_
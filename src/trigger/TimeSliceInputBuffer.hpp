@@ -15,7 +15,10 @@
 #include "logging/Logging.hpp"
 
 #include <algorithm>
+#include <queue>
 #include <string>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 namespace dunedaq::trigger {
@@ -24,6 +27,11 @@ namespace dunedaq::trigger {
 // time_start and time_end. Finally, get a vector of all contained objects in
 // time order when a Set<T> with a different time_start arrives.
 // This class encapsulates that logic.
+//
+// The slice container is a template parameter: the default std::vector<T>
+// gives the usual AoS slice, while a structure-of-arrays container with the
+// same push_back/reserve/size interface (e.g. TPSoAColumns) has the slice
+// assembled directly into its columns, with no intermediate AoS pass.
 template<class T>
 class TimeSliceInputBuffer
 {
@@ -33,46 +41,93 @@ public:
     : m_name(name)
     , m_algorithm(algorithm)
   {}
-  // Add a new Set<T> to the buffer. If it's inconsistent with buffered events,
-  // fill time_slice, start_time, end_time with the previous (complete) slice.
+  // Add a new Set<T> to the buffer, taking ownership of its contents. If it's
+  // inconsistent with buffered events, fill time_slice, start_time, end_time
+  // with the previous (complete) slice.
   // Returns whether the previous slice was complete (and time_slice etc was filled)
-  bool buffer(Set<T> in,
-              std::vector<T>& time_slice,
+  template<class SLICE = std::vector<T>>
+  bool buffer(Set<T>&& in,
+              SLICE& time_slice,
               daqdataformats::timestamp_t& start_time,
               daqdataformats::timestamp_t& end_time)
   {
     if (m_buffer.size() == 0 || m_buffer.back().start_time == in.start_time) {
       // if `in` is the current time slice
-      m_buffer.emplace_back(in);
+      m_buffer.emplace_back(std::move(in));
       return false; // buffer the time slice
     }
     // obtain the current (complete) time slice
     flush(time_slice, start_time, end_time);
     // add `in`, which is the next time slice
-    m_buffer.emplace_back(in);
+    m_buffer.emplace_back(std::move(in));
     return true;
   }
   // Fill time_slice with the sorted buffer, clear the buffer, and return true
   // Returns false and does nothing if the buffer is empty
-  bool flush(std::vector<T>& time_slice, daqdataformats::timestamp_t& start_time, daqdataformats::timestamp_t& end_time)
+  template<class SLICE = std::vector<T>>
+  bool flush(SLICE& time_slice, daqdataformats::timestamp_t& start_time, daqdataformats::timestamp_t& end_time)
   {
     if (m_buffer.size() == 0) {
       return false;
     }
-    // build a vector of the T objects from all the sets in the slice
     start_time = m_buffer[0].start_time;
     end_time = m_buffer[0].end_time;
+    auto time_start_less = [](const T& a, const T& b) { return a.time_start < b.time_start; };
+    // TODO Benjamin Land <BenLand100@github.com> June-01-2021: would be nice if the T (TriggerPrimative, etc) included a natural ordering with operator<()
+    size_t n_objects = 0;
+    bool runs_sorted = true;
     for (Set<T>& x : m_buffer) {
       if (x.start_time != start_time || x.end_time != end_time) {
         ers::warning(InconsistentSetTimeError(ERS_HERE, m_name, m_algorithm));
       }
-      time_slice.insert(time_slice.end(), x.objects.begin(), x.objects.end());
+      n_objects += x.objects.size();
+      runs_sorted = runs_sorted && std::is_sorted(x.objects.begin(), x.objects.end(), time_start_less);
+    }
+    time_slice.reserve(time_slice.size() + n_objects);
+    if (runs_sorted) {
+      // Each Set's objects vector is already time-ordered by its producer, so
+      // build the slice with a k-way merge of the pre-sorted runs: O(n log k)
+      // with sequential access, instead of concatenating everything and
+      // re-sorting the whole slice at O(n log n)
+      using run_iterator = typename Set<T>::collection_t::const_iterator;
+      struct run_cursor
+      {
+        run_iterator it, end;
+      };
+      auto cursor_greater = [](const run_cursor& a, const run_cursor& b) {
+        return a.it->time_start > b.it->time_start;
+      };
+      std::priority_queue<run_cursor, std::vector<run_cursor>, decltype(cursor_greater)> heap(cursor_greater);
+      for (const Set<T>& x : m_buffer) {
+        if (!x.objects.empty()) {
+          heap.push(run_cursor{ x.objects.begin(), x.objects.end() });
+        }
+      }
+      while (!heap.empty()) {
+        run_cursor c = heap.top();
+        heap.pop();
+        time_slice.push_back(*c.it);
+        if (++c.it != c.end) {
+          heap.push(c);
+        }
+      }
+    } else {
+      // An upstream producer sent an unsorted Set: fall back to the
+      // concatenate-and-sort path, which makes no ordering assumptions
+      for (Set<T>& x : m_buffer) {
+        for (const T& obj : x.objects) {
+          time_slice.push_back(obj);
+        }
+      }
+      if constexpr (std::is_same_v<SLICE, std::vector<T>>) {
+        std::sort(time_slice.begin(), time_slice.end(), time_start_less);
+      } else {
+        // SoA slices restore time order across all columns themselves
+        time_slice.sort_by_time_start();
+      }
     }
     // clear the buffer
     m_buffer.clear();
-    // sort the vector by time_start property of T
-    std::sort(time_slice.begin(), time_slice.end(), [](const T& a, const T& b) { return a.time_start < b.time_start; });
-    // TODO Benjamin Land <BenLand100@github.com> June-01-2021: would be nice if the T (TriggerPrimative, etc) included a natural ordering with operator<()
     return true;
   }
 
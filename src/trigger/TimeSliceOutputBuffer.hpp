@@ -10,13 +10,17 @@
 #define TRIGGER_SRC_TRIGGER_TIMESLICEOUTPUTBUFFER_HPP_
 
 #include "trigger/Issues.hpp"
+#include "trigger/IssueThrottler.hpp"
 #include "trigger/Set.hpp"
 #include "trigger/Logging.hpp"
 
 #include "logging/Logging.hpp"
 
+#include <algorithm>
+#include <deque>
 #include <queue>
 #include <string>
+#include <utility>
 #include <vector>
 
 using dunedaq::trigger::logging::TLVL_DEBUG_MEDIUM;
@@ -24,12 +28,6 @@ using dunedaq::trigger::logging::TLVL_DEBUG_MEDIUM;
 namespace dunedaq::trigger {
 
 // TODO Benjamin Land <BenLand100@github.com> June-01-2021: would be nice if the T (TriggerPrimative, etc) included a natural ordering with operator<()
-template<class T>
-struct time_start_greater_t
-{
-  bool operator()(const T& a, const T& b) { return a.time_start > b.time_start; }
-};
-
 // TODO Philip Rodrigues rodriges@fnal.gov 2022-04-27: Same comment as above, plus we should really fix the time_start/start_time inconsistency
 template<class T>
 struct start_time_greater_t
@@ -70,10 +68,24 @@ public:
     }
     for (const T& x : in) {
       if (x.time_start < m_next_window_start) {
-        ers::warning(TardyOutputError(ERS_HERE, m_name, m_algorithm, x.time_start, m_next_window_start));
+        // A single badly-stamped slice can make every object here tardy, so
+        // emission is throttled: the raw count stays in tardy_count()
+        ++m_tardy_count;
+        if (m_tardy_throttle.allow()) {
+          ers::warning(TardyOutputError(ERS_HERE, m_name, m_algorithm, x.time_start, m_next_window_start));
+          report_suppressed();
+        }
         // x is discarded
       } else {
-        m_buffer.push(x);
+        // O(1) insertion into the per-window bucket that contains x. Windows
+        // are emitted strictly in order, so bucket 0 is always the window
+        // starting at m_next_window_start
+        size_t window_index = (x.time_start - m_next_window_start) / m_window_time;
+        if (window_index >= m_windows.size()) {
+          m_windows.resize(window_index + 1);
+        }
+        m_windows[window_index].push_back(x);
+        ++m_n_buffered;
         if (m_largest_time < x.time_start) {
           m_largest_time = x.time_start;
         }
@@ -84,6 +96,14 @@ public:
   // Add a new heartbeat Set to the buffer
   void buffer_heartbeat(const Set<T> heartbeat)
   {
+    // A heartbeat at time T is the producer's guarantee that no input earlier
+    // than T will arrive, so it acts as a watermark releasing every window
+    // that ends at or before T (see ready()). This holds even if the
+    // heartbeat itself is discarded below
+    if (m_watermark < heartbeat.start_time) {
+      m_watermark = heartbeat.start_time;
+    }
+
     if (m_next_window_start == 0) {
       // Window start time is unknown. pick it as the window that contains the
       // first element of in. Window start time must be multiples of m_window_time
@@ -91,7 +111,11 @@ public:
     }
 
     if (heartbeat.start_time < m_next_window_start) {
-      ers::warning(TardyOutputError(ERS_HERE, m_name, m_algorithm, heartbeat.start_time, m_next_window_start));
+      ++m_tardy_count;
+      if (m_tardy_throttle.allow()) {
+        ers::warning(TardyOutputError(ERS_HERE, m_name, m_algorithm, heartbeat.start_time, m_next_window_start));
+        report_suppressed();
+      }
       // heartbeat is discarded
     } else if (heartbeat.start_time % m_window_time != 0) {
       ers::warning(UnalignedHeartbeat(ERS_HERE, m_name, m_algorithm, heartbeat.start_time, m_window_time));
@@ -104,7 +128,19 @@ public:
     }
   }
 
-  void reset() { m_next_window_start = 0; }
+  void reset()
+  {
+    m_next_window_start = 0;
+    m_windows.clear();
+    m_n_buffered = 0;
+    m_watermark = 0;
+    m_tardy_count = 0;
+    m_tardy_throttle.reset();
+  }
+
+  // Total tardy objects/heartbeats dropped, including those whose warning
+  // was suppressed. Exported through the owning maker's opmon info
+  uint64_t tardy_count() const { return m_tardy_count; } // NOLINT(build/unsigned)
 
   void set_window_time(const daqdataformats::timestamp_t window_time)
   {
@@ -117,17 +153,23 @@ public:
   // Set the time to wait after a window before a window is emitted in ticks
   void set_buffer_time(const daqdataformats::timestamp_t buffer_time) { m_buffer_time = buffer_time; }
 
-  // True if this buffer has gone m_buffer_time past the end of the first window
+  // True if this buffer has gone m_buffer_time past the end of the first
+  // window, or if a heartbeat watermark guarantees the first window is
+  // complete. The latter keeps emission latency bounded by the heartbeat
+  // cadence during quiet detector periods, when no later payload would
+  // otherwise push m_largest_time forward
   bool ready()
   {
     if (empty()) {
       return false;
-    } else {
-      return m_largest_time - (m_next_window_start + m_window_time) > m_buffer_time;
     }
+    if (m_watermark >= m_next_window_start + m_window_time) {
+      return true;
+    }
+    return m_largest_time - (m_next_window_start + m_window_time) > m_buffer_time;
   }
 
-  bool empty() { return m_buffer.empty() && m_heartbeat_buffer.empty(); }
+  bool empty() { return m_n_buffered == 0 && m_heartbeat_buffer.empty(); }
 
   // Fills out_set with the contents of the buffer that fall within
   // the first window, or with the next buffered heartbeat Set, if it
@@ -145,7 +187,7 @@ public:
     // buffer
     if (!m_heartbeat_buffer.empty() && m_heartbeat_buffer.top().start_time == m_next_window_start) {
       auto& hb = m_heartbeat_buffer.top();
-      TLOG_DEBUG(TLVL_DEBUG_MEDIUM) << "[TimeSliceOutputBuffer] Flushing heartbeat with start time " << hb.start_time;
+      TRIGGER_TLOG_DEBUG(TLVL_DEBUG_MEDIUM) << "[TimeSliceOutputBuffer] Flushing heartbeat with start time " << hb.start_time;
       out_set.start_time = hb.start_time;
       out_set.end_time = hb.end_time;
       out_set.origin = hb.origin;
@@ -158,26 +200,42 @@ public:
     out_set.start_time = m_next_window_start;
     out_set.end_time = m_next_window_start + m_window_time;
     m_next_window_start = m_next_window_start + m_window_time;
-    while (!m_buffer.empty() && m_buffer.top().time_start <= out_set.end_time) {
-      if (m_buffer.top().time_start < out_set.start_time) {
-        ers::warning(WindowlessOutputError(ERS_HERE, m_name, m_algorithm));
-        // top is discarded
-      } else {
-        out_set.objects.emplace_back(m_buffer.top());
-      }
-      m_buffer.pop();
+    if (!m_windows.empty()) {
+      // Hand the front window's bucket to out_set wholesale. Objects may have
+      // arrived in any order within the window, so one contiguous sort here
+      // replaces the per-object heap pops of the old priority_queue
+      out_set.objects = std::move(m_windows.front());
+      m_windows.pop_front();
+      m_n_buffered -= out_set.objects.size();
+      std::sort(out_set.objects.begin(), out_set.objects.end(), [](const T& a, const T& b) {
+        return a.time_start < b.time_start;
+      });
     }
-    TLOG_DEBUG(TLVL_DEBUG_MEDIUM) << "[TimeSliceOutputBuffer] Filled payload from " << out_set.start_time << " to " << out_set.end_time << " with " << out_set.objects.size() << " objects";
+    TRIGGER_TLOG_DEBUG(TLVL_DEBUG_MEDIUM) << "[TimeSliceOutputBuffer] Filled payload from " << out_set.start_time << " to " << out_set.end_time << " with " << out_set.objects.size() << " objects";
   }
 
 private:
-  std::priority_queue<T, std::vector<T>, time_start_greater_t<T>> m_buffer;
+  void report_suppressed()
+  {
+    if (uint64_t n = m_tardy_throttle.take_suppressed()) { // NOLINT(build/unsigned)
+      ers::warning(IssuesSuppressed(ERS_HERE, m_name, "TardyOutputError", n));
+    }
+  }
+
+  // Ring of per-window buckets: m_windows[i] holds the objects whose
+  // time_start falls in [m_next_window_start + i*m_window_time,
+  // m_next_window_start + (i+1)*m_window_time)
+  std::deque<std::vector<T>> m_windows;
+  size_t m_n_buffered = 0; // total objects across m_windows
   std::priority_queue<Set<T>, std::vector<Set<T>>, start_time_greater_t<Set<T>>> m_heartbeat_buffer;
   const std::string &m_name, &m_algorithm;
   daqdataformats::timestamp_t m_next_window_start; // tick start of next window, or 0 if not yet known
   daqdataformats::timestamp_t m_buffer_time;       // ticks to buffer after a window before a window is valid
   daqdataformats::timestamp_t m_window_time;       // width of output windows in ticks
   daqdataformats::timestamp_t m_largest_time;      // larges observed timestamp
+  daqdataformats::timestamp_t m_watermark = 0;     // largest heartbeat time: no input earlier than this will arrive
+  IssueThrottler m_tardy_throttle;                 // rate limit on TardyOutputError emission
+  uint64_t m_tardy_count = 0;                      // raw tardy drops, throttled or not // NOLINT(build/unsigned)
 };
 
 } // namespace dunedaq::trigger
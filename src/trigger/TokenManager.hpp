@@ -15,10 +15,10 @@
 #include "dfmessages/Types.hpp"
 #include "iomanager/Receiver.hpp"
 
+#include <array>
 #include <atomic>
 #include <chrono>
 #include <memory>
-#include <set>
 #include <string>
 #include <thread>
 
@@ -71,6 +71,12 @@ public:
    */
   void trigger_sent(dfmessages::trigger_number_t);
 
+  /**
+   * Instantaneous number of in-flight trigger decisions. Reads a single
+   * atomic, so it is cheap enough to export as an opmon gauge
+   */
+  int get_n_open_decisions() const { return m_n_open_decisions.load(std::memory_order_relaxed); }
+
 private:
   // The main thread
   void receive_token(dfmessages::TriggerDecisionToken& token);
@@ -82,9 +88,14 @@ private:
   // How many tokens are currently available?
   std::atomic<int> m_n_tokens;
 
-  // The currently-in-flight trigger decisions, and a mutex to guard it
-  std::set<dfmessages::trigger_number_t> m_open_trigger_decisions;
-  std::mutex m_open_trigger_decisions_mutex;
+  // The currently-in-flight trigger decisions, held in a fixed-size
+  // open-addressed table of atomic slots keyed by trigger number. The
+  // decision thread inserts in trigger_sent and the token callback erases in
+  // receive_token, so the two threads never take a lock at trigger rate;
+  // empty slots hold s_invalid_trigger_number
+  static constexpr size_t s_open_decision_slots = 1024;
+  std::array<std::atomic<dfmessages::trigger_number_t>, s_open_decision_slots> m_open_trigger_decisions;
+  std::atomic<int> m_n_open_decisions{ 0 };
 
   daqdataformats::run_number_t m_run_number;
   std::shared_ptr<LivetimeCounter> m_livetime_counter;
@@ -9,9 +9,18 @@
 #ifndef TRIGGER_SRC_TRIGGER_TRIGGERGENERICMAKER_HPP_
 #define TRIGGER_SRC_TRIGGER_TRIGGERGENERICMAKER_HPP_
 
+#include "trigger/AdaptiveReceiver.hpp"
 #include "trigger/Issues.hpp"
+#include "trigger/IssueThrottler.hpp"
+#include "trigger/LatencyHistogram.hpp"
 #include "trigger/Logging.hpp"
+#include "trigger/MetricSnapshot.hpp"
+#include "trigger/QueueSpy.hpp"
+#include "trigger/WorkerLiveness.hpp"
+#include "trigger/SequenceTracker.hpp"
 #include "trigger/Set.hpp"
+#include "trigger/TaskPool.hpp"
+#include "trigger/ThreadPlacement.hpp"
 #include "trigger/TimeSliceInputBuffer.hpp"
 #include "trigger/TimeSliceOutputBuffer.hpp"
 #include "trigger/triggergenericmakerinfo/InfoNljs.hpp"
@@ -28,8 +37,17 @@
 #include "utilities/WorkerThread.hpp"
 
 #include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <iterator>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 using dunedaq::trigger::logging::TLVL_DEBUG_MEDIUM;
@@ -41,6 +59,24 @@ namespace dunedaq::trigger {
 template<class IN, class OUT, class MAKER>
 class TriggerGenericWorker;
 
+// Detects whether a payload type carries a channel member, which is what the
+// sharded processing mode in TriggerGenericWorker partitions on
+template<class T, class = void>
+struct has_channel : std::false_type
+{};
+template<class T>
+struct has_channel<T, std::void_t<decltype(std::declval<T>().channel)>> : std::true_type
+{};
+
+// Detects whether an input type is a Set<T>, i.e. carries an origin and a
+// per-origin seqno that the receive path can check for continuity
+template<class T>
+struct is_set : std::false_type
+{};
+template<class T>
+struct is_set<Set<T>> : std::true_type
+{};
+
 // This template class reads IN items from queues, passes them to MAKER objects,
 // and writes the resulting OUT objects to another queue. The behavior of
 // passing IN objects to the MAKER and creating OUT objects from the MAKER is
@@ -65,6 +101,8 @@ public:
     , m_sourceid(dunedaq::daqdataformats::SourceID::s_invalid_id)
     , m_buffer_time(0)
     , m_window_time(625000)
+    , m_n_worker_shards(1)
+    , m_pipeline_depth(0)
     , worker(*this) // should be last; may use other members
   {
     register_command("start", &TriggerGenericMaker::do_start);
@@ -83,17 +121,18 @@ public:
   {
     m_input_queue = get_iom_receiver<IN>(appfwk::connection_uid(obj, "input"));
     m_output_queue = get_iom_sender<OUT>(appfwk::connection_uid(obj, "output"));
+    m_input_policy = std::make_unique<AdaptiveReceiver<IN>>(m_input_queue, m_queue_timeout);
+    m_input_spy = QueueSpy::get_instance().register_queue(appfwk::connection_uid(obj, "input"));
+    m_output_spy = QueueSpy::get_instance().register_queue(appfwk::connection_uid(obj, "output"));
+    m_liveness = WorkerLiveness::get_instance().register_worker(get_name());
   }
 
   void get_info(opmonlib::InfoCollector& ci, int /*level*/) override
   {
+    // Report the snapshot the worker thread last published, so the opmon
+    // poll never reads worker-owned counters or histograms directly
     triggergenericmakerinfo::Info i;
-
-    i.received_count = m_received_count.load();
-    i.sent_count = m_sent_count.load();
-    if (m_maker) { i.data_vs_system_ms = m_maker->m_data_vs_system_time; }
-    else i.data_vs_system_ms = 0;    
-
+    m_info_snapshot.read(i);
     ci.add(i);
   }
   
@@ -113,6 +152,35 @@ protected:
     m_buffer_time = buffer_time;
   }
 
+  // Only applies to makers whose input payload type has a channel member
+  // (i.e. TPs): process each time slice across this many channel-sharded
+  // MAKER instances, each driven by its own thread. The MAKER algorithm must
+  // not require seeing the full channel range to be used with n_shards > 1
+  void set_worker_shards(size_t n_shards) { m_n_worker_shards = n_shards == 0 ? 1 : n_shards; }
+
+  // Only applies to makers that input and output Sets: process up to `depth`
+  // consecutive time slices concurrently, each on its own MAKER instance,
+  // with outputs re-sequenced into submission order before windowing. Only
+  // safe for MAKER algorithms that are stateless across slices. Ignored when
+  // channel sharding is enabled
+  void set_pipeline_depth(size_t depth) { m_pipeline_depth = depth; }
+
+  // Run this module's work loop as a cooperative task on the process-wide
+  // TaskPool instead of a dedicated WorkerThread, so a host full of mostly
+  // idle makers pays a thread count proportional to cores, not modules
+  void set_shared_work_pool(bool use_pool) { m_use_shared_pool = use_pool; }
+
+  // Pin every thread this module starts (the work loop plus any shard or
+  // pipeline threads) to the given logical CPUs and prefer the given NUMA
+  // node for their allocations. Empty set / node -1 leave the scheduler in
+  // charge. Not applied in shared-pool mode, where the threads are shared
+  // property of the process
+  void set_thread_placement(const std::vector<uint16_t>& cpus, int32_t numa_node) // NOLINT(build/unsigned)
+  {
+    m_cpu_affinity = cpus;
+    m_numa_node = numa_node;
+  }
+
 private:
   dunedaq::utilities::WorkerThread m_thread;
 
@@ -121,14 +189,81 @@ private:
   std::atomic<metric_counter_type> m_sent_count;
   dfmessages::run_number_t m_run_number;
 
+  // Per-stage latency histograms, written by the worker thread and read by
+  // the opmon thread (see LatencyHistogram for the threading contract).
+  // m_maker_hist only covers the serial processing path: in sharded or
+  // pipelined mode the algorithm runs on several threads at once
+  LatencyHistogram m_maker_hist;
+  LatencyHistogram m_send_hist;
+  LatencyHistogram m_process_hist;
+
+  // Per-origin seqno continuity over the input stream(s), so transport
+  // loss between apps is quantified rather than inferred from missing
+  // coverage offline. Only engaged when IN is a Set type
+  SequenceTracker m_seq_tracker;
+
+  // Latest complete Info record, published by the worker thread on its
+  // own cadence and copied out by get_info() on the opmon thread
+  MetricSnapshot<triggergenericmakerinfo::Info> m_info_snapshot;
+  static constexpr std::chrono::milliseconds s_snapshot_interval{ 100 };
+  std::chrono::steady_clock::time_point m_last_snapshot_time;
+
+  // Assemble and publish an Info snapshot; worker thread only
+  void publish_info()
+  {
+    triggergenericmakerinfo::Info i;
+
+    i.received_count = m_received_count.load();
+    i.sent_count = m_sent_count.load();
+    if (m_maker) { i.data_vs_system_ms = m_maker->m_data_vs_system_time; }
+    else i.data_vs_system_ms = 0;
+
+    i.maker_time_p50_us = m_maker_hist.quantile(0.5);
+    i.maker_time_p99_us = m_maker_hist.quantile(0.99);
+    i.send_time_p50_us = m_send_hist.quantile(0.5);
+    i.send_time_p99_us = m_send_hist.quantile(0.99);
+    i.process_time_p50_us = m_process_hist.quantile(0.5);
+    i.process_time_p99_us = m_process_hist.quantile(0.99);
+
+    i.seqno_gap_count = m_seq_tracker.gap_count();
+    i.seqno_duplicate_count = m_seq_tracker.duplicate_count();
+    i.seqno_reorder_count = m_seq_tracker.reorder_count();
+
+    i.out_of_order_set_count = worker.get_out_of_order_count();
+    i.tardy_output_count = worker.get_tardy_output_count();
+
+    m_info_snapshot.publish(i);
+  }
+
+  // Publish at most every s_snapshot_interval, from the do_work loop
+  void maybe_publish_info()
+  {
+    auto now = std::chrono::steady_clock::now();
+    if (now - m_last_snapshot_time >= s_snapshot_interval) {
+      m_last_snapshot_time = now;
+      publish_info();
+    }
+  }
+
   using source_t = dunedaq::iomanager::ReceiverConcept<IN>;
   std::shared_ptr<source_t> m_input_queue;
+  std::unique_ptr<AdaptiveReceiver<IN>> m_input_policy;
 
   using sink_t = dunedaq::iomanager::SenderConcept<OUT>;
   std::shared_ptr<sink_t> m_output_queue;
 
   std::chrono::milliseconds m_queue_timeout;
 
+  // Backpressure probes (see QueueSpy): each drained input batch is a
+  // depth sample, each send reports how long it blocked
+  QueueSpy::handle_t m_input_spy = 0;
+  QueueSpy::handle_t m_output_spy = 0;
+
+  // Liveness probe (see WorkerLiveness): the work loop pulses it every
+  // pass and labels the stage it is entering, so the StallWatchdog can
+  // tell a wedged algorithm from an idle stream
+  WorkerLiveness::handle_t m_liveness = 0;
+
   std::string m_algorithm_name;
 
   uint32_t m_sourceid; // NOLINT(build/unsigned)
@@ -137,8 +272,32 @@ private:
   daqdataformats::timestamp_t m_window_time;
 
   std::unique_ptr<MAKER> m_maker;
+  // Standby instance for the next run, constructed outside the start
+  // transition (at conf time and again after each stop)
+  std::unique_ptr<MAKER> m_prepared_maker;
   nlohmann::json m_maker_conf;
-  
+  size_t m_n_worker_shards;
+  size_t m_pipeline_depth;
+
+  // Placement applied at the top of every thread this module starts (see
+  // set_thread_placement). Worker code calls apply_thread_placement() as
+  // the first thing on a fresh thread, before any buffers are populated
+  std::vector<uint16_t> m_cpu_affinity; // NOLINT(build/unsigned)
+  int32_t m_numa_node = -1;
+
+  void apply_thread_placement()
+  {
+    thread_placement::pin_current_thread(m_cpu_affinity, get_name());
+    thread_placement::prefer_numa_node(m_numa_node, get_name());
+  }
+
+  // Shared-pool execution mode state (see set_shared_work_pool)
+  bool m_use_shared_pool = false;
+  TaskPool::task_id_t m_pool_task_id = 0;
+  // Reused batch for do_work_step, so the pooled path has the same
+  // steady-state allocation behaviour as the dedicated-thread loop
+  std::vector<IN> m_task_batch;
+
   TriggerGenericWorker<IN, OUT, MAKER> worker;
 
   // This should return a unique_ptr to the MAKER created from conf command arguments.
@@ -149,43 +308,116 @@ private:
   {
     m_received_count = 0;
     m_sent_count = 0;
-    m_maker = make_maker(m_maker_conf);
+    m_maker_hist.reset();
+    m_send_hist.reset();
+    m_process_hist.reset();
+    m_seq_tracker.reset();
+    // Swap in the instance primed at conf time (or after the previous
+    // stop), so algorithm construction - which for some makers means
+    // allocating large channel-indexed buffers - stays out of the start
+    // transition. Fall back to constructing here if nothing is primed
+    if (m_prepared_maker) {
+      m_maker = std::move(m_prepared_maker);
+    } else {
+      m_maker = make_maker(m_maker_conf);
+    }
     worker.reconfigure();
-    m_thread.start_working_thread(get_name());
     m_run_number = startobj.value<dunedaq::daqdataformats::run_number_t>("run", 0);
+    if (m_use_shared_pool) {
+      m_pool_task_id = TaskPool::get_instance().add_task(get_name(), [this] { return do_work_step(); });
+    } else {
+      m_thread.start_working_thread(get_name());
+    }
+    WorkerLiveness::get_instance().set_active(m_liveness, true);
   }
 
   void do_stop(const nlohmann::json& /*obj*/)
   {
-    m_thread.stop_working_thread();
+    if (m_use_shared_pool) {
+      // Deregistration waits for any in-progress step, after which this
+      // thread owns the worker and can run the same drain sequence the
+      // dedicated-thread path runs at the end of do_work
+      TaskPool::get_instance().remove_task(m_pool_task_id);
+      finish_run();
+    } else {
+      m_thread.stop_working_thread();
+    }
+    WorkerLiveness::get_instance().set_active(m_liveness, false);
+    // Prime a fresh instance for the next run now, during inter-run dead
+    // time we're already paying, rather than in the next start
+    m_prepared_maker = make_maker(m_maker_conf);
   }
 
   void do_configure(const nlohmann::json& obj)
   {
     // P. Rodrigues 2022-07-13
-    // We stash the config here and don't actually create the maker
-    // algorithm until start time, so that the algorithm doesn't
-    // persist between runs and hold onto its state from the previous
-    // run
+    // We stash the config here and the running maker is still always a
+    // fresh instance per run, so the algorithm doesn't persist between
+    // runs and hold onto its state from the previous run. The instance
+    // for the *next* run is constructed eagerly into the standby slot
     m_maker_conf = obj;
-   
+    m_prepared_maker = make_maker(m_maker_conf);
+
     // worker should be notified that configuration potentially changed
     worker.reconfigure();
   }
 
   void do_work(std::atomic<bool>& m_running_flag)
   {
+    apply_thread_placement();
+    // Reused across iterations so the batch's heap allocation is only paid
+    // until the vector reaches its steady-state capacity
+    std::vector<IN> batch;
+    WorkerLiveness& liveness = WorkerLiveness::get_instance();
     // Loop until a stop is received
     while (m_running_flag.load()) {
+      // Every pass pulses the liveness counter - including empty ones, so
+      // an idle input stream never looks like a stall
+      liveness.pulse(m_liveness);
+      liveness.set_stage(m_liveness, "receive");
       // While there are items in the input queue, continue draining even if
       // the running_flag is false, but stop _immediately_ when input is empty
-      IN in;
-      while (receive(in)) {
+      while (receive_batch(batch)) {
         if (m_running_flag.load()) {
-	  worker.process(in); 
-	}
+          liveness.set_stage(m_liveness, "process");
+          ScopedLatencyTimer timer(m_process_hist);
+          worker.process_batch(batch);
+        }
+        maybe_publish_info();
+        liveness.pulse(m_liveness);
+        liveness.set_stage(m_liveness, "receive");
       }
+      maybe_publish_info();
     }
+    liveness.set_stage(m_liveness, "finish_run");
+    finish_run();
+  }
+
+  // One cooperative unit of work for the shared TaskPool: process at most
+  // one batch, never blocking on an empty queue (the pool's backoff covers
+  // the idle case), and report whether anything was found
+  bool do_work_step()
+  {
+    WorkerLiveness& liveness = WorkerLiveness::get_instance();
+    liveness.pulse(m_liveness);
+    if (!receive_batch_nonblocking(m_task_batch)) {
+      maybe_publish_info();
+      return false;
+    }
+    {
+      liveness.set_stage(m_liveness, "process");
+      ScopedLatencyTimer timer(m_process_hist);
+      worker.process_batch(m_task_batch);
+    }
+    liveness.set_stage(m_liveness, "receive");
+    maybe_publish_info();
+    return true;
+  }
+
+  // End-of-run drain and bookkeeping, shared by the dedicated-thread and
+  // pooled execution paths
+  void finish_run()
+  {
     // P. Rodrigues 2022-06-01. The argument here is whether to drop
     // buffered outputs. We choose 'true' because some significant
     // time can pass between the last input sent by readout and when
@@ -195,6 +427,8 @@ private:
     // outputs are stale and will cause tardy warnings from the zipper
     // downstream
     worker.drain(true);
+    // Final snapshot so the end-of-run totals are what opmon reports
+    publish_info();
     TLOG() << "[TGM] " << get_name() << ": Exiting do_work() method for run " << m_run_number << ", received " << m_received_count
            << " inputs (" << worker.get_low_level_input_count() << " sub-inputs) and successfully sent " << m_sent_count
            << " outputs. ";
@@ -203,23 +437,97 @@ private:
 
   bool receive(IN& in)
   {
-    try {
-      in = m_input_queue->receive(m_queue_timeout);
-    } catch (const dunedaq::iomanager::TimeoutExpired& excpt) {
-      // it is perfectly reasonable that there might be no data in the queue
-      // some fraction of the times that we check, so we just continue on and try again
+    // it is perfectly reasonable that there might be no data in the queue
+    // some fraction of the times that we check, so we just continue on and
+    // try again. The adaptive policy spins briefly when traffic is hot and
+    // parks on the queue otherwise, with no exception on the empty-queue path
+    std::optional<IN> item = m_input_policy->receive();
+    if (!item.has_value()) {
       return false;
     }
+    in = std::move(*item);
+    if constexpr (is_set<IN>::value) {
+      m_seq_tracker.observe(in.origin, in.seqno);
+    }
     ++m_received_count;
     return true;
   }
 
+  // Fill `batch` with everything currently waiting on the input queue, paying
+  // the blocking receive (timeout setup, exception machinery) only once per
+  // batch. The first item is obtained with the usual timeout; any items
+  // already queued behind it are drained without blocking. Returns whether
+  // anything was received.
+  bool receive_batch(std::vector<IN>& batch)
+  {
+    batch.clear();
+    IN in;
+    if (!receive(in)) {
+      QueueSpy::get_instance().record_drain(m_input_spy, 0, false);
+      return false;
+    }
+    batch.push_back(std::move(in));
+    while (batch.size() < s_max_batch_size) {
+      std::optional<IN> maybe_in = m_input_policy->try_receive();
+      if (!maybe_in.has_value()) {
+        break;
+      }
+      if constexpr (is_set<IN>::value) {
+        m_seq_tracker.observe(maybe_in->origin, maybe_in->seqno);
+      }
+      ++m_received_count;
+      batch.push_back(std::move(*maybe_in));
+    }
+    QueueSpy::get_instance().record_drain(m_input_spy, batch.size(), batch.size() == s_max_batch_size);
+    return true;
+  }
+
+  // Like receive_batch, but the first item is also tried without blocking:
+  // a pooled task must hand its thread back instead of parking on the queue
+  bool receive_batch_nonblocking(std::vector<IN>& batch)
+  {
+    batch.clear();
+    while (batch.size() < s_max_batch_size) {
+      std::optional<IN> maybe_in = m_input_policy->try_receive();
+      if (!maybe_in.has_value()) {
+        break;
+      }
+      if constexpr (is_set<IN>::value) {
+        m_seq_tracker.observe(maybe_in->origin, maybe_in->seqno);
+      }
+      ++m_received_count;
+      batch.push_back(std::move(*maybe_in));
+    }
+    // Empty sweeps are not recorded: at the pool's sweep rate they would
+    // drown the depth distribution in zeros
+    if (!batch.empty()) {
+      QueueSpy::get_instance().record_drain(m_input_spy, batch.size(), batch.size() == s_max_batch_size);
+    }
+    return !batch.empty();
+  }
+
+  // Cap on the batch size, so a persistently-full input queue can't delay
+  // output emission (and stop response) arbitrarily long
+  static constexpr size_t s_max_batch_size = 64;
+
   bool send(OUT&& out)
   {
+    WorkerLiveness::get_instance().set_stage(m_liveness, "send");
+    auto send_start = std::chrono::steady_clock::now();
+    bool ok = true;
     try {
       m_output_queue->send(std::move(out), m_queue_timeout);
     } catch (const dunedaq::iomanager::TimeoutExpired& excpt) {
       ers::warning(excpt);
+      ok = false;
+    }
+    // One clock pair serves both the module's own histogram and the
+    // process-wide backpressure probe
+    auto wait_us = static_cast<uint64_t>( // NOLINT(build/unsigned)
+      std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - send_start).count());
+    m_send_hist.record_value(wait_us);
+    QueueSpy::get_instance().record_send_wait(m_output_spy, wait_us);
+    if (!ok) {
       return false;
     }
     ++m_sent_count;
@@ -251,11 +559,17 @@ public:
     m_low_level_input_count = 0;
   }
 
+  // Scratch for process(), reused across calls so the per-input allocation
+  // disappears once it reaches steady-state capacity
+  std::vector<OUT> m_out_vec;
+
   void process(IN& in)
   {
     ++m_low_level_input_count;
-    std::vector<OUT> out_vec; // one input -> many outputs
+    std::vector<OUT>& out_vec = m_out_vec; // one input -> many outputs
+    out_vec.clear();
     try {
+      ScopedLatencyTimer timer(m_parent.m_maker_hist);
       m_parent.m_maker->operator()(in, out_vec);
     } catch (...) { // NOLINT TODO Benjamin Land <BenLand100@github.com> May 28-2021 can we restrict the possible
                     // exceptions triggeralgs might raise?
@@ -272,10 +586,19 @@ public:
     }
   }
 
+  void process_batch(std::vector<IN>& batch)
+  {
+    for (IN& in : batch) {
+      process(in);
+    }
+  }
+
   void drain(bool) {}
 
   size_t get_low_level_input_count() {return m_low_level_input_count;}
   size_t m_low_level_input_count;
+  uint64_t get_out_of_order_count() { return 0; } // NOLINT(build/unsigned)
+  uint64_t get_tardy_output_count() { return 0; } // NOLINT(build/unsigned)
 };
 
 // Partial specialization for IN = Set<A>, OUT = Set<B> and assumes the MAKER has:
@@ -291,17 +614,244 @@ public: // NOLINT
     , m_low_level_input_count(0)
   {}
 
+  ~TriggerGenericWorker()
+  {
+    stop_shard_threads();
+    stop_pipeline_threads();
+  }
+
+  TriggerGenericWorker(const TriggerGenericWorker&) = delete;
+  TriggerGenericWorker& operator=(const TriggerGenericWorker&) = delete;
+  TriggerGenericWorker(TriggerGenericWorker&&) = delete;
+  TriggerGenericWorker& operator=(TriggerGenericWorker&&) = delete;
+
   TriggerGenericMaker<Set<A>, Set<B>, MAKER>& m_parent;
 
   TimeSliceInputBuffer<A> m_in_buffer;
   TimeSliceOutputBuffer<B> m_out_buffer;
 
+  // Reused across process() calls, so slice assembly stops allocating once it
+  // reaches its steady-state capacity
+  std::vector<A> m_time_slice;
+
   daqdataformats::timestamp_t m_prev_start_time = 0;
 
+  // State for the sharded processing mode (set_worker_shards). Each shard
+  // owns a MAKER instance plus scratch input/output vectors, reused across
+  // slices. Shard threads park on m_shard_go_cv between slices and report
+  // completion through m_shards_pending / m_shard_done_cv
+  struct Shard
+  {
+    std::unique_ptr<MAKER> maker;
+    std::vector<A> slice;
+    std::vector<B> out;
+    std::thread thread;
+  };
+  std::vector<Shard> m_shards;
+  std::mutex m_shard_mutex;
+  std::condition_variable m_shard_go_cv;
+  std::condition_variable m_shard_done_cv;
+  uint64_t m_shard_generation = 0; // NOLINT(build/unsigned)
+  size_t m_shards_pending = 0;
+  bool m_shard_shutdown = false;
+
+  void start_shard_threads()
+  {
+    m_shard_shutdown = false;
+    m_shards = std::vector<Shard>(m_parent.m_n_worker_shards);
+    for (size_t i = 0; i < m_shards.size(); ++i) {
+      m_shards[i].maker = m_parent.make_maker(m_parent.m_maker_conf);
+      if (i > 0) { // shard 0 runs on the worker thread itself
+        m_shards[i].thread = std::thread([this, i]() { shard_thread_loop(i); });
+      }
+    }
+  }
+
+  void stop_shard_threads()
+  {
+    {
+      std::unique_lock<std::mutex> lock(m_shard_mutex);
+      m_shard_shutdown = true;
+    }
+    m_shard_go_cv.notify_all();
+    for (Shard& s : m_shards) {
+      if (s.thread.joinable()) {
+        s.thread.join();
+      }
+    }
+    m_shards.clear();
+  }
+
+  void shard_thread_loop(size_t i)
+  {
+    m_parent.apply_thread_placement();
+    uint64_t seen_generation = m_shard_generation; // NOLINT(build/unsigned)
+    while (true) {
+      {
+        std::unique_lock<std::mutex> lock(m_shard_mutex);
+        m_shard_go_cv.wait(lock, [&]() { return m_shard_shutdown || m_shard_generation != seen_generation; });
+        if (m_shard_shutdown) {
+          return;
+        }
+        seen_generation = m_shard_generation;
+      }
+      run_shard(m_shards[i]);
+      {
+        std::unique_lock<std::mutex> lock(m_shard_mutex);
+        --m_shards_pending;
+      }
+      m_shard_done_cv.notify_one();
+    }
+  }
+
+  void run_shard(Shard& shard)
+  {
+    for (const A& x : shard.slice) {
+      try {
+        shard.maker->operator()(x, shard.out);
+      } catch (...) { // NOLINT same rationale as process_slice
+        ers::fatal(AlgorithmFatalError(ERS_HERE, m_parent.get_name(), m_parent.m_algorithm_name));
+        return;
+      }
+    }
+  }
+
+  // State for the window-pipelined mode (set_pipeline_depth). Complete time
+  // slices are queued as jobs, claimed by the pipeline threads (one MAKER
+  // instance per thread), and their outputs collected strictly in submission
+  // order by pipeline_collect(), so downstream sees the same sequence as the
+  // serial path
+  struct PipelineJob
+  {
+    std::vector<A> slice;
+    std::vector<B> out;
+    bool claimed = false;
+    bool done = false;
+  };
+  std::deque<PipelineJob> m_pipeline_jobs; // oldest job first
+  std::vector<std::thread> m_pipeline_threads;
+  std::vector<std::unique_ptr<MAKER>> m_pipeline_makers;
+  std::mutex m_pipeline_mutex;
+  std::condition_variable m_pipeline_work_cv;
+  std::condition_variable m_pipeline_done_cv;
+  bool m_pipeline_shutdown = false;
+
+  void start_pipeline_threads()
+  {
+    m_pipeline_shutdown = false;
+    for (size_t i = 0; i < m_parent.m_pipeline_depth; ++i) {
+      m_pipeline_makers.push_back(m_parent.make_maker(m_parent.m_maker_conf));
+      m_pipeline_threads.emplace_back([this, i]() { pipeline_thread_loop(i); });
+    }
+  }
+
+  void stop_pipeline_threads()
+  {
+    {
+      std::unique_lock<std::mutex> lock(m_pipeline_mutex);
+      m_pipeline_shutdown = true;
+    }
+    m_pipeline_work_cv.notify_all();
+    for (std::thread& t : m_pipeline_threads) {
+      if (t.joinable()) {
+        t.join();
+      }
+    }
+    m_pipeline_threads.clear();
+    m_pipeline_makers.clear();
+    m_pipeline_jobs.clear();
+  }
+
+  void pipeline_thread_loop(size_t i)
+  {
+    m_parent.apply_thread_placement();
+    MAKER& maker = *m_pipeline_makers[i];
+    while (true) {
+      PipelineJob* job = nullptr;
+      {
+        std::unique_lock<std::mutex> lock(m_pipeline_mutex);
+        m_pipeline_work_cv.wait(lock, [&]() {
+          if (m_pipeline_shutdown) {
+            return true;
+          }
+          for (PipelineJob& j : m_pipeline_jobs) {
+            if (!j.claimed) {
+              job = &j;
+              return true;
+            }
+          }
+          return false;
+        });
+        if (m_pipeline_shutdown) {
+          return;
+        }
+        // the deque only has done jobs popped from the front, which never
+        // invalidates the reference to this (not-done) job
+        job->claimed = true;
+      }
+      for (const A& x : job->slice) {
+        try {
+          maker.operator()(x, job->out);
+        } catch (...) { // NOLINT same rationale as process_slice
+          ers::fatal(AlgorithmFatalError(ERS_HERE, m_parent.get_name(), m_parent.m_algorithm_name));
+          break;
+        }
+      }
+      {
+        std::unique_lock<std::mutex> lock(m_pipeline_mutex);
+        job->done = true;
+      }
+      m_pipeline_done_cv.notify_one();
+    }
+  }
+
+  // Queue a complete slice for the pipeline threads, blocking first if
+  // m_pipeline_depth slices are already in flight
+  void pipeline_submit(std::vector<A>&& slice)
+  {
+    {
+      std::unique_lock<std::mutex> lock(m_pipeline_mutex);
+      m_pipeline_done_cv.wait(lock, [this]() {
+        return m_pipeline_jobs.size() < m_parent.m_pipeline_depth || m_pipeline_jobs.front().done;
+      });
+      m_pipeline_jobs.emplace_back();
+      m_pipeline_jobs.back().slice = std::move(slice);
+    }
+    m_pipeline_work_cv.notify_one();
+  }
+
+  // Append the outputs of completed slices to out_vec, strictly in
+  // submission order. If block is set, wait for every in-flight slice
+  void pipeline_collect(bool block, std::vector<B>& out_vec)
+  {
+    std::unique_lock<std::mutex> lock(m_pipeline_mutex);
+    while (!m_pipeline_jobs.empty()) {
+      if (!m_pipeline_jobs.front().done) {
+        if (!block) {
+          break;
+        }
+        m_pipeline_done_cv.wait(lock, [this]() { return m_pipeline_jobs.front().done; });
+      }
+      PipelineJob& front = m_pipeline_jobs.front();
+      out_vec.insert(out_vec.end(), std::make_move_iterator(front.out.begin()), std::make_move_iterator(front.out.end()));
+      m_pipeline_jobs.pop_front();
+    }
+  }
+
   void reconfigure()
   {
     m_out_buffer.set_window_time(m_parent.m_window_time);
     m_out_buffer.set_buffer_time(m_parent.m_buffer_time);
+    if constexpr (has_channel<A>::value) {
+      stop_shard_threads();
+      if (m_parent.m_n_worker_shards > 1 && !m_parent.m_maker_conf.is_null()) {
+        start_shard_threads();
+      }
+    }
+    stop_pipeline_threads();
+    if (m_parent.m_pipeline_depth > 0 && m_parent.m_n_worker_shards <= 1 && !m_parent.m_maker_conf.is_null()) {
+      start_pipeline_threads();
+    }
   }
 
   void reset()
@@ -309,12 +859,23 @@ public: // NOLINT
     m_prev_start_time = 0;
     m_out_buffer.reset();
     m_low_level_input_count = 0;
+    m_out_of_order_count = 0;
+    m_ooo_throttle.reset();
+    stop_shard_threads();
+    stop_pipeline_threads();
   }
 
   void process_slice(const std::vector<A>& time_slice, std::vector<B>& out_vec)
   {
+    if constexpr (has_channel<A>::value) {
+      if (!m_shards.empty()) {
+        process_slice_sharded(time_slice, out_vec);
+        return;
+      }
+    }
     // time_slice is a full slice (all Set<A> combined), time ordered, vector of A
     // call operator for each of the objects in the vector
+    ScopedLatencyTimer timer(m_parent.m_maker_hist);
     for (const A& x : time_slice) {
       try {
         m_parent.m_maker->operator()(x, out_vec);
@@ -326,22 +887,71 @@ public: // NOLINT
     }
   }
 
+  // Fan a time slice out across the channel-sharded MAKER instances: each
+  // shard sees the (time-ordered) subsequence of the slice for its channels,
+  // shards 1..N-1 run on their own threads while shard 0 runs here, and the
+  // per-shard outputs are re-merged into out_vec for the output buffer
+  void process_slice_sharded(const std::vector<A>& time_slice, std::vector<B>& out_vec)
+  {
+    const size_t n_shards = m_shards.size();
+    for (Shard& s : m_shards) {
+      s.slice.clear();
+      s.out.clear();
+    }
+    for (const A& x : time_slice) {
+      m_shards[x.channel % n_shards].slice.push_back(x);
+    }
+    {
+      std::unique_lock<std::mutex> lock(m_shard_mutex);
+      ++m_shard_generation;
+      m_shards_pending = n_shards - 1;
+    }
+    m_shard_go_cv.notify_all();
+    run_shard(m_shards[0]);
+    {
+      std::unique_lock<std::mutex> lock(m_shard_mutex);
+      m_shard_done_cv.wait(lock, [this]() { return m_shards_pending == 0; });
+    }
+    for (Shard& s : m_shards) {
+      out_vec.insert(out_vec.end(), std::make_move_iterator(s.out.begin()), std::make_move_iterator(s.out.end()));
+    }
+    // restore time order across shards before the outputs are windowed
+    std::sort(out_vec.begin(), out_vec.end(), [](const B& a, const B& b) { return a.time_start < b.time_start; });
+  }
+
+  // Scratch for process() and drain(), reused across calls so the per-set
+  // allocation disappears once it reaches steady-state capacity
+  std::vector<B> m_elems;
+
   void process(Set<A>& in)
   {
-    std::vector<B> elems; // Bs to buffer for the next window
+    std::vector<B>& elems = m_elems; // Bs to buffer for the next window
+    elems.clear();
     switch (in.type) {
       case Set<A>::Type::kPayload: {
         if (m_prev_start_time != 0 && in.start_time < m_prev_start_time) {
-          ers::warning(OutOfOrderSets(ERS_HERE, m_parent.get_name(), m_prev_start_time, in.start_time));
+          // A misbehaving upstream reorders every set, not just one, so the
+          // warning is rate limited; the raw count goes out through opmon
+          ++m_out_of_order_count;
+          if (m_ooo_throttle.allow()) {
+            ers::warning(OutOfOrderSets(ERS_HERE, m_parent.get_name(), m_prev_start_time, in.start_time));
+            if (uint64_t n = m_ooo_throttle.take_suppressed()) { // NOLINT(build/unsigned)
+              ers::warning(IssuesSuppressed(ERS_HERE, m_parent.get_name(), "OutOfOrderSets", n));
+            }
+          }
         }
         m_prev_start_time = in.start_time;
-        std::vector<A> time_slice;
+        m_time_slice.clear();
         daqdataformats::timestamp_t start_time, end_time;
-        if (!m_in_buffer.buffer(in, time_slice, start_time, end_time)) {
+        if (!m_in_buffer.buffer(std::move(in), m_time_slice, start_time, end_time)) {
           return; // no complete time slice yet (`in` was part of buffered slice)
         }
-        m_low_level_input_count += time_slice.size();
-        process_slice(time_slice, elems);
+        m_low_level_input_count += m_time_slice.size();
+        if (!m_pipeline_threads.empty()) {
+          pipeline_submit(std::move(m_time_slice));
+        } else {
+          process_slice(m_time_slice, elems);
+        }
       } break;
       case Set<A>::Type::kHeartbeat: {
         // PAR 2022-04-27 We've got a heartbeat for time T, so we know
@@ -351,15 +961,21 @@ public: // NOLINT
         // heartbeat in the output buffer, which will handle it
         // appropriately
 
-        std::vector<A> time_slice;
+        // The slice flushed below is younger than anything in flight in the
+        // pipeline, so collect all of those outputs first to keep order
+        if (!m_pipeline_threads.empty()) {
+          pipeline_collect(true, elems);
+        }
+
+        m_time_slice.clear();
         daqdataformats::timestamp_t start_time, end_time;
-        if (m_in_buffer.flush(time_slice, start_time, end_time)) {
+        if (m_in_buffer.flush(m_time_slice, start_time, end_time)) {
           if (end_time > in.start_time) {
             // This should never happen, but we check here so we at least get some output if it did
             ers::fatal(OutOfOrderSets(ERS_HERE, m_parent.get_name(), end_time, in.start_time));
           }
-          m_low_level_input_count += time_slice.size();
-          process_slice(time_slice, elems);
+          m_low_level_input_count += m_time_slice.size();
+          process_slice(m_time_slice, elems);
         }
 
         Set<B> heartbeat;
@@ -369,14 +985,24 @@ public: // NOLINT
         heartbeat.origin = daqdataformats::SourceID(
           daqdataformats::SourceID::Subsystem::kTrigger, m_parent.m_sourceid);
 
-        TLOG_DEBUG(TLVL_DEBUG_HIGH) << "[TGM] Buffering heartbeat with start time " << heartbeat.start_time;
+        TRIGGER_TLOG_DEBUG(TLVL_DEBUG_HIGH) << "[TGM] Buffering heartbeat with start time " << heartbeat.start_time;
         m_out_buffer.buffer_heartbeat(heartbeat);
 
-        // flush the maker
+        // flush the maker (or, in sharded mode, every shard's maker)
         try {
           // TODO Benjamin Land <BenLand100@github.com> July-14-2021 flushed events go into the buffer... until a window
           // is ready?
-          m_parent.m_maker->flush(in.end_time, elems);
+          if (!m_shards.empty()) {
+            for (Shard& s : m_shards) {
+              s.maker->flush(in.end_time, elems);
+            }
+          } else if (!m_pipeline_makers.empty()) {
+            for (std::unique_ptr<MAKER>& maker : m_pipeline_makers) {
+              maker->flush(in.end_time, elems);
+            }
+          } else {
+            m_parent.m_maker->flush(in.end_time, elems);
+          }
         } catch (...) { // NOLINT TODO Benjamin Land <BenLand100@github.com> May-28-2021 can we restrict the possible
                         // exceptions triggeralgs might raise?
           ers::fatal(AlgorithmFatalError(ERS_HERE, m_parent.get_name(), m_parent.m_algorithm_name));
@@ -388,6 +1014,12 @@ public: // NOLINT
         break;
     }
 
+    // In pipelined mode, pick up outputs of any slices that have completed,
+    // in submission order, so they are windowed exactly as in the serial path
+    if (!m_pipeline_threads.empty()) {
+      pipeline_collect(false, elems);
+    }
+
     // add new elements to output buffer
     if (elems.size() > 0) {
       m_out_buffer.buffer(elems);
@@ -404,7 +1036,7 @@ public: // NOLINT
           daqdataformats::SourceID::Subsystem::kTrigger, m_parent.m_sourceid);
 
       if (out.type == Set<B>::Type::kHeartbeat) {
-        TLOG_DEBUG(TLVL_DEBUG_MEDIUM) << "[TGM] Sending heartbeat with start time " << out.start_time;
+        TRIGGER_TLOG_DEBUG(TLVL_DEBUG_MEDIUM) << "[TGM] Sending heartbeat with start time " << out.start_time;
         if (!m_parent.send(std::move(out))) {
           ers::error(AlgorithmFailedToSend(ERS_HERE, m_parent.get_name(), m_parent.m_algorithm_name));
           // out is dropped
@@ -412,7 +1044,7 @@ public: // NOLINT
       }
       // Only form and send Set<B> if it has a nonzero number of objects
       else if (out.type == Set<B>::Type::kPayload && out.objects.size() != 0) {
-        TLOG_DEBUG(TLVL_DEBUG_MEDIUM) << "[TGM] Output set window ready with start time " << out.start_time << " end time " << out.end_time
+        TRIGGER_TLOG_DEBUG(TLVL_DEBUG_MEDIUM) << "[TGM] Output set window ready with start time " << out.start_time << " end time " << out.end_time
                       << " and " << out.objects.size() << " members";
         if (!m_parent.send(std::move(out))) {
           ers::error(AlgorithmFailedToSend(ERS_HERE, m_parent.get_name(), m_parent.m_algorithm_name));
@@ -420,22 +1052,36 @@ public: // NOLINT
         }
       }
     }
-    TLOG_DEBUG(TLVL_DEBUG_HIGH) << "[TGM] process() done. Advanced output buffer by " << n_output_windows << " output windows";
+    TRIGGER_TLOG_DEBUG(TLVL_DEBUG_HIGH) << "[TGM] process() done. Advanced output buffer by " << n_output_windows << " output windows";
+  }
+
+  // Process a whole drained batch in one go. Because the input buffer only
+  // emits a slice when the start time changes, feeding many Sets at once lets
+  // process_slice run over larger contiguous slices than one-at-a-time calls
+  void process_batch(std::vector<Set<A>>& batch)
+  {
+    for (Set<A>& in : batch) {
+      process(in);
+    }
   }
 
   void drain(bool drop)
   {
-    // First, send anything in the input buffer to the algorithm, and add any
-    // results to output buffer
-    std::vector<A> time_slice;
+    // First, wait out any slices still in the pipeline, then send anything in
+    // the input buffer to the algorithm, and add any results to output buffer
+    std::vector<B>& elems = m_elems;
+    elems.clear();
+    if (!m_pipeline_threads.empty()) {
+      pipeline_collect(true, elems);
+    }
+    m_time_slice.clear();
     daqdataformats::timestamp_t start_time, end_time;
-    if (m_in_buffer.flush(time_slice, start_time, end_time)) {
-      std::vector<B> elems;
-      m_low_level_input_count += time_slice.size();
-      process_slice(time_slice, elems);
-      if (elems.size() > 0) {
-        m_out_buffer.buffer(elems);
-      }
+    if (m_in_buffer.flush(m_time_slice, start_time, end_time)) {
+      m_low_level_input_count += m_time_slice.size();
+      process_slice(m_time_slice, elems);
+    }
+    if (elems.size() > 0) {
+      m_out_buffer.buffer(elems);
     }
     // Second, drain the output buffer onto the queue. These may not be "fully
     // formed" windows, but at this point we're getting no more data anyway.
@@ -456,7 +1102,7 @@ public: // NOLINT
       }
       // Only form and send Set<B> if it has a nonzero number of objects
       else if (out.type == Set<B>::Type::kPayload && out.objects.size() != 0) {
-        TLOG_DEBUG(TLVL_DEBUG_MEDIUM) << "[TGM] Output set window ready with start time " << out.start_time << " end time " << out.end_time
+        TRIGGER_TLOG_DEBUG(TLVL_DEBUG_MEDIUM) << "[TGM] Output set window ready with start time " << out.start_time << " end time " << out.end_time
                       << " and " << out.objects.size() << " members";
         if (!drop) {
           if (!m_parent.send(std::move(out))) {
@@ -470,6 +1116,10 @@ public: // NOLINT
 
   size_t get_low_level_input_count() {return m_low_level_input_count;}
   size_t m_low_level_input_count;
+  uint64_t get_out_of_order_count() { return m_out_of_order_count; }        // NOLINT(build/unsigned)
+  uint64_t get_tardy_output_count() { return m_out_buffer.tardy_count(); }  // NOLINT(build/unsigned)
+  uint64_t m_out_of_order_count{ 0 };                                       // NOLINT(build/unsigned)
+  IssueThrottler m_ooo_throttle; // rate limit on OutOfOrderSets emission
 };
 
 // Partial specialization for IN = Set<A> and assumes the the MAKER has:
@@ -488,6 +1138,10 @@ public: // NOLINT
 
   TimeSliceInputBuffer<A> m_in_buffer;
 
+  // Reused across process() calls, so slice assembly stops allocating once it
+  // reaches its steady-state capacity
+  std::vector<A> m_time_slice;
+
   void reconfigure() {}
 
   void reset() {
@@ -498,6 +1152,7 @@ public: // NOLINT
   {
     // time_slice is a full slice (all Set<A> combined), time ordered, vector of A
     // call operator for each of the objects in the vector
+    ScopedLatencyTimer timer(m_parent.m_maker_hist);
     for (const A& x : time_slice) {
       try {
         m_parent.m_maker->operator()(x, out_vec);
@@ -509,18 +1164,23 @@ public: // NOLINT
     }
   }
 
+  // Scratch for process() and drain(), reused across calls so the per-set
+  // allocation disappears once it reaches steady-state capacity
+  std::vector<OUT> m_out_vec;
+
   void process(Set<A>& in)
   {
-    std::vector<OUT> out_vec; // either a whole time slice, heartbeat flushed, or empty
+    std::vector<OUT>& out_vec = m_out_vec; // either a whole time slice, heartbeat flushed, or empty
+    out_vec.clear();
     switch (in.type) {
       case Set<A>::Type::kPayload: {
-        std::vector<A> time_slice;
+        m_time_slice.clear();
         daqdataformats::timestamp_t start_time, end_time;
-        if (!m_in_buffer.buffer(in, time_slice, start_time, end_time)) {
+        if (!m_in_buffer.buffer(std::move(in), m_time_slice, start_time, end_time)) {
           return; // no complete time slice yet (`in` was part of buffered slice)
         }
-        m_low_level_input_count += time_slice.size();
-        process_slice(time_slice, out_vec);
+        m_low_level_input_count += m_time_slice.size();
+        process_slice(m_time_slice, out_vec);
       } break;
       case Set<A>::Type::kHeartbeat:
         // TODO BJL May-28-2021 should anything happen with the heartbeat when OUT is not a Set<T>?
@@ -530,15 +1190,15 @@ public: // NOLINT
         // we can flush all items in the input buffer, which have
         // times t < T, because the input is time-ordered
         try {
-          std::vector<A> time_slice;
+          m_time_slice.clear();
           daqdataformats::timestamp_t start_time, end_time;
-          if (m_in_buffer.flush(time_slice, start_time, end_time)) {
+          if (m_in_buffer.flush(m_time_slice, start_time, end_time)) {
             if (end_time > in.start_time) {
               // This should never happen, but we check here so we at least get some output if it did
               ers::fatal(OutOfOrderSets(ERS_HERE, m_parent.get_name(), end_time, in.start_time));
             }
-            m_low_level_input_count += time_slice.size();
-            process_slice(time_slice, out_vec);
+            m_low_level_input_count += m_time_slice.size();
+            process_slice(m_time_slice, out_vec);
           }
           m_parent.m_maker->flush(in.end_time, out_vec);
         } catch (...) { // NOLINT TODO Benjamin Land <BenLand100@github.com> May 28-2021 can we restrict the possible
@@ -561,16 +1221,24 @@ public: // NOLINT
     }
   }
 
+  void process_batch(std::vector<Set<A>>& batch)
+  {
+    for (Set<A>& in : batch) {
+      process(in);
+    }
+  }
+
   void drain(bool drop)
   {
     // Send anything in the input buffer to the algorithm, and put any results
     // on the output queue
-    std::vector<A> time_slice;
+    m_time_slice.clear();
     daqdataformats::timestamp_t start_time, end_time;
-    if (m_in_buffer.flush(time_slice, start_time, end_time)) {
-      std::vector<OUT> out_vec;
-      m_low_level_input_count += time_slice.size();
-      process_slice(time_slice, out_vec);
+    if (m_in_buffer.flush(m_time_slice, start_time, end_time)) {
+      std::vector<OUT>& out_vec = m_out_vec;
+      out_vec.clear();
+      m_low_level_input_count += m_time_slice.size();
+      process_slice(m_time_slice, out_vec);
       while (out_vec.size()) {
         if (!drop) {
           if (!m_parent.send(std::move(out_vec.back()))) {
@@ -585,6 +1253,8 @@ public: // NOLINT
 
   size_t get_low_level_input_count() {return m_low_level_input_count;}
   size_t m_low_level_input_count;
+  uint64_t get_out_of_order_count() { return 0; } // NOLINT(build/unsigned)
+  uint64_t get_tardy_output_count() { return 0; } // NOLINT(build/unsigned)
 };
 
 } // namespace dunedaq::trigger
@@ -0,0 +1,102 @@
+/**
+ * @file WorkerLiveness.hpp
+ *
+ * Process-wide registry of worker-thread liveness counters.
+ *
+ * A wedged maker thread - an algorithm stuck in a pathological input -
+ * shows up only as silently rising queue depths until the run dies.
+ * Instead, every worker loop bumps an iteration counter here each pass
+ * (including empty passes, so an idle stream is not a stall) and labels
+ * the stage it is about to enter with a string literal; the StallWatchdog
+ * module samples the counters and flags any active worker whose count has
+ * not moved within its deadline, together with the last stage it was seen
+ * entering.
+ *
+ * Slots are claimed once at registration (under a mutex) and written
+ * lock-free afterwards: a pulse is one relaxed fetch_add and a stage
+ * label is one relaxed pointer store, cheap enough for per-iteration use.
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#ifndef TRIGGER_SRC_TRIGGER_WORKERLIVENESS_HPP_
+#define TRIGGER_SRC_TRIGGER_WORKERLIVENESS_HPP_
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+namespace dunedaq::trigger {
+
+class WorkerLiveness
+{
+public:
+  using handle_t = size_t;
+  static constexpr size_t s_max_workers = 128;
+
+  struct WorkerStats
+  {
+    std::string name; // written once at registration, before m_n_workers is bumped
+    std::atomic<uint64_t> iterations{ 0 }; // NOLINT(build/unsigned)
+    // Stage the worker last entered; must be a string literal (or other
+    // storage outliving the process) so the watchdog can read it raceless
+    std::atomic<const char*> stage{ nullptr };
+    std::atomic<bool> active{ false };
+  };
+
+  static WorkerLiveness& get_instance()
+  {
+    static WorkerLiveness instance;
+    return instance;
+  }
+
+  // Claim (or find) the slot for the given worker name. A module restarted
+  // across runs reuses its slot
+  handle_t register_worker(const std::string& name)
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    size_t n = m_n_workers.load(std::memory_order_acquire);
+    for (size_t i = 0; i < n; ++i) {
+      if (m_slots[i].name == name) {
+        return i;
+      }
+    }
+    if (n == s_max_workers) {
+      // Table full; overflow workers share the last slot rather than grow,
+      // as in QueueSpy
+      return s_max_workers - 1;
+    }
+    m_slots[n].name = name;
+    m_n_workers.store(n + 1, std::memory_order_release);
+    return n;
+  }
+
+  // One loop iteration completed (or about to begin - either convention
+  // works as long as it runs every pass)
+  void pulse(handle_t h) { m_slots[h].iterations.fetch_add(1, std::memory_order_relaxed); }
+
+  // Label the stage the worker is about to enter; `stage` must be a
+  // string literal
+  void set_stage(handle_t h, const char* stage) { m_slots[h].stage.store(stage, std::memory_order_relaxed); }
+
+  // Bracket the worker loop: the watchdog only judges active workers
+  void set_active(handle_t h, bool active) { m_slots[h].active.store(active, std::memory_order_relaxed); }
+
+  size_t size() const { return m_n_workers.load(std::memory_order_acquire); }
+  const WorkerStats& stats(size_t i) const { return m_slots[i]; }
+
+private:
+  WorkerLiveness() = default;
+
+  std::mutex m_mutex;
+  std::atomic<size_t> m_n_workers{ 0 };
+  std::array<WorkerStats, s_max_workers> m_slots;
+};
+
+} // namespace dunedaq::trigger
+
+#endif // TRIGGER_SRC_TRIGGER_WORKERLIVENESS_HPP_
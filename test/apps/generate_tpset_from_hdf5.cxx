@@ -2,6 +2,14 @@
  * @file generate_tpset_from_hdf5.cxx Read TP fragments from file and generate a TPSet vector.
  * Matches code within TriggerPrimitiveMaker.
  *
+ * Conversion is pipelined: one reader thread per input file pulls
+ * fragments off storage, a pool of workers decodes them into
+ * window-bucketed TPs in parallel, and a single writer re-orders the
+ * results, merges the window spanning each fragment boundary, assigns
+ * seqnos and streams the TPSets out. A converting pass is I/O- and
+ * decode-bound, so this saturates the storage array instead of one
+ * core; progress and throughput are reported as it runs.
+ *
  * This is part of the DUNE DAQ Application Framework, copyright 2020.
  * Licensing/copyright details are in the COPYING file that you should have
  * received with this code.
@@ -9,6 +17,7 @@
 #include "CLI/CLI.hpp"
 
 #include "../../plugins/TriggerPrimitiveMaker.hpp"
+#include "trigger/TPStreamFile.hpp"
 #include "trgdataformats/TriggerPrimitive.hpp"
 
 #include "daqdataformats/Fragment.hpp"
@@ -18,99 +27,307 @@
 #include "daqdataformats/Types.hpp"
 #include "hdf5libs/HDF5RawDataFile.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
 #include <iostream>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace {
+
+// Minimal bounded MPMC queue for the pipeline stages: push blocks when
+// full (backpressure towards the readers), pop returns false once the
+// queue is closed and drained
+template<class T>
+class BoundedQueue
+{
+public:
+  explicit BoundedQueue(size_t capacity)
+    : m_capacity(capacity)
+  {}
+
+  void push(T&& item)
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_not_full.wait(lock, [this] { return m_items.size() < m_capacity; });
+    m_items.push_back(std::move(item));
+    m_not_empty.notify_one();
+  }
+
+  bool pop(T& item)
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_not_empty.wait(lock, [this] { return !m_items.empty() || m_closed; });
+    if (m_items.empty()) {
+      return false;
+    }
+    item = std::move(m_items.front());
+    m_items.pop_front();
+    m_not_full.notify_one();
+    return true;
+  }
+
+  void close()
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_closed = true;
+    m_not_empty.notify_all();
+  }
+
+private:
+  size_t m_capacity;
+  std::mutex m_mutex;
+  std::condition_variable m_not_full;
+  std::condition_variable m_not_empty;
+  std::deque<T> m_items;
+  bool m_closed = false;
+};
+
+struct ReadTask
+{
+  size_t index = 0; // global fragment order: file order, then dataset order
+  std::unique_ptr<dunedaq::daqdataformats::Fragment> frag;
+};
+
+struct Window
+{
+  uint64_t number = 0; // NOLINT(build/unsigned)
+  std::vector<dunedaq::trgdataformats::TriggerPrimitive> tps;
+};
+
+struct DecodedFragment
+{
+  size_t index = 0;
+  bool relevant = false; // false for non-TP fragments, which are skipped
+  bool sorted = true;
+  std::vector<Window> windows;
+};
+
+} // namespace
 
 int
 main(int argc, char** argv)
 {
-  CLI::App app{ "App description" };
+  CLI::App app{ "Convert HDF5 TP fragments to a .tpstream replay input" };
 
-  std::string filename;
-  app.add_option("-f,--file", filename, "Input HDF5 file");
+  std::vector<std::string> filenames;
+  app.add_option("-f,--file", filenames, "Input HDF5 file(s), in time order")->required();
 
-  CLI11_PARSE(app, argc, argv);
+  std::string output_filename;
+  app.add_option("-o,--output", output_filename, "Output .tpstream file (compressed, seekable TPSet stream)");
 
-  dunedaq::trigger::TPSet tpset;
-  std::vector<dunedaq::trigger::TPSet> tpsets;
+  size_t n_workers = std::max(1u, std::thread::hardware_concurrency() / 2);
+  app.add_option("-j,--jobs", n_workers, "Number of fragment-decode worker threads");
 
-  uint64_t prev_tpset_number = 0; // NOLINT(build/unsigned)
-  uint32_t seqno = 0;             // NOLINT(build/unsigned)
-  uint64_t old_time_start = 0;    // NOLINT(build/unsigned)
-  uint32_t tpset_time_width = 10; // Arbitrary
-  uint32_t tpset_time_offset = 5; // Arbitrary
-  uint16_t element = 0;           // Arbitrary
-  uint32_t total_tps = 0;
+  CLI11_PARSE(app, argc, argv);
 
-  // Prepare input file
-  std::unique_ptr<dunedaq::hdf5libs::HDF5RawDataFile> input_file =
-    std::make_unique<dunedaq::hdf5libs::HDF5RawDataFile>(filename);
+  const uint32_t tpset_time_width = 10; // Arbitrary
+  const uint32_t tpset_time_offset = 5; // Arbitrary
+  const uint16_t element = 0;           // Arbitrary
 
-  // Check that the file is a TimeSlice type
-  if (!input_file->is_timeslice_type()) {
-    std::cout << "Not a timeslice type.\n";
-    return 1;
+  // Enumerate fragment datasets up front so every fragment has a global
+  // index the writer can re-order on. Requires a thread-safe HDF5 build
+  // for the per-file reader threads, which is what our stack ships
+  struct InputFile
+  {
+    std::string name;
+    std::vector<std::string> fragment_paths;
+    size_t index_offset = 0;
+  };
+  std::vector<InputFile> inputs;
+  size_t total_fragments = 0;
+  for (const auto& filename : filenames) {
+    dunedaq::hdf5libs::HDF5RawDataFile probe(filename);
+    if (!probe.is_timeslice_type()) {
+      std::cout << "Not a timeslice type: " << filename << "\n";
+      return 1;
+    }
+    InputFile input;
+    input.name = filename;
+    input.fragment_paths = probe.get_all_fragment_dataset_paths();
+    input.index_offset = total_fragments;
+    total_fragments += input.fragment_paths.size();
+    inputs.push_back(std::move(input));
   }
 
-  std::vector<std::string> fragment_paths = input_file->get_all_fragment_dataset_paths();
-
-  // Read in the file and place the TPs in TPSets. TPSets have time
-  // boundaries ( n*tpset_time_width + tpset_time_offset ), and TPs are placed
-  // in TPSets based on the TP start time
-  //
-  // This loop assumes the input file is sorted by TP start time
-  for (std::string& fragment_path : fragment_paths) {
-    std::unique_ptr<dunedaq::daqdataformats::Fragment> frag = input_file->get_frag_ptr(fragment_path);
-    // Make sure this fragment is a TriggerPrimitive
-    if (frag->get_fragment_type() != dunedaq::daqdataformats::FragmentType::kTriggerPrimitive)
-      continue;
-    if (frag->get_element_id().subsystem != dunedaq::daqdataformats::SourceID::Subsystem::kTrigger)
-      continue;
-
-    // Prepare TP buffer
-    size_t num_tps = frag->get_data_size() / sizeof(dunedaq::trgdataformats::TriggerPrimitive);
-    total_tps += num_tps;
+  BoundedQueue<ReadTask> read_queue(4 * n_workers);
+  BoundedQueue<DecodedFragment> decoded_queue(4 * n_workers);
+  std::atomic<uint64_t> total_tps{ 0 };          // NOLINT(build/unsigned)
+  std::atomic<size_t> fragments_decoded{ 0 };
+  std::atomic<bool> failed{ false };
 
-    dunedaq::trgdataformats::TriggerPrimitive* tp_array =
-      static_cast<dunedaq::trgdataformats::TriggerPrimitive*>(frag->get_data());
+  // Stage 1: one reader per file, so a striped storage array serves
+  // several streams at once
+  std::vector<std::thread> readers;
+  for (const auto& input : inputs) {
+    readers.emplace_back([&read_queue, &failed, &input] {
+      dunedaq::hdf5libs::HDF5RawDataFile file(input.name);
+      for (size_t i = 0; i < input.fragment_paths.size() && !failed.load(); ++i) {
+        ReadTask task;
+        task.index = input.index_offset + i;
+        task.frag = file.get_frag_ptr(input.fragment_paths[i]);
+        read_queue.push(std::move(task));
+      }
+    });
+  }
 
-    for (size_t i(0); i < num_tps; i++) {
-      auto& tp = tp_array[i];
-      if (tp.time_start < old_time_start) {
-        std::cout << "TPs are unsorted.\n";
-        return 1;
+  // Stage 2: parallel decode of each fragment's TP array into
+  // window-numbered buckets ( boundaries at n*tpset_time_width +
+  // tpset_time_offset, bucketed by TP start time )
+  std::vector<std::thread> workers;
+  for (size_t w = 0; w < n_workers; ++w) {
+    workers.emplace_back([&read_queue, &decoded_queue, &total_tps, &fragments_decoded] {
+      ReadTask task;
+      while (read_queue.pop(task)) {
+        DecodedFragment decoded;
+        decoded.index = task.index;
+        if (task.frag->get_fragment_type() == dunedaq::daqdataformats::FragmentType::kTriggerPrimitive &&
+            task.frag->get_element_id().subsystem == dunedaq::daqdataformats::SourceID::Subsystem::kTrigger) {
+          decoded.relevant = true;
+          size_t num_tps = task.frag->get_data_size() / sizeof(dunedaq::trgdataformats::TriggerPrimitive);
+          total_tps += num_tps;
+          auto* tp_array = static_cast<dunedaq::trgdataformats::TriggerPrimitive*>(task.frag->get_data());
+          uint64_t old_time_start = 0; // NOLINT(build/unsigned)
+          for (size_t i = 0; i < num_tps; i++) {
+            auto& tp = tp_array[i];
+            if (tp.time_start < old_time_start) {
+              decoded.sorted = false;
+              break;
+            }
+            old_time_start = tp.time_start;
+            // NOLINTNEXTLINE(build/unsigned)
+            uint64_t window_number = (tp.time_start + tpset_time_offset) / tpset_time_width;
+            if (decoded.windows.empty() || decoded.windows.back().number != window_number) {
+              decoded.windows.push_back(Window{ window_number, {} });
+            }
+            decoded.windows.back().tps.push_back(tp);
+          }
+        }
+        ++fragments_decoded;
+        decoded_queue.push(std::move(decoded));
       }
-      // NOLINTNEXTLINE(build/unsigned)
-      uint64_t current_tpset_number = (tp.time_start + tpset_time_offset) / tpset_time_width;
-      old_time_start = tp.time_start;
+    });
+  }
 
-      // If we crossed a time boundary, push the current TPSet and reset it
-      if (current_tpset_number > prev_tpset_number) {
-        tpset.start_time = prev_tpset_number * tpset_time_width + tpset_time_offset;
-        tpset.end_time = tpset.start_time + tpset_time_width;
-        tpset.seqno = seqno;
-        ++seqno;
+  std::thread closer([&readers, &workers, &read_queue, &decoded_queue] {
+    for (auto& reader : readers) {
+      reader.join();
+    }
+    read_queue.close();
+    for (auto& worker : workers) {
+      worker.join();
+    }
+    decoded_queue.close();
+  });
+
+  // Stage 3: single ordered writer. Fragments come back in any order, so
+  // they are parked in a reorder buffer (bounded by the queue capacities)
+  // until the next index arrives; the window spanning two consecutive
+  // fragments is merged before its TPSet is emitted
+  std::unique_ptr<dunedaq::trigger::TPStreamWriter> writer;
+  if (!output_filename.empty()) {
+    writer = std::make_unique<dunedaq::trigger::TPStreamWriter>(output_filename);
+  }
 
-        // 12-Jul-2021, KAB: setting origin fields from configuration
-        tpset.origin.id = element;
+  size_t next_index = 0;
+  std::map<size_t, DecodedFragment> reorder_buffer;
+  Window pending;
+  bool have_pending = false;
+  uint32_t seqno = 0;       // NOLINT(build/unsigned)
+  uint64_t sets_written = 0; // NOLINT(build/unsigned)
+  auto start_time = std::chrono::steady_clock::now();
+  auto last_report = start_time;
 
-        tpset.type = dunedaq::trigger::TPSet::Type::kPayload;
+  auto emit = [&](Window&& window) {
+    dunedaq::trigger::TPSet tpset;
+    tpset.start_time = window.number * tpset_time_width + tpset_time_offset;
+    tpset.end_time = tpset.start_time + tpset_time_width;
+    tpset.seqno = seqno;
+    ++seqno;
+    // 12-Jul-2021, KAB: setting origin fields from configuration
+    tpset.origin.id = element;
+    tpset.type = dunedaq::trigger::TPSet::Type::kPayload;
+    tpset.objects = std::move(window.tps);
+    if (writer) {
+      writer->write(tpset);
+    }
+    ++sets_written;
+  };
 
-        if (!tpset.objects.empty()) {
+  // On a sortedness error the readers and workers still need to drain
+  // and exit, so `failed` stops the processing and the loop keeps
+  // popping until the pipeline winds down
+  DecodedFragment decoded;
+  while (decoded_queue.pop(decoded)) {
+    if (failed.load()) {
+      continue;
+    }
+    reorder_buffer.emplace(decoded.index, std::move(decoded));
+    while (!failed.load() && !reorder_buffer.empty() && reorder_buffer.begin()->first == next_index) {
+      DecodedFragment front = std::move(reorder_buffer.begin()->second);
+      reorder_buffer.erase(reorder_buffer.begin());
+      ++next_index;
+      if (!front.sorted) {
+        std::cout << "TPs are unsorted.\n";
+        failed.store(true);
+        break;
+      }
+      for (auto& window : front.windows) {
+        if (have_pending && window.number == pending.number) {
+          pending.tps.insert(pending.tps.end(), window.tps.begin(), window.tps.end());
+          continue;
+        }
+        if (have_pending && window.number < pending.number) {
+          std::cout << "TPs are unsorted.\n";
+          failed.store(true);
+          break;
+        }
+        if (have_pending && !pending.tps.empty()) {
           // We don't send empty TPSets, so there's no point creating them
-          tpsets.push_back(tpset);
+          emit(std::move(pending));
         }
-        prev_tpset_number = current_tpset_number;
-
-        tpset.objects.clear();
+        pending = std::move(window);
+        have_pending = true;
       }
-      tpset.objects.push_back(tp);
     }
+
+    auto now = std::chrono::steady_clock::now();
+    if (now - last_report >= std::chrono::seconds(2)) {
+      last_report = now;
+      double elapsed_s = std::chrono::duration<double>(now - start_time).count();
+      std::printf("Progress: %zu/%zu fragments, %lu TPs (%.1f MTP/s), %lu TPSets written\n",
+                  fragments_decoded.load(),
+                  total_fragments,
+                  static_cast<unsigned long>(total_tps.load()),       // NOLINT(runtime/int)
+                  total_tps.load() / elapsed_s * 1e-6,
+                  static_cast<unsigned long>(sets_written));          // NOLINT(runtime/int)
+      std::fflush(stdout);
+    }
+  }
+  closer.join();
+  if (failed.load()) {
+    return 1;
   }
-  if (!tpset.objects.empty()) {
+  if (have_pending && !pending.tps.empty()) {
     // We don't send empty TPSets, so there's no point creating them
-    tpsets.push_back(tpset);
+    emit(std::move(pending));
+  }
+
+  double elapsed_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+  std::cout << "Read " << total_tps.load() << " TPs into " << sets_written << " TPSets, from " << filenames.size()
+            << " file(s) in " << elapsed_s << " s (" << total_tps.load() / elapsed_s * 1e-6 << " MTP/s)" << std::endl;
+
+  if (writer) {
+    writer->close();
+    std::cout << "Wrote " << sets_written << " TPSets to stream file " << output_filename << std::endl;
   }
-  std::cout << "Read " << total_tps << " TPs into " << tpsets.size() << " TPSets, from file " << filename << std::endl;
 
   return 0;
 }
@@ -0,0 +1,280 @@
+/**
+ * @file mlt_backpressure_sim.cxx Offline DF-backpressure sweep for MLT token tuning
+ *
+ * Drives the MLT decision path's credit machinery - TokenManager plus
+ * LivetimeCounter - with a configurable TC burst profile, while a DFO
+ * emulator thread returns TriggerDecisionTokens with a configurable
+ * latency distribution and periodic busy episodes during which returns
+ * are withheld. Decisions that cannot be sent are parked (the MLT's
+ * behaviour) up to a capacity, then dropped. Reports decision latency
+ * percentiles, sent/parked/dropped counts and livetime fractions, so
+ * initial_tokens and inhibit thresholds can be swept offline in a
+ * minute instead of tuned by trial and error on the detector.
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#include "trigger/LatencyHistogram.hpp"
+#include "trigger/LivetimeCounter.hpp"
+#include "trigger/TokenManager.hpp"
+
+#include "dfmessages/TriggerDecisionToken.hpp"
+#include "iomanager/IOManager.hpp"
+
+#include "CLI/CLI.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <functional>
+#include <cstdlib>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <random>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using namespace std::chrono_literals;
+using steady_clock = std::chrono::steady_clock;
+
+namespace {
+
+// Emulated DFO: completes each decision after a sampled latency and
+// sends the TriggerDecisionToken back over the iomanager connection
+// TokenManager listens on. During a busy episode, completions are
+// deferred to the end of the episode, exactly what a stalled dataflow
+// app does to the real trigger
+class DfoEmulator
+{
+public:
+  DfoEmulator(const std::string& connection_name,
+              dunedaq::daqdataformats::run_number_t run_number,
+              std::chrono::microseconds busy_period,
+              std::chrono::microseconds busy_duration)
+    : m_run_number(run_number)
+    , m_busy_period(busy_period)
+    , m_busy_duration(busy_duration)
+    , m_epoch(steady_clock::now())
+    , m_sender(dunedaq::get_iom_sender<dunedaq::dfmessages::TriggerDecisionToken>(connection_name))
+    , m_thread(&DfoEmulator::run, this)
+  {}
+
+  ~DfoEmulator()
+  {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_stopping = true;
+    }
+    m_cv.notify_one();
+    m_thread.join();
+  }
+
+  void schedule(dunedaq::dfmessages::trigger_number_t trigger_number, std::chrono::microseconds latency)
+  {
+    auto completion = steady_clock::now() + latency;
+    // A completion falling inside a busy episode is deferred to its end
+    if (m_busy_period.count() > 0) {
+      auto phase = std::chrono::duration_cast<std::chrono::microseconds>(completion - m_epoch) % m_busy_period;
+      if (phase < m_busy_duration) {
+        completion += m_busy_duration - phase;
+      }
+    }
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_schedule.emplace(completion, trigger_number);
+    }
+    m_cv.notify_one();
+  }
+
+private:
+  void run()
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true) {
+      if (m_schedule.empty()) {
+        if (m_stopping) {
+          return;
+        }
+        m_cv.wait(lock);
+        continue;
+      }
+      auto next = m_schedule.top();
+      if (m_cv.wait_until(lock, next.first) == std::cv_status::timeout && !m_schedule.empty() &&
+          m_schedule.top().first <= steady_clock::now()) {
+        auto due = m_schedule.top();
+        m_schedule.pop();
+        lock.unlock();
+        dunedaq::dfmessages::TriggerDecisionToken token;
+        token.run_number = m_run_number;
+        token.trigger_number = due.second;
+        m_sender->send(std::move(token), 10ms);
+        lock.lock();
+      }
+    }
+  }
+
+  using entry_t = std::pair<steady_clock::time_point, dunedaq::dfmessages::trigger_number_t>;
+
+  dunedaq::daqdataformats::run_number_t m_run_number;
+  std::chrono::microseconds m_busy_period;
+  std::chrono::microseconds m_busy_duration;
+  steady_clock::time_point m_epoch;
+  std::shared_ptr<dunedaq::iomanager::SenderConcept<dunedaq::dfmessages::TriggerDecisionToken>> m_sender;
+
+  std::mutex m_mutex;
+  std::condition_variable m_cv;
+  std::priority_queue<entry_t, std::vector<entry_t>, std::greater<entry_t>> m_schedule;
+  bool m_stopping = false;
+  std::thread m_thread;
+};
+
+} // namespace
+
+int
+main(int argc, char** argv)
+{
+  CLI::App app{ "Offline DF-backpressure sweep for MLT token tuning" };
+
+  int initial_tokens = 10;
+  app.add_option("--initial-tokens", initial_tokens, "TokenManager initial token count");
+  double tc_rate_hz = 1000;
+  app.add_option("--tc-rate-hz", tc_rate_hz, "Mean TC arrival rate");
+  size_t burst_size = 1;
+  app.add_option("--burst-size", burst_size, "TCs arriving back-to-back per burst");
+  uint64_t dfo_latency_us = 2000; // NOLINT(build/unsigned)
+  app.add_option("--dfo-latency-us", dfo_latency_us, "Fixed part of the token return latency");
+  uint64_t dfo_jitter_us = 500; // NOLINT(build/unsigned)
+  app.add_option("--dfo-jitter-us", dfo_jitter_us, "Exponential tail scale of the token return latency");
+  uint64_t busy_period_ms = 0; // NOLINT(build/unsigned)
+  app.add_option("--busy-period-ms", busy_period_ms, "Interval between DFO busy episodes (0 disables them)");
+  uint64_t busy_duration_ms = 100; // NOLINT(build/unsigned)
+  app.add_option("--busy-duration-ms", busy_duration_ms, "Length of each busy episode");
+  size_t park_capacity = 1024;
+  app.add_option("--park-capacity", park_capacity, "Decisions parked while inhibited before dropping");
+  double duration_s = 10;
+  app.add_option("--duration-s", duration_s, "Simulated run length");
+
+  CLI11_PARSE(app, argc, argv);
+
+  setenv("DUNEDAQ_PARTITION", "mlt_backpressure_sim", 0);
+  const std::string connection_name = "td_token";
+  dunedaq::iomanager::Connections_t connections;
+  dunedaq::iomanager::ConnectionId cid{ connection_name, "TriggerDecisionToken" };
+  connections.emplace_back(dunedaq::iomanager::Connection{
+    cid, "inproc://" + connection_name, dunedaq::iomanager::ConnectionType::kSendRecv });
+  dunedaq::get_iomanager()->configure({}, connections, false, 0ms); // Not using ConfigClient
+
+  const dunedaq::daqdataformats::run_number_t run_number = 1;
+  auto livetime_counter =
+    std::make_shared<dunedaq::trigger::LivetimeCounter>(dunedaq::trigger::LivetimeCounter::State::kLive);
+
+  {
+    dunedaq::trigger::TokenManager token_manager(connection_name, initial_tokens, run_number, livetime_counter);
+    DfoEmulator dfo(connection_name,
+                    run_number,
+                    std::chrono::microseconds(busy_period_ms * 1000),
+                    std::chrono::microseconds(busy_duration_ms * 1000));
+
+    std::mt19937 gen(42);
+    std::exponential_distribution<double> jitter(dfo_jitter_us > 0 ? 1.0 / dfo_jitter_us : 1.0);
+    auto sample_latency = [&]() {
+      return std::chrono::microseconds(dfo_latency_us + (dfo_jitter_us > 0 ? static_cast<uint64_t>(jitter(gen)) : 0));
+    };
+
+    dunedaq::trigger::LatencyHistogram decision_latency;
+    uint64_t n_sent = 0;              // NOLINT(build/unsigned)
+    uint64_t n_parked = 0;            // NOLINT(build/unsigned)
+    uint64_t n_dropped = 0;           // NOLINT(build/unsigned)
+    uint64_t max_park_depth = 0;      // NOLINT(build/unsigned)
+    dunedaq::dfmessages::trigger_number_t trigger_number = 0;
+
+    // Arrival times of decisions waiting for a token, oldest first (the
+    // MLT's parked-decision ring, modelled as a bounded deque)
+    std::deque<steady_clock::time_point> parked;
+
+    auto send_decision = [&](steady_clock::time_point arrival) {
+      ++trigger_number;
+      token_manager.trigger_sent(trigger_number);
+      dfo.schedule(trigger_number, sample_latency());
+      decision_latency.record(steady_clock::now() - arrival);
+      ++n_sent;
+    };
+
+    const auto start = steady_clock::now();
+    const auto stop = start + std::chrono::microseconds(static_cast<uint64_t>(duration_s * 1e6));
+    const auto burst_spacing =
+      std::chrono::microseconds(static_cast<uint64_t>(burst_size * 1e6 / tc_rate_hz)); // NOLINT(build/unsigned)
+    auto next_burst = start;
+
+    while (steady_clock::now() < stop) {
+      // Drain parked decisions as tokens return, oldest first
+      while (!parked.empty() && token_manager.triggers_allowed()) {
+        send_decision(parked.front());
+        parked.pop_front();
+      }
+
+      auto now = steady_clock::now();
+      if (now < next_burst) {
+        std::this_thread::sleep_for(std::min(std::chrono::microseconds(100),
+                                             std::chrono::duration_cast<std::chrono::microseconds>(next_burst - now)));
+        continue;
+      }
+      next_burst += burst_spacing;
+
+      for (size_t i = 0; i < burst_size; ++i) {
+        auto arrival = steady_clock::now();
+        if (parked.empty() && token_manager.triggers_allowed()) {
+          send_decision(arrival);
+        } else if (parked.size() < park_capacity) {
+          parked.push_back(arrival);
+          ++n_parked;
+          max_park_depth = std::max<uint64_t>(max_park_depth, parked.size());
+        } else {
+          ++n_dropped;
+        }
+      }
+    }
+
+    const double elapsed_s = std::chrono::duration<double>(steady_clock::now() - start).count();
+    auto time_map = livetime_counter->get_time_map();
+    double total_ms = 0;
+    for (const auto& [state, ms] : time_map) {
+      total_ms += ms;
+    }
+
+    std::printf("initial_tokens=%d tc_rate_hz=%.0f burst_size=%zu dfo_latency_us=%lu dfo_jitter_us=%lu "
+                "busy_period_ms=%lu busy_duration_ms=%lu\n",
+                initial_tokens,
+                tc_rate_hz,
+                burst_size,
+                static_cast<unsigned long>(dfo_latency_us),     // NOLINT(runtime/int)
+                static_cast<unsigned long>(dfo_jitter_us),      // NOLINT(runtime/int)
+                static_cast<unsigned long>(busy_period_ms),     // NOLINT(runtime/int)
+                static_cast<unsigned long>(busy_duration_ms));  // NOLINT(runtime/int)
+    std::printf("sent=%lu parked=%lu dropped=%lu max_park_depth=%lu still_parked=%zu rate_hz=%.1f\n",
+                static_cast<unsigned long>(n_sent),         // NOLINT(runtime/int)
+                static_cast<unsigned long>(n_parked),       // NOLINT(runtime/int)
+                static_cast<unsigned long>(n_dropped),      // NOLINT(runtime/int)
+                static_cast<unsigned long>(max_park_depth), // NOLINT(runtime/int)
+                parked.size(),
+                n_sent / elapsed_s);
+    std::printf("latency_us_p50=%lu latency_us_p99=%lu latency_us_p999=%lu\n",
+                static_cast<unsigned long>(decision_latency.quantile(0.5)),   // NOLINT(runtime/int)
+                static_cast<unsigned long>(decision_latency.quantile(0.99)),  // NOLINT(runtime/int)
+                static_cast<unsigned long>(decision_latency.quantile(0.999))); // NOLINT(runtime/int)
+    std::printf("livetime_live=%.3f livetime_dead=%.3f livetime_paused=%.3f\n",
+                total_ms > 0 ? time_map[dunedaq::trigger::LivetimeCounter::State::kLive] / total_ms : 0,
+                total_ms > 0 ? time_map[dunedaq::trigger::LivetimeCounter::State::kDead] / total_ms : 0,
+                total_ms > 0 ? time_map[dunedaq::trigger::LivetimeCounter::State::kPaused] / total_ms : 0);
+  }
+
+  dunedaq::get_iomanager()->reset();
+  return 0;
+}
@@ -11,13 +11,21 @@
 #include "trgdataformats/TriggerPrimitive.hpp"
 #include "hdf5libs/HDF5RawDataFile.hpp"
 
+#include "../../src/trigger/LatencyHistogram.hpp" // NOLINT
+
 #include <daqdataformats/Fragment.hpp>
 #include <daqdataformats/SourceID.hpp>
 #include <daqdataformats/TimeSlice.hpp>
 #include <daqdataformats/TimeSliceHeader.hpp>
 #include <daqdataformats/Types.hpp>
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
 #include <iostream>
+#include <thread>
+#include <vector>
 
 using dunedaq::trgdataformats::TriggerActivity;
 using dunedaq::trgdataformats::TriggerActivityData;
@@ -121,6 +129,154 @@ print_tcs(std::unique_ptr<dunedaq::daqdataformats::Fragment>&& frag)
   }
 }
 
+// ---------------------------------------------------------------------------
+// Scan mode: a parallel summary pass over TB-scale files. Records are
+// fanned across threads (each with its own file handle), each fragment
+// is processed one at a time so memory stays flat regardless of record
+// size, and only headers plus the fields being histogrammed are decoded.
+// Aggregation is shared atomic counters and LatencyHistograms, whose
+// multi-writer relaxed increments make merging free.
+// ---------------------------------------------------------------------------
+
+struct ScanStats
+{
+  std::atomic<uint64_t> n_records{ 0 };      // NOLINT(build/unsigned)
+  std::atomic<uint64_t> n_tp_fragments{ 0 }; // NOLINT(build/unsigned)
+  std::atomic<uint64_t> n_ta_fragments{ 0 }; // NOLINT(build/unsigned)
+  std::atomic<uint64_t> n_tc_fragments{ 0 }; // NOLINT(build/unsigned)
+  std::atomic<uint64_t> n_tps{ 0 };          // NOLINT(build/unsigned)
+  std::atomic<uint64_t> n_tas{ 0 };          // NOLINT(build/unsigned)
+  std::atomic<uint64_t> n_tcs{ 0 };          // NOLINT(build/unsigned)
+  std::atomic<uint64_t> n_bytes{ 0 };        // NOLINT(build/unsigned)
+
+  // Log2-binned distributions; bin units are the field's own units
+  dunedaq::trigger::LatencyHistogram tps_per_fragment;
+  dunedaq::trigger::LatencyHistogram tp_adc_integral;
+  dunedaq::trigger::LatencyHistogram tp_time_over_threshold;
+  dunedaq::trigger::LatencyHistogram ta_inputs;
+  dunedaq::trigger::LatencyHistogram tc_inputs;
+};
+
+void
+scan_fragment(std::unique_ptr<dunedaq::daqdataformats::Fragment> frag, bool histos, ScanStats& stats)
+{
+  size_t payload_size = frag->get_size() - sizeof(dunedaq::daqdataformats::FragmentHeader);
+  stats.n_bytes += frag->get_size();
+
+  switch (frag->get_fragment_type()) {
+    case dunedaq::daqdataformats::FragmentType::kTriggerPrimitive: {
+      // TP count comes from the header alone; the payload is only
+      // touched when field histograms are requested
+      size_t n_tps = payload_size / sizeof(TriggerPrimitive);
+      ++stats.n_tp_fragments;
+      stats.n_tps += n_tps;
+      stats.tps_per_fragment.record_value(n_tps);
+      if (histos) {
+        const TriggerPrimitive* prim = reinterpret_cast<TriggerPrimitive*>(frag->get_data());
+        for (size_t i = 0; i < n_tps; ++i, ++prim) {
+          stats.tp_adc_integral.record_value(prim->adc_integral);
+          stats.tp_time_over_threshold.record_value(prim->time_over_threshold);
+        }
+      }
+      break;
+    }
+    case dunedaq::daqdataformats::FragmentType::kTriggerActivity: {
+      ++stats.n_ta_fragments;
+      char* buffer = static_cast<char*>(frag->get_data());
+      size_t offset = 0;
+      while (offset < payload_size) {
+        const TriggerActivity* activity = reinterpret_cast<TriggerActivity*>(buffer + offset);
+        ++stats.n_tas;
+        stats.ta_inputs.record_value(activity->n_inputs);
+        offset += sizeof(TriggerActivity) + activity->n_inputs * sizeof(TriggerActivity::input_t);
+      }
+      break;
+    }
+    case dunedaq::daqdataformats::FragmentType::kTriggerCandidate: {
+      ++stats.n_tc_fragments;
+      char* buffer = static_cast<char*>(frag->get_data());
+      size_t offset = 0;
+      while (offset < payload_size) {
+        const TriggerCandidate* candidate = reinterpret_cast<TriggerCandidate*>(buffer + offset);
+        ++stats.n_tcs;
+        stats.tc_inputs.record_value(candidate->n_inputs);
+        offset += sizeof(TriggerCandidate) + candidate->n_inputs * sizeof(TriggerCandidate::input_t);
+      }
+      break;
+    }
+    default:
+      break;
+  }
+}
+
+int
+scan_file(const std::string& in_filename, size_t n_threads, bool histos)
+{
+  std::vector<dunedaq::hdf5libs::HDF5RawDataFile::record_id_t> record_ids;
+  {
+    dunedaq::hdf5libs::HDF5RawDataFile probe(in_filename);
+    auto ids = probe.get_all_trigger_record_ids();
+    record_ids.assign(ids.begin(), ids.end());
+  }
+
+  ScanStats stats;
+  std::atomic<size_t> next_record{ 0 };
+  auto start_time = std::chrono::steady_clock::now();
+
+  // Records are handed out by an atomic cursor so slow records don't
+  // leave threads idle; each thread holds its own file handle
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < n_threads; ++t) {
+    threads.emplace_back([&] {
+      dunedaq::hdf5libs::HDF5RawDataFile hdf5file(in_filename);
+      while (true) {
+        size_t i = next_record.fetch_add(1);
+        if (i >= record_ids.size()) {
+          break;
+        }
+        auto frag_paths =
+          hdf5file.get_fragment_dataset_paths(record_ids[i], dunedaq::daqdataformats::SourceID::Subsystem::kTrigger);
+        for (auto const& frag_path : frag_paths) {
+          scan_fragment(hdf5file.get_frag_ptr(frag_path), histos, stats);
+        }
+        ++stats.n_records;
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  double elapsed_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+  std::printf("records=%lu tp_fragments=%lu ta_fragments=%lu tc_fragments=%lu\n",
+              static_cast<unsigned long>(stats.n_records.load()),      // NOLINT(runtime/int)
+              static_cast<unsigned long>(stats.n_tp_fragments.load()), // NOLINT(runtime/int)
+              static_cast<unsigned long>(stats.n_ta_fragments.load()), // NOLINT(runtime/int)
+              static_cast<unsigned long>(stats.n_tc_fragments.load())); // NOLINT(runtime/int)
+  std::printf("tps=%lu tas=%lu tcs=%lu bytes=%lu\n",
+              static_cast<unsigned long>(stats.n_tps.load()),   // NOLINT(runtime/int)
+              static_cast<unsigned long>(stats.n_tas.load()),   // NOLINT(runtime/int)
+              static_cast<unsigned long>(stats.n_tcs.load()),   // NOLINT(runtime/int)
+              static_cast<unsigned long>(stats.n_bytes.load())); // NOLINT(runtime/int)
+  std::printf("tps_per_fragment_p50=%lu tps_per_fragment_p99=%lu ta_inputs_p50=%lu ta_inputs_p99=%lu "
+              "tc_inputs_p50=%lu tc_inputs_p99=%lu\n",
+              static_cast<unsigned long>(stats.tps_per_fragment.quantile(0.5)),  // NOLINT(runtime/int)
+              static_cast<unsigned long>(stats.tps_per_fragment.quantile(0.99)), // NOLINT(runtime/int)
+              static_cast<unsigned long>(stats.ta_inputs.quantile(0.5)),         // NOLINT(runtime/int)
+              static_cast<unsigned long>(stats.ta_inputs.quantile(0.99)),        // NOLINT(runtime/int)
+              static_cast<unsigned long>(stats.tc_inputs.quantile(0.5)),         // NOLINT(runtime/int)
+              static_cast<unsigned long>(stats.tc_inputs.quantile(0.99)));       // NOLINT(runtime/int)
+  if (histos) {
+    std::printf("tp_adc_integral_p50=%lu tp_adc_integral_p99=%lu tp_tot_p50=%lu tp_tot_p99=%lu\n",
+                static_cast<unsigned long>(stats.tp_adc_integral.quantile(0.5)),        // NOLINT(runtime/int)
+                static_cast<unsigned long>(stats.tp_adc_integral.quantile(0.99)),       // NOLINT(runtime/int)
+                static_cast<unsigned long>(stats.tp_time_over_threshold.quantile(0.5)), // NOLINT(runtime/int)
+                static_cast<unsigned long>(stats.tp_time_over_threshold.quantile(0.99))); // NOLINT(runtime/int)
+  }
+  std::printf("elapsed_s=%.1f throughput_mb_s=%.1f\n", elapsed_s, stats.n_bytes.load() / elapsed_s * 1e-6);
+  return 0;
+}
+
 int
 main(int argc, char** argv)
 {
@@ -129,8 +285,21 @@ main(int argc, char** argv)
   std::string in_filename;
   app.add_option("-i,--input", in_filename, "Input HDF5 file");
 
+  bool scan = false;
+  app.add_flag("--scan", scan, "Summary scan: aggregate counts/histograms in parallel instead of printing contents");
+
+  size_t n_threads = std::max(1u, std::thread::hardware_concurrency() / 2);
+  app.add_option("-j,--jobs", n_threads, "Number of scan threads");
+
+  bool histos = false;
+  app.add_flag("--field-histos", histos, "In scan mode, also histogram TP ADC integral and time over threshold");
+
   CLI11_PARSE(app, argc, argv);
 
+  if (scan) {
+    return scan_file(in_filename, n_threads, histos);
+  }
+
   dunedaq::hdf5libs::HDF5RawDataFile hdf5file(in_filename);
 
   auto record_ids = hdf5file.get_all_trigger_record_ids();
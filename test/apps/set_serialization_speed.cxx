@@ -1,93 +1,379 @@
 /**
- * @file set_serialization_speed.cxx Test the amount of time it takes to serialize a TASet
+ * @file set_serialization_speed.cxx Benchmark and regression-gate TPSet serialization
+ *
+ * Times serialize and deserialize separately for every registered
+ * serialization format (msgpack, json) plus a raw overlay-blob memcpy
+ * baseline, across parameterized set sizes, tracking heap allocations
+ * per operation. Output is CSV on stdout so CI can archive and compare
+ * runs, and --fail-under turns any row into a hard threshold: the
+ * process exits non-zero if a measured rate drops below it, catching a
+ * serialization regression before deployment. This path handles every
+ * byte of trigger data that crosses an app boundary.
  *
  * This is part of the DUNE DAQ Application Framework, copyright 2020.
  * Licensing/copyright details are in the COPYING file that you should have
  * received with this code.
  */
 
-#include "logging/Logging.hpp"
 #include "serialization/Serialization.hpp"
 #include "trigger/TASet.hpp"
 #include "trigger/TPSet.hpp"
 #include "triggeralgs/TriggerPrimitive.hpp"
 #include "trgdataformats/Types.hpp"
 
+#include "CLI/CLI.hpp"
+
+#include <atomic>
 #include <chrono>
-#include <iostream>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
 #include <random>
+#include <string>
 #include <vector>
 
-// Return the current steady clock in microseconds
+// ---------------------------------------------------------------------------
+// Allocation accounting: every operator new in the process is counted, so
+// each measured section reports exactly the allocations its workload
+// performs (same approach as trigger_component_benchmarks.cxx)
+// ---------------------------------------------------------------------------
+
+static std::atomic<uint64_t> g_alloc_count{ 0 }; // NOLINT(build/unsigned)
+static std::atomic<uint64_t> g_alloc_bytes{ 0 }; // NOLINT(build/unsigned)
+
+void*
+operator new(std::size_t size)
+{
+  g_alloc_count.fetch_add(1, std::memory_order_relaxed);
+  g_alloc_bytes.fetch_add(size, std::memory_order_relaxed);
+  if (void* p = std::malloc(size)) { // NOLINT
+    return p;
+  }
+  throw std::bad_alloc();
+}
+
+void*
+operator new[](std::size_t size)
+{
+  return operator new(size);
+}
+
+void
+operator delete(void* p) noexcept
+{
+  std::free(p); // NOLINT
+}
+
+void
+operator delete(void* p, std::size_t) noexcept
+{
+  std::free(p); // NOLINT
+}
+
+void
+operator delete[](void* p) noexcept
+{
+  std::free(p); // NOLINT
+}
+
+void
+operator delete[](void* p, std::size_t) noexcept
+{
+  std::free(p); // NOLINT
+}
+
+namespace {
+
+using dunedaq::trigger::TPSet;
+
+// Return the current steady clock in nanoseconds
 inline uint64_t // NOLINT(build/unsigned)
-now_us()
+now_ns()
 {
   using namespace std::chrono;
   // std::chrono is the worst
-  return duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+  return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
 }
 
+TPSet
+make_tpset(size_t seqno, size_t tps_per_set, std::default_random_engine& generator)
+{
+  std::uniform_int_distribution<int> uniform(0, 1000);
+  TPSet set;
+  set.seqno = seqno + 1;
+  set.start_time = (seqno + 1) * 5000;
+  set.end_time = (seqno + 2) * 5000 - 1;
+  for (size_t j = 0; j < tps_per_set; ++j) {
+    triggeralgs::TriggerPrimitive tp;
+    tp.time_start = 1234963454;
+    tp.time_peak = tp.time_start + 10000;
+    tp.time_over_threshold = uniform(generator);
+    tp.channel = uniform(generator);
+    tp.adc_integral = uniform(generator);
+    tp.adc_peak = uniform(generator);
+    tp.detid = 1;
+    tp.type = triggeralgs::TriggerPrimitive::Type::kUnknown;
+    tp.algorithm = triggeralgs::TriggerPrimitive::Algorithm::kSimpleThreshold;
+    tp.flag = 1;
+    set.objects.push_back(tp);
+  }
+  return set;
+}
+
+// The raw overlay baseline: the header fields memcpy'd into a fixed
+// layout followed by the objects array as one contiguous blob. This is
+// the floor any general-purpose format is measured against.
+struct OverlayHeader
+{
+  TPSet::seqno_t seqno;
+  dunedaq::daqdataformats::run_number_t run_number;
+  uint32_t origin_subsystem; // NOLINT(build/unsigned)
+  uint32_t origin_id;        // NOLINT(build/unsigned)
+  uint32_t type;             // NOLINT(build/unsigned)
+  TPSet::timestamp_t start_time;
+  TPSet::timestamp_t end_time;
+  uint32_t n_objects; // NOLINT(build/unsigned)
+};
+
+std::vector<uint8_t> // NOLINT(build/unsigned)
+overlay_serialize(const TPSet& set)
+{
+  OverlayHeader header;
+  header.seqno = set.seqno;
+  header.run_number = set.run_number;
+  header.origin_subsystem = static_cast<uint32_t>(set.origin.subsystem); // NOLINT(build/unsigned)
+  header.origin_id = set.origin.id;
+  header.type = static_cast<uint32_t>(set.type); // NOLINT(build/unsigned)
+  header.start_time = set.start_time;
+  header.end_time = set.end_time;
+  header.n_objects = set.objects.size();
+  const size_t blob_bytes = set.objects.size() * sizeof(dunedaq::trgdataformats::TriggerPrimitive);
+  std::vector<uint8_t> bytes(sizeof(header) + blob_bytes); // NOLINT(build/unsigned)
+  std::memcpy(bytes.data(), &header, sizeof(header));
+  std::memcpy(bytes.data() + sizeof(header), set.objects.begin(), blob_bytes);
+  return bytes;
+}
+
+TPSet
+overlay_deserialize(const std::vector<uint8_t>& bytes) // NOLINT(build/unsigned)
+{
+  OverlayHeader header;
+  std::memcpy(&header, bytes.data(), sizeof(header));
+  TPSet set;
+  set.seqno = header.seqno;
+  set.run_number = header.run_number;
+  set.origin = dunedaq::daqdataformats::SourceID{
+    static_cast<dunedaq::daqdataformats::SourceID::Subsystem>(header.origin_subsystem), header.origin_id
+  };
+  set.type = static_cast<TPSet::Type>(header.type);
+  set.start_time = header.start_time;
+  set.end_time = header.end_time;
+  set.objects.reserve(header.n_objects);
+  dunedaq::trgdataformats::TriggerPrimitive tp;
+  for (uint32_t i = 0; i < header.n_objects; ++i) { // NOLINT(build/unsigned)
+    std::memcpy(&tp, bytes.data() + sizeof(header) + i * sizeof(tp), sizeof(tp));
+    set.objects.push_back(tp);
+  }
+  return set;
+}
+
+struct Measurement
+{
+  std::string format;
+  std::string direction; // "serialize" or "deserialize"
+  size_t tps_per_set;
+  size_t n_sets;
+  double ns_per_set;
+  double mtp_per_s;
+  double allocs_per_set;
+  double bytes_per_set;
+  size_t serialized_bytes; // size of one serialized set
+};
+
 void
-time_serialization(int tps_per_set)
+print_row(const Measurement& m)
 {
-  const int N = 100000;
-  int total = 0;
+  std::printf("%s,%s,%zu,%zu,%.1f,%.4f,%.2f,%.1f,%zu\n",
+              m.format.c_str(),
+              m.direction.c_str(),
+              m.tps_per_set,
+              m.n_sets,
+              m.ns_per_set,
+              m.mtp_per_s,
+              m.allocs_per_set,
+              m.bytes_per_set,
+              m.serialized_bytes);
+}
 
-  std::default_random_engine generator;
-  std::uniform_int_distribution<int> uniform(0, 1000);
+// Run `op` n_sets times and fill the timing/allocation fields of `m`
+template<class OP>
+void
+measure(Measurement& m, size_t n_sets, OP&& op)
+{
+  const uint64_t allocs0 = g_alloc_count.load(); // NOLINT(build/unsigned)
+  const uint64_t bytes0 = g_alloc_bytes.load();  // NOLINT(build/unsigned)
+  const uint64_t t0 = now_ns();                  // NOLINT(build/unsigned)
+  for (size_t i = 0; i < n_sets; ++i) {
+    op(i);
+  }
+  const uint64_t dt = now_ns() - t0; // NOLINT(build/unsigned)
+  m.n_sets = n_sets;
+  m.ns_per_set = static_cast<double>(dt) / n_sets;
+  m.mtp_per_s = dt > 0 ? static_cast<double>(m.tps_per_set) * n_sets * 1e3 / dt : 0.0;
+  m.allocs_per_set = static_cast<double>(g_alloc_count.load() - allocs0) / n_sets;
+  m.bytes_per_set = static_cast<double>(g_alloc_bytes.load() - bytes0) / n_sets;
+}
 
-  std::vector<dunedaq::trigger::TPSet> sets;
-  for (int i = 0; i < N; ++i) {
-    dunedaq::trigger::TPSet set;
-    set.seqno = i + 1;
-    set.start_time = (i + 1) * 5000;
-    set.end_time = (i + 2) * 5000 - 1;
-    for (int j = 0; j < tps_per_set; ++j) {
-      triggeralgs::TriggerPrimitive tp;
-      tp.time_start = 1234963454;
-      tp.time_peak = tp.time_start + 10000;
-      tp.time_over_threshold = uniform(generator);
-      tp.channel = uniform(generator);
-      tp.adc_integral = uniform(generator);
-      tp.adc_peak = uniform(generator);
-      tp.detid = 1;
-      tp.type = triggeralgs::TriggerPrimitive::Type::kUnknown;
-      tp.algorithm = triggeralgs::TriggerPrimitive::Algorithm::kSimpleThreshold;
-      tp.flag = 1;
-
-      set.objects.push_back(tp);
-    }
-    sets.push_back(set);
+// One format at one set size: serialize and deserialize measured
+// separately, on distinct pre-built inputs so neither measures the other
+std::vector<Measurement>
+bench_format(const std::string& format, size_t tps_per_set, size_t n_sets)
+{
+  std::default_random_engine generator(42);
+  std::vector<TPSet> sets;
+  sets.reserve(n_sets);
+  for (size_t i = 0; i < n_sets; ++i) {
+    sets.push_back(make_tpset(i, tps_per_set, generator));
   }
 
-  uint64_t start_time = now_us(); // NOLINT(build/unsigned)
+  // NOLINTNEXTLINE(build/unsigned)
+  std::vector<std::vector<uint8_t>> serialized(n_sets);
+  Measurement ser{ format, "serialize", tps_per_set, 0, 0, 0, 0, 0, 0 };
+  Measurement deser{ format, "deserialize", tps_per_set, 0, 0, 0, 0, 0, 0 };
+  uint64_t checksum = 0; // NOLINT(build/unsigned)
 
-  for (int i = 0; i < N; ++i) {
-    // NOLINTNEXTLINE(build/unsigned)
-    std::vector<uint8_t> bytes = dunedaq::serialization::serialize(sets[i], dunedaq::serialization::kMsgPack);
-    dunedaq::trigger::TPSet set_recv = dunedaq::serialization::deserialize<dunedaq::trigger::TPSet>(bytes);
-    total += set_recv.seqno;
+  if (format == "overlay") {
+    measure(ser, n_sets, [&](size_t i) { serialized[i] = overlay_serialize(sets[i]); });
+    measure(deser, n_sets, [&](size_t i) { checksum += overlay_deserialize(serialized[i]).seqno; });
+  } else {
+    const auto stype = dunedaq::serialization::from_string(format);
+    measure(ser, n_sets, [&](size_t i) { serialized[i] = dunedaq::serialization::serialize(sets[i], stype); });
+    measure(deser, n_sets, [&](size_t i) {
+      checksum += dunedaq::serialization::deserialize<TPSet>(serialized[i]).seqno;
+    });
+  }
+  if (checksum != n_sets * (n_sets + 1) / 2) {
+    std::fprintf(stderr, "ERROR: %s round-trip corrupted seqno checksum at %zu TPs/set\n", format.c_str(), tps_per_set);
+    std::exit(1);
   }
-  uint64_t end_time = now_us(); // NOLINT(build/unsigned)
+  ser.serialized_bytes = serialized.empty() ? 0 : serialized.front().size();
+  deser.serialized_bytes = ser.serialized_bytes;
+  return { ser, deser };
+}
 
-  double time_taken_s = 1e-6 * (end_time - start_time);
-  double msg_kHz = 1e-3 * N / time_taken_s;
-  double tp_kHz = 1e-3 * tps_per_set * N / time_taken_s;
-  TLOG() << "Sent " << N << " messages in " << time_taken_s << " (" << msg_kHz << " kHz of msgs, " << tp_kHz
-         << " kHz of TPs) " << total;
+// A fail threshold, parsed from "format:direction:tps_per_set:min_mtps".
+// CI generates these from a known-good run; any matching measurement
+// below min_mtps fails the process.
+struct Threshold
+{
+  std::string format;
+  std::string direction;
+  size_t tps_per_set;
+  double min_mtp_per_s;
+};
+
+bool
+parse_threshold(const std::string& spec, Threshold& t)
+{
+  const size_t a = spec.find(':');
+  const size_t b = spec.find(':', a + 1);
+  const size_t c = spec.find(':', b + 1);
+  if (a == std::string::npos || b == std::string::npos || c == std::string::npos) {
+    return false;
+  }
+  t.format = spec.substr(0, a);
+  t.direction = spec.substr(a + 1, b - a - 1);
+  try {
+    t.tps_per_set = std::stoul(spec.substr(b + 1, c - b - 1));
+    t.min_mtp_per_s = std::stod(spec.substr(c + 1));
+  } catch (const std::exception&) {
+    return false;
+  }
+  return true;
 }
 
+} // namespace
+
 int
-main()
+main(int argc, char** argv)
 {
-  std::vector<int> n_tps{ 0, 1, 10, 100, 1000 };
-  for (auto n : n_tps) {
-    TLOG() << n << " TPs per set: " << std::flush;
-    time_serialization(n);
+  CLI::App app{ "TPSet serialization benchmark and regression gate" };
+
+  std::vector<size_t> sizes{ 1, 10, 100, 1000, 10000, 100000 };
+  app.add_option("-s,--sizes", sizes, "TPs per set to measure");
+  std::vector<std::string> formats{ "msgpack", "json", "overlay" };
+  app.add_option("-f,--formats", formats, "Formats to measure (msgpack, json, overlay)");
+  size_t tp_budget = 2000000;
+  app.add_option("--tp-budget", tp_budget, "Total TPs per (format, size) measurement; sets iteration count");
+  std::vector<std::string> threshold_specs;
+  app.add_option("--fail-under",
+                 threshold_specs,
+                 "Fail threshold format:direction:tps_per_set:min_Mtps, e.g. msgpack:serialize:1000:50");
+
+  CLI11_PARSE(app, argc, argv);
+
+  std::vector<Threshold> thresholds;
+  for (const auto& spec : threshold_specs) {
+    Threshold t;
+    if (!parse_threshold(spec, t)) {
+      std::fprintf(stderr, "ERROR: bad --fail-under spec '%s'\n", spec.c_str());
+      return 2;
+    }
+    thresholds.push_back(t);
   }
 
+  std::printf("format,direction,tps_per_set,n_sets,ns_per_set,Mtp_per_s,allocs_per_set,heap_bytes_per_set,"
+              "serialized_bytes\n");
+
+  std::vector<Measurement> results;
+  for (const auto& format : formats) {
+    // json decodes every TP field by field and is orders of magnitude
+    // slower; give it a smaller budget so a full sweep stays minutes
+    const size_t budget = format == "json" ? tp_budget / 10 : tp_budget;
+    for (size_t tps : sizes) {
+      const size_t n_sets = std::max<size_t>(10, budget / std::max<size_t>(1, tps));
+      for (const auto& m : bench_format(format, tps, n_sets)) {
+        print_row(m);
+        results.push_back(m);
+      }
+    }
+  }
+
+  // Smoke-check that TASet still round-trips with the generic path
   dunedaq::trigger::TASet taset;
   // NOLINTNEXTLINE(build/unsigned)
   std::vector<uint8_t> bytes = dunedaq::serialization::serialize(taset, dunedaq::serialization::kMsgPack);
   dunedaq::trigger::TASet set_recv = dunedaq::serialization::deserialize<dunedaq::trigger::TASet>(bytes);
+
+  int failures = 0;
+  for (const auto& t : thresholds) {
+    bool matched = false;
+    for (const auto& m : results) {
+      if (m.format == t.format && m.direction == t.direction && m.tps_per_set == t.tps_per_set) {
+        matched = true;
+        if (m.mtp_per_s < t.min_mtp_per_s) {
+          std::fprintf(stderr,
+                       "FAIL: %s %s at %zu TPs/set measured %.4f Mtp/s, threshold %.4f\n",
+                       t.format.c_str(),
+                       t.direction.c_str(),
+                       t.tps_per_set,
+                       m.mtp_per_s,
+                       t.min_mtp_per_s);
+          ++failures;
+        }
+      }
+    }
+    if (!matched) {
+      std::fprintf(stderr,
+                   "FAIL: threshold %s:%s:%zu matched no measurement (check --sizes/--formats)\n",
+                   t.format.c_str(),
+                   t.direction.c_str(),
+                   t.tps_per_set);
+      ++failures;
+    }
+  }
+
+  return failures == 0 ? 0 : 1;
 }
@@ -0,0 +1,252 @@
+/**
+ * @file trigger_replay_benchmark.cxx Offline whole-chain trigger throughput benchmark
+ *
+ * Runs TPSets through the trigger chain - channel filter compaction, a
+ * TriggerActivityMaker, a TriggerCandidateMaker, and an MLT-equivalent
+ * decision-building stage - in a single process with no iomanager hops,
+ * as fast as the CPU allows. Input is either a pre-formed .tpstream file
+ * (see TPStreamFile.hpp, producible with generate_tpset_from_hdf5 -o) or
+ * a synthetic TP stream. Reports per-stage throughput, whole-chain
+ * p50/p99/p999 per-set latency and peak RSS, so algorithm and
+ * infrastructure changes can be gated on end-to-end numbers before they
+ * touch the detector.
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#include "trigger/AlgorithmPlugins.hpp"
+#include "trigger/TPSet.hpp"
+
+#include "../../src/trigger/LatencyHistogram.hpp" // NOLINT
+#include "../../src/trigger/TPStreamFile.hpp"     // NOLINT
+
+#include "daqdataformats/ComponentRequest.hpp"
+#include "dfmessages/TriggerDecision.hpp"
+#include "triggeralgs/TriggerActivity.hpp"
+#include "triggeralgs/TriggerCandidate.hpp"
+
+#include "CLI/CLI.hpp"
+
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+using dunedaq::trigger::LatencyHistogram;
+using dunedaq::trigger::TPSet;
+
+namespace {
+
+inline uint64_t // NOLINT(build/unsigned)
+now_ns()
+{
+  using namespace std::chrono;
+  return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+// Synthetic input: `n_sets` windows of `tps_per_set` time-ordered TPs
+std::vector<TPSet>
+make_synthetic_tpsets(size_t n_sets, size_t tps_per_set)
+{
+  std::vector<TPSet> sets;
+  sets.reserve(n_sets);
+  const uint64_t window = 10000; // NOLINT(build/unsigned)
+  for (size_t i = 0; i < n_sets; ++i) {
+    TPSet set;
+    set.seqno = i;
+    set.start_time = (i + 1) * window;
+    set.end_time = (i + 2) * window;
+    set.type = TPSet::kPayload;
+    set.origin =
+      dunedaq::daqdataformats::SourceID{ dunedaq::daqdataformats::SourceID::Subsystem::kTrigger, 0 };
+    for (size_t j = 0; j < tps_per_set; ++j) {
+      triggeralgs::TriggerPrimitive tp;
+      tp.time_start = set.start_time + j * window / (tps_per_set + 1);
+      tp.time_peak = tp.time_start + 10;
+      tp.time_over_threshold = 20 + j % 100;
+      tp.channel = static_cast<int>(j * 7 % 2560);
+      tp.adc_integral = 1000 + j % 500;
+      tp.adc_peak = 100 + j % 50;
+      tp.detid = 1;
+      tp.type = triggeralgs::TriggerPrimitive::Type::kTPC;
+      tp.algorithm = triggeralgs::TriggerPrimitive::Algorithm::kSimpleThreshold;
+      set.objects.push_back(tp);
+    }
+    sets.push_back(set);
+  }
+  return sets;
+}
+
+struct StageStats
+{
+  uint64_t ns = 0;     // NOLINT(build/unsigned)
+  uint64_t n_in = 0;   // NOLINT(build/unsigned)
+  uint64_t n_out = 0;  // NOLINT(build/unsigned)
+
+  void report(const char* name) const
+  {
+    double mobj_per_s = ns > 0 ? static_cast<double>(n_in) * 1e3 / ns : 0.0;
+    std::printf("%-18s %12lu in %12lu out %10.1f ms %10.3f Mobj/s\n",
+                name,
+                static_cast<unsigned long>(n_in),  // NOLINT(runtime/int)
+                static_cast<unsigned long>(n_out), // NOLINT(runtime/int)
+                ns / 1e6,
+                mobj_per_s);
+  }
+};
+
+long
+peak_rss_kb()
+{
+  struct rusage ru;
+  getrusage(RUSAGE_SELF, &ru);
+  return ru.ru_maxrss;
+}
+
+} // namespace
+
+int
+main(int argc, char** argv)
+{
+  CLI::App app{ "Offline single-process trigger chain throughput benchmark" };
+
+  std::string input_file;
+  app.add_option("-i,--input", input_file, "Input .tpstream file (synthetic TPs if omitted)");
+  std::string ta_plugin = "TriggerActivityMakerPrescalePlugin";
+  app.add_option("--ta-plugin", ta_plugin, "TriggerActivityMaker plugin name");
+  std::string tc_plugin = "TriggerCandidateMakerPrescalePlugin";
+  app.add_option("--tc-plugin", tc_plugin, "TriggerCandidateMaker plugin name");
+  size_t n_sets = 100000;
+  app.add_option("-n,--sets", n_sets, "Number of synthetic TPSets");
+  size_t tps_per_set = 32;
+  app.add_option("--tps-per-set", tps_per_set, "TPs per synthetic TPSet");
+  int filter_reject_modulus = 0;
+  app.add_option("--filter-reject-modulus", filter_reject_modulus,
+                 "Reject TPs whose channel is divisible by this (0: keep all, scan still runs)");
+
+  CLI11_PARSE(app, argc, argv);
+
+  // -------------------------------------------------------------------------
+  // Input
+  // -------------------------------------------------------------------------
+  std::vector<TPSet> sets;
+  if (!input_file.empty()) {
+    dunedaq::trigger::TPStreamReader reader(input_file);
+    TPSet set;
+    while (reader.read_next(set)) {
+      sets.push_back(set);
+    }
+    std::printf("Read %zu TPSets from %s\n", sets.size(), input_file.c_str());
+  } else {
+    sets = make_synthetic_tpsets(n_sets, tps_per_set);
+    std::printf("Generated %zu synthetic TPSets of %zu TPs\n", sets.size(), tps_per_set);
+  }
+
+  auto ta_maker = dunedaq::trigger::make_ta_maker(ta_plugin);
+  auto tc_maker = dunedaq::trigger::make_tc_maker(tc_plugin);
+
+  // -------------------------------------------------------------------------
+  // Chain
+  // -------------------------------------------------------------------------
+  StageStats filter_stats, ta_stats, tc_stats, decision_stats;
+  LatencyHistogram chain_latency; // whole-chain ns per set
+
+  std::vector<triggeralgs::TriggerActivity> tas;
+  std::vector<triggeralgs::TriggerCandidate> tcs;
+  uint64_t n_decisions = 0;       // NOLINT(build/unsigned)
+  uint64_t trigger_number = 0;    // NOLINT(build/unsigned)
+
+  uint64_t run_t0 = now_ns(); // NOLINT(build/unsigned)
+  for (TPSet& set : sets) {
+    uint64_t set_t0 = now_ns(); // NOLINT(build/unsigned)
+
+    // Stage 1: channel filter compaction, same in-place remove_if shape as
+    // TPChannelFilter but with a synthetic predicate (no channel map here)
+    uint64_t t0 = now_ns(); // NOLINT(build/unsigned)
+    filter_stats.n_in += set.objects.size();
+    if (filter_reject_modulus > 1) {
+      auto it = std::remove_if(set.objects.begin(), set.objects.end(), [&](const triggeralgs::TriggerPrimitive& p) {
+        return p.channel % filter_reject_modulus == 0;
+      });
+      set.objects.erase(it, set.objects.end());
+    }
+    filter_stats.n_out += set.objects.size();
+    uint64_t t1 = now_ns(); // NOLINT(build/unsigned)
+    filter_stats.ns += t1 - t0;
+
+    // Stage 2: TriggerActivityMaker
+    tas.clear();
+    for (const auto& tp : set.objects) {
+      ta_maker->operator()(tp, tas);
+    }
+    ta_stats.n_in += set.objects.size();
+    ta_stats.n_out += tas.size();
+    uint64_t t2 = now_ns(); // NOLINT(build/unsigned)
+    ta_stats.ns += t2 - t1;
+
+    // Stage 3: TriggerCandidateMaker
+    tcs.clear();
+    for (const auto& ta : tas) {
+      tc_maker->operator()(ta, tcs);
+    }
+    tc_stats.n_in += tas.size();
+    tc_stats.n_out += tcs.size();
+    uint64_t t3 = now_ns(); // NOLINT(build/unsigned)
+    tc_stats.ns += t3 - t2;
+
+    // Stage 4: MLT-equivalent decision building - one TriggerDecision per
+    // TC with a component request per (synthetic) readout link, the same
+    // shape the MLT emits, but with no inhibit/merge bookkeeping
+    for (const auto& tc : tcs) {
+      dfmessages::TriggerDecision decision;
+      decision.trigger_number = ++trigger_number;
+      decision.run_number = 1;
+      decision.trigger_timestamp = tc.time_candidate;
+      decision.readout_type = dunedaq::dfmessages::ReadoutType::kLocalized;
+      for (uint32_t link = 0; link < 10; ++link) { // NOLINT(build/unsigned)
+        dunedaq::daqdataformats::ComponentRequest request;
+        request.component =
+          dunedaq::daqdataformats::SourceID{ dunedaq::daqdataformats::SourceID::Subsystem::kDetectorReadout, link };
+        request.window_begin = tc.time_start;
+        request.window_end = tc.time_end;
+        decision.components.push_back(request);
+      }
+      ++n_decisions;
+    }
+    decision_stats.n_in += tcs.size();
+    decision_stats.n_out = n_decisions;
+    uint64_t t4 = now_ns(); // NOLINT(build/unsigned)
+    decision_stats.ns += t4 - t3;
+
+    chain_latency.record_value(t4 - set_t0);
+  }
+  uint64_t run_ns = now_ns() - run_t0; // NOLINT(build/unsigned)
+
+  // -------------------------------------------------------------------------
+  // Report
+  // -------------------------------------------------------------------------
+  std::printf("\n%-18s %15s %16s %13s %16s\n", "stage", "objects in", "objects out", "time", "throughput");
+  filter_stats.report("channel filter");
+  ta_stats.report("activity maker");
+  tc_stats.report("candidate maker");
+  decision_stats.report("decision builder");
+
+  std::printf("\nWhole chain: %zu sets in %.1f ms (%.1f kset/s)\n",
+              sets.size(),
+              run_ns / 1e6,
+              run_ns > 0 ? static_cast<double>(sets.size()) * 1e6 / run_ns : 0.0);
+  std::printf("Per-set latency: p50 %lu ns, p99 %lu ns, p999 %lu ns\n",
+              static_cast<unsigned long>(chain_latency.quantile(0.5)),   // NOLINT(runtime/int)
+              static_cast<unsigned long>(chain_latency.quantile(0.99)),  // NOLINT(runtime/int)
+              static_cast<unsigned long>(chain_latency.quantile(0.999))); // NOLINT(runtime/int)
+  std::printf("Peak RSS: %ld kB\n", peak_rss_kb());
+
+  return 0;
+}
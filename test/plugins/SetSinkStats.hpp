@@ -0,0 +1,203 @@
+/**
+ * @file SetSinkStats.hpp
+ *
+ * Measurement accumulator shared by TPSetSink and TASetSink, so any
+ * chain prefix can be benchmarked by terminating it with a sink instead
+ * of bolting external rate-estimation scripts onto the queues.
+ *
+ * This is part of the DUNE DAQ Software Suite, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#ifndef TRIGGER_TEST_PLUGINS_SETSINKSTATS_HPP_
+#define TRIGGER_TEST_PLUGINS_SETSINKSTATS_HPP_
+
+#include "../../src/trigger/LatencyHistogram.hpp" // NOLINT
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <sstream>
+#include <string>
+
+namespace dunedaq::trigger {
+
+/**
+ * @brief Lock-free receive-side statistics for a Set-draining sink
+ *
+ * record() is called from the sink's single consumer thread for every
+ * received set and costs a handful of relaxed atomic increments, cheap
+ * enough to keep up with full TP rate. It accumulates, per origin
+ * element, set and object counts and seqno gap counts in a fixed
+ * open-addressed table (the same scheme TriggerZipper uses for its
+ * per-stream stats), and globally a set-size distribution and the
+ * distribution of data-time vs wall-time lag: how far the data clock of
+ * arriving payload sets has fallen behind the wall clock since the
+ * first set, converted through the configured data clock frequency.
+ *
+ * report() renders one machine-readable key=value line - totals,
+ * interval rates since the previous report, lag and size percentiles,
+ * and per-origin counters - for periodic emission from the work loop
+ * and a final summary at stop.
+ */
+template<class SET>
+class SetSinkStats
+{
+public:
+  static constexpr size_t s_max_origins = 64;
+
+  explicit SetSinkStats(uint64_t clock_frequency_hz) // NOLINT(build/unsigned)
+    : m_clock_frequency_hz(clock_frequency_hz)
+  {}
+
+  // Called from the consumer thread for every received set
+  void record(const SET& set)
+  {
+    const uint64_t wall_ns = now_ns(); // NOLINT(build/unsigned)
+
+    OriginStats& origin = find_or_claim(set.origin.id);
+    origin.n_sets.fetch_add(1, std::memory_order_relaxed);
+    origin.n_objects.fetch_add(set.objects.size(), std::memory_order_relaxed);
+    if (origin.seen && set.seqno != origin.last_seqno + 1) {
+      const uint64_t gap = // NOLINT(build/unsigned)
+        set.seqno > origin.last_seqno ? set.seqno - origin.last_seqno - 1 : 1;
+      origin.n_gaps.fetch_add(gap, std::memory_order_relaxed);
+    }
+    origin.last_seqno = set.seqno;
+    origin.seen = true;
+
+    if (set.type != SET::Type::kPayload) {
+      return;
+    }
+    m_set_size.record_value(set.objects.size());
+
+    if (!m_have_baseline) {
+      m_baseline_wall_ns = wall_ns;
+      m_baseline_data_time = set.start_time;
+      m_have_baseline = true;
+      return;
+    }
+    // Lag of the data clock behind the wall clock, both measured from
+    // the first payload set. Negative lag (data running ahead, e.g. a
+    // faster-than-real-time replay) is clamped to zero
+    const int64_t wall_us = (wall_ns - m_baseline_wall_ns) / 1000;
+    const int64_t data_us =
+      static_cast<int64_t>((set.start_time - m_baseline_data_time) * 1e6 / m_clock_frequency_hz);
+    const int64_t lag_us = wall_us - data_us;
+    m_lag.record_value(lag_us > 0 ? static_cast<uint64_t>(lag_us) : 0); // NOLINT(build/unsigned)
+  }
+
+  // One key=value line with totals, rates over the interval since the
+  // previous report() call, percentiles and per-origin counters. Must be
+  // called from a single thread (the work loop, and once at stop)
+  std::string report()
+  {
+    const uint64_t wall_ns = now_ns(); // NOLINT(build/unsigned)
+    uint64_t total_sets = 0;           // NOLINT(build/unsigned)
+    uint64_t total_objects = 0;        // NOLINT(build/unsigned)
+    uint64_t total_gaps = 0;           // NOLINT(build/unsigned)
+
+    std::ostringstream out;
+    size_t n_origins = 0;
+    for (auto& slot : m_origins) {
+      const uint32_t id = slot.id.load(std::memory_order_acquire); // NOLINT(build/unsigned)
+      if (id == s_unclaimed) {
+        continue;
+      }
+      const uint64_t n_sets = slot.n_sets.load(std::memory_order_relaxed);       // NOLINT(build/unsigned)
+      const uint64_t n_objects = slot.n_objects.load(std::memory_order_relaxed); // NOLINT(build/unsigned)
+      const uint64_t n_gaps = slot.n_gaps.load(std::memory_order_relaxed);       // NOLINT(build/unsigned)
+      total_sets += n_sets;
+      total_objects += n_objects;
+      total_gaps += n_gaps;
+      ++n_origins;
+      out << " origin." << id << ".sets=" << n_sets << " origin." << id << ".objects=" << n_objects << " origin."
+          << id << ".gaps=" << n_gaps;
+    }
+
+    const double interval_s = (wall_ns - m_last_report_wall_ns) * 1e-9;
+    const double set_rate_hz =
+      interval_s > 0 ? static_cast<double>(total_sets - m_last_report_sets) / interval_s : 0;
+    const double object_rate_hz =
+      interval_s > 0 ? static_cast<double>(total_objects - m_last_report_objects) / interval_s : 0;
+    m_last_report_wall_ns = wall_ns;
+    m_last_report_sets = total_sets;
+    m_last_report_objects = total_objects;
+
+    std::ostringstream line;
+    line << "sets=" << total_sets << " objects=" << total_objects << " gaps=" << total_gaps
+         << " origins=" << n_origins << " set_rate_hz=" << set_rate_hz << " object_rate_hz=" << object_rate_hz
+         << " size_p50=" << m_set_size.quantile(0.5) << " size_p99=" << m_set_size.quantile(0.99)
+         << " lag_us_p50=" << m_lag.quantile(0.5) << " lag_us_p99=" << m_lag.quantile(0.99)
+         << " lag_us_p999=" << m_lag.quantile(0.999) << out.str();
+    return line.str();
+  }
+
+private:
+  static constexpr uint32_t s_unclaimed = std::numeric_limits<uint32_t>::max(); // NOLINT(build/unsigned)
+
+  struct OriginStats
+  {
+    std::atomic<uint32_t> id{ s_unclaimed };  // NOLINT(build/unsigned)
+    std::atomic<uint64_t> n_sets{ 0 };        // NOLINT(build/unsigned)
+    std::atomic<uint64_t> n_objects{ 0 };     // NOLINT(build/unsigned)
+    std::atomic<uint64_t> n_gaps{ 0 };        // NOLINT(build/unsigned)
+    // Writer-thread-only, not reported directly
+    uint32_t last_seqno = 0; // NOLINT(build/unsigned)
+    bool seen = false;
+  };
+
+  static uint64_t now_ns() // NOLINT(build/unsigned)
+  {
+    using namespace std::chrono;
+    return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+  }
+
+  // Open-addressed lookup keyed by origin element id; with a single
+  // writer thread the claim never races, the CAS just publishes the id
+  // to the reporting side. Past s_max_origins distinct origins, extras
+  // share the last slot rather than being dropped
+  OriginStats& find_or_claim(uint32_t id) // NOLINT(build/unsigned)
+  {
+    const size_t start = id % s_max_origins;
+    for (size_t probe = 0; probe < s_max_origins; ++probe) {
+      OriginStats& slot = m_origins[(start + probe) % s_max_origins];
+      uint32_t slot_id = slot.id.load(std::memory_order_acquire); // NOLINT(build/unsigned)
+      if (slot_id == id) {
+        return slot;
+      }
+      if (slot_id == s_unclaimed &&
+          slot.id.compare_exchange_strong(slot_id, id, std::memory_order_release, std::memory_order_acquire)) {
+        return slot;
+      }
+    }
+    return m_origins[s_max_origins - 1];
+  }
+
+  uint64_t m_clock_frequency_hz; // NOLINT(build/unsigned)
+
+  std::array<OriginStats, s_max_origins> m_origins{};
+  LatencyHistogram m_set_size; // bins are object counts, not us
+  LatencyHistogram m_lag;      // us behind the wall clock
+
+  // Writer-thread-only lag baseline
+  bool m_have_baseline = false;
+  uint64_t m_baseline_wall_ns = 0;                              // NOLINT(build/unsigned)
+  typename SET::timestamp_t m_baseline_data_time = 0;
+
+  // Reporter-thread-only interval state
+  uint64_t m_last_report_wall_ns = now_ns(); // NOLINT(build/unsigned)
+  uint64_t m_last_report_sets = 0;           // NOLINT(build/unsigned)
+  uint64_t m_last_report_objects = 0;        // NOLINT(build/unsigned)
+};
+
+} // namespace dunedaq::trigger
+
+#endif // TRIGGER_TEST_PLUGINS_SETSINKSTATS_HPP_
+
+// Local Variables:
+// c-basic-offset: 2
+// End:
@@ -41,6 +41,7 @@ TASetSink::init(const nlohmann::json& obj)
 void
 TASetSink::do_start(const nlohmann::json& /*obj*/)
 {
+  m_stats = std::make_unique<SetSinkStats<TASet>>(m_conf.clock_frequency_hz);
   m_running_flag.store(true);
   m_thread = std::thread(&TASetSink::do_work, this);
   pthread_setname_np(m_thread.native_handle(), "tasink");
@@ -74,12 +75,12 @@ TASetSink::do_work()
   size_t n_taset_received = 0;
 
   auto start_time = steady_clock::now();
+  auto last_report_time = start_time;
+  const auto report_interval = milliseconds(m_conf.report_interval_ms);
 
   triggeralgs::timestamp_t first_timestamp = 0;
   triggeralgs::timestamp_t last_timestamp = 0;
 
-  uint32_t last_seqno = 0;
-
   while (true) {
     std::optional<TASet> taset_opt = m_taset_source->try_receive(std::chrono::milliseconds(100));
     if (!taset_opt.has_value()) {
@@ -87,14 +88,18 @@ TASetSink::do_work()
       // there's nothing left on the input queue
       if (!m_running_flag.load()) {
         break;
-      } else {
-        continue;
       }
+      if (m_conf.report_interval_ms != 0 && steady_clock::now() - last_report_time >= report_interval) {
+        last_report_time = steady_clock::now();
+        TLOG() << "[TASetSink] " << m_stats->report();
+      }
+      continue;
     }
 
     TASet taset = *taset_opt;
-    
+
     ++n_taset_received;
+    m_stats->record(taset);
     if (m_outfile.is_open()) {
       for (auto const& ta : taset.objects) {
         m_outfile << ta.time_start << "\t" << ta.time_end << "\t" << ta.channel_start << "\t" << ta.channel_end << "\t"
@@ -110,10 +115,6 @@ TASetSink::do_work()
 
     if (m_conf.do_checks) {
       // Do some checks on the received TASet
-      if (last_seqno != 0 && taset.seqno != last_seqno + 1) {
-        TLOG() << "[TASetSink] Missed TASets: last_seqno=" << last_seqno << ", current seqno=" << taset.seqno;
-      }
-
       if (taset.start_time < last_timestamp) {
         TLOG_DEBUG(TLVL_VERY_IMPORTANT) << "[TASetSink] TASets out of order: last start time " << last_timestamp << ", current start time "
                       << taset.start_time;
@@ -131,12 +132,15 @@ TASetSink::do_work()
       }
     } // end if(m_conf.do_checks)
 
-    last_seqno = taset.seqno;
-    
     if (first_timestamp == 0) {
       first_timestamp = taset.start_time;
     }
     last_timestamp = taset.start_time;
+
+    if (m_conf.report_interval_ms != 0 && steady_clock::now() - last_report_time >= report_interval) {
+      last_report_time = steady_clock::now();
+      TLOG() << "[TASetSink] " << m_stats->report();
+    }
   } // while(true)
 
   auto end_time = steady_clock::now();
@@ -144,6 +148,7 @@ TASetSink::do_work()
   float rate_hz = 1e3 * static_cast<float>(n_taset_received) / time_ms;
   float inferred_clock_frequency = 1e3 * (last_timestamp - first_timestamp) / time_ms;
 
+  TLOG() << "[TASetSink] final " << m_stats->report();
   TLOG_DEBUG(TLVL_VERY_IMPORTANT) << "[TASetSink] Received " << n_taset_received << " TASets in " << time_ms << "ms. " << rate_hz
          << " TASet/s. Inferred clock frequency " << inferred_clock_frequency << "Hz";
 }
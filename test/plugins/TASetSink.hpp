@@ -12,6 +12,8 @@
 #ifndef TRIGGER_TEST_PLUGINS_TASETSINK_HPP_
 #define TRIGGER_TEST_PLUGINS_TASETSINK_HPP_
 
+#include "SetSinkStats.hpp"
+
 #include "trigger/TASet.hpp"
 #include "trigger/tasetsink/Nljs.hpp"
 
@@ -55,7 +57,8 @@ private:
   std::atomic<bool> m_running_flag{ false };
   std::thread m_thread;
   std::ofstream m_outfile;
-  
+  std::unique_ptr<SetSinkStats<TASet>> m_stats;
+
   tasetsink::Conf m_conf;
   // Queue sources and sinks
   using source_t = iomanager::ReceiverConcept<TASet>;
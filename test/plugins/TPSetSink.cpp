@@ -30,6 +30,7 @@ TPSetSink::TPSetSink(const std::string& name)
 {
   register_command("start", &TPSetSink::do_start);
   register_command("stop", &TPSetSink::do_stop);
+  register_command("conf", &TPSetSink::do_conf);
 }
 
 void
@@ -38,9 +39,16 @@ TPSetSink::init(const nlohmann::json& obj)
   m_tpset_source = get_iom_receiver<TPSet>(appfwk::connection_uid(obj, "tpset_source"));
 }
 
+void
+TPSetSink::do_conf(const nlohmann::json& obj)
+{
+  m_conf = obj;
+}
+
 void
 TPSetSink::do_start(const nlohmann::json& /*obj*/)
 {
+  m_stats = std::make_unique<SetSinkStats<TPSet>>(m_conf.clock_frequency_hz);
   m_running_flag.store(true);
   m_thread = std::thread(&TPSetSink::do_work, this);
   pthread_setname_np(m_thread.native_handle(), "tpsink");
@@ -61,12 +69,12 @@ TPSetSink::do_work()
   size_t n_tpset_received = 0;
 
   auto start_time = steady_clock::now();
+  auto last_report_time = start_time;
+  const auto report_interval = milliseconds(m_conf.report_interval_ms);
 
   triggeralgs::timestamp_t first_timestamp = 0;
   triggeralgs::timestamp_t last_timestamp = 0;
 
-  uint32_t last_seqno = 0; // NOLINT(build/unsigned)
-
   while (true) {
     TPSet tpset;
     try {
@@ -77,37 +85,44 @@ TPSetSink::do_work()
       // there's nothing left on the input queue
       if (!m_running_flag.load()) {
         break;
-      } else {
-        continue;
       }
+      if (m_conf.report_interval_ms != 0 && steady_clock::now() - last_report_time >= report_interval) {
+        last_report_time = steady_clock::now();
+        TLOG() << "[TPSetSink] " << m_stats->report();
+      }
+      continue;
     }
 
-    // Do some checks on the received TPSet
-    if (last_seqno != 0 && tpset.seqno != last_seqno + 1) {
-      TLOG() << "[TPSetSink] Missed TPSets: last_seqno=" << last_seqno << ", current seqno=" << tpset.seqno;
-    }
-    last_seqno = tpset.seqno;
+    m_stats->record(tpset);
 
-    if (tpset.start_time < last_timestamp) {
-      TLOG_DEBUG(TLVL_VERY_IMPORTANT) << "[TPSetSink] TPSets out of order: last start time " << last_timestamp << ", current start time "
-             << tpset.start_time;
-    }
-    if (tpset.type == TPSet::Type::kHeartbeat) {
-      TLOG_DEBUG(TLVL_GENERAL) << "[TPSetSink] Heartbeat TPSet with start time " << tpset.start_time;
-    } else if (tpset.objects.empty()) {
-      TLOG_DEBUG(TLVL_GENERAL) << "[TPSetSink] Empty TPSet with start time " << tpset.start_time;
-    }
-    for (auto const& tp : tpset.objects) {
-      if (tp.time_start < tpset.start_time || tp.time_start > tpset.end_time) {
-        TLOG_DEBUG(TLVL_GENERAL) << "[TPSetSink] TPSet with start time " << tpset.start_time << ", end time " << tpset.end_time
-               << " contains out-of-bounds TP with start time " << tp.time_start;
+    if (m_conf.do_checks) {
+      // Do some checks on the received TPSet
+      if (tpset.start_time < last_timestamp) {
+        TLOG_DEBUG(TLVL_VERY_IMPORTANT) << "[TPSetSink] TPSets out of order: last start time " << last_timestamp << ", current start time "
+               << tpset.start_time;
       }
-    }
+      if (tpset.type == TPSet::Type::kHeartbeat) {
+        TLOG_DEBUG(TLVL_GENERAL) << "[TPSetSink] Heartbeat TPSet with start time " << tpset.start_time;
+      } else if (tpset.objects.empty()) {
+        TLOG_DEBUG(TLVL_GENERAL) << "[TPSetSink] Empty TPSet with start time " << tpset.start_time;
+      }
+      for (auto const& tp : tpset.objects) {
+        if (tp.time_start < tpset.start_time || tp.time_start > tpset.end_time) {
+          TLOG_DEBUG(TLVL_GENERAL) << "[TPSetSink] TPSet with start time " << tpset.start_time << ", end time " << tpset.end_time
+                 << " contains out-of-bounds TP with start time " << tp.time_start;
+        }
+      }
+    } // end if(m_conf.do_checks)
 
     if (first_timestamp == 0) {
       first_timestamp = tpset.start_time;
     }
     last_timestamp = tpset.start_time;
+
+    if (m_conf.report_interval_ms != 0 && steady_clock::now() - last_report_time >= report_interval) {
+      last_report_time = steady_clock::now();
+      TLOG() << "[TPSetSink] " << m_stats->report();
+    }
   } // while(true)
 
   auto end_time = steady_clock::now();
@@ -115,6 +130,7 @@ TPSetSink::do_work()
   float rate_hz = 1e3 * static_cast<float>(n_tpset_received) / time_ms;
   float inferred_clock_frequency = 1e3 * (last_timestamp - first_timestamp) / time_ms;
 
+  TLOG() << "[TPSetSink] final " << m_stats->report();
   TLOG_DEBUG(TLVL_VERY_IMPORTANT) << "[TPSetSink] Received " << n_tpset_received << " TPSets in " << time_ms << "ms. " << rate_hz
          << " TPSet/s. Inferred clock frequency " << inferred_clock_frequency << "Hz";
 }
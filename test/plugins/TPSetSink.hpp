@@ -12,7 +12,10 @@
 #ifndef TRIGGER_TEST_PLUGINS_TPSETSINK_HPP_
 #define TRIGGER_TEST_PLUGINS_TPSETSINK_HPP_
 
+#include "SetSinkStats.hpp"
+
 #include "trigger/TPSet.hpp"
+#include "trigger/tpsetsink/Nljs.hpp"
 
 #include "appfwk/DAQModule.hpp"
 #include "iomanager/Receiver.hpp"
@@ -25,7 +28,10 @@ namespace dunedaq {
 namespace trigger {
 
 /**
- * @brief TPSetSink receives TPSets from a queue and prints them out
+ * @brief TPSetSink receives TPSets from a queue and measures them:
+ * per-origin receive rates, set-size distributions, data-time vs
+ * wall-time lag percentiles and seqno gap counts, emitted as periodic
+ * machine-readable reports
  */
 class TPSetSink : public dunedaq::appfwk::DAQModule
 {
@@ -47,12 +53,16 @@ private:
   // Commands
   void do_start(const nlohmann::json& obj);
   void do_stop(const nlohmann::json& obj);
+  void do_conf(const nlohmann::json& obj);
 
   void do_work();
 
   std::atomic<bool> m_running_flag{ false };
   std::thread m_thread;
 
+  tpsetsink::Conf m_conf;
+  std::unique_ptr<SetSinkStats<TPSet>> m_stats;
+
   // Queue sources and sinks
   using source_t = iomanager::ReceiverConcept<TPSet>;
   std::shared_ptr<source_t> m_tpset_source;
@@ -0,0 +1,145 @@
+/**
+ * @file ShmSetArena_test.cxx unit tests for the shared-memory Set arena
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2021.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#include "trigger/ShmSetArena.hpp"
+#include "trigger/TPSet.hpp"
+
+/**
+ * @brief Name of this test module
+ */
+#define BOOST_TEST_MODULE ShmSetArena_test // NOLINT
+#include "boost/test/unit_test.hpp"
+
+#include <unistd.h>
+
+#include <string>
+
+using namespace dunedaq;
+
+namespace {
+
+// shm segment names are process-global, so make them unique per test run
+std::string
+unique_name(const char* tag)
+{
+  return std::string("/trigger-shmarena-test-") + tag + "-" + std::to_string(::getpid());
+}
+
+trigger::TPSet
+make_tpset(uint64_t seqno, size_t n_tps) // NOLINT(build/unsigned)
+{
+  trigger::TPSet s;
+  s.seqno = seqno;
+  s.run_number = 3;
+  s.origin.id = 7;
+  s.type = trigger::TPSet::Type::kPayload;
+  s.start_time = 1000 * seqno;
+  s.end_time = 1000 * seqno + 999;
+  for (size_t i = 0; i < n_tps; ++i) {
+    trgdataformats::TriggerPrimitive tp{};
+    tp.time_start = s.start_time + i;
+    tp.channel = static_cast<int>(i);
+    tp.adc_integral = 100 + i;
+    s.objects.push_back(tp);
+  }
+  return s;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(BOOST_TEST_MODULE)
+
+BOOST_AUTO_TEST_CASE(WriteReadRoundTrip)
+{
+  const std::string name = unique_name("roundtrip");
+  trigger::ShmSetArena<trigger::TPSet> producer(name, 4, 100);
+  trigger::ShmSetArena<trigger::TPSet> consumer(name);
+
+  trigger::TPSet in = make_tpset(42, 10);
+  trigger::ShmSetHandle handle;
+  BOOST_REQUIRE(producer.write(in, handle));
+
+  auto view = consumer.read(handle);
+  BOOST_REQUIRE(view.valid());
+  BOOST_CHECK_EQUAL(view.header().seqno, in.seqno);
+  BOOST_CHECK_EQUAL(view.header().start_time, in.start_time);
+  BOOST_CHECK_EQUAL(view.n_objects(), in.objects.size());
+  for (size_t i = 0; i < view.n_objects(); ++i) {
+    BOOST_CHECK_EQUAL(view.objects()[i].channel, in.objects[i].channel);
+    BOOST_CHECK_EQUAL(view.objects()[i].adc_integral, in.objects[i].adc_integral);
+  }
+
+  trigger::TPSet out;
+  trigger::ShmSetArena<trigger::TPSet>::copy_out(view, out);
+  BOOST_CHECK_EQUAL(out.seqno, in.seqno);
+  BOOST_CHECK_EQUAL(out.run_number, in.run_number);
+  BOOST_CHECK_EQUAL(out.origin.id, in.origin.id);
+  BOOST_CHECK_EQUAL(out.start_time, in.start_time);
+  BOOST_CHECK_EQUAL(out.end_time, in.end_time);
+  BOOST_CHECK_EQUAL(out.objects.size(), in.objects.size());
+}
+
+BOOST_AUTO_TEST_CASE(StaleHandleRefusedAfterRecycling)
+{
+  const std::string name = unique_name("recycle");
+  trigger::ShmSetArena<trigger::TPSet> arena(name, 2, 100);
+
+  trigger::ShmSetHandle h0, h1, h2;
+  BOOST_REQUIRE(arena.write(make_tpset(0, 5), h0));
+  BOOST_REQUIRE(arena.write(make_tpset(1, 5), h1));
+  // Third write wraps the two-slot ring and recycles h0's slot
+  BOOST_REQUIRE(arena.write(make_tpset(2, 5), h2));
+  BOOST_CHECK_EQUAL(h2.slot, h0.slot);
+
+  auto stale = arena.read(h0);
+  BOOST_CHECK(!stale.valid());
+  auto fresh = arena.read(h2);
+  BOOST_REQUIRE(fresh.valid());
+  BOOST_CHECK_EQUAL(fresh.header().seqno, 2);
+}
+
+BOOST_AUTO_TEST_CASE(ReaderBlocksOverwrite)
+{
+  const std::string name = unique_name("reader");
+  trigger::ShmSetArena<trigger::TPSet> arena(name, 2, 100);
+
+  trigger::ShmSetHandle h0, h1, h2;
+  BOOST_REQUIRE(arena.write(make_tpset(0, 5), h0));
+  auto view = arena.read(h0);
+  BOOST_REQUIRE(view.valid());
+
+  BOOST_REQUIRE(arena.write(make_tpset(1, 5), h1));
+  // The ring is back at the held slot: the write must be refused, and the
+  // view must still see the original contents (the aborted write restored
+  // the generation, so the handle remains readable)
+  BOOST_CHECK(!arena.write(make_tpset(2, 5), h2));
+  BOOST_CHECK_EQUAL(view.header().seqno, 0);
+  auto again = arena.read(h0);
+  BOOST_CHECK(again.valid());
+  again.release();
+
+  // Releasing the last view frees the slot for the producer
+  view.release();
+  BOOST_REQUIRE(arena.write(make_tpset(2, 5), h2));
+  BOOST_CHECK_EQUAL(h2.slot, h0.slot);
+  auto fresh = arena.read(h2);
+  BOOST_REQUIRE(fresh.valid());
+  BOOST_CHECK_EQUAL(fresh.header().seqno, 2);
+}
+
+BOOST_AUTO_TEST_CASE(OversizedPayloadTakesSerializedPath)
+{
+  const std::string name = unique_name("oversize");
+  trigger::ShmSetArena<trigger::TPSet> arena(name, 2, 4);
+
+  trigger::ShmSetHandle handle;
+  BOOST_CHECK(!arena.write(make_tpset(0, 5), handle));
+  BOOST_CHECK(arena.write(make_tpset(1, 4), handle));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,107 @@
+/**
+ * @file TriggerDecisionMakerSupernovaIncremental_test.cxx unit tests for the
+ * incremental supernova multiplicity window
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#include "../plugins/TriggerDecisionMakerSupernovaIncremental.hpp" // NOLINT
+
+/**
+ * @brief Name of this test module
+ */
+#define BOOST_TEST_MODULE TriggerDecisionMakerSupernovaIncremental_test // NOLINT
+#include "boost/test/unit_test.hpp"
+
+#include <vector>
+
+using namespace dunedaq;
+
+BOOST_AUTO_TEST_SUITE(BOOST_TEST_MODULE)
+
+namespace {
+
+triggeralgs::TriggerCandidate
+make_candidate(triggeralgs::timestamp_t time, size_t n_inputs = 2)
+{
+  triggeralgs::TriggerCandidate cand{};
+  cand.time_start = time;
+  cand.inputs.resize(n_inputs);
+  return cand;
+}
+
+nlohmann::json
+small_window_config()
+{
+  // 1000-tick window, 10-tick buckets, fire on 3 candidates
+  return { { "time_window", 1000 }, { "threshold", 3 }, { "hit_threshold", 2 }, { "bucket_width", 10 } };
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(FiresAtThresholdWithinWindow)
+{
+  trigger::TriggerDecisionMakerSupernovaIncremental maker;
+  maker.configure(small_window_config());
+
+  std::vector<triggeralgs::TriggerDecision> decisions;
+  maker(make_candidate(100), decisions);
+  maker(make_candidate(200), decisions);
+  BOOST_CHECK_EQUAL(decisions.size(), 0);
+  maker(make_candidate(300), decisions);
+  BOOST_REQUIRE_EQUAL(decisions.size(), 1);
+  BOOST_CHECK_EQUAL(decisions[0].time_end, 300);
+}
+
+BOOST_AUTO_TEST_CASE(OldCandidatesExpire)
+{
+  trigger::TriggerDecisionMakerSupernovaIncremental maker;
+  maker.configure(small_window_config());
+
+  std::vector<triggeralgs::TriggerDecision> decisions;
+  maker(make_candidate(100), decisions);
+  maker(make_candidate(200), decisions);
+  // Far beyond the window: the first two have aged out, so this is 1 of 3
+  maker(make_candidate(5000), decisions);
+  BOOST_CHECK_EQUAL(decisions.size(), 0);
+  maker(make_candidate(5100), decisions);
+  BOOST_CHECK_EQUAL(decisions.size(), 0);
+  maker(make_candidate(5200), decisions);
+  BOOST_CHECK_EQUAL(decisions.size(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(HitThresholdFiltersCandidates)
+{
+  trigger::TriggerDecisionMakerSupernovaIncremental maker;
+  maker.configure(small_window_config());
+
+  std::vector<triggeralgs::TriggerDecision> decisions;
+  // Below hit_threshold: never counted, however many arrive
+  for (int i = 0; i < 10; ++i) {
+    maker(make_candidate(100 + 10 * i, 1), decisions);
+  }
+  BOOST_CHECK_EQUAL(decisions.size(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(RearmsEmptyAfterFiring)
+{
+  trigger::TriggerDecisionMakerSupernovaIncremental maker;
+  maker.configure(small_window_config());
+
+  std::vector<triggeralgs::TriggerDecision> decisions;
+  maker(make_candidate(100), decisions);
+  maker(make_candidate(200), decisions);
+  maker(make_candidate(300), decisions);
+  BOOST_REQUIRE_EQUAL(decisions.size(), 1);
+  // The burst that fired must not fire again on its own tail: a full
+  // fresh threshold is needed
+  maker(make_candidate(400), decisions);
+  maker(make_candidate(500), decisions);
+  BOOST_CHECK_EQUAL(decisions.size(), 1);
+  maker(make_candidate(600), decisions);
+  BOOST_CHECK_EQUAL(decisions.size(), 2);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -21,10 +21,12 @@
 
 #include <chrono>
 #include <iostream>
+#include <iterator>
 #include <map>
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 using namespace dunedaq;
 
@@ -73,6 +75,28 @@ BOOST_AUTO_TEST_CASE(ZipperStreamIDFromGeoID)
   BOOST_CHECK_EQUAL(n2, id2);
 }
 
+BOOST_AUTO_TEST_CASE(LoserMergeDisorderedProducer)
+{
+  using node_t = zipper::Node<int>;
+  zipper::loser_merge<node_t> lm(2);
+  auto now = std::chrono::steady_clock::now();
+
+  BOOST_CHECK(lm.feed(node_t{ 1, 50, 0, now }));
+  BOOST_CHECK(lm.feed(node_t{ 2, 60, 0, now }));
+  BOOST_CHECK(lm.feed(node_t{ 3, 45, 1, now }));
+  // A producer violating its own ordering: this node displaces stream 0's
+  // FIFO head, and the tournament tree must be replayed to see it
+  BOOST_CHECK(lm.feed(node_t{ 4, 40, 0, now }));
+
+  std::vector<node_t> got;
+  lm.drain_full(std::back_inserter(got));
+  BOOST_REQUIRE_EQUAL(got.size(), 4);
+  BOOST_CHECK_EQUAL(got[0].ordering, 40);
+  BOOST_CHECK_EQUAL(got[1].ordering, 45);
+  BOOST_CHECK_EQUAL(got[2].ordering, 50);
+  BOOST_CHECK_EQUAL(got[3].ordering, 60);
+}
+
 using receiver_t = std::shared_ptr<iomanager::ReceiverConcept<trigger::TPSet>>;
 using sender_t = std::shared_ptr<iomanager::SenderConcept<trigger::TPSet>>;
 using duration_t = iomanager::Queue<trigger::TPSet>::duration_t;
@@ -16,9 +16,11 @@
 #include "boost/test/unit_test.hpp"
 
 #include <chrono>
+#include <cstdint>
 #include <map>
 #include <memory>
 #include <string>
+#include <vector>
 
 using namespace dunedaq;
 
@@ -42,4 +44,30 @@ BOOST_AUTO_TEST_CASE(Initialization)
   BOOST_CHECK_EQUAL(tpset.origin.subsystem, daqdataformats::SourceID::Subsystem::kTrigger);
 }
 
+// Regression test: move-assigning small content into a previously spilled
+// SmallVector must not leave the old heap elements behind, where the next
+// spill would resurface them ahead of the live payload
+BOOST_AUTO_TEST_CASE(SmallVectorMoveAssignClearsSpill)
+{
+  trigger::SmallVector<uint64_t, 8> v; // NOLINT(build/unsigned)
+  for (uint64_t i = 0; i < 10; ++i) {  // NOLINT(build/unsigned)
+    v.push_back(1000 + i); // spills past the inline capacity
+  }
+  BOOST_REQUIRE_EQUAL(v.size(), 10);
+
+  v = std::vector<uint64_t>{ 1, 2, 3 }; // NOLINT(build/unsigned)
+  BOOST_REQUIRE_EQUAL(v.size(), 3);
+
+  for (uint64_t i = 0; i < 6; ++i) { // NOLINT(build/unsigned)
+    v.push_back(10 + i); // spills again
+  }
+  BOOST_REQUIRE_EQUAL(v.size(), 9);
+  BOOST_CHECK_EQUAL(v[0], 1);
+  BOOST_CHECK_EQUAL(v[1], 2);
+  BOOST_CHECK_EQUAL(v[2], 3);
+  for (uint64_t i = 0; i < 6; ++i) { // NOLINT(build/unsigned)
+    BOOST_CHECK_EQUAL(v[3 + i], 10 + i);
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END()